@@ -46,13 +46,20 @@ void INA219Manager::begin() {
     // Create mutex for thread-safe data access
     powerMutex = xSemaphoreCreateMutex();
 
+    // The simulated plant stands in for the chip
+    if (_plant != nullptr) {
+        LOGW(_logger, "INA219 readings come from the simulated plant");
+        ReadData();
+        return;
+    }
+
     // Initialize INA219 sensor with error handling
     while (!_ina219.begin()) {
-        _logger.error("Failed to find INA219 chip");
+        LOGE(_logger, "Failed to find INA219 chip");
         delay(1000); // Wait before retrying
     }
 
-    _logger.info("INA219 sensor initialized successfully");
+    LOGI(_logger, "INA219 sensor initialized successfully");
     
     // Perform initial data reading
     ReadData();
@@ -65,8 +72,8 @@ void INA219Manager::begin() {
 void INA219Manager::ReadData() {
     if (xSemaphoreTake(powerMutex, portMAX_DELAY) == pdTRUE) {
         // Read raw sensor values atomically
-        float shuntvoltage = _ina219.getShuntVoltage_mV();
-        float busvoltage = _ina219.getBusVoltage_V();
+        float shuntvoltage = (_plant != nullptr) ? _plant->readShuntVoltage_mV() : _ina219.getShuntVoltage_mV();
+        float busvoltage = (_plant != nullptr) ? _plant->readBusVoltage_V() : _ina219.getBusVoltage_V();
         
         // Calculate raw values
         float rawLoadVoltage = busvoltage + (shuntvoltage / 1000);
@@ -85,6 +92,10 @@ void INA219Manager::ReadData() {
     }
 }
 
+void INA219Manager::setPlantSimulator(PlantSimulator* plant) {
+    _plant = plant;
+}
+
 // =============================================================================
 // VOLTAGE AVERAGING METHODS
 // =============================================================================
@@ -24,6 +24,7 @@
 
 // Custom includes
 #include "logger.h"
+#include "plant_simulator.h"
 
 class INA219Manager {
 public:
@@ -34,6 +35,9 @@ public:
     void begin();
     void ReadData();
 
+    // Bench testing: read supply current and voltage from a simulated plant
+    void setPlantSimulator(PlantSimulator* plant);
+
     // Data access methods
     float getCurrent();
     float getLoadVoltage();
@@ -42,6 +46,7 @@ public:
 private:
     // Dependencies
     Logger& _logger;
+    PlantSimulator* _plant = nullptr;
 
     // Hardware configuration
     static constexpr int _INA219_I2C_ADDRESS = 0x45;
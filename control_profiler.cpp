@@ -0,0 +1,189 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Control Profiler - Per-stage timing histograms for the motor control loop.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "control_profiler.h"
+
+#ifndef ARDUINO
+#include <chrono>
+#endif
+
+// =============================================================================
+// CONSTRUCTOR
+// =============================================================================
+
+ControlLoopProfiler::ControlLoopProfiler() {
+    clearHistograms();
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        _pendingValid[i] = false;
+    }
+}
+
+// =============================================================================
+// CONTROL TASK INSTRUMENTATION
+// =============================================================================
+
+void ControlLoopProfiler::startCycle() {
+    _cycleStart = now();
+    _lastMark = _cycleStart;
+}
+
+void ControlLoopProfiler::mark(Stage stage) {
+    // Each mark closes the stage that ran since the previous one
+    uint32_t timestamp = now();
+    _pending[stage] = timestamp - _lastMark;
+    _pendingValid[stage] = true;
+    _lastMark = timestamp;
+}
+
+void ControlLoopProfiler::endCycle() {
+    _pending[STAGE_TOTAL] = now() - _cycleStart;
+    _pendingValid[STAGE_TOTAL] = true;
+
+    portENTER_CRITICAL(&_lock);
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        if (!_pendingValid[i]) {
+            continue;
+        }
+        uint32_t ticks = _pending[i];
+        StageHistogram& stage = _stages[i];
+        stage.count++;
+        stage.sumTicks += ticks;
+        stage.minTicks = min(stage.minTicks, ticks);
+        stage.maxTicks = max(stage.maxTicks, ticks);
+        stage.buckets[bucketIndex(ticks)]++;
+    }
+    portEXIT_CRITICAL(&_lock);
+
+    // Stages skipped this tick (calibration mode) must not carry over
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        _pendingValid[i] = false;
+    }
+}
+
+// =============================================================================
+// RESULTS
+// =============================================================================
+
+ControlLoopProfiler::StageStats ControlLoopProfiler::getStats(Stage stage) {
+    StageStats stats = {0, 0, 0, 0, 0};
+    uint32_t count, minTicks, maxTicks, p99Ticks = 0;
+    uint64_t sumTicks;
+
+    portENTER_CRITICAL(&_lock);
+    const StageHistogram& histogram = _stages[stage];
+    count = histogram.count;
+    minTicks = histogram.minTicks;
+    maxTicks = histogram.maxTicks;
+    sumTicks = histogram.sumTicks;
+
+    // Walk up the histogram to the bucket holding the 99th percentile sample
+    uint32_t target = count - count / 100;
+    uint32_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT && count > 0; i++) {
+        seen += histogram.buckets[i];
+        if (seen >= target) {
+            p99Ticks = bucketUpperBound(i);
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&_lock);
+
+    if (count == 0) {
+        return stats;
+    }
+
+    float scale = ticksPerMicro();
+    stats.count = count;
+    stats.minMicros = minTicks / scale;
+    stats.meanMicros = (float)((double)sumTicks / count) / scale;
+    stats.p99Micros = min(p99Ticks, maxTicks) / scale;
+    stats.maxMicros = maxTicks / scale;
+    return stats;
+}
+
+void ControlLoopProfiler::reset() {
+    portENTER_CRITICAL(&_lock);
+    clearHistograms();
+    portEXIT_CRITICAL(&_lock);
+}
+
+const char* ControlLoopProfiler::getStageName(Stage stage) {
+    switch (stage) {
+        case STAGE_WIND:            return "wind";
+        case STAGE_SETPOINT:        return "setpoint";
+        case STAGE_SENSORS:         return "sensors";
+        case STAGE_ERRORS:          return "errors";
+        case STAGE_ERROR_TRACKING:  return "error_tracking";
+        case STAGE_CONTROL:         return "control";
+        case STAGE_ACTUATION:       return "actuation";
+        case STAGE_OSCILLATION:     return "oscillation";
+        case STAGE_TELEMETRY:       return "telemetry";
+        case STAGE_TOTAL:           return "total";
+        default:                    return "unknown";
+    }
+}
+
+// =============================================================================
+// HELPER METHODS
+// =============================================================================
+
+uint32_t ControlLoopProfiler::now() {
+#ifdef ARDUINO
+    return ESP.getCycleCount();
+#else
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+float ControlLoopProfiler::ticksPerMicro() {
+#ifdef ARDUINO
+    return (float)ESP.getCpuFreqMHz();
+#else
+    return 1000.0f;
+#endif
+}
+
+int ControlLoopProfiler::bucketIndex(uint32_t ticks) {
+    if (ticks < SUB_BUCKETS) {
+        return ticks;
+    }
+    int msb = 31 - __builtin_clz(ticks);
+    int shift = msb - SUB_BUCKET_BITS;
+    int sub = (ticks >> shift) & (SUB_BUCKETS - 1);
+    return (shift + 1) * SUB_BUCKETS + sub;
+}
+
+uint32_t ControlLoopProfiler::bucketUpperBound(int index) {
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+    int shift = index / SUB_BUCKETS - 1;
+    uint32_t lower = (uint32_t)(SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+    return lower + ((1u << shift) - 1);
+}
+
+void ControlLoopProfiler::clearHistograms() {
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        _stages[i].count = 0;
+        _stages[i].minTicks = UINT32_MAX;
+        _stages[i].maxTicks = 0;
+        _stages[i].sumTicks = 0;
+        memset(_stages[i].buckets, 0, sizeof(_stages[i].buckets));
+    }
+}
@@ -0,0 +1,97 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Control Profiler - Per-stage timing histograms for the motor control loop.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CONTROL_PROFILER_H
+#define CONTROL_PROFILER_H
+
+// System includes
+#include <Arduino.h>
+
+// Times each stage of a control tick with the CPU cycle counter (a monotonic nanosecond
+// clock when built off-target) and keeps min/mean/max plus a log-linear histogram per
+// stage for percentiles. The control task is the only writer; a tick's samples are
+// committed in one short critical section so readers always see whole ticks.
+class ControlLoopProfiler {
+public:
+    enum Stage {
+        STAGE_WIND = 0,
+        STAGE_SETPOINT,
+        STAGE_SENSORS,
+        STAGE_ERRORS,
+        STAGE_ERROR_TRACKING,
+        STAGE_CONTROL,
+        STAGE_ACTUATION,
+        STAGE_OSCILLATION,
+        STAGE_TELEMETRY,
+        STAGE_TOTAL,
+        STAGE_COUNT
+    };
+
+    struct StageStats {
+        uint32_t count;
+        float minMicros;
+        float meanMicros;
+        float p99Micros;
+        float maxMicros;
+    };
+
+    // Constructor
+    ControlLoopProfiler();
+
+    // Control task instrumentation
+    void startCycle();
+    void mark(Stage stage);
+    void endCycle();
+
+    // Results
+    StageStats getStats(Stage stage);
+    void reset();
+    static const char* getStageName(Stage stage);
+
+private:
+    // Histogram layout: SUB_BUCKETS linear buckets per power of two of ticks
+    static constexpr int SUB_BUCKET_BITS = 2;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr int BUCKET_COUNT = 32 * SUB_BUCKETS;
+
+    struct StageHistogram {
+        uint32_t count;
+        uint32_t minTicks;
+        uint32_t maxTicks;
+        uint64_t sumTicks;
+        uint32_t buckets[BUCKET_COUNT];
+    };
+
+    StageHistogram _stages[STAGE_COUNT];
+    portMUX_TYPE _lock = portMUX_INITIALIZER_UNLOCKED;
+
+    // Current tick, owned by the control task
+    uint32_t _cycleStart = 0;
+    uint32_t _lastMark = 0;
+    uint32_t _pending[STAGE_COUNT];
+    bool _pendingValid[STAGE_COUNT];
+
+    // Helper methods
+    static uint32_t now();
+    static float ticksPerMicro();
+    static int bucketIndex(uint32_t ticks);
+    static uint32_t bucketUpperBound(int index);
+    void clearHistograms();
+};
+
+#endif // CONTROL_PROFILER_H
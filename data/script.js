@@ -21,200 +21,481 @@ var logScrollPaused = false;
 var logLines = []; // Store log lines in browser memory
 var MAX_LOG_LINES = 100000;
 
-setInterval(function() {
+// Live values and weather arrive on the /events push channel as partial frames that are
+// merged here. Configuration comes from /config, revalidated with its ETag whenever the
+// stream reports a new configVersion. Without a stream the UI polls /telemetry at the
+// fast rate instead. Both are converted to the stream's string fields before merging.
+var uiState = {};
+var configLoaded = false;
+var liveLoaded = false;
+var eventSource = null;
+var pollTimer = null;
+var configVersion = null;
+var configETag = null;
+var FAST_POLL_MS = 250;
+var EVENT_RETRY_MS = 10000;
+
+function applyFrame(frame) {
+  if (frame.configVersion !== undefined && frame.configVersion !== configVersion) {
+    if (configVersion !== null) {
+      loadConfig();
+    }
+    configVersion = frame.configVersion;
+  }
+  Object.assign(uiState, frame);
+  if (!configLoaded || !liveLoaded) {
+    return;  // Hold partial frames until both configuration and live values are in
+  }
+  updateUI(uiState);
+  // Log text is only rendered once; frames without logs must not repeat it
+  uiState.newLogMessages = "";
+}
+
+// Bucket labels for the rotctl latency histogram, matching the firmware's bucket bounds
+var LATENCY_BUCKET_LABELS = ["<0.1", "<0.25", "<0.5", "<1", "<2.5", "<5", "<10", ">10"];
+
+function updateLatencyHistogram(histogram) {
+  var container = document.getElementById('rotctl_latency_hist');
+  if (!histogram) {
+    return;
+  }
+  var percents = histogram.split(",");
+  if (container.children.length != percents.length) {
+    container.innerHTML = "";
+    for (var i = 0; i < percents.length; i++) {
+      var column = document.createElement("div");
+      column.className = "signal latency-bucket";
+      var bar = document.createElement("div");
+      bar.className = "bar active";
+      column.appendChild(bar);
+      container.appendChild(column);
+    }
+  }
+  for (var i = 0; i < percents.length; i++) {
+    var column = container.children[i];
+    column.title = LATENCY_BUCKET_LABELS[i] + " ms: " + percents[i] + "%";
+    column.firstChild.style.height = percents[i] + "%";
+  }
+}
+
+function onOff(value) {
+  return value ? "ON" : "OFF";
+}
+
+function yesNo(value) {
+  return value ? "YES" : "NO";
+}
+
+// /config fields, formatted the way the event stream and the old /variable sent them
+function configFrame(config) {
+  return {
+    http_port: config.http_port,
+    rotctl_port: config.rotctl_port,
+    wifissid: config.wifissid,
+    loginUser: config.loginUser,
+    passwordStatus: config.passwordProtected ? "True" : "False",
+    maxDualMotorAzSpeed: config.maxDualMotorAzSpeed,
+    maxDualMotorElSpeed: config.maxDualMotorElSpeed,
+    maxSingleMotorAzSpeed: config.maxSingleMotorAzSpeed,
+    maxSingleMotorElSpeed: config.maxSingleMotorElSpeed,
+    azOffset: config.azOffset.toFixed(3),
+    elOffset: config.elOffset.toFixed(3),
+    toleranceAz: config.MIN_AZ_TOLERANCE.toFixed(2),
+    toleranceEl: config.MIN_EL_TOLERANCE.toFixed(2),
+    P_el: config.P_el,
+    P_az: config.P_az,
+    MIN_EL_SPEED: config.MIN_EL_SPEED,
+    MIN_AZ_SPEED: config.MIN_AZ_SPEED,
+    MIN_AZ_TOLERANCE: config.MIN_AZ_TOLERANCE.toFixed(2),
+    MIN_EL_TOLERANCE: config.MIN_EL_TOLERANCE.toFixed(2),
+    MAX_FAULT_POWER: config.MAX_FAULT_POWER,
+    MIN_VOLTAGE_THRESHOLD: config.MIN_VOLTAGE_THRESHOLD,
+    CONTROL_PERIOD_US: config.CONTROL_PERIOD_US,
+    CONTROLLER_MODE: config.CONTROLLER_MODE,
+    MOTION_PROFILE: config.MOTION_PROFILE ? "1" : "0",
+    EVENT_INTERVAL_MS: config.EVENT_INTERVAL_MS,
+    Ki_az: config.Ki_az.toFixed(2),
+    Kd_az: config.Kd_az.toFixed(2),
+    Kff_az: config.Kff_az.toFixed(2),
+    Ki_el: config.Ki_el.toFixed(2),
+    Kd_el: config.Kd_el.toFixed(2),
+    Kff_el: config.Kff_el.toFixed(2),
+    stellariumPollingOn: onOff(config.stellariumPollingOn),
+    stellariumServerIPText: config.stellariumServerIP || "NO IP SET",
+    stellariumServerPortText: config.stellariumServerPort,
+    trackingOnText: onOff(config.trackingOn),
+    trackingSatName: config.trackingSatName,
+    trackingTleEpoch: config.trackingTleEpoch,
+    weatherEnabled: onOff(config.weatherEnabled),
+    weatherApiKeyConfigured: yesNo(config.weatherApiKeyConfigured),
+    weatherLocationConfigured: yesNo(config.weatherLocationConfigured),
+    weatherLatitude: config.weatherLatitude.toFixed(6),
+    weatherLongitude: config.weatherLongitude.toFixed(6),
+    windSafetyEnabled: onOff(config.windSafetyEnabled),
+    windBasedHomeEnabled: onOff(config.windBasedHomeEnabled),
+    windSpeedThreshold: config.windSpeedThreshold.toFixed(1),
+    windGustThreshold: config.windGustThreshold.toFixed(1),
+    currentDebugLevel: config.currentDebugLevel,
+    serialOutputDisabled: config.serialOutputDisabled
+  };
+}
+
+// /telemetry fields, formatted the way the event stream sends them
+function telemetryFrame(t) {
+  var frame = {
+    configVersion: String(t.configVersion),
+    correctedAngle_el: t.correctedAngle_el.toFixed(2),
+    correctedAngle_az: t.correctedAngle_az.toFixed(2),
+    setpoint_az: t.setpoint_az.toFixed(2),
+    setpoint_el: t.setpoint_el.toFixed(2),
+    setPointState_az: t.setPointState_az ? "1" : "0",
+    setPointState_el: t.setPointState_el ? "1" : "0",
+    error_az: t.error_az.toFixed(2),
+    error_el: t.error_el.toFixed(2),
+    el_startAngle: t.el_startAngle.toFixed(2),
+    needs_unwind: String(t.needs_unwind),
+    isAzMotorLatched: t.isAzMotorLatched ? "1" : "0",
+    isElMotorLatched: t.isElMotorLatched ? "1" : "0",
+    calMode: onOff(t.calMode),
+    i2cErrorFlag_az: t.i2cErrorFlag_az ? "1" : "0",
+    i2cErrorFlag_el: t.i2cErrorFlag_el ? "1" : "0",
+    faultTripped: t.faultTripped ? "1" : "0",
+    badAngleFlag: t.badAngleFlag ? "1" : "0",
+    magnetFault: t.magnetFault ? "1" : "0",
+    singleMotorModeText: onOff(t.singleMotorMode),
+    serialActive: t.serialActive ? "1" : "0",
+    stellariumConnActive: t.stellariumConnActive ? "Connected" : "Disconnected",
+    trackingState: t.trackingState,
+    trackingAz: t.trackingAz.toFixed(2),
+    trackingEl: t.trackingEl.toFixed(2),
+    trackingRange: t.trackingRange.toFixed(0),
+    trackingPropUs: t.trackingPropUs + " / " + t.trackingPropMaxUs,
+    inputVoltage: t.inputVoltage.toFixed(2),
+    currentDraw: t.currentDraw.toFixed(2),
+    rotatorPowerDraw: t.rotatorPowerDraw.toFixed(2),
+    rssi: String(t.rssi),
+    level: String(t.level),
+    ip_addr: t.ip_addr,
+    bssid: t.bssid,
+    wifi_channel: t.wifi_channel,
+    rotctl_client_ip: t.rotctl_client_ip,
+    rotctl_clients: String(t.rotctl_clients),
+    windStowActive: yesNo(t.windStowActive),
+    windStowReason: t.windStowReason,
+    windTrackingActive: yesNo(t.windTrackingActive),
+    windTrackingStatus: t.windTrackingStatus,
+    emergencyStowActive: yesNo(t.emergencyStowActive),
+    stowDirection: t.stowDirection.toFixed(1),
+    newLogMessages: t.newLogMessages || ""
+  };
+
+  var latency = t.rotctl_latency;
+  if (latency.count == 0) {
+    frame.rotctl_latency = "No commands yet";
+  } else {
+    frame.rotctl_latency = "p50 " + (latency.p50_us / 1000).toFixed(2) + " ms, p99 " +
+                           (latency.p99_us / 1000).toFixed(2) + " ms, max " + (latency.max_us / 1000).toFixed(2) + " ms";
+  }
+  var percents = [];
+  for (var i = 0; i < latency.buckets.length; i++) {
+    percents.push(latency.count > 0 ? Math.floor(latency.buckets[i] * 100 / latency.count) : 0);
+  }
+  frame.rotctl_latency_hist = percents.join(",");
+
+  var weather = t.weather;
+  frame.weatherDataValid = yesNo(weather.valid);
+  if (weather.valid) {
+    frame.currentWindSpeed = weather.windSpeed.toFixed(1);
+    frame.currentWindDirection = weather.windDirection.toFixed(0);
+    frame.currentWindGust = weather.windGust.toFixed(1);
+    frame.currentWeatherTime = weather.time;
+    frame.weatherLastUpdate = weather.lastUpdate;
+    frame.weatherError = "";
+    for (var i = 0; i < 3; i++) {
+      frame["forecastTime" + i] = weather.forecast[i].time;
+      frame["forecastWindSpeed" + i] = weather.forecast[i].windSpeed.toFixed(1);
+      frame["forecastWindDirection" + i] = weather.forecast[i].windDirection.toFixed(0);
+      frame["forecastWindGust" + i] = weather.forecast[i].windGust.toFixed(1);
+    }
+  } else {
+    frame.currentWindSpeed = "N/A";
+    frame.currentWindDirection = "N/A";
+    frame.currentWindGust = "N/A";
+    frame.currentWeatherTime = "N/A";
+    frame.weatherLastUpdate = "Never";
+    frame.weatherError = weather.error;
+  }
+  return frame;
+}
+
+// Conditional fetch: after the first load the firmware answers 304 unless a setting changed
+function loadConfig() {
   var xhr = new XMLHttpRequest();
-  xhr.open("GET", "/variable", true);
+  xhr.open("GET", "/config", true);
+  if (configETag) {
+    xhr.setRequestHeader("If-None-Match", configETag);
+  }
   xhr.onreadystatechange = function() {
     if (xhr.readyState == 4 && xhr.status == 200) {
-      var data = JSON.parse(xhr.responseText);
-      document.getElementById("correctedAngle_el").innerHTML = data.correctedAngle_el;
-      document.getElementById("correctedAngle_az").innerHTML = data.correctedAngle_az;
-      document.getElementById("setpoint_az").innerHTML = data.setpoint_az;
-      document.getElementById("setpoint_el").innerHTML = data.setpoint_el;
-      document.getElementById("setPointState_az").innerHTML = data.setPointState_az;
-      document.getElementById("setPointState_el").innerHTML = data.setPointState_el;
-      document.getElementById("error_az").innerHTML = data.error_az;
-      document.getElementById("error_el").innerHTML = data.error_el;
-      document.getElementById("el_startAngle").innerHTML = data.el_startAngle;
-      document.getElementById("needs_unwind").innerHTML = data.needs_unwind;
-      document.getElementById("calMode").innerHTML = data.calMode;
-      document.getElementById("i2cErrorFlag_az").innerHTML = data.i2cErrorFlag_az;
-      document.getElementById("i2cErrorFlag_el").innerHTML = data.i2cErrorFlag_el;
-      document.getElementById("badAngleFlag").innerHTML = data.badAngleFlag;
-      document.getElementById("magnetFault").innerHTML = data.magnetFault;
-      document.getElementById("faultTripped").innerHTML = data.faultTripped;
-      document.getElementById("http_port").innerHTML = data.http_port;
-      document.getElementById("rotctl_port").innerHTML = data.rotctl_port;
-      document.getElementById("maxDualMotorAzSpeed").innerHTML = data.maxDualMotorAzSpeed;
-      document.getElementById("maxDualMotorElSpeed").innerHTML = data.maxDualMotorElSpeed;
-      document.getElementById("maxSingleMotorAzSpeed").innerHTML = data.maxSingleMotorAzSpeed;
-      document.getElementById("maxSingleMotorElSpeed").innerHTML = data.maxSingleMotorElSpeed;
-      document.getElementById("wifissid").innerHTML = data.wifissid;
-      document.getElementById("loginUser").innerHTML = data.loginUser;
-      document.getElementById("passwordStatus").innerHTML = data.passwordStatus;
-      document.getElementById("serialActive").innerHTML = data.serialActive;
-      document.getElementById("singleMotorModeText").innerHTML = data.singleMotorModeText;
-      document.getElementById("toleranceAz").innerHTML = data.toleranceAz;
-      document.getElementById("toleranceEl").innerHTML = data.toleranceEl;
-      document.getElementById("isAzMotorLatched").innerHTML = data.isAzMotorLatched;
-      document.getElementById("isElMotorLatched").innerHTML = data.isElMotorLatched;
-      document.getElementById("stellariumPollingOn").innerHTML = data.stellariumPollingOn;
-      document.getElementById("stellariumServerIPText").innerHTML = data.stellariumServerIPText;
-      document.getElementById("stellariumServerPortText").innerHTML = data.stellariumServerPortText;
-      document.getElementById("stellariumConnActive").innerHTML = data.stellariumConnActive;
-      document.getElementById("inputVoltage").innerHTML = data.inputVoltage;
-      document.getElementById("currentDraw").innerHTML = data.currentDraw;
-      document.getElementById("rotatorPowerDraw").innerHTML = data.rotatorPowerDraw;
-      document.getElementById('ip_addr').innerHTML = data.ip_addr;
-      document.getElementById('rotctl_client_ip').innerHTML = data.rotctl_client_ip;
-      document.getElementById('bssid').innerHTML = data.bssid;
-      document.getElementById('wifi_channel').innerHTML = data.wifi_channel;
-
-      document.getElementById('rssi').innerHTML = data.rssi;
-      var level = data.level;
-      document.getElementById('bar1').classList.toggle('active', level >= 1);
-      document.getElementById('bar2').classList.toggle('active', level >= 2);
-      document.getElementById('bar3').classList.toggle('active', level >= 3);
-      document.getElementById('bar4').classList.toggle('active', level >= 4);
-
-      // Wind safety status updates
-      document.getElementById("windStowActive").innerHTML = data.windStowActive;
-      document.getElementById("windStowReason").innerHTML = data.windStowReason;
-      document.getElementById("windTrackingActive").innerHTML = data.windTrackingActive;
-      document.getElementById("windTrackingStatus").innerHTML = data.windTrackingStatus;
-      document.getElementById("windSafetyEnabled").innerHTML = data.windSafetyEnabled;
-      document.getElementById("windBasedHomeEnabled").innerHTML = data.windBasedHomeEnabled;
-      document.getElementById("windSpeedThreshold").innerHTML = data.windSpeedThreshold;
-      document.getElementById("windGustThreshold").innerHTML = data.windGustThreshold;
-      document.getElementById("emergencyStowActive").innerHTML = data.emergencyStowActive;
-      document.getElementById("stowDirection").innerHTML = data.stowDirection;
-      
-      document.getElementById("azOffset").innerHTML = data.azOffset;
-      document.getElementById("elOffset").innerHTML = data.elOffset;
-
-      // Update wind safety checkboxes
-      var windSafetyCheckbox = document.getElementById("windSafetyToggle");
-      if (windSafetyCheckbox) {
-        windSafetyCheckbox.checked = (data.windSafetyEnabled === "ON");
-      }
+      configETag = xhr.getResponseHeader("ETag");
+      configLoaded = true;
+      applyFrame(configFrame(JSON.parse(xhr.responseText)));
+    }
+  };
+  xhr.send();
+}
 
-      var windBasedHomeCheckbox = document.getElementById("windBasedHomeToggle");
-      if (windBasedHomeCheckbox) {
-        windBasedHomeCheckbox.checked = (data.windBasedHomeEnabled === "ON");
-      }
+function pollTelemetry() {
+  var xhr = new XMLHttpRequest();
+  xhr.open("GET", "/telemetry?logs=1", true);
+  xhr.onreadystatechange = function() {
+    if (xhr.readyState == 4 && xhr.status == 200) {
+      liveLoaded = true;
+      applyFrame(telemetryFrame(JSON.parse(xhr.responseText)));
+    }
+  };
+  xhr.send();
+}
 
-      // Show/hide wind stow alert
-      var windStowAlert = document.getElementById("windStowAlert");
-      var windStowMessage = document.getElementById("windStowMessage");
-      if (data.emergencyStowActive === "YES") {
-        windStowMessage.innerHTML = "⚠️ EMERGENCY WIND STOW ACTIVE: " + data.windStowReason;
-        windStowAlert.style.display = "block";
-      } else {
-        windStowAlert.style.display = "none";
-      }
+function schedulePolling() {
+  clearInterval(pollTimer);
+  pollTimer = eventSource ? null : setInterval(pollTelemetry, FAST_POLL_MS);
+}
 
-      // Handle new log messages with browser-side rolling buffer
-      if (data.newLogMessages && data.newLogMessages.trim() !== "") {
-        // Split new messages into lines and add them
-        var newLines = data.newLogMessages.split('\n');
-        for (var i = 0; i < newLines.length; i++) {
-          if (newLines[i].trim() !== "") {
-            logLines.push(newLines[i]);
-
-            // Keep only the last MAX_LOG_LINES
-            if (logLines.length > MAX_LOG_LINES) {
-              logLines.shift(); // Remove oldest line
-            }
-          }
-        }
-      }
+function connectEvents() {
+  if (!window.EventSource) {
+    schedulePolling();
+    return;
+  }
 
-      updateLogDisplay();
+  eventSource = new EventSource("/events");
+  eventSource.onmessage = function(event) {
+    liveLoaded = true;
+    applyFrame(JSON.parse(event.data));
+  };
+  eventSource.addEventListener("log", function(event) {
+    applyFrame({ newLogMessages: event.data });
+  });
+  eventSource.onerror = function() {
+    // Server full or connection lost: poll at full rate until a retry succeeds
+    eventSource.close();
+    eventSource = null;
+    schedulePolling();
+    setTimeout(connectEvents, EVENT_RETRY_MS);
+  };
+  schedulePolling();
+}
 
-      // Update debug level if element exists
-      if (document.getElementById("currentDebugLevel")) {
-        document.getElementById("currentDebugLevel").innerHTML = data.currentDebugLevel;
-        updateDebugLevelDropdown(data.currentDebugLevel);
-      }
+loadConfig();
+connectEvents();
+
+function updateUI(data) {
+  document.getElementById("correctedAngle_el").innerHTML = data.correctedAngle_el;
+  document.getElementById("correctedAngle_az").innerHTML = data.correctedAngle_az;
+  document.getElementById("setpoint_az").innerHTML = data.setpoint_az;
+  document.getElementById("setpoint_el").innerHTML = data.setpoint_el;
+  document.getElementById("setPointState_az").innerHTML = data.setPointState_az;
+  document.getElementById("setPointState_el").innerHTML = data.setPointState_el;
+  document.getElementById("error_az").innerHTML = data.error_az;
+  document.getElementById("error_el").innerHTML = data.error_el;
+  document.getElementById("el_startAngle").innerHTML = data.el_startAngle;
+  document.getElementById("needs_unwind").innerHTML = data.needs_unwind;
+  document.getElementById("calMode").innerHTML = data.calMode;
+  document.getElementById("i2cErrorFlag_az").innerHTML = data.i2cErrorFlag_az;
+  document.getElementById("i2cErrorFlag_el").innerHTML = data.i2cErrorFlag_el;
+  document.getElementById("badAngleFlag").innerHTML = data.badAngleFlag;
+  document.getElementById("magnetFault").innerHTML = data.magnetFault;
+  document.getElementById("faultTripped").innerHTML = data.faultTripped;
+  document.getElementById("http_port").innerHTML = data.http_port;
+  document.getElementById("rotctl_port").innerHTML = data.rotctl_port;
+  document.getElementById("maxDualMotorAzSpeed").innerHTML = data.maxDualMotorAzSpeed;
+  document.getElementById("maxDualMotorElSpeed").innerHTML = data.maxDualMotorElSpeed;
+  document.getElementById("maxSingleMotorAzSpeed").innerHTML = data.maxSingleMotorAzSpeed;
+  document.getElementById("maxSingleMotorElSpeed").innerHTML = data.maxSingleMotorElSpeed;
+  document.getElementById("wifissid").innerHTML = data.wifissid;
+  document.getElementById("loginUser").innerHTML = data.loginUser;
+  document.getElementById("passwordStatus").innerHTML = data.passwordStatus;
+  document.getElementById("serialActive").innerHTML = data.serialActive;
+  document.getElementById("singleMotorModeText").innerHTML = data.singleMotorModeText;
+  document.getElementById("toleranceAz").innerHTML = data.toleranceAz;
+  document.getElementById("toleranceEl").innerHTML = data.toleranceEl;
+  document.getElementById("isAzMotorLatched").innerHTML = data.isAzMotorLatched;
+  document.getElementById("isElMotorLatched").innerHTML = data.isElMotorLatched;
+  document.getElementById("stellariumPollingOn").innerHTML = data.stellariumPollingOn;
+  document.getElementById("stellariumServerIPText").innerHTML = data.stellariumServerIPText;
+  document.getElementById("stellariumServerPortText").innerHTML = data.stellariumServerPortText;
+  document.getElementById("stellariumConnActive").innerHTML = data.stellariumConnActive;
+  document.getElementById("trackingOnText").innerHTML = data.trackingOnText;
+  document.getElementById("trackingState").innerHTML = data.trackingState;
+  document.getElementById("trackingSatName").innerHTML = data.trackingSatName;
+  document.getElementById("trackingTleEpoch").innerHTML = data.trackingTleEpoch;
+  document.getElementById("trackingAz").innerHTML = data.trackingAz;
+  document.getElementById("trackingEl").innerHTML = data.trackingEl;
+  document.getElementById("trackingRange").innerHTML = data.trackingRange;
+  document.getElementById("trackingPropUs").innerHTML = data.trackingPropUs;
+  document.getElementById("inputVoltage").innerHTML = data.inputVoltage;
+  document.getElementById("currentDraw").innerHTML = data.currentDraw;
+  document.getElementById("rotatorPowerDraw").innerHTML = data.rotatorPowerDraw;
+  document.getElementById('ip_addr').innerHTML = data.ip_addr;
+  document.getElementById('rotctl_client_ip').innerHTML = data.rotctl_client_ip;
+  document.getElementById('rotctl_clients').innerHTML = data.rotctl_clients;
+  document.getElementById('rotctl_latency').innerHTML = data.rotctl_latency;
+  updateLatencyHistogram(data.rotctl_latency_hist);
+  document.getElementById('bssid').innerHTML = data.bssid;
+  document.getElementById('wifi_channel').innerHTML = data.wifi_channel;
+
+  document.getElementById('rssi').innerHTML = data.rssi;
+  var level = data.level;
+  document.getElementById('bar1').classList.toggle('active', level >= 1);
+  document.getElementById('bar2').classList.toggle('active', level >= 2);
+  document.getElementById('bar3').classList.toggle('active', level >= 3);
+  document.getElementById('bar4').classList.toggle('active', level >= 4);
+
+  // Wind safety status updates
+  document.getElementById("windStowActive").innerHTML = data.windStowActive;
+  document.getElementById("windStowReason").innerHTML = data.windStowReason;
+  document.getElementById("windTrackingActive").innerHTML = data.windTrackingActive;
+  document.getElementById("windTrackingStatus").innerHTML = data.windTrackingStatus;
+  document.getElementById("windSafetyEnabled").innerHTML = data.windSafetyEnabled;
+  document.getElementById("windBasedHomeEnabled").innerHTML = data.windBasedHomeEnabled;
+  document.getElementById("windSpeedThreshold").innerHTML = data.windSpeedThreshold;
+  document.getElementById("windGustThreshold").innerHTML = data.windGustThreshold;
+  document.getElementById("emergencyStowActive").innerHTML = data.emergencyStowActive;
+  document.getElementById("stowDirection").innerHTML = data.stowDirection;
+  
+  document.getElementById("azOffset").innerHTML = data.azOffset;
+  document.getElementById("elOffset").innerHTML = data.elOffset;
 
-      // Update serial output disabled status
-      if (document.getElementById("serialOutputDisabled")) {
-        document.getElementById("serialOutputDisabled").innerHTML = data.serialOutputDisabled ? "True" : "False";
-      }
+  // Update wind safety checkboxes
+  var windSafetyCheckbox = document.getElementById("windSafetyToggle");
+  if (windSafetyCheckbox) {
+    windSafetyCheckbox.checked = (data.windSafetyEnabled === "ON");
+  }
 
-      // Update the checkbox state based on the current setting
-      var disableSerialOutputCheckbox = document.getElementById("disableSerialOutput");
-      if (disableSerialOutputCheckbox) {
-        disableSerialOutputCheckbox.checked = data.serialOutputDisabled;
-      }
+  var windBasedHomeCheckbox = document.getElementById("windBasedHomeToggle");
+  if (windBasedHomeCheckbox) {
+    windBasedHomeCheckbox.checked = (data.windBasedHomeEnabled === "ON");
+  }
 
-      document.getElementById("P_el").innerHTML = data.P_el;
-      document.getElementById("P_az").innerHTML = data.P_az;
-      document.getElementById("MIN_EL_SPEED").innerHTML = data.MIN_EL_SPEED;
-      document.getElementById("MIN_AZ_SPEED").innerHTML = data.MIN_AZ_SPEED;
-      document.getElementById("MIN_AZ_TOLERANCE").innerHTML = data.MIN_AZ_TOLERANCE;
-      document.getElementById("MIN_EL_TOLERANCE").innerHTML = data.MIN_EL_TOLERANCE;
-      document.getElementById("MAX_FAULT_POWER").innerHTML = data.MAX_FAULT_POWER;
-      document.getElementById("MIN_VOLTAGE_THRESHOLD").innerHTML = data.MIN_VOLTAGE_THRESHOLD;
-
-      var azimuth = data.correctedAngle_az; // Replace with actual AZ data from Arduino
-      var elevation = data.correctedAngle_el; // Replace with actual EL data from Arduino
-      var setpoint_az = data.setpoint_az; // Replace with actual Setpoint AZ
-      var setpoint_el = data.setpoint_el; // Replace with actual Setpoint EL
-      
-      
-      // Weather data updates
-      document.getElementById("weatherEnabled").innerHTML = data.weatherEnabled;
-      document.getElementById("weatherApiKeyConfigured").innerHTML = data.weatherApiKeyConfigured;
-      document.getElementById("weatherLocationConfigured").innerHTML = data.weatherLocationConfigured;
-      document.getElementById("weatherLatitude").innerHTML = data.weatherLatitude;
-      document.getElementById("weatherLongitude").innerHTML = data.weatherLongitude;
-      document.getElementById("weatherDataValid").innerHTML = data.weatherDataValid;
-      document.getElementById("weatherLastUpdate").innerHTML = data.weatherLastUpdate;
-      
-      // Update weather polling checkbox
-      var weatherCheckbox = document.getElementById("weatherPolling");
-      if (weatherCheckbox) {
-        weatherCheckbox.checked = (data.weatherEnabled === "ON");
-      }
-      
-      // Current weather conditions
-      document.getElementById("currentWindSpeed").innerHTML = data.currentWindSpeed;
-      document.getElementById("currentWindDirection").innerHTML = formatWindDirection(data.currentWindDirection);
-      document.getElementById("currentWindGust").innerHTML = data.currentWindGust;
-      document.getElementById("currentWeatherTime").innerHTML = formatWeatherTime(data.currentWeatherTime);
-      
-      // Forecast data
-      if (data.forecastWindSpeed && data.forecastWindSpeed.length >= 3) {
-        for (var i = 0; i < 3; i++) {
-          document.getElementById("forecastTime" + i).innerHTML = formatWeatherTime(data.forecastTimes[i]);
-          document.getElementById("forecastWindSpeed" + i).innerHTML = data.forecastWindSpeed[i];
-          document.getElementById("forecastWindDirection" + i).innerHTML = formatWindDirection(data.forecastWindDirection[i]);
-          document.getElementById("forecastWindGust" + i).innerHTML = data.forecastWindGust[i];
+  // Show/hide wind stow alert
+  var windStowAlert = document.getElementById("windStowAlert");
+  var windStowMessage = document.getElementById("windStowMessage");
+  if (data.emergencyStowActive === "YES") {
+    windStowMessage.innerHTML = "⚠️ EMERGENCY WIND STOW ACTIVE: " + data.windStowReason;
+    windStowAlert.style.display = "block";
+  } else {
+    windStowAlert.style.display = "none";
+  }
+
+  // Handle new log messages with browser-side rolling buffer
+  if (data.newLogMessages && data.newLogMessages.trim() !== "") {
+    // Split new messages into lines and add them
+    var newLines = data.newLogMessages.split('\n');
+    for (var i = 0; i < newLines.length; i++) {
+      if (newLines[i].trim() !== "") {
+        logLines.push(newLines[i]);
+
+        // Keep only the last MAX_LOG_LINES
+        if (logLines.length > MAX_LOG_LINES) {
+          logLines.shift(); // Remove oldest line
         }
       }
-      
-      // Weather error handling
-      var weatherErrorDiv = document.getElementById("weatherErrorDiv");
-      var weatherError = document.getElementById("weatherError");
-      if (data.weatherError && data.weatherError !== "") {
-        weatherError.innerHTML = "Error: " + data.weatherError;
-        weatherErrorDiv.style.display = "block";
-      } else {
-        weatherErrorDiv.style.display = "none";
-      }     
-      
-
-      // Redraw the skyplane and update the position of the circle
-      drawSkyplane();
-      drawPositions(azimuth, elevation, setpoint_az, setpoint_el);
-      
-      // Draw wind direction triangle (pass raw wind direction value)
-      drawWindDirection(data.currentWindDirection, data.weatherDataValid === "YES");
     }
-  };
-  xhr.send();
-}, 250);
+  }
+
+  updateLogDisplay();
+
+  // Update debug level if element exists
+  if (document.getElementById("currentDebugLevel")) {
+    document.getElementById("currentDebugLevel").innerHTML = data.currentDebugLevel;
+    updateDebugLevelDropdown(data.currentDebugLevel);
+  }
+
+  // Update serial output disabled status
+  if (document.getElementById("serialOutputDisabled")) {
+    document.getElementById("serialOutputDisabled").innerHTML = data.serialOutputDisabled ? "True" : "False";
+  }
+
+  // Update the checkbox state based on the current setting
+  var disableSerialOutputCheckbox = document.getElementById("disableSerialOutput");
+  if (disableSerialOutputCheckbox) {
+    disableSerialOutputCheckbox.checked = data.serialOutputDisabled;
+  }
+
+  document.getElementById("P_el").innerHTML = data.P_el;
+  document.getElementById("P_az").innerHTML = data.P_az;
+  document.getElementById("MIN_EL_SPEED").innerHTML = data.MIN_EL_SPEED;
+  document.getElementById("MIN_AZ_SPEED").innerHTML = data.MIN_AZ_SPEED;
+  document.getElementById("MIN_AZ_TOLERANCE").innerHTML = data.MIN_AZ_TOLERANCE;
+  document.getElementById("MIN_EL_TOLERANCE").innerHTML = data.MIN_EL_TOLERANCE;
+  document.getElementById("MAX_FAULT_POWER").innerHTML = data.MAX_FAULT_POWER;
+  document.getElementById("MIN_VOLTAGE_THRESHOLD").innerHTML = data.MIN_VOLTAGE_THRESHOLD;
+  document.getElementById("CONTROL_PERIOD_US").innerHTML = data.CONTROL_PERIOD_US;
+  document.getElementById("CONTROLLER_MODE").innerHTML = data.CONTROLLER_MODE;
+  document.getElementById("MOTION_PROFILE").innerHTML = data.MOTION_PROFILE;
+  document.getElementById("EVENT_INTERVAL_MS").innerHTML = data.EVENT_INTERVAL_MS;
+  document.getElementById("Ki_az").innerHTML = data.Ki_az;
+  document.getElementById("Kd_az").innerHTML = data.Kd_az;
+  document.getElementById("Kff_az").innerHTML = data.Kff_az;
+  document.getElementById("Ki_el").innerHTML = data.Ki_el;
+  document.getElementById("Kd_el").innerHTML = data.Kd_el;
+  document.getElementById("Kff_el").innerHTML = data.Kff_el;
+
+  var azimuth = data.correctedAngle_az; // Replace with actual AZ data from Arduino
+  var elevation = data.correctedAngle_el; // Replace with actual EL data from Arduino
+  var setpoint_az = data.setpoint_az; // Replace with actual Setpoint AZ
+  var setpoint_el = data.setpoint_el; // Replace with actual Setpoint EL
+  
+  
+  // Weather data updates
+  document.getElementById("weatherEnabled").innerHTML = data.weatherEnabled;
+  document.getElementById("weatherApiKeyConfigured").innerHTML = data.weatherApiKeyConfigured;
+  document.getElementById("weatherLocationConfigured").innerHTML = data.weatherLocationConfigured;
+  document.getElementById("weatherLatitude").innerHTML = data.weatherLatitude;
+  document.getElementById("weatherLongitude").innerHTML = data.weatherLongitude;
+  document.getElementById("weatherDataValid").innerHTML = data.weatherDataValid;
+  document.getElementById("weatherLastUpdate").innerHTML = data.weatherLastUpdate;
+  
+  // Update weather polling checkbox
+  var weatherCheckbox = document.getElementById("weatherPolling");
+  if (weatherCheckbox) {
+    weatherCheckbox.checked = (data.weatherEnabled === "ON");
+  }
+  
+  // Current weather conditions
+  document.getElementById("currentWindSpeed").innerHTML = data.currentWindSpeed;
+  document.getElementById("currentWindDirection").innerHTML = formatWindDirection(data.currentWindDirection);
+  document.getElementById("currentWindGust").innerHTML = data.currentWindGust;
+  document.getElementById("currentWeatherTime").innerHTML = formatWeatherTime(data.currentWeatherTime);
+  
+  // Forecast data, flattened to forecastWindSpeed0..2 and so on like the event stream sends it
+  if (data.weatherDataValid === "YES") {
+    for (var i = 0; i < 3; i++) {
+      document.getElementById("forecastTime" + i).innerHTML = formatWeatherTime(data["forecastTime" + i]);
+      document.getElementById("forecastWindSpeed" + i).innerHTML = data["forecastWindSpeed" + i];
+      document.getElementById("forecastWindDirection" + i).innerHTML = formatWindDirection(data["forecastWindDirection" + i]);
+      document.getElementById("forecastWindGust" + i).innerHTML = data["forecastWindGust" + i];
+    }
+  }
+  
+  // Weather error handling
+  var weatherErrorDiv = document.getElementById("weatherErrorDiv");
+  var weatherError = document.getElementById("weatherError");
+  if (data.weatherError && data.weatherError !== "") {
+    weatherError.innerHTML = "Error: " + data.weatherError;
+    weatherErrorDiv.style.display = "block";
+  } else {
+    weatherErrorDiv.style.display = "none";
+  }     
+  
+
+  // Redraw the skyplane and update the position of the circle
+  drawSkyplane();
+  drawPositions(azimuth, elevation, setpoint_az, setpoint_el);
+  
+  // Draw wind direction triangle (pass raw wind direction value)
+  drawWindDirection(data.currentWindDirection, data.weatherDataValid === "YES");
+}
 
 // Wind safety control functions
 function toggleWindSafety() {
@@ -552,6 +833,17 @@ function stellariumOn() {
   xhr.send();
 }
 
+function trackingOn() {
+  var switchState = document.getElementById("trackingOn").checked;
+  var xhr = new XMLHttpRequest();
+  if (switchState) {
+    xhr.open("GET", "/trackingOn", true);
+  } else {
+    xhr.open("GET", "/trackingOff", true);
+  }
+  xhr.send();
+}
+
 function updateVariable() {
   var azValue = parseFloat(document.getElementById("new_setpoint_az").value);
   var elValue = parseFloat(document.getElementById("new_setpoint_el").value);
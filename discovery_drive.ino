@@ -25,7 +25,15 @@
 #include "weather_poller.h"
 #include "serial_manager.h"
 #include "rotctl_wifi.h"
+#include "udp_control.h"
+#include "satellite_tracker.h"
+#include "plant_simulator.h"
 #include "logger.h"
+#include "log_file.h"
+
+// Uncomment to run the firmware against a simulated dish instead of the motors, hall
+// sensors and INA219 (bench testing of control changes without hardware)
+// #define SIMULATED_PLANT
 
 #if CONFIG_FREERTOS_UNICORE
 #define ARDUINO_RUNNING_CORE 0
@@ -42,6 +50,7 @@ const int _SERIAL_BAUD = 19200;
 Preferences preferences;
 
 Logger logger(preferences);
+LogFile logFile(preferences, logger);
 WiFiManager wifiManager(preferences, logger);  // Pass preferences to constructor
 INA219Manager ina219Manager(logger);
 MotorSensorController motorSensorCtrl(preferences, ina219Manager, logger);
@@ -49,28 +58,39 @@ SerialManager serialManager(preferences, motorSensorCtrl, logger);
 StellariumPoller stellariumPoller(preferences, motorSensorCtrl, logger);
 WeatherPoller weatherPoller(preferences, logger);
 RotctlWifi rotctlWifi(preferences, motorSensorCtrl, logger);
-WebServerManager webServerManager(preferences, motorSensorCtrl, ina219Manager, stellariumPoller, weatherPoller, serialManager, wifiManager, rotctlWifi, logger);
+UdpControl udpControl(preferences, motorSensorCtrl, ina219Manager, logger);
+SatelliteTracker satelliteTracker(preferences, motorSensorCtrl, weatherPoller, logger);
+#ifdef SIMULATED_PLANT
+PlantSimulator plantSimulator;
+#endif
+WebServerManager webServerManager(preferences, motorSensorCtrl, ina219Manager, stellariumPoller, weatherPoller, serialManager, wifiManager, rotctlWifi, udpControl, satelliteTracker, logFile, logger);
 
 void SafetyMonitor ( void *pvParameters );
 void ReadPowerSensor( void *pvParameters );
-void HandleWebRequests( void *pvParameters );
+void PushWebEvents( void *pvParameters );
 void ReadWiFi( void *pvParameters );
+void HandleUdpControl( void *pvParameters );
 void PollStellarium( void *pvParameters );
 void PollWeather( void *pvParameters );
+void TrackSatellite( void *pvParameters );
 void ProcessSerial( void *pvParameters );
 void ControlMotors( void *pvParameters );
+void ReadHallSensors( void *pvParameters );
+void DrainLog( void *pvParameters );
+void WriteLogFile( void *pvParameters );
+String getNetworkControllerIP();
 
 // The setup function runs once when you press reset or power on the board.
 void setup() {
 
   // Setup Preferences
   if (!preferences.begin("dd", false)) {
-    logger.error("Failed to initialize preferences");
+    LOGE(logger, "Failed to initialize preferences");
   }
 
   // Initialize LittleFS for images and HTML file
   if (!LittleFS.begin(true)) {
-    logger.error("Failed to mount LittleFS");
+    LOGE(logger, "Failed to mount LittleFS");
     return;
   }
 
@@ -84,12 +104,43 @@ void setup() {
 
   // Init logger
   logger.begin();
+
+  // Serial log output is formatted by its own task so logging never blocks the caller.
+  // Created first so the other tasks and WiFi events all log into the ring.
+  TaskHandle_t logDrainTask = NULL;
+  xTaskCreatePinnedToCore(
+    DrainLog
+    ,  "Log Drain"
+    ,  4096
+    ,  NULL
+    ,  1  // Priority
+    ,  &logDrainTask
+    ,  1);
+  logger.attachDrainTask(logDrainTask);
+
+  // Flash writes happen only in this task; everything else just fills the logger's ring
+  logFile.begin();
+  xTaskCreatePinnedToCore(
+    WriteLogFile
+    ,  "Log File"
+    ,  4096
+    ,  NULL
+    ,  1  // Priority
+    ,  NULL
+    ,  1);
+#ifdef SIMULATED_PLANT
+  // Attach before the motor controller and INA219 start talking to hardware
+  motorSensorCtrl.setPlantSimulator(&plantSimulator);
+  ina219Manager.setPlantSimulator(&plantSimulator);
+#endif
   // Initialize the serial connection
   serialManager.begin();
   // Begin and connect to WiFi
   wifiManager.begin();
   // Initialize rotctl server
   rotctlWifi.begin();
+  // Initialize binary UDP control
+  udpControl.begin();
   // Begin web server
   webServerManager.begin();
   // Initialize motor controller and home
@@ -98,16 +149,20 @@ void setup() {
   ina219Manager.begin();
   // Initialize weather poller
   weatherPoller.begin();
+  // Initialize satellite tracker (uses the weather station location)
+  satelliteTracker.begin();
 
   // IMPORTANT: Set up the cross-reference between weather poller and motor controller
   // This enables wind safety features
   motorSensorCtrl.setWeatherPoller(&weatherPoller);
-  logger.info("Wind safety integration enabled");
+  LOGI(logger, "Wind safety integration enabled");
 
+  // The web server runs its own tasks, started by webServerManager.begin(); this one only
+  // paces the /events frames
   xTaskCreatePinnedToCore(
-    HandleWebRequests
-    ,  "Web Server Task"
-    ,  20480  // Stack size may need adjustment
+    PushWebEvents
+    ,  "Web Events"
+    ,  2048
     ,  NULL
     ,  1  // Priority (lower than LWIP tasks)
     ,  NULL
@@ -132,6 +187,15 @@ void setup() {
     ,  NULL // Task handle is not used here - simply pass NULL
     ,  1);
 
+  xTaskCreatePinnedToCore(
+    HandleUdpControl
+    ,  "UDP Control"
+    ,  4096
+    ,  NULL
+    ,  1  // Priority
+    ,  NULL
+    ,  1);
+
   xTaskCreatePinnedToCore(
     PollStellarium
     ,  "Read Stellarium API" // A name just for humans
@@ -150,6 +214,15 @@ void setup() {
     ,  NULL // Task handle is not used here - simply pass NULL
     ,  1); // Run on core 0 (network polling is not timing critical)
 
+  xTaskCreatePinnedToCore(
+    TrackSatellite
+    ,  "Track Satellite" // A name just for humans
+    ,  8192        // SGP4 runs in double precision; leave room for the soft-float call chain
+    ,  NULL // Task parameter which can modify the task behavior. This must be passed as pointer to void.
+    ,  1  // Priority
+    ,  NULL // Task handle is not used here - simply pass NULL
+    ,  1); // One propagation per second, interpolated by the control loop
+
   xTaskCreatePinnedToCore(
     ProcessSerial
     ,  "Process Serial Input" // A name just for humans
@@ -168,6 +241,15 @@ void setup() {
     ,  NULL
     ,  0); // Run on core 1
 
+  xTaskCreatePinnedToCore(
+    ReadHallSensors
+    ,  "Read Hall Sensors"
+    ,  4096
+    ,  NULL
+    ,  2  // Same priority as the control loop it feeds
+    ,  NULL
+    ,  1);
+
   xTaskCreatePinnedToCore(
     ControlMotors
     ,  "Read ADC and Control motors" // A name just for humans
@@ -208,36 +290,66 @@ void SafetyMonitor(void *pvParameters) {
   }
 }
 
-void HandleWebRequests(void *pvParameters) {
+// Print new log records over serial; woken by each log call, with a timeout as a backstop
+void DrainLog(void *pvParameters) {
+  for(;;) {
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+    logger.drainToSerial();
+  }
+}
+
+// Batch log records to LittleFS; the log file decides when a batch is due for flash
+void WriteLogFile(void *pvParameters) {
   TickType_t xLastWakeTime = xTaskGetTickCount();
-  const TickType_t xFrequency = 100 / portTICK_PERIOD_MS;
+  const TickType_t xFrequency = pdMS_TO_TICKS(1000);
   for(;;) {
-    webServerManager.server->handleClient();
+    logFile.runLogFileLoop();
     vTaskDelayUntil(&xLastWakeTime, xFrequency);
   }
 }
 
+void PushWebEvents(void *pvParameters) {
+  for(;;) {
+    webServerManager.pushEvents();
+    vTaskDelay(pdMS_TO_TICKS(webServerManager.getEventIntervalMs()));
+  }
+}
+
 void ControlMotors(void *pvParameters){
   TickType_t xLastWakeTime = xTaskGetTickCount();
-  const TickType_t xFrequency = 25 / portTICK_PERIOD_MS;
+  const TickType_t xFrequency = (MotorSensorController::LEGACY_CONTROL_PERIOD_US / 1000) / portTICK_PERIOD_MS;
+  motorSensorCtrl.attachControlTask(xTaskGetCurrentTaskHandle());
   for(;;)
   {
     motorSensorCtrl.runControlLoop();
+    if (motorSensorCtrl.isHighRateControl()) {
+      // Paced by the control timer; the timeout keeps the loop alive if notifications stop
+      ulTaskNotifyTake(pdTRUE, xFrequency);
+      xLastWakeTime = xTaskGetTickCount();
+    } else {
+      vTaskDelayUntil(&xLastWakeTime, xFrequency);
+    }
+  }
+}
+
+// Continuously sample both hall sensors so the control loop never waits on I2C
+void ReadHallSensors(void *pvParameters){
+  TickType_t xLastWakeTime = xTaskGetTickCount();
+  const TickType_t xFrequency = 2 / portTICK_PERIOD_MS;
+  for(;;)
+  {
+    motorSensorCtrl.runSensorLoop();
     vTaskDelayUntil(&xLastWakeTime, xFrequency);
   }
 }
 
+// Woken by the serial driver's RX event; the timeout keeps replies draining and serialActive current
 void ProcessSerial(void *pvParameters){
-
-  TickType_t xLastWakeTime = xTaskGetTickCount();
-  TickType_t xFrequency;
+  serialManager.attachSerialTask(xTaskGetCurrentTaskHandle());
 
   for(;;)
   {
-    serialManager.runSerialLoop();
-    xFrequency = serialManager.serialActive ? 
-            pdMS_TO_TICKS(100) : pdMS_TO_TICKS(1000);
-    vTaskDelayUntil(&xLastWakeTime, xFrequency);
+    ulTaskNotifyTake(pdTRUE, serialManager.runSerialLoop());
   }
 }
 
@@ -248,7 +360,7 @@ void PollStellarium(void *pvParameters){
 
   for(;;)
   {
-    stellariumPoller.runStellariumLoop(serialManager.serialActive, rotctlWifi.getRotctlClientIP(), wifiManager.wifiConnected);
+    stellariumPoller.runStellariumLoop(serialManager.serialActive, getNetworkControllerIP(), wifiManager.wifiConnected);
     xFrequency = stellariumPoller.getStellariumOn() ? 
             pdMS_TO_TICKS(250) : pdMS_TO_TICKS(1000);
     vTaskDelayUntil(&xLastWakeTime, xFrequency);
@@ -280,20 +392,44 @@ void PollWeather(void *pvParameters){
   }
 }
 
+// Propagate the uploaded TLE and stream look angles to the motor controller
+void TrackSatellite(void *pvParameters){
+  TickType_t xLastWakeTime = xTaskGetTickCount();
+  const TickType_t xFrequency = pdMS_TO_TICKS(1000);
+
+  for(;;)
+  {
+    satelliteTracker.runTrackingLoop(serialManager.serialActive, getNetworkControllerIP(), stellariumPoller.getStellariumOn());
+    vTaskDelayUntil(&xLastWakeTime, xFrequency);
+  }
+}
+
 // ROTCTL Protcol: https://manpages.ubuntu.com/manpages/xenial/man8/rotctld.8.html
 void ReadWiFi(void *pvParameters){
+  for(;;)
+  {
+    // Blocks in select() until a rotctl socket is readable, so no delay is needed here
+    rotctlWifi.rotctlWifiLoop(serialManager.serialActive, stellariumPoller.getStellariumOn(), udpControl.isControlling());
+  }
+}
 
-  TickType_t xLastWakeTime = xTaskGetTickCount();
-  TickType_t xFrequency;
-
+// Binary setpoint/telemetry protocol for high-rate tracking experiments
+void HandleUdpControl(void *pvParameters){
   for(;;)
   {
-  rotctlWifi.rotctlWifiLoop(serialManager.serialActive, stellariumPoller.getStellariumOn());
-  xFrequency = rotctlWifi.isRotctlConnected() ? 
-          pdMS_TO_TICKS(10) : pdMS_TO_TICKS(1000);
-  vTaskDelayUntil(&xLastWakeTime, xFrequency);
-  // ------------------------------------------------------------------------
+    // Blocks in select() until a datagram arrives; a rotctl controller takes precedence
+    bool motionAllowed = !serialManager.serialActive && !stellariumPoller.getStellariumOn() &&
+                         rotctlWifi.getRotctlClientIP() == "NO ROTCTL CONNECTION";
+    udpControl.runUdpControlLoop(motionAllowed);
+  }
+}
+
+// Stellarium polling and satellite tracking pause while either network client controls
+String getNetworkControllerIP() {
+  if (udpControl.isControlling()) {
+    return udpControl.getControllerIP();
   }
+  return rotctlWifi.getRotctlClientIP();
 }
 
 // Does nothing
@@ -0,0 +1,278 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Event Stream - Server-Sent Events channel pushing changed UI fields to browsers.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "event_stream.h"
+
+// =============================================================================
+// CLIENT MANAGEMENT
+// =============================================================================
+
+bool EventStream::addClient(httpd_handle_t server, int fd) {
+    _server = server;
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        if (!_clients[i].active) {
+            _clients[i].fd = fd;
+            _clients[i].active = true;
+            _clients[i].needsFull = true;
+
+            // The response header is written by hand because the connection outlives the request
+            _length = 0;
+            _targets = 1 << i;
+            append("HTTP/1.1 200 OK\r\n"
+                   "Content-Type: text/event-stream\r\n"
+                   "Cache-Control: no-cache\r\n"
+                   "Connection: keep-alive\r\n\r\n");
+            char retry[24];
+            snprintf(retry, sizeof(retry), "retry: %lu\n\n", (unsigned long)RETRY_MS);
+            append(retry);
+            flush();
+            return _clients[i].active;
+        }
+    }
+    return false;
+}
+
+void EventStream::removeClient(int fd) {
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        if (_clients[i].active && _clients[i].fd == fd) {
+            _clients[i].fd = -1;
+            _clients[i].active = false;
+            _clients[i].needsFull = false;
+            _targets &= ~(1 << i);
+        }
+    }
+}
+
+int EventStream::getClientCount() const {
+    int count = 0;
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        if (_clients[i].active) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void EventStream::dropClient(int index) {
+    // The server closes the socket after the current request or work item
+    int fd = _clients[index].fd;
+    removeClient(fd);
+    httpd_sess_trigger_close(_server, fd);
+}
+
+// =============================================================================
+// FRAME BUILDING
+// =============================================================================
+
+void EventStream::beginFrame() {
+    _cursor = 0;
+}
+
+void EventStream::setField(const char* key, const char* value) {
+    if (_cursor >= MAX_FIELDS) {
+        return;
+    }
+
+    // Fields are matched by position; a different key in a slot resets its history
+    Field& field = _fields[_cursor];
+    if (_cursor >= _fieldCount || field.key != key) {
+        field.key = key;
+        field.sentValid = false;
+    }
+    strlcpy(field.value, value, VALUE_SIZE);
+    _cursor++;
+}
+
+void EventStream::setField(const char* key, const String& value) {
+    setField(key, value.c_str());
+}
+
+void EventStream::setField(const char* key, float value, int decimals) {
+    // Same text as String(float, decimals) so values match /variable
+    char text[24];
+    snprintf(text, sizeof(text), "%.*f", decimals, value);
+    setField(key, text);
+}
+
+void EventStream::setField(const char* key, int value) {
+    char text[16];
+    snprintf(text, sizeof(text), "%d", value);
+    setField(key, text);
+}
+
+void EventStream::endFrame() {
+    _fieldCount = _cursor;
+
+    // Clients that just joined get every field once
+    uint8_t joined = 0;
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        if (_clients[i].active && _clients[i].needsFull) {
+            joined |= 1 << i;
+            _clients[i].needsFull = false;
+        }
+    }
+    if (joined != 0) {
+        _targets = joined;
+        writeFrame(true);
+    }
+
+    // Everyone else only hears about what changed
+    _targets = 0;
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        if (_clients[i].active && !(joined & (1 << i))) {
+            _targets |= 1 << i;
+        }
+    }
+
+    bool changed = false;
+    for (int i = 0; i < _fieldCount; i++) {
+        if (!_fields[i].sentValid || strcmp(_fields[i].value, _fields[i].sent) != 0) {
+            changed = true;
+            break;
+        }
+    }
+
+    if (changed) {
+        writeFrame(false);
+    } else {
+        uint32_t now = millis();
+        uint8_t idle = 0;
+        for (int i = 0; i < MAX_CLIENTS; i++) {
+            if ((_targets & (1 << i)) && now - _clients[i].lastWriteMs >= KEEPALIVE_MS) {
+                idle |= 1 << i;
+            }
+        }
+        if (idle != 0) {
+            _targets = idle;
+            append(": keepalive\n\n");
+            flush();
+        }
+    }
+
+    for (int i = 0; i < _fieldCount; i++) {
+        memcpy(_fields[i].sent, _fields[i].value, VALUE_SIZE);
+        _fields[i].sentValid = true;
+    }
+}
+
+void EventStream::sendLog(const String& text) {
+    _targets = 0;
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        if (_clients[i].active) {
+            _targets |= 1 << i;
+        }
+    }
+    if (_targets == 0) {
+        return;
+    }
+
+    append("event: log\n");
+    const char* line = text.c_str();
+    while (*line != '\0') {
+        const char* end = strchr(line, '\n');
+        size_t length = (end != nullptr) ? (size_t)(end - line) : strlen(line);
+        if (length > 0) {
+            append("data: ");
+            append(line, length);
+            append("\n");
+        }
+        line += length;
+        if (*line == '\n') {
+            line++;
+        }
+    }
+    append("\n");
+    flush();
+}
+
+// =============================================================================
+// HELPER METHODS
+// =============================================================================
+
+void EventStream::writeFrame(bool full) {
+    append("data: {");
+    bool first = true;
+    for (int i = 0; i < _fieldCount; i++) {
+        const Field& field = _fields[i];
+        if (!full && field.sentValid && strcmp(field.value, field.sent) == 0) {
+            continue;
+        }
+        if (!first) {
+            append(",");
+        }
+        first = false;
+        appendJsonString(field.key);
+        append(":");
+        appendJsonString(field.value);
+    }
+    append("}\n\n");
+    flush();
+}
+
+void EventStream::appendJsonString(const char* text) {
+    append("\"");
+    for (const char* c = text; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') {
+            char escaped[2] = { '\\', *c };
+            append(escaped, 2);
+        } else if ((unsigned char)*c < 0x20) {
+            append(" ");
+        } else {
+            append(c, 1);
+        }
+    }
+    append("\"");
+}
+
+void EventStream::append(const char* text) {
+    append(text, strlen(text));
+}
+
+void EventStream::append(const char* data, size_t length) {
+    while (length > 0) {
+        size_t chunk = min(length, BUFFER_SIZE - _length);
+        memcpy(_buffer + _length, data, chunk);
+        _length += chunk;
+        data += chunk;
+        length -= chunk;
+        if (_length == BUFFER_SIZE) {
+            flush();
+        }
+    }
+}
+
+void EventStream::flush() {
+    if (_length == 0) {
+        return;
+    }
+
+    uint32_t now = millis();
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        if (!(_targets & (1 << i))) {
+            continue;
+        }
+        Client& slot = _clients[i];
+        // A short write means the peer is gone or stalled; either way stop feeding it
+        if (httpd_socket_send(_server, slot.fd, _buffer, _length, 0) != (int)_length) {
+            dropClient(i);
+            continue;
+        }
+        slot.lastWriteMs = now;
+    }
+    _length = 0;
+}
@@ -0,0 +1,93 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Event Stream - Server-Sent Events channel pushing changed UI fields to browsers.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EVENT_STREAM_H
+#define EVENT_STREAM_H
+
+// System includes
+#include <Arduino.h>
+#include <esp_http_server.h>
+
+// Holds the open /events connections and the last value sent for each field. Every frame
+// the caller sets all fields in the same order; endFrame() sends a full JSON object to
+// clients that just joined and only the changed fields to everyone else. Clients are
+// sockets of the ESP-IDF HTTP server, written directly once their request is handled. Not
+// thread safe: all calls must come from the server task.
+class EventStream {
+public:
+    static constexpr int MAX_CLIENTS = 4;
+
+    // Client management
+    bool addClient(httpd_handle_t server, int fd);
+    void removeClient(int fd);      // The server closed the socket
+    int getClientCount() const;
+
+    // Frame building; keys must be string literals, values are sent as JSON strings
+    void beginFrame();
+    void setField(const char* key, const char* value);
+    void setField(const char* key, const String& value);
+    void setField(const char* key, float value, int decimals = 2);
+    void setField(const char* key, int value);
+    void endFrame();
+
+    // Log text goes out as a separate "log" event, one data line per log line
+    void sendLog(const String& text);
+
+private:
+    static constexpr int MAX_FIELDS = 80;
+    static constexpr size_t VALUE_SIZE = 64;
+    static constexpr size_t BUFFER_SIZE = 1024;
+    static constexpr uint32_t KEEPALIVE_MS = 15000;   // Comment line so dead peers get noticed
+    static constexpr uint32_t RETRY_MS = 3000;        // Browser reconnect delay
+
+    struct Field {
+        const char* key = nullptr;
+        char value[VALUE_SIZE] = "";
+        char sent[VALUE_SIZE] = "";
+        bool sentValid = false;
+    };
+
+    struct Client {
+        int fd = -1;
+        bool active = false;
+        bool needsFull = false;
+        uint32_t lastWriteMs = 0;
+    };
+
+    Field _fields[MAX_FIELDS];
+    int _fieldCount = 0;
+    int _cursor = 0;
+
+    httpd_handle_t _server = nullptr;
+    Client _clients[MAX_CLIENTS];
+
+    // Output buffer and the clients it is flushed to
+    char _buffer[BUFFER_SIZE];
+    size_t _length = 0;
+    uint8_t _targets = 0;
+
+    // Helper methods
+    void writeFrame(bool full);
+    void append(const char* data, size_t length);
+    void append(const char* text);
+    void appendJsonString(const char* text);
+    void flush();
+    void dropClient(int index);
+};
+
+#endif // EVENT_STREAM_H
@@ -0,0 +1,431 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Host HAL - Arduino core, clock, GPIO and console for the host build.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "host_hal.h"
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+
+HardwareSerial Serial;
+EspClass ESP;
+
+namespace {
+
+// =============================================================================
+// CLOCK
+// =============================================================================
+
+// The virtual clock starts at 1 s so that "0 means never" timestamps in the firmware stay distinct
+constexpr uint64_t VIRTUAL_EPOCH_MICROS = 1000000;
+
+const std::chrono::steady_clock::time_point g_realEpoch = std::chrono::steady_clock::now();
+std::atomic<bool> g_virtualClock{false};
+std::atomic<uint64_t> g_virtualMicros{VIRTUAL_EPOCH_MICROS};
+
+uint64_t realMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - g_realEpoch).count();
+}
+
+// =============================================================================
+// GPIO AND CONSOLE STATE
+// =============================================================================
+
+std::mutex g_pinMutex;
+std::map<int, int> g_pinValues;
+HostHal::PinWriter g_pinWriter;
+
+std::mutex g_serialMutex;
+std::deque<uint8_t> g_serialRx;
+std::string g_serialTx;
+std::function<void(void)> g_serialRxCallback;
+bool g_serialEcho = false;
+int g_serialTxSpace = 256;  // USB CDC TX FIFO; writes fill it until setSerialTxSpace() frees it
+
+void writePin(int pin, int value, bool analog) {
+    HostHal::PinWriter writer;
+    {
+        std::lock_guard<std::mutex> lock(g_pinMutex);
+        g_pinValues[pin] = value;
+        writer = g_pinWriter;
+    }
+    if (writer) {
+        writer(pin, value, analog);
+    }
+}
+
+} // namespace
+
+// =============================================================================
+// SIMULATION CONTROLS
+// =============================================================================
+
+namespace HostHal {
+
+void useVirtualClock(bool enabled) {
+    g_virtualClock = enabled;
+}
+
+bool isVirtualClock() {
+    return g_virtualClock;
+}
+
+uint64_t nowMicros() {
+    return g_virtualClock ? g_virtualMicros.load() : realMicros();
+}
+
+void advanceMicros(uint64_t micros) {
+    g_virtualMicros += micros;
+}
+
+void setPinWriter(PinWriter writer) {
+    std::lock_guard<std::mutex> lock(g_pinMutex);
+    g_pinWriter = writer;
+}
+
+int getPinValue(int pin) {
+    std::lock_guard<std::mutex> lock(g_pinMutex);
+    auto it = g_pinValues.find(pin);
+    return it == g_pinValues.end() ? 0 : it->second;
+}
+
+void injectSerial(const char* data, size_t length) {
+    std::function<void(void)> callback;
+    {
+        std::lock_guard<std::mutex> lock(g_serialMutex);
+        g_serialRx.insert(g_serialRx.end(), data, data + length);
+        callback = g_serialRxCallback;
+    }
+    if (callback) {
+        callback();
+    }
+}
+
+std::string takeSerialOutput() {
+    std::lock_guard<std::mutex> lock(g_serialMutex);
+    std::string output;
+    output.swap(g_serialTx);
+    return output;
+}
+
+void setSerialEcho(bool echo) {
+    std::lock_guard<std::mutex> lock(g_serialMutex);
+    g_serialEcho = echo;
+}
+
+void setSerialTxSpace(int bytes) {
+    std::lock_guard<std::mutex> lock(g_serialMutex);
+    g_serialTxSpace = bytes;
+}
+
+}
+
+// =============================================================================
+// TIME
+// =============================================================================
+
+unsigned long millis() {
+    return (unsigned long)(HostHal::nowMicros() / 1000);
+}
+
+unsigned long micros() {
+    return (unsigned long)HostHal::nowMicros();
+}
+
+void delay(unsigned long ms) {
+    if (g_virtualClock) {
+        HostHal::advanceMicros((uint64_t)ms * 1000);
+    } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    }
+}
+
+void delayMicroseconds(unsigned int us) {
+    if (g_virtualClock) {
+        HostHal::advanceMicros(us);
+        return;
+    }
+    // Busy-wait like the core does; sleeping overshoots short delays
+    uint64_t end = realMicros() + us;
+    while (realMicros() < end) {
+    }
+}
+
+// =============================================================================
+// GPIO AND SYSTEM
+// =============================================================================
+
+void pinMode(int pin, int mode) {
+    (void)pin;
+    (void)mode;
+}
+
+void digitalWrite(int pin, int value) {
+    writePin(pin, value, false);
+}
+
+int digitalRead(int pin) {
+    return HostHal::getPinValue(pin);
+}
+
+void analogWrite(int pin, int value) {
+    writePin(pin, value, true);
+}
+
+void analogWriteFrequency(int pin, int frequency) {
+    (void)pin;
+    (void)frequency;
+}
+
+long random(long max) {
+    return max <= 0 ? 0 : (long)(esp_random() % (uint32_t)max);
+}
+
+long random(long min, long max) {
+    return max <= min ? min : min + random(max - min);
+}
+
+uint32_t esp_random() {
+    static std::mt19937 generator(12345);
+    static std::mutex generatorMutex;
+    std::lock_guard<std::mutex> lock(generatorMutex);
+    return generator();
+}
+
+void configTime(long gmtOffset, int daylightOffset, const char* server1, const char* server2, const char* server3) {
+    (void)gmtOffset;
+    (void)daylightOffset;
+    (void)server1;
+    (void)server2;
+    (void)server3;
+}
+
+#if defined(__GLIBC__) && !__GLIBC_PREREQ(2, 38)
+size_t strlcpy(char* dst, const char* src, size_t size) {
+    size_t length = strlen(src);
+    if (size > 0) {
+        size_t copy = length < size - 1 ? length : size - 1;
+        memcpy(dst, src, copy);
+        dst[copy] = '\0';
+    }
+    return length;
+}
+#endif
+
+void EspClass::restart() {
+    fprintf(stderr, "ESP.restart() called\n");
+    exit(1);
+}
+
+uint32_t EspClass::getCycleCount() {
+    // 240 MHz worth of cycles from the wall clock, so cycle-based timing keeps its units
+    return (uint32_t)(realMicros() * getCpuFreqMHz());
+}
+
+// =============================================================================
+// STRING
+// =============================================================================
+
+std::string String::formatInteger(long long value, unsigned char base) {
+    if (base == DEC || value >= 0) {
+        return base == DEC ? std::to_string(value) : formatUnsigned((unsigned long long)value, base);
+    }
+    return "-" + formatUnsigned((unsigned long long)(-value), base);
+}
+
+std::string String::formatUnsigned(unsigned long long value, unsigned char base) {
+    if (base < 2 || base > 36) {
+        base = DEC;
+    }
+    std::string digits;
+    do {
+        int digit = (int)(value % base);
+        digits.insert(digits.begin(), (char)(digit < 10 ? '0' + digit : 'a' + digit - 10));
+        value /= base;
+    } while (value != 0);
+    return digits;
+}
+
+std::string String::formatFloat(double value, unsigned int decimals) {
+    if (std::isnan(value)) {
+        return "nan";
+    }
+    if (std::isinf(value)) {
+        return value > 0 ? "inf" : "-inf";
+    }
+    char text[64];
+    snprintf(text, sizeof(text), "%.*f", (int)decimals, value);
+    return text;
+}
+
+bool String::equalsIgnoreCase(const String& other) const {
+    if (_s.size() != other._s.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < _s.size(); i++) {
+        if (tolower((unsigned char)_s[i]) != tolower((unsigned char)other._s[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool String::endsWith(const String& suffix) const {
+    return _s.size() >= suffix._s.size() &&
+           _s.compare(_s.size() - suffix._s.size(), suffix._s.size(), suffix._s) == 0;
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+    if (from > to) {
+        std::swap(from, to);
+    }
+    if (from >= _s.size()) {
+        return String();
+    }
+    return String(_s.substr(from, min((size_t)to, _s.size()) - from));
+}
+
+void String::trim() {
+    size_t start = 0;
+    while (start < _s.size() && isspace((unsigned char)_s[start])) {
+        start++;
+    }
+    size_t end = _s.size();
+    while (end > start && isspace((unsigned char)_s[end - 1])) {
+        end--;
+    }
+    _s = _s.substr(start, end - start);
+}
+
+void String::toLowerCase() {
+    for (char& c : _s) {
+        c = (char)tolower((unsigned char)c);
+    }
+}
+
+void String::toUpperCase() {
+    for (char& c : _s) {
+        c = (char)toupper((unsigned char)c);
+    }
+}
+
+void String::replace(const String& from, const String& to) {
+    if (from._s.empty()) {
+        return;
+    }
+    size_t pos = 0;
+    while ((pos = _s.find(from._s, pos)) != std::string::npos) {
+        _s.replace(pos, from._s.size(), to._s);
+        pos += to._s.size();
+    }
+}
+
+void String::toCharArray(char* buffer, unsigned int size) const {
+    if (size == 0) {
+        return;
+    }
+    size_t copy = min((size_t)size - 1, _s.size());
+    memcpy(buffer, _s.data(), copy);
+    buffer[copy] = '\0';
+}
+
+// =============================================================================
+// PRINT, STREAM AND SERIAL
+// =============================================================================
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t written = 0;
+    while (written < size && write(buffer[written])) {
+        written++;
+    }
+    return written;
+}
+
+size_t Print::printf(const char* format, ...) {
+    char text[256];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    if (length < 0) {
+        return 0;
+    }
+    return write((const uint8_t*)text, min((size_t)length, sizeof(text) - 1));
+}
+
+size_t Stream::readBytes(uint8_t* buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+        int c = read();
+        if (c < 0) {
+            break;
+        }
+        buffer[count++] = (uint8_t)c;
+    }
+    return count;
+}
+
+void HardwareSerial::onReceive(std::function<void(void)> callback, bool onlyOnTimeout) {
+    (void)onlyOnTimeout;
+    std::lock_guard<std::mutex> lock(g_serialMutex);
+    g_serialRxCallback = callback;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    std::lock_guard<std::mutex> lock(g_serialMutex);
+    g_serialTx.append((const char*)buffer, size);
+    g_serialTxSpace = std::max(0, g_serialTxSpace - (int)size);
+    if (g_serialEcho) {
+        fwrite(buffer, 1, size, stdout);
+    }
+    return size;
+}
+
+int HardwareSerial::availableForWrite() {
+    std::lock_guard<std::mutex> lock(g_serialMutex);
+    return g_serialTxSpace;
+}
+
+int HardwareSerial::available() {
+    std::lock_guard<std::mutex> lock(g_serialMutex);
+    return (int)g_serialRx.size();
+}
+
+int HardwareSerial::read() {
+    std::lock_guard<std::mutex> lock(g_serialMutex);
+    if (g_serialRx.empty()) {
+        return -1;
+    }
+    uint8_t c = g_serialRx.front();
+    g_serialRx.pop_front();
+    return c;
+}
+
+int HardwareSerial::peek() {
+    std::lock_guard<std::mutex> lock(g_serialMutex);
+    return g_serialRx.empty() ? -1 : g_serialRx.front();
+}
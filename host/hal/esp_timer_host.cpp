@@ -0,0 +1,108 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Host HAL - esp_timer periodic callbacks, dispatched from a host thread in real time.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <esp_timer.h>
+
+#include "host_hal.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+struct HostEspTimer {
+    esp_timer_create_args_t args;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::thread thread;
+    uint64_t periodUs = 0;
+    bool running = false;
+    bool deleted = false;
+};
+
+namespace {
+
+void runTimer(HostEspTimer* timer) {
+    std::unique_lock<std::mutex> lock(timer->mutex);
+    auto next = std::chrono::steady_clock::now();
+    while (!timer->deleted) {
+        if (!timer->running) {
+            timer->changed.wait(lock);
+            next = std::chrono::steady_clock::now() + std::chrono::microseconds(timer->periodUs);
+            continue;
+        }
+        if (timer->changed.wait_until(lock, next) == std::cv_status::timeout && timer->running) {
+            // Fixed-rate like the ESP-IDF timer; the callback runs without the lock held
+            next += std::chrono::microseconds(timer->periodUs);
+            lock.unlock();
+            timer->args.callback(timer->args.arg);
+            lock.lock();
+        }
+    }
+}
+
+} // namespace
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* handle) {
+    if (args == nullptr || args->callback == nullptr || handle == nullptr) {
+        return ESP_FAIL;
+    }
+    HostEspTimer* timer = new HostEspTimer();
+    timer->args = *args;
+    timer->thread = std::thread(runTimer, timer);
+    *handle = timer;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t periodUs) {
+    std::lock_guard<std::mutex> lock(timer->mutex);
+    if (timer->running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->periodUs = periodUs;
+    timer->running = true;
+    timer->changed.notify_all();
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+    std::lock_guard<std::mutex> lock(timer->mutex);
+    if (!timer->running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->running = false;
+    timer->changed.notify_all();
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+    {
+        std::lock_guard<std::mutex> lock(timer->mutex);
+        timer->deleted = true;
+        timer->running = false;
+        timer->changed.notify_all();
+    }
+    timer->thread.join();
+    delete timer;
+    return ESP_OK;
+}
+
+int64_t esp_timer_get_time() {
+    return (int64_t)HostHal::nowMicros();
+}
@@ -0,0 +1,211 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Host HAL - FreeRTOS tasks, mutexes, notifications and critical sections on std::thread.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "host_hal.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// A task is a thread plus its notification counter. Threads not started through
+// xTaskCreatePinnedToCore (main, test threads) get a record on first use.
+struct HostTask {
+    char name[16];
+    std::mutex mutex;
+    std::condition_variable wake;
+    uint32_t notifyCount = 0;
+};
+
+struct HostSemaphore {
+    std::timed_mutex mutex;
+};
+
+namespace {
+
+thread_local HostTask* t_currentTask = nullptr;
+
+HostTask* currentTask() {
+    if (t_currentTask == nullptr) {
+        // Lives as long as the thread may still be notified; never freed, like a static task
+        t_currentTask = new HostTask();
+        strlcpy(t_currentTask->name, "main", sizeof(t_currentTask->name));
+    }
+    return t_currentTask;
+}
+
+struct TaskStart {
+    TaskFunction_t function;
+    void* parameters;
+    HostTask* task;
+};
+
+} // namespace
+
+// =============================================================================
+// TASKS
+// =============================================================================
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, uint32_t stackDepth,
+                                   void* parameters, UBaseType_t priority, TaskHandle_t* handle,
+                                   BaseType_t core) {
+    (void)stackDepth;
+    (void)priority;
+    (void)core;
+
+    HostTask* task = new HostTask();
+    strlcpy(task->name, name != nullptr ? name : "", sizeof(task->name));
+    if (handle != nullptr) {
+        *handle = task;
+    }
+
+    TaskStart start = {function, parameters, task};
+    std::thread([start]() {
+        t_currentTask = start.task;
+        start.function(start.parameters);
+    }).detach();
+    return pdPASS;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    return currentTask();
+}
+
+const char* pcTaskGetName(TaskHandle_t task) {
+    return (task != nullptr ? task : currentTask())->name;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    (void)task;
+    return 4096;
+}
+
+TickType_t xTaskGetTickCount() {
+    return (TickType_t)millis();
+}
+
+void vTaskDelay(TickType_t ticks) {
+    delay(ticks);
+}
+
+void vTaskDelayUntil(TickType_t* previousWake, TickType_t period) {
+    TickType_t wake = *previousWake + period;
+    TickType_t now = xTaskGetTickCount();
+    // Signed difference so a missed deadline returns at once, as FreeRTOS does
+    if ((int32_t)(wake - now) > 0) {
+        vTaskDelay(wake - now);
+    }
+    *previousWake = wake;
+}
+
+void taskYIELD() {
+    std::this_thread::yield();
+}
+
+// =============================================================================
+// NOTIFICATIONS
+// =============================================================================
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    {
+        std::lock_guard<std::mutex> lock(task->mutex);
+        task->notifyCount++;
+    }
+    task->wake.notify_one();
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken) {
+    xTaskNotifyGive(task);
+    if (higherPriorityTaskWoken != nullptr) {
+        *higherPriorityTaskWoken = pdTRUE;
+    }
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait) {
+    HostTask* task = currentTask();
+    std::unique_lock<std::mutex> lock(task->mutex);
+
+    if (task->notifyCount == 0 && ticksToWait > 0) {
+        if (HostHal::isVirtualClock()) {
+            // Nothing else runs in virtual time while we wait, so the wait is the whole timeout
+            lock.unlock();
+            HostHal::advanceMicros((uint64_t)ticksToWait * 1000);
+            lock.lock();
+        } else if (ticksToWait == portMAX_DELAY) {
+            task->wake.wait(lock, [task]() { return task->notifyCount != 0; });
+        } else {
+            task->wake.wait_for(lock, std::chrono::milliseconds(ticksToWait),
+                                [task]() { return task->notifyCount != 0; });
+        }
+    }
+
+    uint32_t count = task->notifyCount;
+    if (count != 0) {
+        task->notifyCount = clearOnExit ? 0 : count - 1;
+    }
+    return count;
+}
+
+// =============================================================================
+// MUTEXES
+// =============================================================================
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+    return new HostSemaphore();
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait) {
+    if (semaphore == nullptr) {
+        return pdFALSE;
+    }
+    if (ticksToWait == portMAX_DELAY) {
+        semaphore->mutex.lock();
+        return pdTRUE;
+    }
+    if (ticksToWait == 0) {
+        return semaphore->mutex.try_lock() ? pdTRUE : pdFALSE;
+    }
+    return semaphore->mutex.try_lock_for(std::chrono::milliseconds(ticksToWait)) ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+    if (semaphore == nullptr) {
+        return pdFALSE;
+    }
+    semaphore->mutex.unlock();
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore) {
+    delete semaphore;
+}
+
+// =============================================================================
+// CRITICAL SECTIONS
+// =============================================================================
+
+void vPortEnterCritical(portMUX_TYPE* mux) {
+    while (mux->locked.exchange(true, std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+}
+
+void vPortExitCritical(portMUX_TYPE* mux) {
+    mux->locked.store(false, std::memory_order_release);
+}
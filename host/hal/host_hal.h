@@ -0,0 +1,51 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Host HAL - Simulation-side controls for the host build: clock, GPIO and console.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_HAL_H
+#define HOST_HAL_H
+
+// System includes
+#include <Arduino.h>
+#include <functional>
+#include <string>
+
+// The shims behave like the ESP32 core by default: real time, GPIO writes go nowhere and
+// console output is captured. A simulation switches to the virtual clock so that delays,
+// task sleeps and I2C transfers advance time instantly and runs go faster than real time.
+namespace HostHal {
+
+// Clock
+void useVirtualClock(bool enabled);
+bool isVirtualClock();
+uint64_t nowMicros();
+void advanceMicros(uint64_t micros);
+
+// GPIO; analogWrite() reports its duty, digitalWrite() its level
+typedef std::function<void(int pin, int value, bool analog)> PinWriter;
+void setPinWriter(PinWriter writer);
+int getPinValue(int pin);
+
+// Console
+void injectSerial(const char* data, size_t length);
+std::string takeSerialOutput();
+void setSerialEcho(bool echo);
+void setSerialTxSpace(int bytes);
+
+}
+
+#endif // HOST_HAL_H
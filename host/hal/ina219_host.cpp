@@ -0,0 +1,49 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Host HAL - INA219 register reads over the simulated I2C bus.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Adafruit_INA219.h>
+
+bool Adafruit_INA219::begin(TwoWire* wire) {
+    _wire = wire;
+    uint16_t value;
+    return readRegister(REG_BUS_VOLTAGE, value);
+}
+
+float Adafruit_INA219::getShuntVoltage_mV() {
+    uint16_t value = 0;
+    readRegister(REG_SHUNT_VOLTAGE, value);
+    return (int16_t)value * 0.01f;
+}
+
+float Adafruit_INA219::getBusVoltage_V() {
+    uint16_t value = 0;
+    readRegister(REG_BUS_VOLTAGE, value);
+    return (int16_t)((value >> 3) * 4) * 0.001f;
+}
+
+bool Adafruit_INA219::readRegister(uint8_t reg, uint16_t& value) {
+    _wire->beginTransmission(_address);
+    _wire->write(reg);
+    if (_wire->endTransmission() != 0 || _wire->requestFrom((uint16_t)_address, (uint8_t)2) != 2) {
+        return false;
+    }
+    uint16_t high = (uint16_t)_wire->read();
+    uint16_t low = (uint16_t)_wire->read();
+    value = (high << 8) | low;
+    return true;
+}
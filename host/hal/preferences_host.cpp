@@ -0,0 +1,141 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Host HAL - Preferences in a process-wide map, shared between instances on the same namespace.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Preferences.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace {
+
+struct StoredValue {
+    enum Type { INT, UINT, FLOAT, BOOL, STRING } type;
+    int32_t intValue;
+    uint32_t uintValue;
+    float floatValue;
+    bool boolValue;
+    std::string stringValue;
+};
+
+typedef std::map<std::string, StoredValue> Namespace;
+
+std::mutex g_storeMutex;
+std::map<std::string, Namespace> g_store;
+
+bool validKey(const char* key) {
+    return key != nullptr && key[0] != '\0' && strlen(key) <= Preferences::MAX_KEY_LENGTH;
+}
+
+} // namespace
+
+// =============================================================================
+// NAMESPACE
+// =============================================================================
+
+bool Preferences::begin(const char* name, bool readOnly) {
+    _namespace = name;
+    _readOnly = readOnly;
+    _open = true;
+    return true;
+}
+
+void Preferences::end() {
+    _open = false;
+}
+
+bool Preferences::clear() {
+    std::lock_guard<std::mutex> lock(g_storeMutex);
+    if (!_open || _readOnly) {
+        return false;
+    }
+    g_store[_namespace.c_str()].clear();
+    return true;
+}
+
+bool Preferences::remove(const char* key) {
+    std::lock_guard<std::mutex> lock(g_storeMutex);
+    if (!_open || _readOnly) {
+        return false;
+    }
+    return g_store[_namespace.c_str()].erase(key) != 0;
+}
+
+bool Preferences::isKey(const char* key) {
+    std::lock_guard<std::mutex> lock(g_storeMutex);
+    Namespace& values = g_store[_namespace.c_str()];
+    return values.find(key) != values.end();
+}
+
+void Preferences::resetAll() {
+    std::lock_guard<std::mutex> lock(g_storeMutex);
+    g_store.clear();
+}
+
+// =============================================================================
+// TYPED ACCESS
+// =============================================================================
+
+#define PREFERENCES_ACCESSORS(Name, CType, TypeTag, Field, Size)                          \
+    CType Preferences::get##Name(const char* key, CType defaultValue) {                     \
+        std::lock_guard<std::mutex> lock(g_storeMutex);                                     \
+        Namespace& values = g_store[_namespace.c_str()];                                    \
+        auto it = values.find(key);                                                         \
+        if (!_open || it == values.end() || it->second.type != StoredValue::TypeTag) {      \
+            return defaultValue;                                                            \
+        }                                                                                   \
+        return it->second.Field;                                                            \
+    }                                                                                       \
+    size_t Preferences::put##Name(const char* key, CType value) {                           \
+        std::lock_guard<std::mutex> lock(g_storeMutex);                                     \
+        if (!_open || _readOnly || !validKey(key)) {                                        \
+            return 0;                                                                       \
+        }                                                                                   \
+        StoredValue& stored = g_store[_namespace.c_str()][key];                             \
+        stored = StoredValue();                                                             \
+        stored.type = StoredValue::TypeTag;                                                 \
+        stored.Field = value;                                                               \
+        return Size;                                                                        \
+    }
+
+PREFERENCES_ACCESSORS(Int, int32_t, INT, intValue, sizeof(int32_t))
+PREFERENCES_ACCESSORS(UInt, uint32_t, UINT, uintValue, sizeof(uint32_t))
+PREFERENCES_ACCESSORS(Float, float, FLOAT, floatValue, sizeof(float))
+PREFERENCES_ACCESSORS(Bool, bool, BOOL, boolValue, 1)
+
+String Preferences::getString(const char* key, const String& defaultValue) {
+    std::lock_guard<std::mutex> lock(g_storeMutex);
+    Namespace& values = g_store[_namespace.c_str()];
+    auto it = values.find(key);
+    if (!_open || it == values.end() || it->second.type != StoredValue::STRING) {
+        return defaultValue;
+    }
+    return String(it->second.stringValue);
+}
+
+size_t Preferences::putString(const char* key, const String& value) {
+    std::lock_guard<std::mutex> lock(g_storeMutex);
+    if (!_open || _readOnly || !validKey(key)) {
+        return 0;
+    }
+    StoredValue& stored = g_store[_namespace.c_str()][key];
+    stored = StoredValue();
+    stored.type = StoredValue::STRING;
+    stored.stringValue = value.c_str();
+    return value.length();
+}
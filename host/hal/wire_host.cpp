@@ -0,0 +1,109 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Host HAL - I2C master on a simulated bus, charging each transfer's wire time to the clock.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Wire.h>
+
+TwoWire Wire;
+
+// =============================================================================
+// CONFIGURATION
+// =============================================================================
+
+bool TwoWire::begin(int sda, int scl, uint32_t frequency) {
+    (void)sda;
+    (void)scl;
+    if (frequency != 0) {
+        _frequency = frequency;
+    }
+    return true;
+}
+
+void TwoWire::attachDevice(uint16_t address, HostI2CDevice* device) {
+    if (address < MAX_ADDRESS) {
+        _devices[address] = device;
+    }
+}
+
+void TwoWire::detachDevice(uint16_t address) {
+    if (address < MAX_ADDRESS) {
+        _devices[address] = nullptr;
+    }
+}
+
+// =============================================================================
+// TRANSACTIONS
+// =============================================================================
+
+void TwoWire::beginTransmission(uint16_t address) {
+    _txAddress = address;
+    _txLength = 0;
+}
+
+size_t TwoWire::write(uint8_t c) {
+    if (_txLength >= BUFFER_SIZE) {
+        return 0;
+    }
+    _txBuffer[_txLength++] = c;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t length) {
+    size_t written = 0;
+    while (written < length && write(data[written])) {
+        written++;
+    }
+    return written;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+    (void)sendStop;
+    _transactions++;
+    HostI2CDevice* device = _txAddress < MAX_ADDRESS ? _devices[_txAddress] : nullptr;
+    if (device == nullptr) {
+        chargeBusTime(0);
+        return I2C_NACK_ADDR;
+    }
+    chargeBusTime(_txLength);
+    return device->write(_txBuffer, _txLength) ? I2C_OK : I2C_NACK_DATA;
+}
+
+uint8_t TwoWire::requestFrom(uint16_t address, uint8_t quantity, bool sendStop) {
+    (void)sendStop;
+    _transactions++;
+    _rxIndex = 0;
+    _rxLength = 0;
+    quantity = min((size_t)quantity, BUFFER_SIZE);
+
+    HostI2CDevice* device = address < MAX_ADDRESS ? _devices[address] : nullptr;
+    if (device == nullptr) {
+        chargeBusTime(0);
+        return 0;
+    }
+    chargeBusTime(quantity);
+    if (!device->read(_rxBuffer, quantity)) {
+        return 0;
+    }
+    _rxLength = quantity;
+    return quantity;
+}
+
+void TwoWire::chargeBusTime(size_t dataBytes) {
+    // Address byte plus data, nine clocks each with the ACK, plus START and STOP
+    uint32_t bits = (uint32_t)(dataBytes + 1) * 9 + 2;
+    delayMicroseconds((unsigned int)((uint64_t)bits * 1000000 / _frequency));
+}
@@ -0,0 +1,45 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Host Shims - INA219 driver reading the chip over the simulated I2C bus.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_ADAFRUIT_INA219_H
+#define HOST_ADAFRUIT_INA219_H
+
+// System includes
+#include <Wire.h>
+
+// Same register reads as the Adafruit driver: shunt voltage in 10 uV steps, bus voltage
+// in 4 mV steps above bit 3
+class Adafruit_INA219 {
+public:
+    Adafruit_INA219(uint8_t address = 0x40) : _address(address) {}
+
+    bool begin(TwoWire* wire = &Wire);
+    float getShuntVoltage_mV();
+    float getBusVoltage_V();
+
+private:
+    static constexpr uint8_t REG_SHUNT_VOLTAGE = 0x01;
+    static constexpr uint8_t REG_BUS_VOLTAGE = 0x02;
+
+    uint8_t _address;
+    TwoWire* _wire = &Wire;
+
+    bool readRegister(uint8_t reg, uint16_t& value);
+};
+
+#endif // HOST_ADAFRUIT_INA219_H
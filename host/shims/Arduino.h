@@ -0,0 +1,240 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Host Shims - The subset of the Arduino core used by the firmware, for the host build.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// System includes
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <string>
+
+// Custom includes
+#include "freertos/FreeRTOS.h"
+
+// As in the ESP32 core: abs() and friends come from the STL, so abs(double) stays a double
+using std::abs;
+using std::isfinite;
+using std::isinf;
+using std::isnan;
+using std::max;
+using std::min;
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define PI 3.1415926535897932384626433832795
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+#define HEX 16
+#define DEC 10
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define IRAM_ATTR
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// =============================================================================
+// STRING
+// =============================================================================
+
+// Arduino String on top of std::string; numeric constructors format like the ESP32 core
+class String {
+public:
+    String() {}
+    String(const char* text) : _s(text != nullptr ? text : "") {}
+    String(const std::string& text) : _s(text) {}
+    explicit String(char c) : _s(1, c) {}
+    String(int value, unsigned char base = DEC) : _s(formatInteger((long long)value, base)) {}
+    String(unsigned int value, unsigned char base = DEC) : _s(formatUnsigned(value, base)) {}
+    String(long value, unsigned char base = DEC) : _s(formatInteger(value, base)) {}
+    String(unsigned long value, unsigned char base = DEC) : _s(formatUnsigned(value, base)) {}
+    String(long long value, unsigned char base = DEC) : _s(formatInteger(value, base)) {}
+    String(unsigned long long value, unsigned char base = DEC) : _s(formatUnsigned(value, base)) {}
+    String(float value, unsigned int decimals = 2) : _s(formatFloat(value, decimals)) {}
+    String(double value, unsigned int decimals = 2) : _s(formatFloat(value, decimals)) {}
+
+    unsigned int length() const { return _s.size(); }
+    bool isEmpty() const { return _s.empty(); }
+    const char* c_str() const { return _s.c_str(); }
+    bool reserve(unsigned int size) { _s.reserve(size); return true; }
+
+    String& operator+=(const String& other) { _s += other._s; return *this; }
+    String& operator+=(const char* other) { _s += other; return *this; }
+    String& operator+=(char c) { _s += c; return *this; }
+    String& operator+=(int value) { _s += String(value)._s; return *this; }
+    String& operator+=(unsigned long value) { _s += String(value)._s; return *this; }
+    bool concat(const char* text, unsigned int length) { _s.append(text, length); return true; }
+    bool concat(const String& other) { _s += other._s; return true; }
+
+    friend String operator+(const String& a, const String& b) { return String(a._s + b._s); }
+    friend String operator+(const String& a, const char* b) { return String(a._s + b); }
+    friend String operator+(const char* a, const String& b) { return String(a + b._s); }
+    friend String operator+(const String& a, char b) { return String(a._s + b); }
+
+    bool operator==(const String& other) const { return _s == other._s; }
+    bool operator==(const char* other) const { return _s == other; }
+    bool operator!=(const String& other) const { return _s != other._s; }
+    bool operator!=(const char* other) const { return _s != other; }
+    bool operator<(const String& other) const { return _s < other._s; }
+    char operator[](unsigned int index) const { return index < _s.size() ? _s[index] : 0; }
+    char& operator[](unsigned int index) { return _s[index]; }
+
+    bool equals(const String& other) const { return _s == other._s; }
+    bool equalsIgnoreCase(const String& other) const;
+    int compareTo(const String& other) const { return _s.compare(other._s); }
+    bool startsWith(const String& prefix) const { return _s.rfind(prefix._s, 0) == 0; }
+    bool endsWith(const String& suffix) const;
+    char charAt(unsigned int index) const { return (*this)[index]; }
+    void setCharAt(unsigned int index, char c) { if (index < _s.size()) _s[index] = c; }
+
+    int indexOf(char c, unsigned int from = 0) const { return position(_s.find(c, from)); }
+    int indexOf(const String& text, unsigned int from = 0) const { return position(_s.find(text._s, from)); }
+    int lastIndexOf(char c) const { return position(_s.rfind(c)); }
+    String substring(unsigned int from) const { return from >= _s.size() ? String() : String(_s.substr(from)); }
+    String substring(unsigned int from, unsigned int to) const;
+
+    long toInt() const { return atol(_s.c_str()); }
+    float toFloat() const { return (float)atof(_s.c_str()); }
+    double toDouble() const { return atof(_s.c_str()); }
+    void trim();
+    void toLowerCase();
+    void toUpperCase();
+    void replace(const String& from, const String& to);
+    void remove(unsigned int index) { if (index < _s.size()) _s.erase(index); }
+    void remove(unsigned int index, unsigned int count) { if (index < _s.size()) _s.erase(index, count); }
+    void toCharArray(char* buffer, unsigned int size) const;
+    void getBytes(unsigned char* buffer, unsigned int size) const { toCharArray((char*)buffer, size); }
+
+private:
+    std::string _s;
+
+    static int position(size_t pos) { return pos == std::string::npos ? -1 : (int)pos; }
+    static std::string formatInteger(long long value, unsigned char base);
+    static std::string formatUnsigned(unsigned long long value, unsigned char base);
+    static std::string formatFloat(double value, unsigned int decimals);
+};
+
+// =============================================================================
+// PRINT, STREAM AND SERIAL
+// =============================================================================
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    size_t write(const char* text) { return write((const uint8_t*)text, strlen(text)); }
+    size_t write(const char* buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+    virtual int availableForWrite() { return 0; }
+    virtual void flush() {}
+
+    size_t print(const String& text) { return write(text.c_str(), text.length()); }
+    size_t print(const char* text) { return write(text); }
+    size_t print(char c) { return write((uint8_t)c); }
+    template <typename T> size_t print(T value) { return print(String(value)); }
+    template <typename T> size_t print(T value, int format) { return print(String(value, format)); }
+    size_t println() { return write("\r\n"); }
+    template <typename T> size_t println(T value) { size_t n = print(value); return n + println(); }
+    template <typename T> size_t println(T value, int format) { size_t n = print(value, format); return n + println(); }
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    size_t readBytes(uint8_t* buffer, size_t length);
+    size_t readBytes(char* buffer, size_t length) { return readBytes((uint8_t*)buffer, length); }
+    void setTimeout(unsigned long timeout) { _timeout = timeout; }
+
+protected:
+    unsigned long _timeout = 1000;
+};
+
+typedef const char* esp_event_base_t;
+
+// Console: what the firmware writes is captured for tests (and echoed to stdout if asked);
+// tests inject received bytes, which fire the onReceive() callback like the UART driver
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    operator bool() const { return true; }
+    void onReceive(std::function<void(void)> callback, bool onlyOnTimeout = false);
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    int availableForWrite() override;
+    int available() override;
+    int read() override;
+    int peek() override;
+};
+
+extern HardwareSerial Serial;
+
+// =============================================================================
+// TIME, GPIO AND SYSTEM
+// =============================================================================
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(int pin, int mode);
+void digitalWrite(int pin, int value);
+int digitalRead(int pin);
+void analogWrite(int pin, int value);
+void analogWriteFrequency(int pin, int frequency);
+
+long random(long max);
+long random(long min, long max);
+uint32_t esp_random();
+void configTime(long gmtOffset, int daylightOffset, const char* server1,
+                const char* server2 = nullptr, const char* server3 = nullptr);
+
+// glibc only provides strlcpy from 2.38
+#if defined(__GLIBC__) && !__GLIBC_PREREQ(2, 38)
+size_t strlcpy(char* dst, const char* src, size_t size);
+#endif
+
+class EspClass {
+public:
+    void restart();
+    uint32_t getFreeHeap() { return 320 * 1024; }
+    uint32_t getMinFreeHeap() { return 256 * 1024; }
+    uint32_t getMaxAllocHeap() { return 128 * 1024; }
+    uint32_t getCpuFreqMHz() { return 240; }
+    uint32_t getCycleCount();
+};
+
+extern EspClass ESP;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,57 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Host Shims - Non-volatile key/value storage kept in memory for the life of the process.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+
+// System includes
+#include <Arduino.h>
+
+// Every instance opened on the same namespace sees the same values, as on the device.
+// Keys are limited to 15 characters like NVS; longer keys fail the put.
+class Preferences {
+public:
+    static constexpr size_t MAX_KEY_LENGTH = 15;
+
+    bool begin(const char* name, bool readOnly = false);
+    void end();
+    bool clear();
+    bool remove(const char* key);
+    bool isKey(const char* key);
+
+    int32_t getInt(const char* key, int32_t defaultValue = 0);
+    size_t putInt(const char* key, int32_t value);
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0);
+    size_t putUInt(const char* key, uint32_t value);
+    float getFloat(const char* key, float defaultValue = 0);
+    size_t putFloat(const char* key, float value);
+    bool getBool(const char* key, bool defaultValue = false);
+    size_t putBool(const char* key, bool value);
+    String getString(const char* key, const String& defaultValue = String());
+    size_t putString(const char* key, const String& value);
+
+    // Host only: forget every namespace, for tests that need a factory-fresh device
+    static void resetAll();
+
+private:
+    String _namespace;
+    bool _readOnly = false;
+    bool _open = false;
+};
+
+#endif // HOST_PREFERENCES_H
@@ -0,0 +1,86 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Host Shims - I2C master on a simulated bus; devices are attached by the simulation.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+// System includes
+#include <Arduino.h>
+
+// A device on the simulated bus. write() receives the bytes of a write transaction
+// (register pointer first); read() fills a read transaction. Returning false NACKs.
+class HostI2CDevice {
+public:
+    virtual ~HostI2CDevice() {}
+    virtual bool write(const uint8_t* data, size_t length) = 0;
+    virtual bool read(uint8_t* data, size_t length) = 0;
+};
+
+// Transactions go to whichever device is attached at the address, and each one advances
+// the virtual clock by its time on the wire at the configured SCL rate
+class TwoWire : public Stream {
+public:
+    static constexpr size_t BUFFER_SIZE = 128;
+
+    // Error codes returned by endTransmission(), as in the ESP32 core
+    static constexpr uint8_t I2C_OK = 0;
+    static constexpr uint8_t I2C_NACK_ADDR = 2;
+    static constexpr uint8_t I2C_NACK_DATA = 3;
+
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+    void setClock(uint32_t frequency) { _frequency = frequency; }
+    uint32_t getClock() const { return _frequency; }
+    void setTimeOut(uint16_t timeoutMs) { _timeoutMs = timeoutMs; }
+
+    void beginTransmission(uint16_t address);
+    uint8_t endTransmission(bool sendStop = true);
+    uint8_t requestFrom(uint16_t address, uint8_t quantity, bool sendStop = true);
+    uint8_t requestFrom(int address, int quantity) { return requestFrom((uint16_t)address, (uint8_t)quantity); }
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* data, size_t length) override;
+    using Print::write;
+    int available() override { return (int)(_rxLength - _rxIndex); }
+    int read() override { return _rxIndex < _rxLength ? _rxBuffer[_rxIndex++] : -1; }
+    int peek() override { return _rxIndex < _rxLength ? _rxBuffer[_rxIndex] : -1; }
+
+    // Simulation side
+    void attachDevice(uint16_t address, HostI2CDevice* device);
+    void detachDevice(uint16_t address);
+    uint32_t getTransactionCount() const { return _transactions; }
+
+private:
+    static constexpr int MAX_ADDRESS = 128;
+
+    HostI2CDevice* _devices[MAX_ADDRESS] = {};
+    uint32_t _frequency = 100000;
+    uint16_t _timeoutMs = 50;
+    uint16_t _txAddress = 0;
+    uint8_t _txBuffer[BUFFER_SIZE];
+    size_t _txLength = 0;
+    uint8_t _rxBuffer[BUFFER_SIZE];
+    size_t _rxLength = 0;
+    size_t _rxIndex = 0;
+    uint32_t _transactions = 0;
+
+    void chargeBusTime(size_t bytes);
+};
+
+extern TwoWire Wire;
+
+#endif // HOST_WIRE_H
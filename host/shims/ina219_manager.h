@@ -0,0 +1,24 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Host Shims - Forwards the firmware's lower-case include to INA219_manager.h on case-sensitive file systems.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_INA219_MANAGER_FORWARD_H
+#define HOST_INA219_MANAGER_FORWARD_H
+
+#include "../../INA219_manager.h"
+
+#endif // HOST_INA219_MANAGER_FORWARD_H
@@ -0,0 +1,226 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Rotator Sim - Runs the motor controller's tasks against the plant in virtual time.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rotator_sim.h"
+#include "host_hal.h"
+
+namespace {
+
+float wrapSigned(float angle) {
+    angle = fmodf(angle, 360.0f);
+    if (angle > 180.0f) {
+        angle -= 360.0f;
+    } else if (angle <= -180.0f) {
+        angle += 360.0f;
+    }
+    return angle;
+}
+
+} // namespace
+
+// =============================================================================
+// CONSTRUCTOR AND BOOT
+// =============================================================================
+
+RotatorSim::RotatorSim()
+    : _logger(_preferences), _ina219(_logger), _controller(_preferences, _ina219, _logger),
+      _azSensor(_plant, PlantSimulator::AXIS_AZ), _elSensor(_plant, PlantSimulator::AXIS_EL),
+      _powerSensor(_plant) {
+    // Each simulation is a factory-fresh unit on its own clock
+    HostHal::useVirtualClock(true);
+    Preferences::resetAll();
+    _preferences.begin("dd", false);
+
+    Wire.begin();
+    Wire.setClock(100000);  // As configured in setup()
+    Wire.attachDevice(AZ_SENSOR_ADDRESS, &_azSensor);
+    Wire.attachDevice(EL_SENSOR_ADDRESS, &_elSensor);
+    Wire.attachDevice(INA219_ADDRESS, &_powerSensor);
+
+    HostHal::setPinWriter([this](int pin, int value, bool analog) {
+        onPinWrite(pin, value, analog);
+    });
+}
+
+RotatorSim::~RotatorSim() {
+    HostHal::setPinWriter(nullptr);
+    Wire.detachDevice(AZ_SENSOR_ADDRESS);
+    Wire.detachDevice(EL_SENSOR_ADDRESS);
+    Wire.detachDevice(INA219_ADDRESS);
+    HostHal::takeSerialOutput();
+}
+
+void RotatorSim::begin(float azAngle, float elAngle) {
+    // Elevation is tared at its calibration angle; without one the boot position is home
+    if (!_preferences.isKey("el_cal")) {
+        _preferences.putFloat("el_cal", EL_HOME_ANGLE);
+    }
+    _plant.setAngle(PlantSimulator::AXIS_AZ, AZ_HOME_ANGLE + azAngle);
+    _plant.setAngle(PlantSimulator::AXIS_EL, EL_HOME_ANGLE + elAngle);
+    _plant.update(micros());
+
+    // Same order as setup()
+    _logger.begin();
+    _controller.begin();
+    _ina219.begin();
+
+    // Tasks start together once setup() returns
+    _startMicros = HostHal::nowMicros();
+    _nextSensor = _startMicros;
+    _nextControl = _startMicros;
+    _nextPower = _startMicros;
+    _nextSafety = _startMicros;
+    HostHal::takeSerialOutput();
+}
+
+void RotatorSim::setLogEcho(bool echo) {
+    HostHal::setSerialEcho(echo);
+}
+
+// =============================================================================
+// SCHEDULING
+// =============================================================================
+
+void RotatorSim::runFor(float seconds) {
+    uint64_t end = HostHal::nowMicros() + (uint64_t)(seconds * 1e6f);
+
+    for (;;) {
+        uint64_t next = min(min(_nextSensor, _nextControl), min(_nextPower, _nextSafety));
+        if (next > end) {
+            advanceTo(end);
+            break;
+        }
+        advanceTo(next);
+        _plant.update(micros());
+
+        // Highest priority first, as the tasks would preempt each other on the device.
+        // vTaskDelayUntil keeps each task on its own grid even when a run overruns.
+        if (_nextSensor <= next) {
+            _controller.runSensorLoop();
+            _nextSensor += SENSOR_PERIOD_US;
+        }
+        if (_nextControl <= next) {
+            uint64_t startMicros = HostHal::nowMicros();
+            auto wallStart = std::chrono::steady_clock::now();
+            _controller.runControlLoop();
+            uint64_t busyMicros = HostHal::nowMicros() - startMicros;
+            _controlTiming.runs++;
+            _controlTiming.busyMicros += busyMicros;
+            _controlTiming.maxBusyMicros = max(_controlTiming.maxBusyMicros, busyMicros);
+            _controlTiming.wallSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+            _nextControl += controlPeriod();
+        }
+        if (_nextSafety <= next) {
+            _controller.runSafetyLoop();
+            _nextSafety += _controller.global_fault ? SAFETY_FAULT_PERIOD_US : SAFETY_PERIOD_US;
+        }
+        if (_nextPower <= next) {
+            _ina219.ReadData();
+            _nextPower += POWER_PERIOD_US;
+        }
+    }
+
+    // Log output is drained in place (no drain task); keep the capture from growing
+    HostHal::takeSerialOutput();
+}
+
+void RotatorSim::advanceTo(uint64_t micros) {
+    uint64_t now = HostHal::nowMicros();
+    if (micros > now) {
+        HostHal::advanceMicros(micros - now);
+    }
+}
+
+uint64_t RotatorSim::controlPeriod() {
+    return _controller.isHighRateControl() ? (uint64_t)_controller.getControlPeriodUs()
+                                            : (uint64_t)MotorSensorController::LEGACY_CONTROL_PERIOD_US;
+}
+
+float RotatorSim::getElapsedSeconds() const {
+    return (HostHal::nowMicros() - _startMicros) / 1e6f;
+}
+
+// =============================================================================
+// MEASUREMENT
+// =============================================================================
+
+float RotatorSim::getTrueAngle(PlantSimulator::Axis axis) {
+    if (axis == PlantSimulator::AXIS_AZ) {
+        float angle = fmodf(_plant.getAngle(axis) - AZ_HOME_ANGLE, 360.0f);
+        return angle < 0 ? angle + 360.0f : angle;
+    }
+    return _plant.getAngle(axis) - _preferences.getFloat("el_cal", EL_HOME_ANGLE);
+}
+
+RotatorSim::StepResult RotatorSim::step(PlantSimulator::Axis axis, float target, float band, float timeout) {
+    bool az = (axis == PlantSimulator::AXIS_AZ);
+    float startError = az ? wrapSigned(target - getTrueAngle(axis)) : target - getTrueAngle(axis);
+    // Direction of approach, fixed once the axis is within reach of the target. An azimuth
+    // move may unwind the long way round, so the sign of the starting error is not enough.
+    float direction = 0;
+
+    if (az) {
+        _controller.setSetPointAz(target);
+    } else {
+        _controller.setSetPointEl(target);
+    }
+
+    StepResult result = {false, 0, 0, startError};
+    float elapsed = 0;
+    float lastOutside = 0;
+    float lastError = startError;
+    while (elapsed < timeout) {
+        runFor(STEP_SAMPLE_S);
+        elapsed += STEP_SAMPLE_S;
+
+        float error = az ? wrapSigned(target - getTrueAngle(axis)) : target - getTrueAngle(axis);
+        if (fabsf(error) < APPROACH_WINDOW_DEG) {
+            if (direction == 0) {
+                direction = (lastError >= 0) ? 1.0f : -1.0f;
+            }
+            result.overshoot = max(result.overshoot, -error * direction);
+        }
+        lastError = error;
+        result.finalError = error;
+        if (fabsf(error) > band) {
+            lastOutside = elapsed;
+        } else if (elapsed - lastOutside >= STEP_HOLD_S) {
+            break;
+        }
+    }
+
+    result.settled = fabsf(result.finalError) <= band;
+    result.settleTime = lastOutside;
+    return result;
+}
+
+// =============================================================================
+// GPIO
+// =============================================================================
+
+void RotatorSim::onPinWrite(int pin, int value, bool analog) {
+    PlantSimulator::Axis axis = (pin == PWM_PIN_AZ || pin == DIR_PIN_AZ) ? PlantSimulator::AXIS_AZ : PlantSimulator::AXIS_EL;
+    _plant.update(micros());
+
+    if (pin == PWM_PIN_AZ || pin == PWM_PIN_EL) {
+        // A digital write on a PWM pin is 0 % or 100 % duty
+        _plant.setPwm(axis, analog ? value : (value ? 255 : 0));
+    } else if (pin == DIR_PIN_AZ || pin == DIR_PIN_EL) {
+        _plant.setDirection(axis, value == HIGH);
+    }
+}
@@ -0,0 +1,134 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Rotator Sim - Runs the motor controller's tasks against the plant in virtual time.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ROTATOR_SIM_H
+#define ROTATOR_SIM_H
+
+// System includes
+#include <Arduino.h>
+#include <Preferences.h>
+#include <Wire.h>
+#include <chrono>
+
+// Custom includes
+#include "ina219_manager.h"
+#include "logger.h"
+#include "motor_controller.h"
+#include "plant_simulator.h"
+#include "sensor_models.h"
+
+// The firmware as the ESP32 runs it, minus the network: the motor controller talks to the
+// AS5600s and INA219 over the shimmed Wire bus and drives the motor pins through
+// analogWrite/digitalWrite, all backed by one PlantSimulator. The sensor, control, safety
+// and power tasks run at their firmware periods on the virtual clock, so a minute of dish
+// motion takes milliseconds. Everything runs on the calling thread.
+class RotatorSim {
+public:
+    struct StepResult {
+        bool settled;           // Inside the band when the run ended
+        float settleTime;       // s from the command until the axis last entered the band
+        float overshoot;        // Degrees past the target in the direction of travel
+        float finalError;       // Degrees, target minus true position
+    };
+
+    // Cost of one task's runs. Virtual time only passes inside a task for bus transfers
+    // and delays, so busy time is how long the task would hold its core waiting on them.
+    struct TaskTiming {
+        uint32_t runs;
+        uint64_t busyMicros;
+        uint64_t maxBusyMicros;
+        double wallSeconds;     // Host time spent computing
+    };
+
+    // Constructor
+    RotatorSim();
+    ~RotatorSim();
+
+    // Boot the firmware. Preferences written before this call are what it loads.
+    void begin(float azAngle = 0, float elAngle = 0);
+
+    // Advance virtual time, running every task that falls due
+    void runFor(float seconds);
+
+    // Command one axis and follow the true position until it holds inside the band
+    StepResult step(PlantSimulator::Axis axis, float target, float band, float timeout);
+
+    // True position in the controller's frame (degrees from home)
+    float getTrueAngle(PlantSimulator::Axis axis);
+
+    // Access
+    MotorSensorController& controller() { return _controller; }
+    PlantSimulator& plant() { return _plant; }
+    Preferences& preferences() { return _preferences; }
+    Logger& logger() { return _logger; }
+    INA219Manager& ina219() { return _ina219; }
+    As5600Model& sensor(PlantSimulator::Axis axis) { return axis == PlantSimulator::AXIS_AZ ? _azSensor : _elSensor; }
+    uint32_t getControlTicks() const { return _controlTiming.runs; }
+    const TaskTiming& getControlTiming() const { return _controlTiming; }
+    void resetControlTiming() { _controlTiming = {}; }
+    float getElapsedSeconds() const;
+
+    // Mirror firmware log output to stdout
+    void setLogEcho(bool echo);
+
+private:
+    // Task periods from discovery_drive.ino
+    static constexpr uint64_t SENSOR_PERIOD_US = 2000;
+    static constexpr uint64_t POWER_PERIOD_US = 100000;
+    static constexpr uint64_t SAFETY_PERIOD_US = 500000;
+    static constexpr uint64_t SAFETY_FAULT_PERIOD_US = 100000;
+
+    // Wiring and addresses as in MotorSensorController and INA219Manager
+    static constexpr int PWM_PIN_AZ = 35;
+    static constexpr int DIR_PIN_AZ = 36;
+    static constexpr int PWM_PIN_EL = 40;
+    static constexpr int DIR_PIN_EL = 41;
+    static constexpr uint16_t EL_SENSOR_ADDRESS = 0x36;
+    static constexpr uint16_t AZ_SENSOR_ADDRESS = 0x40;
+    static constexpr uint16_t INA219_ADDRESS = 0x45;
+
+    // Plant angle that reads as home; the controller homes azimuth 10 degrees off zero
+    static constexpr float AZ_HOME_ANGLE = 10.0f;
+    static constexpr float EL_HOME_ANGLE = 20.0f;
+
+    static constexpr float STEP_SAMPLE_S = 0.005f;
+    static constexpr float STEP_HOLD_S = 2.0f;
+    static constexpr float APPROACH_WINDOW_DEG = 90.0f;
+
+    Preferences _preferences;
+    PlantSimulator _plant;
+    Logger _logger;
+    INA219Manager _ina219;
+    MotorSensorController _controller;
+    As5600Model _azSensor;
+    As5600Model _elSensor;
+    Ina219Model _powerSensor;
+
+    uint64_t _startMicros = 0;
+    uint64_t _nextSensor = 0;
+    uint64_t _nextControl = 0;
+    uint64_t _nextPower = 0;
+    uint64_t _nextSafety = 0;
+    TaskTiming _controlTiming = {};
+
+    void onPinWrite(int pin, int value, bool analog);
+    void advanceTo(uint64_t micros);
+    uint64_t controlPeriod();
+};
+
+#endif // ROTATOR_SIM_H
@@ -0,0 +1,85 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Sensor Models - AS5600 and INA219 register models on the simulated I2C bus.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sensor_models.h"
+
+// =============================================================================
+// AS5600
+// =============================================================================
+
+bool As5600Model::write(const uint8_t* data, size_t length) {
+    if (_nack) {
+        return false;
+    }
+    // The first byte sets the register pointer; the firmware never writes configuration
+    if (length > 0) {
+        _pointer = data[0];
+    }
+    return true;
+}
+
+bool As5600Model::read(uint8_t* data, size_t length) {
+    if (_nack) {
+        return false;
+    }
+
+    // One conversion per transaction, so both angle bytes belong to the same sample
+    uint16_t rawCount = _plant.readRawCount(_axis);
+    uint8_t status = _plant.readStatus(_axis);
+
+    for (size_t i = 0; i < length; i++, _pointer++) {
+        switch (_pointer) {
+            case REG_STATUS:      data[i] = status; break;
+            case REG_RAW_ANGLE_H:
+            case REG_ANGLE_H:     data[i] = (rawCount >> 8) & 0x0F; break;
+            case REG_RAW_ANGLE_L:
+            case REG_ANGLE_L:     data[i] = rawCount & 0xFF; break;
+            case REG_AGC:         data[i] = NOMINAL_AGC; break;
+            default:              data[i] = 0; break;
+        }
+    }
+    return true;
+}
+
+// =============================================================================
+// INA219
+// =============================================================================
+
+bool Ina219Model::write(const uint8_t* data, size_t length) {
+    if (length > 0) {
+        _pointer = data[0];
+    }
+    return true;
+}
+
+bool Ina219Model::read(uint8_t* data, size_t length) {
+    uint16_t value = 0;
+    if (_pointer == REG_SHUNT_VOLTAGE) {
+        // 10 uV per LSB, two's complement
+        value = (uint16_t)(int16_t)lroundf(_plant.readShuntVoltage_mV() * 100.0f);
+    } else if (_pointer == REG_BUS_VOLTAGE) {
+        // 4 mV per LSB from bit 3 up
+        value = (uint16_t)(lroundf(_plant.readBusVoltage_V() / 0.004f) << 3) | BUS_CONVERSION_READY;
+    }
+
+    // Registers are 16 bits, big-endian; the pointer does not auto-increment
+    for (size_t i = 0; i < length; i++) {
+        data[i] = (i % 2 == 0) ? (value >> 8) : (value & 0xFF);
+    }
+    return true;
+}
@@ -0,0 +1,72 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Sensor Models - AS5600 and INA219 register models on the simulated I2C bus.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SENSOR_MODELS_H
+#define SENSOR_MODELS_H
+
+// System includes
+#include <Wire.h>
+
+// Custom includes
+#include "plant_simulator.h"
+
+// AS5600 register file over one plant axis. The register pointer auto-increments across
+// a read, so the firmware's STATUS + RAW ANGLE burst comes back in one transaction.
+class As5600Model : public HostI2CDevice {
+public:
+    As5600Model(PlantSimulator& plant, PlantSimulator::Axis axis) : _plant(plant), _axis(axis) {}
+
+    bool write(const uint8_t* data, size_t length) override;
+    bool read(uint8_t* data, size_t length) override;
+
+    // Fault injection: NACK every transaction while set
+    void setNack(bool nack) { _nack = nack; }
+
+private:
+    static constexpr uint8_t REG_STATUS = 0x0B;
+    static constexpr uint8_t REG_RAW_ANGLE_H = 0x0C;
+    static constexpr uint8_t REG_RAW_ANGLE_L = 0x0D;
+    static constexpr uint8_t REG_ANGLE_H = 0x0E;
+    static constexpr uint8_t REG_ANGLE_L = 0x0F;
+    static constexpr uint8_t REG_AGC = 0x1A;
+    static constexpr uint8_t NOMINAL_AGC = 0x80;
+
+    PlantSimulator& _plant;
+    PlantSimulator::Axis _axis;
+    uint8_t _pointer = 0;
+    bool _nack = false;
+};
+
+// INA219 shunt and bus voltage registers for the plant's supply
+class Ina219Model : public HostI2CDevice {
+public:
+    explicit Ina219Model(PlantSimulator& plant) : _plant(plant) {}
+
+    bool write(const uint8_t* data, size_t length) override;
+    bool read(uint8_t* data, size_t length) override;
+
+private:
+    static constexpr uint8_t REG_SHUNT_VOLTAGE = 0x01;
+    static constexpr uint8_t REG_BUS_VOLTAGE = 0x02;
+    static constexpr uint16_t BUS_CONVERSION_READY = 0x02;
+
+    PlantSimulator& _plant;
+    uint8_t _pointer = 0;
+};
+
+#endif // SENSOR_MODELS_H
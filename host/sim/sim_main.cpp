@@ -0,0 +1,102 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Simulation Driver - Boots the firmware on the simulated plant and runs a move sequence.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rotator_sim.h"
+
+#include <chrono>
+#include <cstring>
+
+// Usage: dd_sim [--period-us N] [--pid] [--profile] [--log] [az el]...
+// Each az/el pair is a move; the axes are commanded one after the other and the
+// result of each step is printed along with how much faster than real time the run was.
+
+namespace {
+
+void usage() {
+    printf("usage: dd_sim [--period-us N] [--pid] [--profile] [--log] [az el]...\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int periodUs = 0;
+    bool pid = false;
+    bool profile = false;
+    bool log = false;
+    float moves[32][2];
+    int moveCount = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--period-us") == 0 && i + 1 < argc) {
+            periodUs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--pid") == 0) {
+            pid = true;
+        } else if (strcmp(argv[i], "--profile") == 0) {
+            profile = true;
+        } else if (strcmp(argv[i], "--log") == 0) {
+            log = true;
+        } else if (i + 1 < argc && moveCount < 32) {
+            moves[moveCount][0] = atof(argv[i]);
+            moves[moveCount][1] = atof(argv[++i]);
+            moveCount++;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (moveCount == 0) {
+        moves[0][0] = 90;  moves[0][1] = 30;
+        moves[1][0] = 270; moves[1][1] = 60;
+        moves[2][0] = 5;   moves[2][1] = 5;
+        moveCount = 3;
+    }
+
+    RotatorSim sim;
+    sim.setLogEcho(log);
+    sim.preferences().putInt("ctrlPeriodUs", periodUs);
+    sim.preferences().putInt("ctrlMode", pid ? 1 : 0);
+    sim.preferences().putBool("motionProfile", profile);
+
+    auto wallStart = std::chrono::steady_clock::now();
+    sim.begin();
+    sim.runFor(1.0f);
+
+    printf("control period %d us, %s controller, motion profile %s\n",
+           sim.controller().isHighRateControl() ? sim.controller().getControlPeriodUs()
+                                                  : MotorSensorController::LEGACY_CONTROL_PERIOD_US,
+           sim.controller().getControllerMode() != 0 ? "PID" : "legacy",
+           sim.controller().getMotionProfileEnabled() ? "on" : "off");
+
+    bool ok = true;
+    for (int i = 0; i < moveCount; i++) {
+        RotatorSim::StepResult az = sim.step(PlantSimulator::AXIS_AZ, moves[i][0], sim.controller().getMinAzTolerance(), 120);
+        RotatorSim::StepResult el = sim.step(PlantSimulator::AXIS_EL, moves[i][1], sim.controller().getMinElTolerance() * 2, 120);
+        printf("move %d: az %7.2f settled %s in %6.2f s (overshoot %.2f, error %+.3f)  "
+               "el %6.2f settled %s in %6.2f s (overshoot %.2f, error %+.3f)\n",
+               i + 1, moves[i][0], az.settled ? "yes" : "NO", az.settleTime, az.overshoot, az.finalError,
+               moves[i][1], el.settled ? "yes" : "NO", el.settleTime, el.overshoot, el.finalError);
+        ok = ok && az.settled && el.settled;
+    }
+
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    printf("simulated %.1f s (%u control ticks) in %.3f s wall clock, %.0fx real time\n",
+           sim.getElapsedSeconds(), sim.getControlTicks(), wallSeconds, sim.getElapsedSeconds() / wallSeconds);
+    printf("faults: %s\n", sim.controller().global_fault ? "TRIPPED" : "none");
+
+    return ok && !sim.controller().global_fault ? 0 : 1;
+}
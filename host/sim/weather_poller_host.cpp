@@ -0,0 +1,57 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Weather Poller (host) - The wind-safety queries used by the motor controller, with no weather data.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "weather_poller.h"
+
+// The real poller needs HTTPClient and ArduinoJson, which have no host equivalent here.
+// The simulation behaves like a unit whose weather polling has never succeeded: no wind
+// stow, no wind-based home, and the motor controller's wind paths stay idle.
+
+WeatherPoller::WeatherPoller(Preferences& prefs, Logger& logger)
+    : _preferences(prefs), _logger(logger) {
+}
+
+WeatherData WeatherPoller::getWeatherData() {
+    return WeatherData();
+}
+
+bool WeatherPoller::isDataValid() {
+    return false;
+}
+
+String WeatherPoller::getLastError() {
+    return "Weather polling is not available in the host build";
+}
+
+bool WeatherPoller::isWindBasedHomeEnabled() {
+    return false;
+}
+
+WindSafetyData WeatherPoller::getWindSafetyData() {
+    return WindSafetyData();
+}
+
+bool WeatherPoller::shouldActivateEmergencyStow() {
+    return false;
+}
+
+float WeatherPoller::calculateOptimalStowDirection(float windDirection) {
+    // Edge-on to the wind, as in the firmware
+    float direction = fmodf(windDirection + 90.0f, 360.0f);
+    return direction < 0 ? direction + 360.0f : direction;
+}
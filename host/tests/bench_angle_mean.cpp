@@ -0,0 +1,96 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Angle Mean Benchmark - Lookup-table circular mean against the libm version it replaced.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "motor_controller.h"
+#include "test_support.h"
+
+namespace {
+
+constexpr int COUNTS = 4096;
+constexpr int WINDOW = 10;
+constexpr int ROUNDS = 50;
+
+// The previous implementation: degrees in, per-sample sin/cos and pow, double atan2
+float legacyMean(const float* array, int size) {
+    float x[WINDOW], y[WINDOW];
+    for (int i = 0; i < size; i++) {
+        float angleRad = array[i] * PI / 180.0;
+        x[i] = cos(angleRad);
+        y[i] = sin(angleRad);
+    }
+    float xSum = 0, ySum = 0;
+    for (int i = 0; i < size; i++) {
+        xSum += x[i];
+        ySum += y[i];
+    }
+    float xMean = xSum / size;
+    float yMean = ySum / size;
+    float sumX = 0, sumY = 0;
+    for (int i = 0; i < size; i++) {
+        sumX += pow(x[i] - xMean, 2);
+        sumY += pow(y[i] - yMean, 2);
+    }
+    float stdDevX = sqrt(sumX / (size > 1 ? size - 1 : 1));
+    float stdDevY = sqrt(sumY / (size > 1 ? size - 1 : 1));
+    xSum = ySum = 0;
+    for (int i = 0; i < size; i++) {
+        if ((fabs(x[i] - xMean) <= 2.0 * stdDevX) && (fabs(y[i] - yMean) <= 2.0 * stdDevY)) {
+            xSum += x[i];
+            ySum += y[i];
+        }
+    }
+    return atan2(ySum, xSum) * 180.0 / PI;
+}
+
+} // namespace
+
+int main() {
+    // One window per count, a few counts of spread, as the sensor task sees them
+    static uint16_t counts[COUNTS][WINDOW];
+    static float degrees[COUNTS][WINDOW];
+    for (int c = 0; c < COUNTS; c++) {
+        for (int i = 0; i < WINDOW; i++) {
+            counts[c][i] = (c + (i * 7) % 5 - 2 + COUNTS) % COUNTS;
+            degrees[c][i] = counts[c][i] * 360.0f / COUNTS;
+        }
+    }
+
+    volatile float sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int c = 0; c < COUNTS; c++) {
+            sink = sink + legacyMean(degrees[c], WINDOW);
+        }
+    }
+    double legacyNs = secondsSince(start) * 1e9 / (ROUNDS * COUNTS);
+
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int c = 0; c < COUNTS; c++) {
+            sink = sink + MotorSensorController::calculateAngleMeanWithDiscard(counts[c], WINDOW);
+        }
+    }
+    double tableNs = secondsSince(start) * 1e9 / (ROUNDS * COUNTS);
+
+    printf("10-sample circular mean: libm %.0f ns, lookup table %.0f ns (%.1fx)\n",
+           legacyNs, tableNs, legacyNs / tableNs);
+
+    // Generous: this only guards against the table path regressing to libm cost
+    CHECK(tableNs < legacyNs);
+    return testResult();
+}
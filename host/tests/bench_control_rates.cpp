@@ -0,0 +1,143 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Control Rate Benchmark - Settle time of the simulated dish at each control loop rate.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rotator_sim.h"
+#include "test_support.h"
+
+// The same moves at the legacy 25 ms loop and at the timer-driven periods, with the legacy
+// controller so that only the rate changes. Settle time runs from the command until the
+// axis last entered its tolerance band and then held it for 2 s.
+
+namespace {
+
+const int PERIODS_US[] = {0, 5000, 2000, 1000};     // 0 is the legacy 25 ms loop
+
+struct Move {
+    PlantSimulator::Axis axis;
+    float target;
+    const char* name;
+};
+
+const Move MOVES[] = {
+    {PlantSimulator::AXIS_AZ, 5.0f, "az 5"},
+    {PlantSimulator::AXIS_AZ, 60.0f, "az 60"},
+    {PlantSimulator::AXIS_EL, 2.0f, "el 2"},
+    {PlantSimulator::AXIS_EL, 20.0f, "el 20"},
+};
+constexpr int MOVE_COUNT = sizeof(MOVES) / sizeof(MOVES[0]);
+
+constexpr int TRACK_SECONDS = 30;
+constexpr float TRACK_WARMUP_S = 5.0f;
+constexpr float TRACK_RATE_AZ = 2.0f;       // deg/s
+constexpr float TRACK_RATE_EL = 0.5f;
+
+RotatorSim::StepResult runMove(int periodUs, const Move& move) {
+    RotatorSim sim;
+    sim.preferences().putInt("ctrlPeriodUs", periodUs);
+    sim.begin();
+    sim.runFor(1.0f);
+
+    float band = (move.axis == PlantSimulator::AXIS_AZ) ? sim.controller().getMinAzTolerance()
+                                                        : sim.controller().getMinElTolerance() * 2;
+    RotatorSim::StepResult result = sim.step(move.axis, move.target, band, 60);
+    CHECK(!sim.controller().global_fault);
+    return result;
+}
+
+struct Tracking {
+    float rmsAz;
+    float rmsEl;
+};
+
+// A LEO-like pass segment: both axes moving, setpoints streamed at 10 Hz as a UDP client
+// would. Error is sampled every 5 ms once the axes have caught up. The azimuth band is
+// tightened from 1.5 degrees so the in-tolerance latch does not set the error on its own.
+Tracking runTracking(int periodUs, int mode) {
+    RotatorSim sim;
+    sim.preferences().putInt("ctrlPeriodUs", periodUs);
+    sim.preferences().putInt("ctrlMode", mode);
+    sim.preferences().putFloat("MIN_AZ_TOL", 0.2f);
+    sim.begin(20.0f, 10.0f);
+    sim.runFor(1.0f);
+
+    double sumAz = 0;
+    double sumEl = 0;
+    int samples = 0;
+    for (int i = 0; i < TRACK_SECONDS * 10; i++) {
+        float t = i * 0.1f;
+        float az = 20.0f + TRACK_RATE_AZ * t;
+        float el = 10.0f + TRACK_RATE_EL * t;
+        sim.controller().streamSetPoint(az, el, millis());
+        for (int j = 0; j < 20; j++) {
+            sim.runFor(0.005f);
+            if (t >= TRACK_WARMUP_S) {
+                float now = t + (j + 1) * 0.005f;
+                float errorAz = 20.0f + TRACK_RATE_AZ * now - sim.getTrueAngle(PlantSimulator::AXIS_AZ);
+                float errorEl = 10.0f + TRACK_RATE_EL * now - sim.getTrueAngle(PlantSimulator::AXIS_EL);
+                sumAz += errorAz * errorAz;
+                sumEl += errorEl * errorEl;
+                samples++;
+            }
+        }
+    }
+    CHECK(!sim.controller().global_fault);
+    return {(float)sqrt(sumAz / samples), (float)sqrt(sumEl / samples)};
+}
+
+} // namespace
+
+int main() {
+    float settle[4][MOVE_COUNT];
+
+    printf("settle time, s (overshoot, deg), legacy controller:\n");
+    printf("%-10s", "period");
+    for (const Move& move : MOVES) {
+        printf("%18s", move.name);
+    }
+    printf("\n");
+
+    for (int p = 0; p < 4; p++) {
+        printf("%-10s", PERIODS_US[p] == 0 ? "25000 us" : (String(PERIODS_US[p]) + " us").c_str());
+        for (int m = 0; m < MOVE_COUNT; m++) {
+            RotatorSim::StepResult result = runMove(PERIODS_US[p], MOVES[m]);
+            CHECK(result.settled);
+            settle[p][m] = result.settleTime;
+            printf("%10.2f (%5.2f)", result.settleTime, result.overshoot);
+        }
+        printf("\n");
+    }
+
+    // A faster loop must never settle a move more slowly than the 25 ms loop
+    for (int p = 1; p < 4; p++) {
+        for (int m = 0; m < MOVE_COUNT; m++) {
+            CHECK(settle[p][m] <= settle[0][m] + 0.1f);
+        }
+    }
+
+    printf("\nRMS tracking error, deg, %.1f deg/s az and %.1f deg/s el streamed at 10 Hz:\n",
+           TRACK_RATE_AZ, TRACK_RATE_EL);
+    printf("%-10s%18s%18s\n", "period", "legacy az / el", "PID az / el");
+    for (int p = 0; p < 4; p++) {
+        Tracking legacy = runTracking(PERIODS_US[p], 0);
+        Tracking pid = runTracking(PERIODS_US[p], 1);
+        printf("%-10s%9.3f /%6.3f%11.3f /%6.3f\n",
+               PERIODS_US[p] == 0 ? "25000 us" : (String(PERIODS_US[p]) + " us").c_str(),
+               legacy.rmsAz, legacy.rmsEl, pid.rmsAz, pid.rmsEl);
+    }
+    return testResult();
+}
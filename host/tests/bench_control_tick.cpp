@@ -0,0 +1,119 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Control Tick Benchmark - Time per control tick with blocking and task-based angle acquisition.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "host_hal.h"
+#include "rotator_sim.h"
+#include "test_support.h"
+
+// Before: every control tick called getAvgAngle() for each axis, which checked the magnet
+// and then made ten ReadRawAngle() transfers with a 100 us pause after each, all inside the
+// control task. After: the sensor task samples both axes and the control tick only reads
+// the filtered angle. Both run against the same simulated AS5600s on the 100 kHz bus, so
+// the virtual time inside the tick is the bus and delay time the control task spent blocked.
+
+namespace {
+
+constexpr int NUM_AVG = 10;
+constexpr uint16_t EL_SENSOR_ADDRESS = 0x36;
+constexpr uint16_t AZ_SENSOR_ADDRESS = 0x40;
+constexpr float CONTROL_PERIOD_MS = 25.0f;
+
+// The replaced acquisition, as it drove the bus
+int legacyCheckMagnet(uint16_t address) {
+    Wire.beginTransmission(address);
+    Wire.write(0x0B);
+    if (Wire.endTransmission() != 0) {
+        return -999;
+    }
+    Wire.requestFrom(address, (uint8_t)1);
+    return Wire.read();
+}
+
+bool legacyReadRawAngleCount(uint16_t address, uint16_t& rawCount) {
+    Wire.beginTransmission(address);
+    Wire.write(0x0C);
+    if (Wire.endTransmission(false) != 0) {
+        return false;
+    }
+    delayMicroseconds(25);
+    if (Wire.requestFrom(address, (uint8_t)2) != 2) {
+        return false;
+    }
+    uint8_t high = Wire.read();
+    uint8_t low = Wire.read();
+    rawCount = ((high << 8) | low) & 0x0FFF;
+    return true;
+}
+
+float legacyGetAvgAngle(uint16_t address) {
+    legacyCheckMagnet(address);
+
+    uint16_t counts[NUM_AVG];
+    int valid = 0;
+    for (int attempt = 0; attempt < NUM_AVG * 2 && valid < NUM_AVG; attempt++) {
+        uint16_t rawCount;
+        if (legacyReadRawAngleCount(address, rawCount)) {
+            counts[valid++] = rawCount;
+        }
+        delayMicroseconds(100);
+    }
+    return MotorSensorController::calculateAngleMeanWithDiscard(counts, valid);
+}
+
+} // namespace
+
+int main() {
+    RotatorSim sim;
+    sim.begin(30.0f, 20.0f);
+    sim.runFor(1.0f);
+
+    // Before: the acquisition the control tick used to do, measured on the same bus
+    constexpr int LEGACY_TICKS = 200;
+    uint64_t legacyStart = HostHal::nowMicros();
+    auto wallStart = std::chrono::steady_clock::now();
+    volatile float sink = 0;
+    for (int i = 0; i < LEGACY_TICKS; i++) {
+        sink = sink + legacyGetAvgAngle(AZ_SENSOR_ADDRESS) + legacyGetAvgAngle(EL_SENSOR_ADDRESS);
+    }
+    double legacyAcquireUs = (double)(HostHal::nowMicros() - legacyStart) / LEGACY_TICKS;
+    double legacyAcquireWallUs = secondsSince(wallStart) * 1e6 / LEGACY_TICKS;
+
+    // After: the control task as it runs now, through a move so every branch is exercised
+    sim.resetControlTiming();
+    sim.step(PlantSimulator::AXIS_AZ, 120.0f, sim.controller().getMinAzTolerance(), 60);
+    sim.step(PlantSimulator::AXIS_EL, 45.0f, sim.controller().getMinElTolerance() * 2, 60);
+    const RotatorSim::TaskTiming& timing = sim.getControlTiming();
+    double tickUs = (double)timing.busyMicros / timing.runs;
+    double tickWallUs = timing.wallSeconds * 1e6 / timing.runs;
+
+    // The rest of the tick did not change, so before = old acquisition + today's tick
+    double beforeUs = legacyAcquireUs + tickUs;
+    printf("control tick, blocked on bus and delays (virtual time, 100 kHz I2C):\n");
+    printf("  before  %8.0f us  (%.0f%% of the %.0f ms period)\n", beforeUs,
+           beforeUs / (CONTROL_PERIOD_MS * 10.0f), CONTROL_PERIOD_MS);
+    printf("  after   %8.0f us  (max %llu us over %u ticks)\n", tickUs,
+           (unsigned long long)timing.maxBusyMicros, timing.runs);
+    printf("control tick, host CPU:\n");
+    printf("  before  %8.2f us\n", legacyAcquireWallUs + tickWallUs);
+    printf("  after   %8.2f us\n", tickWallUs);
+
+    CHECK(legacyAcquireUs > 10000);     // Two axes x ten transfers cost over 10 ms
+    CHECK(timing.maxBusyMicros < 1000); // The control tick no longer waits on the bus
+    CHECK(!sim.controller().global_fault);
+    return testResult();
+}
@@ -0,0 +1,124 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Logging Benchmark - Control tick time recovered by checking the log level before building messages.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rotator_sim.h"
+#include "test_support.h"
+
+// Before: every log call built its String at the call site and logMessage() dropped it
+// when the level was filtered. After: LOGx checks the level first and builds nothing.
+//
+// The same scenario runs at the default ERROR level and at VERBOSE. At VERBOSE every
+// filtered-out call becomes a record, which counts the messages the control task used to
+// build and throw away at ERROR. Their cost is the measured price of building one such
+// message and handing it to a filtered logMessage().
+
+namespace {
+
+constexpr int CALLS = 200000;
+
+struct Run {
+    double tickUs;              // Host CPU per control tick
+    double recordsPerTick;      // Log records per control tick, from every simulated task
+};
+
+// Slews, a streamed pass and a hold: every branch of the control tick the UI exercises
+Run runScenario(int level) {
+    RotatorSim sim;
+    sim.begin(30.0f, 20.0f);
+    sim.logger().setSerialOutputDisabled(true);
+    sim.logger().setDebugLevel(level);
+    sim.runFor(1.0f);
+
+    uint32_t cursor = 0;
+    Logger::LogEntry entry;
+    while (sim.logger().readEntry(cursor, entry)) {
+    }
+
+    sim.resetControlTiming();
+    uint64_t records = 0;
+    auto drain = [&]() {
+        while (sim.logger().readEntry(cursor, entry)) {
+            records++;
+        }
+    };
+
+    sim.step(PlantSimulator::AXIS_AZ, 120.0f, sim.controller().getMinAzTolerance(), 60);
+    drain();
+    sim.step(PlantSimulator::AXIS_EL, 45.0f, sim.controller().getMinElTolerance() * 2, 60);
+    drain();
+    for (int i = 0; i < 200; i++) {
+        sim.controller().streamSetPoint(120.0f + i * 0.2f, 45.0f - i * 0.05f, millis());
+        sim.runFor(0.1f);
+        drain();
+    }
+    for (int i = 0; i < 10; i++) {
+        sim.runFor(1.0f);
+        drain();
+    }
+    CHECK(!sim.controller().global_fault);
+
+    const RotatorSim::TaskTiming& timing = sim.getControlTiming();
+    return {timing.wallSeconds * 1e6 / timing.runs, (double)records / timing.runs};
+}
+
+// One representative message from the control path, the way each call site used to run
+double filteredMessageUs(Logger& logger, bool checkFirst) {
+    volatile float recentAvg = 1.234f;
+    volatile float olderAvg = 0.987f;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < CALLS; i++) {
+        if (checkFirst) {
+            LOGD(logger, "Divergence detected - Recent avg: " + String(recentAvg, 3) +
+                         ", Older avg: " + String(olderAvg, 3));
+        } else {
+            logger.debug("Divergence detected - Recent avg: " + String(recentAvg, 3) +
+                         ", Older avg: " + String(olderAvg, 3));
+        }
+    }
+    return secondsSince(start) * 1e6 / CALLS;
+}
+
+} // namespace
+
+int main() {
+    Preferences preferences;
+    Logger logger(preferences);
+    logger.begin();
+    logger.setSerialOutputDisabled(true);
+    logger.setDebugLevel(LOG_ERROR);
+
+    double builtUs = filteredMessageUs(logger, false);
+    double skippedUs = filteredMessageUs(logger, true);
+    printf("filtered debug call, host CPU:\n");
+    printf("  before (message built, then dropped)  %8.4f us\n", builtUs);
+    printf("  after  (level checked first)          %8.4f us\n", skippedUs);
+
+    Run quiet = runScenario(LOG_ERROR);
+    Run verbose = runScenario(LOG_VERBOSE);
+    double recoveredUs = verbose.recordsPerTick * (builtUs - skippedUs);
+    printf("control tick at ERROR, host CPU:\n");
+    printf("  messages below ERROR per tick          %8.3f\n", verbose.recordsPerTick);
+    printf("  before                                 %8.3f us\n", quiet.tickUs + recoveredUs);
+    printf("  after                                  %8.3f us  (%.1f%% recovered)\n", quiet.tickUs,
+           100.0 * recoveredUs / (quiet.tickUs + recoveredUs));
+    printf("control tick at VERBOSE, host CPU        %8.3f us\n", verbose.tickUs);
+
+    CHECK(skippedUs < builtUs);
+    CHECK(quiet.recordsPerTick == 0);
+    return testResult();
+}
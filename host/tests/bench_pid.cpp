@@ -0,0 +1,114 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * PID Benchmark - Settle time and overshoot of the PID controller against the legacy P controller.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rotator_sim.h"
+#include "test_support.h"
+
+// Step moves on a fresh simulated dish for each controller configuration. Settle time runs
+// from the command until the axis last entered its band and then held it for 2 s; the
+// overshoot is the furthest the axis went past the target.
+
+namespace {
+
+struct Config {
+    const char* name;
+    int mode;                   // ctrlMode: 0 legacy, 1 PID
+    int periodUs;               // ctrlPeriodUs: 0 is the 25 ms loop
+    bool profile;
+    float kd;                   // Kd for both axes; 0 leaves the default
+};
+
+const Config CONFIGS[] = {
+    {"legacy P", 0, 0, false, 0},
+    {"PID", 1, 0, false, 0},
+    {"PID + Kd", 1, 0, false, 2.0f},
+    {"PID + profile", 1, 0, true, 0},
+    {"PID 2 ms + profile", 1, 2000, true, 0},
+};
+constexpr int CONFIG_COUNT = sizeof(CONFIGS) / sizeof(CONFIGS[0]);
+
+struct Move {
+    PlantSimulator::Axis axis;
+    float target;
+    const char* name;
+};
+
+const Move MOVES[] = {
+    {PlantSimulator::AXIS_AZ, 5.0f, "az 5"},
+    {PlantSimulator::AXIS_AZ, 90.0f, "az 90"},
+    {PlantSimulator::AXIS_EL, 2.0f, "el 2"},
+    {PlantSimulator::AXIS_EL, 30.0f, "el 30"},
+};
+constexpr int MOVE_COUNT = sizeof(MOVES) / sizeof(MOVES[0]);
+
+RotatorSim::StepResult runMove(const Config& config, const Move& move) {
+    RotatorSim sim;
+    sim.preferences().putInt("ctrlMode", config.mode);
+    sim.preferences().putInt("ctrlPeriodUs", config.periodUs);
+    sim.preferences().putBool("motionProfile", config.profile);
+    sim.begin();
+    if (config.kd != 0) {
+        sim.controller().setKdAz(config.kd);
+        sim.controller().setKdEl(config.kd);
+    }
+    sim.runFor(1.0f);
+
+    float band = (move.axis == PlantSimulator::AXIS_AZ) ? sim.controller().getMinAzTolerance()
+                                                        : sim.controller().getMinElTolerance() * 2;
+    RotatorSim::StepResult result = sim.step(move.axis, move.target, band, 90);
+    CHECK(!sim.controller().global_fault);
+    return result;
+}
+
+} // namespace
+
+int main() {
+    RotatorSim::StepResult results[CONFIG_COUNT][MOVE_COUNT];
+
+    printf("settle time, s (overshoot, deg):\n");
+    printf("%-20s", "controller");
+    for (const Move& move : MOVES) {
+        printf("%16s", move.name);
+    }
+    printf("\n");
+
+    for (int c = 0; c < CONFIG_COUNT; c++) {
+        printf("%-20s", CONFIGS[c].name);
+        for (int m = 0; m < MOVE_COUNT; m++) {
+            results[c][m] = runMove(CONFIGS[c], MOVES[m]);
+            CHECK(results[c][m].settled);
+            printf("%8.2f (%5.2f)", results[c][m].settleTime, results[c][m].overshoot);
+        }
+        printf("\n");
+    }
+
+    // Without a profile the PID does no worse than the P controller it replaces
+    for (int c = 1; c <= 2; c++) {
+        for (int m = 0; m < MOVE_COUNT; m++) {
+            CHECK(results[c][m].overshoot <= results[0][m].overshoot + 0.05f);
+        }
+    }
+
+    // Profiled slews end inside two tolerance bands. The feed-forward used to lag the
+    // profile by a second and carried azimuth 6.5 degrees past the target.
+    for (int c = 3; c < CONFIG_COUNT; c++) {
+        CHECK(results[c][1].overshoot < 3.0f);
+        CHECK(results[c][3].overshoot < 0.5f);
+    }
+    return testResult();
+}
@@ -0,0 +1,172 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Telemetry Benchmark - Seqlock snapshot against the per-field mutexes it replaced, under contention.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rotator_sim.h"
+#include "test_support.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+// One writer runs the real control tick back to back, as fast as it can, while reader
+// threads take snapshots the way /variable, rotctl and the serial STATUS command do.
+//
+// Before: five mutexes guarded setpoints, corrected angles, errors, the elevation tare and
+// the offsets. The control tick took one per field it touched and a reader took one per
+// getter, nine of each. That locking is replayed here around the same control tick.
+// After: getTelemetry(), one lock-free copy.
+
+namespace {
+
+constexpr int READERS = 3;
+constexpr double RUN_SECONDS = 0.5;
+constexpr int FIELDS = 9;
+
+struct RunResult {
+    uint64_t snapshots;
+    double tickP50Us;
+    double tickP99Us;
+    double tickMaxUs;
+};
+
+struct LegacyLocks {
+    SemaphoreHandle_t mutex[5];
+    float field[FIELDS] = {};
+
+    LegacyLocks() {
+        for (SemaphoreHandle_t& m : mutex) {
+            m = xSemaphoreCreateMutex();
+        }
+    }
+
+    ~LegacyLocks() {
+        for (SemaphoreHandle_t m : mutex) {
+            vSemaphoreDelete(m);
+        }
+    }
+
+    // Field i lives under mutex i / 2, as setpoint, angle and error pairs did
+    float get(int i) {
+        float value = 0;
+        if (xSemaphoreTake(mutex[min(i / 2, 4)], portMAX_DELAY) == pdTRUE) {
+            value = field[i];
+            xSemaphoreGive(mutex[min(i / 2, 4)]);
+        }
+        return value;
+    }
+
+    void set(int i, float value) {
+        if (xSemaphoreTake(mutex[min(i / 2, 4)], portMAX_DELAY) == pdTRUE) {
+            field[i] = value;
+            xSemaphoreGive(mutex[min(i / 2, 4)]);
+        }
+    }
+};
+
+template <typename Tick, typename Read>
+RunResult run(Tick tick, Read read) {
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> snapshots{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < READERS; r++) {
+        readers.emplace_back([&]() {
+            uint64_t count = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                read();
+                count++;
+            }
+            snapshots += count;
+        });
+    }
+
+    std::vector<double> ticks;
+    auto runStart = std::chrono::steady_clock::now();
+    while (secondsSince(runStart) < RUN_SECONDS) {
+        auto start = std::chrono::steady_clock::now();
+        tick();
+        ticks.push_back(secondsSince(start) * 1e6);
+    }
+    stop = true;
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+
+    std::sort(ticks.begin(), ticks.end());
+    RunResult result;
+    result.snapshots = snapshots;
+    result.tickP50Us = ticks[ticks.size() / 2];
+    result.tickP99Us = ticks[ticks.size() * 99 / 100];
+    result.tickMaxUs = ticks.back();
+    return result;
+}
+
+void print(const char* name, const RunResult& result) {
+    printf("  %-8s %10.0f snapshots/s   tick p50 %6.2f us  p99 %6.2f us  max %8.1f us\n",
+           name, result.snapshots / RUN_SECONDS,
+           result.tickP50Us, result.tickP99Us, result.tickMaxUs);
+}
+
+} // namespace
+
+int main() {
+    RotatorSim sim;
+    sim.begin(30.0f, 20.0f);
+    sim.runFor(1.0f);
+    sim.controller().setSetPointAz(90.0f);
+    sim.runFor(0.1f);
+
+    MotorSensorController& controller = sim.controller();
+    LegacyLocks legacy;
+
+    RunResult before = run(
+        [&]() {
+            for (int i = 0; i < FIELDS; i++) {
+                legacy.set(i, legacy.get(i) + 1.0f);
+            }
+            controller.runControlLoop();
+        },
+        [&]() {
+            volatile float sink = 0;
+            for (int i = 0; i < FIELDS; i++) {
+                sink = sink + legacy.get(i);
+            }
+        });
+
+    uint32_t readsBefore = controller.getTelemetryReads();
+    uint32_t retriesBefore = controller.getTelemetryRetries();
+    RunResult after = run(
+        [&]() { controller.runControlLoop(); },
+        [&]() {
+            volatile float sink = controller.getTelemetry().correctedAngle_az;
+            (void)sink;
+        });
+    uint32_t reads = controller.getTelemetryReads() - readsBefore;
+    uint32_t retries = controller.getTelemetryRetries() - retriesBefore;
+
+    printf("%d readers against a control tick running back to back, %u hardware threads:\n",
+           READERS, std::thread::hardware_concurrency());
+    print("mutexes", before);
+    print("seqlock", after);
+    printf("  seqlock retries: %u in %u reads (%.3f%%)\n", retries, reads, 100.0 * retries / max(reads, 1u));
+
+    CHECK(after.snapshots > 0);
+    CHECK(reads == after.snapshots);
+    CHECK(!controller.global_fault);
+    return testResult();
+}
@@ -0,0 +1,146 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Angle Mean Tests - The lookup-table circular mean agrees with libm over every raw count.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "motor_controller.h"
+#include "test_support.h"
+
+#include <random>
+
+namespace {
+
+constexpr int COUNTS = 4096;
+constexpr int WINDOW = 10;                      // MotorSensorController::_numAvg
+constexpr double MAX_ERROR_DEG = 1e-4;          // ~0.001 counts; float rounding only
+
+// The same algorithm in double precision with libm sin/cos/atan2
+double referenceMean(const uint16_t* counts, int size) {
+    double x[WINDOW];
+    double y[WINDOW];
+    double xSum = 0;
+    double ySum = 0;
+    for (int i = 0; i < size; i++) {
+        double angle = counts[i] * 2.0 * M_PI / COUNTS;
+        x[i] = cos(angle);
+        y[i] = sin(angle);
+        xSum += x[i];
+        ySum += y[i];
+    }
+    double xMean = xSum / size;
+    double yMean = ySum / size;
+    double xVar = 0;
+    double yVar = 0;
+    for (int i = 0; i < size; i++) {
+        xVar += (x[i] - xMean) * (x[i] - xMean);
+        yVar += (y[i] - yMean) * (y[i] - yMean);
+    }
+    double stdDevX = sqrt(xVar / (size > 1 ? size - 1 : 1));
+    double stdDevY = sqrt(yVar / (size > 1 ? size - 1 : 1));
+
+    double keptX = 0;
+    double keptY = 0;
+    int kept = 0;
+    for (int i = 0; i < size; i++) {
+        if (fabs(x[i] - xMean) <= 2.0 * stdDevX && fabs(y[i] - yMean) <= 2.0 * stdDevY) {
+            keptX += x[i];
+            keptY += y[i];
+            kept++;
+        }
+    }
+    if (kept == 0) {
+        keptX = xSum;
+        keptY = ySum;
+    }
+    return atan2(keptY, keptX) * 180.0 / M_PI;
+}
+
+double angleDifference(double a, double b) {
+    double difference = fmod(a - b, 360.0);
+    if (difference > 180.0) {
+        difference -= 360.0;
+    } else if (difference < -180.0) {
+        difference += 360.0;
+    }
+    return fabs(difference);
+}
+
+// A stationary sensor: every sample in the window is the same count
+void testConstantWindowEveryCount() {
+    double maxError = 0;
+    int worstCount = 0;
+    for (int count = 0; count < COUNTS; count++) {
+        uint16_t window[WINDOW];
+        for (int i = 0; i < WINDOW; i++) {
+            window[i] = count;
+        }
+        double error = angleDifference(MotorSensorController::calculateAngleMeanWithDiscard(window, WINDOW),
+                                       referenceMean(window, WINDOW));
+        if (error > maxError) {
+            maxError = error;
+            worstCount = count;
+        }
+    }
+    printf("constant windows: max error %.3g deg at count %d\n", maxError, worstCount);
+    CHECK(maxError <= MAX_ERROR_DEG);
+}
+
+// Sensor noise of a few counts plus an occasional glitch, centred on every count so the
+// windows straddle the 0/4095 wrap as well. Outlier rejection has to make the same calls as
+// the double-precision reference, or the mean moves by a sizeable fraction of a count.
+void testNoisyWindowEveryCount() {
+    std::mt19937 rng(4096);
+    std::uniform_int_distribution<int> noise(-3, 3);
+    std::uniform_int_distribution<int> glitch(0, COUNTS - 1);
+
+    double maxError = 0;
+    int worstCount = 0;
+    for (int count = 0; count < COUNTS; count++) {
+        uint16_t window[WINDOW];
+        for (int i = 0; i < WINDOW; i++) {
+            window[i] = (count + noise(rng) + COUNTS) % COUNTS;
+        }
+        if (count % 4 == 0) {
+            window[count % WINDOW] = glitch(rng);
+        }
+        double error = angleDifference(MotorSensorController::calculateAngleMeanWithDiscard(window, WINDOW),
+                                       referenceMean(window, WINDOW));
+        if (error > maxError) {
+            maxError = error;
+            worstCount = count;
+        }
+    }
+    printf("noisy windows: max error %.3g deg at count %d\n", maxError, worstCount);
+    CHECK(maxError <= MAX_ERROR_DEG);
+}
+
+// A partly filled window, as right after boot
+void testShortWindows() {
+    uint16_t window[WINDOW] = {4090, 4095, 2, 6, 1};
+    for (int size = 1; size <= 5; size++) {
+        CHECK(angleDifference(MotorSensorController::calculateAngleMeanWithDiscard(window, size),
+                              referenceMean(window, size)) <= MAX_ERROR_DEG);
+    }
+}
+
+} // namespace
+
+int main() {
+    testConstantWindowEveryCount();
+    testNoisyWindowEveryCount();
+    testShortWindows();
+    return testResult();
+}
@@ -0,0 +1,173 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Logger Tests - Ring draining after writers lap a reader, and fault reports that outgrow a record.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rotator_sim.h"
+#include "test_support.h"
+
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int RING_SIZE = 128;      // Logger::RING_SIZE
+
+// A reader that fell more than a ring behind resumes at the oldest record still present
+void testReaderSkipsLappedRecords() {
+    Preferences preferences;
+    Logger logger(preferences);
+    logger.begin();
+    logger.setSerialOutputDisabled(true);
+    logger.attachDrainTask(xTaskGetCurrentTaskHandle());
+
+    uint32_t cursor = 0;
+    Logger::LogEntry entry;
+    while (logger.readEntry(cursor, entry)) {
+    }
+
+    const int written = RING_SIZE * 3 + 5;
+    for (int i = 0; i < written; i++) {
+        LOGE(logger, String(i));
+    }
+
+    uint32_t dropped = logger.getDroppedCount();
+    int expected = written - RING_SIZE;
+    int read = 0;
+    while (logger.readEntry(cursor, entry)) {
+        CHECK(atoi(entry.message) == expected);
+        expected++;
+        read++;
+    }
+    CHECK(read == RING_SIZE);
+    CHECK(logger.getDroppedCount() - dropped == (uint32_t)(written - RING_SIZE));
+}
+
+// Writers lap the reader while it drains, and a writer preempted between claiming a slot
+// and publishing it holds that slot while the others come round the ring. Neither may hold
+// the reader back: after each burst it must reach the final record. It must see each
+// writer's records in order, and never a record mixed from two writes to the same slot.
+void testReaderKeepsUpWithLappingWriters() {
+    Preferences preferences;
+    Logger logger(preferences);
+    logger.begin();
+    logger.setSerialOutputDisabled(true);
+    logger.attachDrainTask(xTaskGetCurrentTaskHandle());
+
+    constexpr int WRITERS = 8;          // More than the cores, so writers get preempted mid-record
+    constexpr int PER_WRITER = 2000;
+    constexpr int BURSTS = 100;
+
+    uint32_t cursor = 0;
+    Logger::LogEntry entry;
+    uint64_t read = 0;
+    int missedEnd = 0;
+    bool ordered = true;
+    bool intact = true;
+
+    for (int burst = 0; burst < BURSTS; burst++) {
+        std::atomic<int> running{WRITERS};
+        std::vector<std::thread> writers;
+        for (int w = 0; w < WRITERS; w++) {
+            writers.emplace_back([&logger, &running, w]() {
+                for (int i = 0; i < PER_WRITER; i++) {
+                    // Padded with a letter that depends on both numbers, so a torn copy shows
+                    char message[Logger::MESSAGE_SIZE];
+                    int length = snprintf(message, sizeof(message), "%d %d ", w, i);
+                    memset(message + length, 'a' + (w + i) % 26, sizeof(message) - 1 - length);
+                    message[sizeof(message) - 1] = '\0';
+                    LOGE(logger, message);
+                }
+                running--;
+            });
+        }
+
+        int last[WRITERS];
+        for (int& value : last) {
+            value = -1;
+        }
+        while (running > 0) {
+            while (logger.readEntry(cursor, entry)) {
+                int w = 0;
+                int i = 0;
+                int length = 0;
+                if (sscanf(entry.message, "%d %d %n", &w, &i, &length) == 2 && w >= 0 && w < WRITERS) {
+                    ordered = ordered && i > last[w];
+                    last[w] = i;
+                    for (const char* c = entry.message + length; *c != '\0'; c++) {
+                        intact = intact && *c == 'a' + (w + i) % 26;
+                    }
+                    intact = intact && strlen(entry.message) == Logger::MESSAGE_SIZE - 1;
+                }
+                read++;
+            }
+        }
+        for (std::thread& writer : writers) {
+            writer.join();
+        }
+
+        LOGE(logger, "end");
+        bool sawEnd = false;
+        while (logger.readEntry(cursor, entry)) {
+            sawEnd = strcmp(entry.message, "end") == 0;
+        }
+        if (!sawEnd) {
+            missedEnd++;
+        }
+    }
+
+    printf("lapping writers: %llu of %d records read, %u dropped, %d of %d bursts stalled\n",
+           (unsigned long long)read, BURSTS * WRITERS * PER_WRITER, logger.getDroppedCount(),
+           missedEnd, BURSTS);
+    CHECK(ordered);
+    CHECK(intact);
+    CHECK(missedEnd == 0);
+}
+
+// The safety loop's fault report runs to several lines; each is its own record so none is cut
+void testFaultReportIsLoggedLineByLine() {
+    RotatorSim sim;
+    sim.begin();
+    sim.runFor(0.5f);
+
+    uint32_t cursor = 0;
+    Logger::LogEntry entry;
+    while (sim.logger().readEntry(cursor, entry)) {
+    }
+
+    sim.plant().setMagnetStatus(PlantSimulator::AXIS_EL, 0);
+    sim.runFor(1.0f);
+    CHECK(sim.controller().global_fault);
+
+    bool sawMagnet = false;
+    bool sawStop = false;
+    while (sim.logger().readEntry(cursor, entry)) {
+        CHECK(strchr(entry.message, '\n') == nullptr);
+        sawMagnet = sawMagnet || strcmp(entry.message, "MAGNET NOT DETECTED.") == 0;
+        sawStop = sawStop || strcmp(entry.message, "EMERGENCY ALL STOP. RESTART ESP32 TO CLEAR FAULTS.") == 0;
+    }
+    CHECK(sawMagnet);
+    CHECK(sawStop);
+}
+
+} // namespace
+
+int main() {
+    testReaderSkipsLappedRecords();
+    testReaderKeepsUpWithLappingWriters();
+    testFaultReportIsLoggedLineByLine();
+    return testResult();
+}
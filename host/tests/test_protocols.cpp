@@ -0,0 +1,307 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Protocol Tests - rotctl and UDP control over real loopback sockets.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "host_hal.h"
+#include "rotator_sim.h"
+#include "rotctl_wifi.h"
+#include "serial_manager.h"
+#include "test_support.h"
+#include "udp_control.h"
+
+#include <algorithm>
+#include <poll.h>
+#include <string>
+#include <unistd.h>
+
+// The servers run their loops on the test thread, exactly as their tasks call them; the
+// sockets are real, so each loop pass returns as soon as the client's bytes are readable.
+
+namespace {
+
+constexpr int LOOP_PASSES = 8;
+
+int testPort(int offset) {
+    return 20000 + (getpid() % 20000) + offset;
+}
+
+sockaddr_in loopback(int port) {
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return addr;
+}
+
+bool readable(int fd, int timeoutMs) {
+    pollfd pfd = {fd, POLLIN, 0};
+    return poll(&pfd, 1, timeoutMs) > 0;
+}
+
+// =============================================================================
+// ROTCTL
+// =============================================================================
+
+int connectRotctl(RotctlWifi& rotctl, int port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr = loopback(port);
+    if (connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    rotctl.rotctlWifiLoop(false, false, false);  // Accept
+    return fd;
+}
+
+// Send one or more command lines and collect replies until `lines` newlines have arrived
+std::string rotctlExchange(RotctlWifi& rotctl, int fd, const char* commands, int lines) {
+    send(fd, commands, strlen(commands), 0);
+    std::string reply;
+    for (int pass = 0; pass < LOOP_PASSES; pass++) {
+        rotctl.rotctlWifiLoop(false, false, false);
+        while (readable(fd, 10)) {
+            char buffer[256];
+            int received = recv(fd, buffer, sizeof(buffer), 0);
+            if (received <= 0) {
+                return reply;
+            }
+            reply.append(buffer, received);
+        }
+        if (std::count(reply.begin(), reply.end(), '\n') >= lines) {
+            break;
+        }
+    }
+    return reply;
+}
+
+void testRotctlPipelinedCommandsAndControl() {
+    RotatorSim sim;
+    int port = testPort(0);
+    sim.preferences().putInt("rotctl_port", port);
+    sim.begin();
+    sim.runFor(0.5f);
+
+    RotctlWifi rotctl(sim.preferences(), sim.controller(), sim.logger());
+    rotctl.begin();
+
+    int controller = connectRotctl(rotctl, port);
+    int observer = connectRotctl(rotctl, port);
+    CHECK(controller >= 0 && observer >= 0);
+    CHECK(rotctl.getClientCount() == 2);
+
+    // Pipelined in one segment: both commands are answered in one reply write
+    std::string reply = rotctlExchange(rotctl, controller, "P 40.0 15.0\np\n", 3);
+    CHECK(reply.rfind("RPRT 0\n", 0) == 0);
+    CHECK(std::count(reply.begin(), reply.end(), '\n') == 3);
+    CHECK(rotctl.getRotctlClientIP() == "127.0.0.1");
+
+    // The second client may poll but not move the dish
+    CHECK(rotctlExchange(rotctl, observer, "P 100 10\n", 1) == "RPRT -9\n");
+    std::string observed = rotctlExchange(rotctl, observer, "p\n", 2);
+    CHECK(std::count(observed.begin(), observed.end(), '\n') == 2);
+    CHECK(rotctl.getTotalRejected() == 1);
+
+    // The streamed setpoint moves the dish
+    sim.runFor(20.0f);
+    CHECK_NEAR(sim.getTrueAngle(PlantSimulator::AXIS_AZ), 40.0, 2.0);
+    CHECK_NEAR(sim.getTrueAngle(PlantSimulator::AXIS_EL), 15.0, 1.0);
+
+    std::string position = rotctlExchange(rotctl, controller, "p\n", 2);
+    float az = 0;
+    float el = 0;
+    CHECK(sscanf(position.c_str(), "%f\n%f\n", &az, &el) == 2);
+    CHECK_NEAR(az, sim.getTrueAngle(PlantSimulator::AXIS_AZ), 0.5);
+
+    // A serial session takes precedence and releases the rotctl controller
+    rotctl.rotctlWifiLoop(true, false, false);
+    CHECK(rotctl.getRotctlClientIP() == "NO ROTCTL CONNECTION");
+    CHECK(rotctl.isRotctlConnected());
+
+    RotctlWifi::LatencyStats latency = rotctl.getLatencyStats();
+    CHECK(latency.count >= 4);
+
+    close(controller);
+    close(observer);
+    rotctl.rotctlWifiLoop(false, false, false);
+    CHECK(rotctl.getClientCount() == 0);
+}
+
+// =============================================================================
+// UDP CONTROL
+// =============================================================================
+
+struct UdpReply {
+    bool received;
+    UdpControl::Header header;
+    UdpControl::Telemetry telemetry;
+};
+
+UdpReply udpExchange(UdpControl& udp, int fd, int port, const void* packet, size_t length) {
+    sockaddr_in addr = loopback(port);
+    sendto(fd, packet, length, 0, (sockaddr*)&addr, sizeof(addr));
+
+    UdpReply reply = {};
+    for (int pass = 0; pass < LOOP_PASSES && !reply.received; pass++) {
+        udp.runUdpControlLoop(true);
+        if (readable(fd, 10)) {
+            uint8_t buffer[128];
+            int received = recv(fd, buffer, sizeof(buffer), 0);
+            if (received == (int)(sizeof(UdpControl::Header) + sizeof(UdpControl::Telemetry))) {
+                memcpy(&reply.header, buffer, sizeof(reply.header));
+                memcpy(&reply.telemetry, buffer + sizeof(reply.header), sizeof(reply.telemetry));
+                reply.received = true;
+            }
+        }
+    }
+    return reply;
+}
+
+UdpControl::Header udpHeader(uint8_t type, uint32_t sequence) {
+    UdpControl::Header header = {};
+    header.magic = UdpControl::MAGIC;
+    header.version = UdpControl::PROTOCOL_VERSION;
+    header.type = type;
+    header.sequence = sequence;
+    header.timestampUs = sequence * 1000;
+    return header;
+}
+
+UdpReply udpSetpoints(UdpControl& udp, int fd, int port, uint32_t sequence, float az, float el) {
+    struct __attribute__((packed)) {
+        UdpControl::Header header;
+        UdpControl::SetpointBatch batch;
+        UdpControl::Setpoint points[2];
+    } packet = {};
+    packet.header = udpHeader(UdpControl::PACKET_SETPOINTS, sequence);
+    packet.batch.count = 2;
+    packet.points[0] = {0, az, el};
+    packet.points[1] = {100, az, el};
+    return udpExchange(udp, fd, port, &packet, sizeof(packet));
+}
+
+void testUdpControlRoundTrip() {
+    RotatorSim sim;
+    int port = testPort(1);
+    sim.preferences().putInt("udpCtlPort", port);
+    sim.begin();
+    sim.runFor(0.5f);
+
+    UdpControl udp(sim.preferences(), sim.controller(), sim.ina219(), sim.logger());
+    udp.begin();
+
+    int client = socket(AF_INET, SOCK_DGRAM, 0);
+    int other = socket(AF_INET, SOCK_DGRAM, 0);
+
+    // A poll is answered with telemetry echoing the request's sequence and timestamp
+    UdpControl::Header poll = udpHeader(UdpControl::PACKET_POLL, 7);
+    UdpReply reply = udpExchange(udp, client, port, &poll, sizeof(poll));
+    CHECK(reply.received);
+    CHECK(reply.header.type == UdpControl::PACKET_TELEMETRY);
+    CHECK(reply.header.sequence == 7);
+    CHECK(reply.header.timestampUs == 7000);
+    CHECK(!udp.isControlling());
+
+    // The first sender of setpoints takes control
+    reply = udpSetpoints(udp, client, port, 10, 30.0f, 10.0f);
+    CHECK(reply.received);
+    CHECK(reply.telemetry.accepted == 2);
+    CHECK(reply.telemetry.status & UdpControl::STATUS_CONTROLLER);
+    CHECK(udp.isControlling());
+
+    // Another sender is refused, and an old sequence from the controller is stale
+    reply = udpSetpoints(udp, other, port, 1, 200.0f, 40.0f);
+    CHECK(reply.telemetry.status & UdpControl::STATUS_REJECTED);
+    CHECK(reply.telemetry.accepted == 0);
+    reply = udpSetpoints(udp, client, port, 9, 200.0f, 40.0f);
+    CHECK(reply.telemetry.status & UdpControl::STATUS_STALE);
+
+    // A skipped sequence is counted as loss
+    reply = udpSetpoints(udp, client, port, 13, 30.0f, 10.0f);
+    CHECK(reply.telemetry.accepted == 2);
+    CHECK(udp.getPacketsLost() == 2);
+
+    sim.runFor(15.0f);
+    CHECK_NEAR(sim.getTrueAngle(PlantSimulator::AXIS_AZ), 30.0, 2.0);
+    CHECK_NEAR(sim.getTrueAngle(PlantSimulator::AXIS_EL), 10.0, 1.0);
+
+    // Malformed packets get no reply and are not counted as received: junk, a batch cut
+    // short of its count, and a batch with an infinite azimuth
+    uint32_t received = udp.getPacketsReceived();
+    uint8_t junk[5] = {1, 2, 3, 4, 5};
+    CHECK(!udpExchange(udp, client, port, junk, sizeof(junk)).received);
+    struct __attribute__((packed)) {
+        UdpControl::Header header;
+        UdpControl::SetpointBatch batch;
+        UdpControl::Setpoint points[2];
+    } packet = {};
+    packet.header = udpHeader(UdpControl::PACKET_SETPOINTS, 14);
+    packet.batch.count = 2;
+    packet.points[0] = {0, 30.0f, 10.0f};
+    packet.points[1] = {100, 30.0f, 10.0f};
+    CHECK(!udpExchange(udp, client, port, &packet, sizeof(packet) - 1).received);
+    packet.points[1].az = INFINITY;
+    CHECK(!udpExchange(udp, client, port, &packet, sizeof(packet)).received);
+    CHECK(udp.getPacketsMalformed() == 3);
+    CHECK(udp.getPacketsReceived() == received);
+    CHECK(udp.getSetpointsApplied() == 4);
+
+    close(client);
+    close(other);
+}
+
+// =============================================================================
+// SERIAL
+// =============================================================================
+
+// A reply that waits for room in the driver goes out whole; a log line printed meanwhile
+// lands before or after it, never inside it
+void testSerialReplyIsNotSplitByLog() {
+    RotatorSim sim;
+    sim.begin(30.0f, 20.0f);
+    sim.runFor(0.5f);
+
+    SerialManager serial(sim.preferences(), sim.controller(), sim.logger());
+    serial.begin();
+    HostHal::takeSerialOutput();
+
+    HostHal::setSerialTxSpace(8);
+    HostHal::injectSerial("AZ EL\n", 6);
+    serial.runSerialLoop();
+    LOGE(sim.logger(), "logged while the reply waits");
+    HostHal::setSerialTxSpace(256);
+    serial.runSerialLoop();
+
+    std::string output = HostHal::takeSerialOutput();
+    size_t reply = output.find("AZ");
+    CHECK(reply != std::string::npos);
+    std::string line = output.substr(reply, output.find('\n', reply) + 1 - reply);
+    float az = 0;
+    float el = 0;
+    CHECK(sscanf(line.c_str(), "AZ%f EL%f\r\n", &az, &el) == 2);
+    CHECK_NEAR(az, sim.controller().getTelemetry().correctedAngle_az, 0.01);
+    CHECK(output.find("[ERROR] logged while the reply waits\r\n") != std::string::npos);
+    CHECK(serial.getLatencyStats().count == 1);
+}
+
+} // namespace
+
+int main() {
+    testRotctlPipelinedCommandsAndControl();
+    testUdpControlRoundTrip();
+    testSerialReplyIsNotSplitByLog();
+    return testResult();
+}
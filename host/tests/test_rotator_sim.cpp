@@ -0,0 +1,121 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Rotator Sim Tests - The firmware boots, moves and faults correctly on the simulated plant.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rotator_sim.h"
+#include "test_support.h"
+
+namespace {
+
+void testBootReadsPositionOverI2C() {
+    RotatorSim sim;
+    sim.begin(45.0f, 12.0f);
+    sim.runFor(0.1f);
+
+    MotorSensorController::MotorTelemetry telemetry = sim.controller().getTelemetry();
+    // The controller starts moving at once, so compare against where the dish is now
+    CHECK_NEAR(telemetry.correctedAngle_az, sim.getTrueAngle(PlantSimulator::AXIS_AZ), 0.2);
+    CHECK_NEAR(telemetry.correctedAngle_el, sim.getTrueAngle(PlantSimulator::AXIS_EL), 0.2);
+    CHECK_NEAR(telemetry.correctedAngle_az, 45.0, 1.0);
+    CHECK_NEAR(telemetry.correctedAngle_el, 12.0, 1.0);
+    CHECK(!sim.controller().global_fault);
+    CHECK(sim.controller().getI2CStatsAz().transactions > 40);
+    CHECK(sim.controller().getI2CStatsAz().errors == 0);
+    CHECK(sim.ina219().getLoadVoltage() > 11.0f);
+}
+
+void testMovesSettleInsideTolerance() {
+    RotatorSim sim;
+    sim.begin();
+    sim.runFor(0.5f);
+
+    RotatorSim::StepResult az = sim.step(PlantSimulator::AXIS_AZ, 60.0f, sim.controller().getMinAzTolerance(), 60);
+    CHECK(az.settled);
+    CHECK(az.settleTime > 60.0f / 9.0f * 0.8f);  // Cannot beat the motor's top speed
+    CHECK(az.settleTime < 30.0f);
+
+    RotatorSim::StepResult el = sim.step(PlantSimulator::AXIS_EL, 10.0f, sim.controller().getMinElTolerance() * 2, 60);
+    CHECK(el.settled);
+    CHECK(el.settleTime < 30.0f);
+    CHECK(!sim.controller().global_fault);
+
+    // Virtual time: the firmware's 25 ms loop ran once per period
+    CHECK(sim.getControlTicks() >= (uint32_t)(sim.getElapsedSeconds() / 0.025f) - 1);
+}
+
+void testMissingMagnetTripsFault() {
+    RotatorSim sim;
+    sim.begin();
+    sim.runFor(0.5f);
+    CHECK(!sim.controller().magnetFault);
+
+    // Only the elevation sensor loses its magnet; the status comes back over I2C
+    sim.plant().setMagnetStatus(PlantSimulator::AXIS_EL, 0);
+    sim.runFor(1.0f);
+    CHECK(sim.controller().magnetFault);
+    CHECK(sim.controller().global_fault);
+}
+
+void testSensorNackTripsI2CFault() {
+    RotatorSim sim;
+    sim.begin();
+    sim.runFor(0.5f);
+
+    sim.sensor(PlantSimulator::AXIS_AZ).setNack(true);
+    sim.runFor(1.0f);
+    CHECK(sim.controller().i2cErrorFlag_az);
+    CHECK(!sim.controller().i2cErrorFlag_el);
+    CHECK(sim.controller().global_fault);
+    CHECK(sim.controller().getI2CStatsAz().errors > 0);
+}
+
+// The web UI caches /config until a settings version moves; only accepted values move it
+void testSettersBumpSettingsVersion() {
+    RotatorSim sim;
+    sim.begin();
+
+    MotorSensorController& controller = sim.controller();
+    uint32_t version = controller.getSettingsVersion();
+    controller.setPAz(7);
+    CHECK(controller.getSettingsVersion() != version);
+    version = controller.getSettingsVersion();
+    controller.setAzOffset(1.5f);
+    CHECK(controller.getSettingsVersion() != version);
+    version = controller.getSettingsVersion();
+    controller.setAzOffset(500.0f);
+    controller.setPEl(5000);
+    CHECK(controller.getSettingsVersion() == version);
+
+    Logger& logger = sim.logger();
+    version = logger.getSettingsVersion();
+    logger.setDebugLevel(LOG_INFO);
+    CHECK(logger.getSettingsVersion() != version);
+    version = logger.getSettingsVersion();
+    logger.setDebugLevel(99);
+    CHECK(logger.getSettingsVersion() == version);
+}
+
+} // namespace
+
+int main() {
+    testBootReadsPositionOverI2C();
+    testMovesSettleInsideTolerance();
+    testMissingMagnetTripsFault();
+    testSensorNackTripsI2CFault();
+    testSettersBumpSettingsVersion();
+    return testResult();
+}
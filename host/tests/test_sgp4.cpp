@@ -0,0 +1,177 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * SGP4 Tests - Propagation against the published reference vectors, and TEME to look angles.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sgp4.h"
+#include "test_support.h"
+
+// Reference vectors: Vallado, Crawford, Hujsak and Kelso, "Revisiting Spacetrack Report #3"
+// (AIAA 2006-6753), verification output tcppver.out, WGS-72. 00005 is the near-earth case
+// of that test set; 88888 is the original Spacetrack Report #3 example.
+
+namespace {
+
+constexpr double POSITION_TOLERANCE_KM = 1e-5;         // 1 cm
+constexpr double VELOCITY_TOLERANCE_KMS = 1e-8;        // 0.01 mm/s
+
+struct Reference {
+    double tsince;          // Minutes from epoch
+    double r[3];            // km, TEME
+    double v[3];            // km/s, TEME
+};
+
+const char* TLE_00005[2] = {
+    "1 00005U 58002B   00179.78495062  .00000023  00000-0  28098-4 0  4753",
+    "2 00005  34.2682 348.7242 1859667 331.7664  19.3264 10.82419157413667",
+};
+
+const Reference REFERENCE_00005[] = {
+    {0.0, {7022.46529266, -1400.08296755, 0.03995155}, {1.893841015, 6.405893759, 4.534807250}},
+    {360.0, {-7154.03120202, -3783.17682504, -3536.19412294}, {4.741887409, -4.151817765, -2.093935425}},
+    {720.0, {-7134.59340119, 6531.68641334, 3260.27186483}, {-4.113793027, -2.911922039, -2.557327851}},
+};
+
+const char* TLE_88888[2] = {
+    "1 88888U          80275.98708465  .00073094  13844-3  66816-4 0    87",
+    "2 88888  72.8435 115.9689 0086731  52.6988 110.5714 16.05824518  1058",
+};
+
+const Reference REFERENCE_88888[] = {
+    {0.0, {2328.96975262, -5995.22051338, 1719.97297192}, {2.912073281, -0.983417956, -7.090816210}},
+    {360.0, {2456.10706533, -6071.93855503, 1222.89768554}, {2.679390040, -0.448290811, -7.228792155}},
+    {720.0, {2567.56229695, -6112.50383922, 713.96374435}, {2.440245751, 0.098109002, -7.319959258}},
+};
+
+void checkAgainstReference(const char* name, const char* const tle[2], const Reference* reference, int count) {
+    Sgp4 sgp4;
+    CHECK(sgp4.loadTle(tle[0], tle[1]) == Sgp4::OK);
+
+    for (int i = 0; i < count; i++) {
+        double r[3];
+        double v[3];
+        CHECK(sgp4.propagate(reference[i].tsince, r, v) == Sgp4::OK);
+
+        double positionError = 0;
+        double velocityError = 0;
+        for (int k = 0; k < 3; k++) {
+            positionError = fmax(positionError, fabs(r[k] - reference[i].r[k]));
+            velocityError = fmax(velocityError, fabs(v[k] - reference[i].v[k]));
+        }
+        printf("%s t=%6.1f min: position error %.2e km, velocity error %.2e km/s\n",
+               name, reference[i].tsince, positionError, velocityError);
+        CHECK(positionError <= POSITION_TOLERANCE_KM);
+        CHECK(velocityError <= VELOCITY_TOLERANCE_KMS);
+    }
+}
+
+// Independent of the tables above, the velocity must follow the position. SGP4 leaves the
+// rates of its short-period corrections out of the velocity, so the two agree to about
+// 1 m/s rather than to rounding; a frame or sign slip would be off by kilometres per second.
+void testVelocityMatchesPositionDerivative() {
+    Sgp4 sgp4;
+    CHECK(sgp4.loadTle(TLE_00005[0], TLE_00005[1]) == Sgp4::OK);
+
+    const double h = 1e-4;  // Minutes
+    for (double t = 0; t <= 1440; t += 90) {
+        double r[3], v[3], before[3], after[3];
+        sgp4.propagate(t, r, v);
+        sgp4.propagate(t - h, before);
+        sgp4.propagate(t + h, after);
+        for (int k = 0; k < 3; k++) {
+            CHECK_NEAR(v[k], (after[k] - before[k]) / (2 * h * 60.0), 2e-3);
+        }
+    }
+}
+
+// Vallado, Fundamentals of Astrodynamics, example 3-5: 20 August 1992, 12:14 UT1
+void testGmst() {
+    double gmstDegrees = Sgp4::gmst(714312840.0) * 180.0 / PI;
+    CHECK_NEAR(gmstDegrees, 152.578787810, 1e-6);
+}
+
+// TEME positions built from the station's own frame must come back as the angles they were
+// built from: straight up, and 1000 km out along each compass point at 10 degrees elevation
+void testLookAngles() {
+    const double latitude = 52.0;
+    const double longitude = -4.5;
+    const double unixTime = 1700000000.0;
+
+    const double a = 6378.137;
+    const double f = 1.0 / 298.257223563;
+    const double e2 = f * (2.0 - f);
+    double lat = latitude * PI / 180.0;
+    double lon = longitude * PI / 180.0;
+    double n = a / sqrt(1.0 - e2 * sin(lat) * sin(lat));
+    double station[3] = {n * cos(lat) * cos(lon), n * cos(lat) * sin(lon), n * (1.0 - e2) * sin(lat)};
+    double zenith[3] = {cos(lat) * cos(lon), cos(lat) * sin(lon), sin(lat)};
+    double north[3] = {-sin(lat) * cos(lon), -sin(lat) * sin(lon), cos(lat)};
+    double east[3] = {-sin(lon), cos(lon), 0};
+
+    double theta = Sgp4::gmst(unixTime);
+    const double range = 1000.0;
+    const double elevation = 10.0 * PI / 180.0;
+
+    for (double azimuthDegrees : {0.0, 90.0, 180.0, 270.0, 33.0, 301.0, -1.0}) {
+        double ecef[3];
+        for (int k = 0; k < 3; k++) {
+            if (azimuthDegrees < 0) {
+                ecef[k] = station[k] + range * zenith[k];
+            } else {
+                double azimuth = azimuthDegrees * PI / 180.0;
+                ecef[k] = station[k] + range * (cos(elevation) * (cos(azimuth) * north[k] + sin(azimuth) * east[k]) +
+                                                sin(elevation) * zenith[k]);
+            }
+        }
+        // Earth-fixed back to TEME
+        double teme[3] = {
+            cos(theta) * ecef[0] - sin(theta) * ecef[1],
+            sin(theta) * ecef[0] + cos(theta) * ecef[1],
+            ecef[2]
+        };
+
+        double az, el, distance;
+        Sgp4::lookAngles(teme, unixTime, latitude, longitude, az, el, distance);
+        CHECK_NEAR(distance, range, 1e-6);
+        if (azimuthDegrees < 0) {
+            CHECK_NEAR(el, 90.0, 1e-6);
+        } else {
+            CHECK_NEAR(el, 10.0, 1e-9);
+            CHECK_NEAR(az, azimuthDegrees, 1e-9);
+        }
+    }
+}
+
+void testRejectsBadElements() {
+    Sgp4 sgp4;
+    char line1[70];
+    strlcpy(line1, TLE_00005[0], sizeof(line1));
+    line1[68] = '0';  // Wrong checksum
+    CHECK(sgp4.loadTle(line1, TLE_00005[1]) == Sgp4::ERROR_CHECKSUM);
+    CHECK(!sgp4.isLoaded());
+}
+
+} // namespace
+
+int main() {
+    checkAgainstReference("00005", TLE_00005, REFERENCE_00005, 3);
+    checkAgainstReference("88888", TLE_88888, REFERENCE_88888, 3);
+    testVelocityMatchesPositionDerivative();
+    testGmst();
+    testLookAngles();
+    testRejectsBadElements();
+    return testResult();
+}
@@ -0,0 +1,67 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Test Support - Minimal check macros for the host tests.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEST_SUPPORT_H
+#define TEST_SUPPORT_H
+
+// System includes
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+// Checks report and count failures rather than aborting, so one run shows every problem.
+// A test's main() returns testResult().
+inline int& testFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            printf("%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            testFailures()++; \
+        } \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance) \
+    do { \
+        double checkActual = (actual); \
+        double checkExpected = (expected); \
+        if (!(fabs(checkActual - checkExpected) <= (tolerance))) { \
+            printf("%s:%d: CHECK_NEAR failed: %s = %.9g, expected %.9g +/- %g\n", \
+                   __FILE__, __LINE__, #actual, checkActual, checkExpected, (double)(tolerance)); \
+            testFailures()++; \
+        } \
+    } while (0)
+
+inline int testResult() {
+    if (testFailures() != 0) {
+        printf("%d check(s) failed\n", testFailures());
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
+
+// Wall-clock timing for benchmarks
+inline double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+#endif // TEST_SUPPORT_H
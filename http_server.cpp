@@ -0,0 +1,705 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * HTTP Server - Request and response helpers for the web UI on top of the ESP-IDF HTTP server.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "http_server.h"
+
+#include <mbedtls/base64.h>
+#include <unistd.h>
+
+thread_local HttpServer::Request* HttpServer::_current = nullptr;
+
+namespace {
+
+const uint8_t* findBytes(const uint8_t* data, size_t length, const uint8_t* pattern, size_t patternLength) {
+    if (patternLength == 0 || length < patternLength) {
+        return nullptr;
+    }
+    const uint8_t* last = data + length - patternLength;
+    for (const uint8_t* p = data; p <= last; p++) {
+        p = (const uint8_t*)memchr(p, pattern[0], last - p + 1);
+        if (p == nullptr) {
+            return nullptr;
+        }
+        if (memcmp(p, pattern, patternLength) == 0) {
+            return p;
+        }
+    }
+    return nullptr;
+}
+
+// Value of key="..." in a part's header block, or "" when absent
+String quotedParam(const String& headers, const char* key) {
+    int start = headers.indexOf(key);
+    if (start < 0) {
+        return "";
+    }
+    start += strlen(key);
+    int end = headers.indexOf('"', start);
+    return (end < 0) ? "" : headers.substring(start, end);
+}
+
+} // namespace
+
+// =============================================================================
+// CONSTRUCTOR AND INITIALIZATION
+// =============================================================================
+
+HttpServer::HttpServer(int port) : _port(port) {
+    _notFoundRoute.server = this;
+}
+
+bool HttpServer::begin() {
+    _workQueue = xQueueCreate(WORKER_QUEUE_LENGTH, sizeof(BackgroundRequest));
+    if (_workQueue == NULL ||
+        xTaskCreatePinnedToCore(workerTask, "HTTP Worker", WORKER_STACK_SIZE, this,
+                                TASK_PRIORITY, NULL, TASK_CORE) != pdPASS) {
+        return false;
+    }
+
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.server_port = _port;
+    config.max_uri_handlers = MAX_ROUTES;
+    config.max_open_sockets = MAX_OPEN_SOCKETS;
+    config.max_resp_headers = MAX_RESPONSE_HEADERS;
+    config.stack_size = TASK_STACK_SIZE;
+    config.task_priority = TASK_PRIORITY;
+    config.core_id = TASK_CORE;
+    // When every socket is taken, the one idle longest is closed to admit a new client.
+    // Event streams never send, so they go first; browsers reconnect them on their own.
+    config.lru_purge_enable = true;
+    // TCP keep-alive probes find peers that vanished without closing, such as a sleeping laptop
+    config.keep_alive_enable = true;
+    config.global_user_ctx = this;
+    config.global_user_ctx_free_fn = [](void*) {};  // The server object outlives httpd
+    config.close_fn = closeSocket;
+
+    if (httpd_start(&_handle, &config) != ESP_OK) {
+        _handle = nullptr;
+        return false;
+    }
+
+    bool registered = true;
+    for (Route* route : _routes) {
+        httpd_uri_t uri = {};
+        uri.uri = route->uri.c_str();
+        uri.method = route->method;
+        uri.handler = handleRoute;
+        uri.user_ctx = route;
+        if (httpd_register_uri_handler(_handle, &uri) != ESP_OK) {
+            registered = false;
+        }
+    }
+
+    // A known path asked for with another method is reported like an unknown path
+    httpd_register_err_handler(_handle, HTTPD_404_NOT_FOUND, handleError);
+    httpd_register_err_handler(_handle, HTTPD_405_METHOD_NOT_ALLOWED, handleError);
+    return registered;
+}
+
+void HttpServer::on(const char* uri, httpd_method_t method, THandlerFunction handler) {
+    addRoute(uri, method, handler, nullptr, false);
+}
+
+void HttpServer::on(const char* uri, httpd_method_t method, THandlerFunction handler, THandlerFunction uploadHandler) {
+    addRoute(uri, method, handler, uploadHandler, true);
+}
+
+void HttpServer::onBackground(const char* uri, httpd_method_t method, THandlerFunction handler) {
+    addRoute(uri, method, handler, nullptr, true);
+}
+
+void HttpServer::onNotFound(THandlerFunction handler) {
+    _notFoundRoute.handler = handler;
+}
+
+void HttpServer::onClose(TCloseFunction handler) {
+    _closeHandler = handler;
+}
+
+void HttpServer::addRoute(const char* uri, httpd_method_t method, THandlerFunction handler,
+                          THandlerFunction uploadHandler, bool background) {
+    Route* route = new Route();
+    route->server = this;
+    route->uri = uri;
+    route->method = method;
+    route->handler = handler;
+    route->uploadHandler = uploadHandler;
+    route->background = background;
+    _routes.push_back(route);
+}
+
+// =============================================================================
+// SERVER CALLBACKS
+// =============================================================================
+
+esp_err_t HttpServer::handleRoute(httpd_req_t* req) {
+    Route* route = (Route*)req->user_ctx;
+    if (route->background) {
+        return route->server->startBackground(*route, req);
+    }
+    return route->server->dispatch(*route, req, nullptr);
+}
+
+esp_err_t HttpServer::handleError(httpd_req_t* req, httpd_err_code_t error) {
+    HttpServer* server = (HttpServer*)httpd_get_global_user_ctx(req->handle);
+    if (server == nullptr || !server->_notFoundRoute.handler) {
+        return httpd_resp_send_err(req, error, nullptr);
+    }
+    return server->dispatch(server->_notFoundRoute, req, nullptr);
+}
+
+void HttpServer::closeSocket(httpd_handle_t handle, int fd) {
+    HttpServer* server = (HttpServer*)httpd_get_global_user_ctx(handle);
+    if (server != nullptr && server->_closeHandler) {
+        server->_closeHandler(fd);
+    }
+    close(fd);
+}
+
+void HttpServer::workerTask(void* arg) {
+    HttpServer* server = (HttpServer*)arg;
+    BackgroundRequest work;
+    for (;;) {
+        if (xQueueReceive(server->_workQueue, &work, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        if (server->dispatch(*work.route, work.req, work.contentType) != ESP_OK) {
+            httpd_sess_trigger_close(server->_handle, httpd_req_to_sockfd(work.req));
+        }
+        httpd_req_async_handler_complete(work.req);
+    }
+}
+
+esp_err_t HttpServer::startBackground(Route& route, httpd_req_t* req) {
+    BackgroundRequest work;
+    work.route = &route;
+    work.contentType[0] = '\0';
+    httpd_req_get_hdr_value_str(req, "Content-Type", work.contentType, sizeof(work.contentType));
+
+    // Only this task queues work, so a free slot seen here is still free below
+    if (uxQueueSpacesAvailable(_workQueue) == 0 ||
+        httpd_req_async_handler_begin(req, &work.req) != ESP_OK) {
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        httpd_resp_set_type(req, "text/plain");
+        return httpd_resp_sendstr(req, "Busy with another transfer, try again shortly");
+    }
+
+    // The server stops reading this socket until the worker completes the request
+    if (xQueueSend(_workQueue, &work, 0) != pdTRUE) {
+        httpd_req_async_handler_complete(work.req);
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+esp_err_t HttpServer::dispatch(Route& route, httpd_req_t* req, const char* contentType) {
+    Request request;
+    request.req = req;
+    request.uploadRoute = (bool)route.uploadHandler;
+
+    Request* outer = _current;
+    _current = &request;
+
+    if (!request.uploadRoute || receiveUpload(route, request, contentType)) {
+        route.handler();
+    } else if (!request.failed) {
+        send(400, "text/plain", "Expected a multipart/form-data upload");
+    }
+    finishResponse(request);
+
+    _current = outer;
+    return request.failed ? ESP_FAIL : ESP_OK;
+}
+
+// =============================================================================
+// REQUEST
+// =============================================================================
+
+String HttpServer::arg(const String& name) {
+    Request* request = _current;
+    if (request == nullptr) {
+        return String();
+    }
+    parseArgs(*request);
+    for (const Arg& arg : request->args) {
+        if (arg.name == name) {
+            return arg.value;
+        }
+    }
+    return String();
+}
+
+bool HttpServer::hasArg(const String& name) {
+    Request* request = _current;
+    if (request == nullptr) {
+        return false;
+    }
+    parseArgs(*request);
+    for (const Arg& arg : request->args) {
+        if (arg.name == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+String HttpServer::header(const char* name) {
+    Request* request = _current;
+    if (request == nullptr) {
+        return String();
+    }
+    size_t length = httpd_req_get_hdr_value_len(request->req, name);
+    if (length == 0) {
+        return String();
+    }
+    std::vector<char> value(length + 1);
+    if (httpd_req_get_hdr_value_str(request->req, name, value.data(), value.size()) != ESP_OK) {
+        return String();
+    }
+    return String(value.data());
+}
+
+httpd_method_t HttpServer::method() {
+    return (_current != nullptr) ? (httpd_method_t)_current->req->method : HTTP_GET;
+}
+
+String HttpServer::uri() {
+    if (_current == nullptr) {
+        return String();
+    }
+    const char* uri = _current->req->uri;
+    const char* query = strchr(uri, '?');
+    return (query != nullptr) ? String(uri).substring(0, query - uri) : String(uri);
+}
+
+HttpUpload& HttpServer::upload() {
+    return _upload;
+}
+
+bool HttpServer::authenticate(const char* user, const char* password) {
+    String authorization = header("Authorization");
+    if (!authorization.startsWith("Basic ")) {
+        return false;
+    }
+
+    String credentials = String(user) + ":" + password;
+    size_t encodedLength = 0;
+    mbedtls_base64_encode(nullptr, 0, &encodedLength, (const uint8_t*)credentials.c_str(), credentials.length());
+    std::vector<unsigned char> encoded(encodedLength + 1);
+    if (mbedtls_base64_encode(encoded.data(), encoded.size(), &encodedLength,
+                              (const uint8_t*)credentials.c_str(), credentials.length()) != 0) {
+        return false;
+    }
+    encoded[encodedLength] = '\0';
+    return authorization.substring(6) == (const char*)encoded.data();
+}
+
+void HttpServer::parseArgs(Request& request) {
+    if (request.argsParsed) {
+        return;
+    }
+    request.argsParsed = true;
+
+    size_t queryLength = httpd_req_get_url_query_len(request.req);
+    if (queryLength > 0) {
+        std::vector<char> query(queryLength + 1);
+        if (httpd_req_get_url_query_str(request.req, query.data(), query.size()) == ESP_OK) {
+            parseUrlEncoded(request, query.data(), queryLength);
+        }
+    }
+
+    // Form posts carry their fields in the body; uploads read theirs in receiveUpload()
+    size_t bodyLength = request.req->content_len;
+    if (request.req->method != HTTP_POST || request.uploadRoute || bodyLength == 0 ||
+        bodyLength > MAX_FORM_SIZE || !header("Content-Type").startsWith("application/x-www-form-urlencoded")) {
+        return;
+    }
+    std::vector<char> body(bodyLength);
+    size_t received = 0;
+    while (received < bodyLength) {
+        int count = receive(request.req, (uint8_t*)body.data() + received, bodyLength - received);
+        if (count < 0) {
+            request.failed = true;
+            return;
+        }
+        received += count;
+    }
+    parseUrlEncoded(request, body.data(), bodyLength);
+}
+
+void HttpServer::parseUrlEncoded(Request& request, const char* text, size_t length) {
+    const char* end = text + length;
+    while (text < end) {
+        const char* pairEnd = (const char*)memchr(text, '&', end - text);
+        if (pairEnd == nullptr) {
+            pairEnd = end;
+        }
+        if (pairEnd > text) {
+            const char* equals = (const char*)memchr(text, '=', pairEnd - text);
+            Arg arg;
+            arg.name = urlDecode(text, ((equals != nullptr) ? equals : pairEnd) - text);
+            if (equals != nullptr) {
+                arg.value = urlDecode(equals + 1, pairEnd - equals - 1);
+            }
+            request.args.push_back(arg);
+        }
+        text = pairEnd + 1;
+    }
+}
+
+String HttpServer::urlDecode(const char* text, size_t length) {
+    String decoded;
+    decoded.reserve(length);
+    for (size_t i = 0; i < length; i++) {
+        char c = text[i];
+        if (c == '+') {
+            c = ' ';
+        } else if (c == '%' && i + 2 < length && isxdigit((unsigned char)text[i + 1]) &&
+                   isxdigit((unsigned char)text[i + 2])) {
+            char hex[3] = { text[i + 1], text[i + 2], '\0' };
+            c = (char)strtol(hex, nullptr, 16);
+            i += 2;
+        }
+        decoded += c;
+    }
+    return decoded;
+}
+
+int HttpServer::receive(httpd_req_t* req, uint8_t* data, size_t length) {
+    for (int timeouts = 0; timeouts < MAX_RECEIVE_TIMEOUTS; timeouts++) {
+        int received = httpd_req_recv(req, (char*)data, length);
+        if (received != HTTPD_SOCK_ERR_TIMEOUT) {
+            return (received > 0) ? received : -1;
+        }
+    }
+    return -1;
+}
+
+// =============================================================================
+// UPLOADS
+// =============================================================================
+
+bool HttpServer::receiveUpload(Route& route, Request& request, const char* contentType) {
+    String type = (contentType != nullptr) ? String(contentType) : header("Content-Type");
+    int boundaryStart = type.indexOf("boundary=");
+    if (!type.startsWith("multipart/form-data") || boundaryStart < 0) {
+        return false;
+    }
+    String boundary = type.substring(boundaryStart + 9);
+    int boundaryEnd = boundary.indexOf(';');
+    if (boundaryEnd >= 0) {
+        boundary = boundary.substring(0, boundaryEnd);
+    }
+    boundary.trim();
+    if (boundary.length() >= 2 && boundary.startsWith("\"") && boundary.endsWith("\"")) {
+        boundary = boundary.substring(1, boundary.length() - 1);
+    }
+    if (boundary.length() == 0 || boundary.length() > 70) {
+        return false;
+    }
+
+    // Every delimiter but the first follows a line break; starting the window with one
+    // lets the same search find them all
+    String delimiter = "\r\n--" + boundary;
+    const uint8_t* delimiterBytes = (const uint8_t*)delimiter.c_str();
+    size_t delimiterLength = delimiter.length();
+
+    enum State { PREAMBLE, DELIMITER_END, PART_HEADERS, PART_BODY, DONE };
+    State state = PREAMBLE;
+    uint8_t* window = _receiveBuffer;
+    window[0] = '\r';
+    window[1] = '\n';
+    size_t length = 2;
+    size_t remaining = request.req->content_len;
+    bool inFile = false;
+    String fieldName;
+    String fieldValue;
+
+    // File bytes reach the upload handler in whole buffers
+    auto flushFile = [&]() {
+        if (_upload.currentSize > 0) {
+            _upload.totalSize += _upload.currentSize;
+            _upload.status = UPLOAD_FILE_WRITE;
+            route.uploadHandler();
+            _upload.currentSize = 0;
+        }
+    };
+    auto writeBody = [&](const uint8_t* data, size_t size) {
+        if (!inFile) {
+            if (fieldValue.length() + size <= MAX_FIELD_SIZE) {
+                fieldValue.concat((const char*)data, size);
+            }
+            return;
+        }
+        while (size > 0) {
+            size_t chunk = min(size, HttpUpload::BUFFER_SIZE - _upload.currentSize);
+            memcpy(_upload.buf + _upload.currentSize, data, chunk);
+            _upload.currentSize += chunk;
+            data += chunk;
+            size -= chunk;
+            if (_upload.currentSize == HttpUpload::BUFFER_SIZE) {
+                flushFile();
+            }
+        }
+    };
+    auto abortUpload = [&]() {
+        if (inFile) {
+            _upload.status = UPLOAD_FILE_ABORTED;
+            _upload.currentSize = 0;
+            route.uploadHandler();
+        }
+        return false;
+    };
+
+    while (state != DONE) {
+        size_t consumed = 0;
+        bool progressed = true;
+        while (progressed && state != DONE) {
+            progressed = false;
+            const uint8_t* data = window + consumed;
+            size_t available = length - consumed;
+
+            if (state == PREAMBLE || state == PART_BODY) {
+                // Without a match, the tail might be the start of a delimiter, so it waits for more
+                const uint8_t* match = findBytes(data, available, delimiterBytes, delimiterLength);
+                size_t safe = (match != nullptr) ? (size_t)(match - data)
+                            : (available >= delimiterLength) ? available - delimiterLength + 1 : 0;
+                if (state == PART_BODY && safe > 0) {
+                    writeBody(data, safe);
+                }
+                consumed += safe;
+                progressed = safe > 0;
+                if (match != nullptr) {
+                    consumed += delimiterLength;
+                    if (state == PART_BODY) {
+                        if (inFile) {
+                            flushFile();
+                            _upload.status = UPLOAD_FILE_END;
+                            route.uploadHandler();
+                            inFile = false;
+                        } else if (fieldName.length() > 0) {
+                            request.args.push_back({ fieldName, fieldValue });
+                        }
+                    }
+                    state = DELIMITER_END;
+                    progressed = true;
+                }
+            } else if (state == DELIMITER_END) {
+                // "--" closes the body, a line break opens the next part
+                if (available < 2) {
+                    break;
+                }
+                if (data[0] == '-' && data[1] == '-') {
+                    state = DONE;
+                } else if (data[0] == '\r' && data[1] == '\n') {
+                    consumed += 2;
+                    state = PART_HEADERS;
+                } else {
+                    return abortUpload();
+                }
+                progressed = true;
+            } else if (state == PART_HEADERS) {
+                const uint8_t* match = findBytes(data, available, (const uint8_t*)"\r\n\r\n", 4);
+                if (match == nullptr) {
+                    break;
+                }
+                String headers;
+                headers.concat((const char*)data, match - data);
+                consumed += (match - data) + 4;
+
+                String filename = quotedParam(headers, "; filename=\"");
+                String name = quotedParam(headers, "; name=\"");
+                if (filename.length() > 0 && route.uploadHandler) {
+                    inFile = true;
+                    _upload.filename = filename;
+                    _upload.name = name;
+                    _upload.totalSize = 0;
+                    _upload.currentSize = 0;
+                    _upload.status = UPLOAD_FILE_START;
+                    route.uploadHandler();
+                } else {
+                    fieldName = name;
+                    fieldValue = "";
+                }
+                state = PART_BODY;
+                progressed = true;
+            }
+        }
+
+        memmove(window, window + consumed, length - consumed);
+        length -= consumed;
+        if (state == DONE) {
+            break;
+        }
+
+        // Nothing more will arrive, or a part header does not fit the window
+        if (remaining == 0 || length == RECEIVE_BUFFER_SIZE) {
+            return abortUpload();
+        }
+        int received = receive(request.req, window + length, min(RECEIVE_BUFFER_SIZE - length, remaining));
+        if (received < 0) {
+            request.failed = true;
+            return abortUpload();
+        }
+        length += received;
+        remaining -= received;
+    }
+
+    // Read the epilogue so the connection is ready for the next request
+    while (remaining > 0) {
+        int received = receive(request.req, window, min(RECEIVE_BUFFER_SIZE, remaining));
+        if (received < 0) {
+            request.failed = true;
+            return true;
+        }
+        remaining -= received;
+    }
+    return true;
+}
+
+// =============================================================================
+// RESPONSE
+// =============================================================================
+
+void HttpServer::sendHeader(const String& name, const String& value) {
+    Request* request = _current;
+    if (request == nullptr || request->responded || request->headerCount >= MAX_RESPONSE_HEADERS) {
+        return;
+    }
+    // httpd keeps pointers to header text until the response is out, so the request owns it
+    request->headerNames[request->headerCount] = name;
+    request->headerValues[request->headerCount] = value;
+    request->headerCount++;
+}
+
+void HttpServer::setContentLength(size_t length) {
+    (void)length;
+    if (_current != nullptr) {
+        _current->streaming = true;
+    }
+}
+
+void HttpServer::send(int code, const char* contentType, const String& content) {
+    Request* request = _current;
+    if (request == nullptr || request->responded) {
+        return;
+    }
+    request->responded = true;
+
+    snprintf(request->status, sizeof(request->status), "%d %s", code, reasonPhrase(code));
+    httpd_resp_set_status(request->req, request->status);
+    if (contentType != nullptr && contentType[0] != '\0') {
+        request->contentType = contentType;
+        httpd_resp_set_type(request->req, request->contentType.c_str());
+    }
+    for (int i = 0; i < request->headerCount; i++) {
+        httpd_resp_set_hdr(request->req, request->headerNames[i].c_str(), request->headerValues[i].c_str());
+    }
+
+    // A streamed body sends the status line and headers with its first chunk
+    if (request->streaming) {
+        return;
+    }
+    if (httpd_resp_send(request->req, content.c_str(), content.length()) != ESP_OK) {
+        request->failed = true;
+    }
+    request->finished = true;
+}
+
+void HttpServer::sendContent(const char* data, size_t length) {
+    Request* request = _current;
+    if (request == nullptr || !request->responded || !request->streaming ||
+        request->finished || request->failed) {
+        return;
+    }
+    // An empty chunk ends the body
+    if (httpd_resp_send_chunk(request->req, (length > 0) ? data : nullptr, length) != ESP_OK) {
+        request->failed = true;
+    }
+    if (length == 0) {
+        request->finished = true;
+    }
+}
+
+void HttpServer::sendContent(const String& content) {
+    sendContent(content.c_str(), content.length());
+}
+
+void HttpServer::streamFile(File& file, const String& contentType) {
+    if (String(file.name()).endsWith(".gz")) {
+        sendHeader("Content-Encoding", "gzip");
+    }
+    setContentLength(file.size());
+    send(200, contentType.c_str());
+
+    char buf[1024];
+    size_t bytesRead;
+    while ((bytesRead = file.read((uint8_t*)buf, sizeof(buf))) > 0) {
+        sendContent(buf, bytesRead);
+        if (_current == nullptr || _current->failed) {
+            return;
+        }
+    }
+    sendContent("");
+}
+
+void HttpServer::requestAuthentication() {
+    sendHeader("WWW-Authenticate", "Basic realm=\"Login Required\"");
+    send(401, "text/plain", "Authentication required");
+}
+
+int HttpServer::client() {
+    return (_current != nullptr) ? httpd_req_to_sockfd(_current->req) : -1;
+}
+
+void HttpServer::detachClient() {
+    if (_current != nullptr) {
+        _current->responded = true;
+        _current->finished = true;
+    }
+}
+
+bool HttpServer::queueWork(void (*fn)(void*), void* arg) {
+    return _handle != nullptr && httpd_queue_work(_handle, fn, arg) == ESP_OK;
+}
+
+void HttpServer::finishResponse(Request& request) {
+    if (request.failed) {
+        return;
+    }
+    if (!request.responded) {
+        send(500, "text/plain", "No response");
+    } else if (!request.finished) {
+        sendContent("");
+    }
+}
+
+const char* HttpServer::reasonPhrase(int code) {
+    switch (code) {
+        case 200: return "OK";
+        case 204: return "No Content";
+        case 304: return "Not Modified";
+        case 400: return "Bad Request";
+        case 401: return "Unauthorized";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 500: return "Internal Server Error";
+        case 503: return "Service Unavailable";
+        default: return "";
+    }
+}
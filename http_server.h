@@ -0,0 +1,184 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * HTTP Server - Request and response helpers for the web UI on top of the ESP-IDF HTTP server.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HTTP_SERVER_H
+#define HTTP_SERVER_H
+
+// System includes
+#include <Arduino.h>
+#include <FS.h>
+#include <esp_http_server.h>
+#include <functional>
+#include <vector>
+
+enum HttpUploadStatus {
+    UPLOAD_FILE_START,
+    UPLOAD_FILE_WRITE,
+    UPLOAD_FILE_END,
+    UPLOAD_FILE_ABORTED
+};
+
+// The file part of a multipart/form-data body, handed to the upload handler a buffer at a time
+struct HttpUpload {
+    static constexpr size_t BUFFER_SIZE = 1436;
+
+    HttpUploadStatus status = UPLOAD_FILE_START;
+    String filename;
+    String name;
+    size_t totalSize = 0;       // Bytes delivered so far, the whole file at UPLOAD_FILE_END
+    size_t currentSize = 0;     // Bytes in buf for this call
+    uint8_t buf[BUFFER_SIZE];
+};
+
+// The part of the Arduino WebServer interface the web UI uses, served by esp_http_server.
+// The ESP-IDF server waits on every open connection at once and keeps each one open
+// between requests, so a browser reuses its connections and one slow client no longer
+// holds up the rest. Handlers run on the server task and reach the request they were
+// called for through the methods below. Routes that take an upload, and routes added with
+// onBackground(), run on a worker task instead, so a long transfer leaves the server task
+// free to answer everyone else.
+class HttpServer {
+public:
+    typedef std::function<void()> THandlerFunction;
+    typedef std::function<void(int)> TCloseFunction;
+
+    static constexpr size_t CONTENT_LENGTH_UNKNOWN = (size_t)-1;
+
+    // Constructor
+    HttpServer(int port);
+
+    // Routes and callbacks must be set up before begin()
+    bool begin();
+    void on(const char* uri, httpd_method_t method, THandlerFunction handler);
+    void on(const char* uri, httpd_method_t method, THandlerFunction handler, THandlerFunction uploadHandler);
+    void onBackground(const char* uri, httpd_method_t method, THandlerFunction handler);
+    void onNotFound(THandlerFunction handler);
+    void onClose(TCloseFunction handler);    // Runs on the server task as each socket closes
+
+    // Request, for the handler being run on the calling task
+    String arg(const String& name);
+    bool hasArg(const String& name);
+    String header(const char* name);
+    httpd_method_t method();
+    String uri();
+    HttpUpload& upload();
+    bool authenticate(const char* user, const char* password);
+
+    // Response. setContentLength() before send(code, type, "") streams the body through
+    // sendContent(); streamed bodies go out chunked whatever length was given.
+    void sendHeader(const String& name, const String& value);
+    void setContentLength(size_t length);
+    void send(int code, const char* contentType = nullptr, const String& content = String());
+    void sendContent(const char* data, size_t length);
+    void sendContent(const String& content);
+    void streamFile(File& file, const String& contentType);
+    void requestAuthentication();
+
+    // Long-lived responses write to the socket themselves from the server task; after
+    // detachClient() the handler's request is left without a response
+    int client();
+    void detachClient();
+    httpd_handle_t getHandle() const { return _handle; }
+
+    // Runs fn(arg) on the server task, in between requests
+    bool queueWork(void (*fn)(void*), void* arg);
+
+private:
+    static constexpr int MAX_ROUTES = 64;
+    static constexpr int MAX_OPEN_SOCKETS = 6;          // LWIP has 16; rotctl, UDP and the pollers use the rest
+    static constexpr int MAX_RESPONSE_HEADERS = 8;
+    static constexpr uint32_t TASK_STACK_SIZE = 16384;
+    static constexpr UBaseType_t TASK_PRIORITY = 1;     // Below the control and safety tasks
+    static constexpr BaseType_t TASK_CORE = 1;
+    static constexpr uint32_t WORKER_STACK_SIZE = 8192;
+    static constexpr int WORKER_QUEUE_LENGTH = 2;
+    static constexpr size_t MAX_FORM_SIZE = 4096;       // Largest urlencoded body parsed into args
+    static constexpr size_t MAX_FIELD_SIZE = 1024;      // Largest multipart form field kept as an arg
+    static constexpr size_t RECEIVE_BUFFER_SIZE = 2048;
+    static constexpr int MAX_RECEIVE_TIMEOUTS = 3;      // Each one is recv_wait_timeout long
+    static constexpr size_t CONTENT_TYPE_SIZE = 128;
+
+    struct Route {
+        HttpServer* server = nullptr;
+        String uri;
+        httpd_method_t method = HTTP_GET;
+        THandlerFunction handler;
+        THandlerFunction uploadHandler;
+        bool background = false;
+    };
+
+    struct Arg {
+        String name;
+        String value;
+    };
+
+    // State of the request a handler is running for; lives on the dispatching task's stack
+    struct Request {
+        httpd_req_t* req = nullptr;
+        bool argsParsed = false;
+        std::vector<Arg> args;
+        String headerNames[MAX_RESPONSE_HEADERS];
+        String headerValues[MAX_RESPONSE_HEADERS];
+        int headerCount = 0;
+        char status[32] = "";
+        String contentType;
+        bool uploadRoute = false;   // The body is multipart and read by receiveUpload()
+        bool streaming = false;     // setContentLength() was called
+        bool responded = false;     // Status line and headers are out, or the caller owns the socket
+        bool finished = false;      // Terminating chunk sent
+        bool failed = false;        // The socket failed; the server closes it
+    };
+
+    // A request handed from the server task to the worker
+    struct BackgroundRequest {
+        Route* route;
+        httpd_req_t* req;
+        char contentType[CONTENT_TYPE_SIZE];
+    };
+
+    int _port;
+    httpd_handle_t _handle = nullptr;
+    std::vector<Route*> _routes;
+    Route _notFoundRoute;
+    TCloseFunction _closeHandler;
+    QueueHandle_t _workQueue = NULL;
+    HttpUpload _upload;                     // Only the worker receives uploads, one at a time
+    uint8_t _receiveBuffer[RECEIVE_BUFFER_SIZE];
+    static thread_local Request* _current;  // Set while a handler runs on this task
+
+    // Server callbacks
+    static esp_err_t handleRoute(httpd_req_t* req);
+    static esp_err_t handleError(httpd_req_t* req, httpd_err_code_t error);
+    static void closeSocket(httpd_handle_t handle, int fd);
+    static void workerTask(void* arg);
+
+    // Helper methods
+    void addRoute(const char* uri, httpd_method_t method, THandlerFunction handler,
+                  THandlerFunction uploadHandler, bool background);
+    esp_err_t dispatch(Route& route, httpd_req_t* req, const char* contentType);
+    esp_err_t startBackground(Route& route, httpd_req_t* req);
+    bool receiveUpload(Route& route, Request& request, const char* contentType);
+    static int receive(httpd_req_t* req, uint8_t* data, size_t length);
+    void parseArgs(Request& request);
+    void parseUrlEncoded(Request& request, const char* text, size_t length);
+    void finishResponse(Request& request);
+    static String urlDecode(const char* text, size_t length);
+    static const char* reasonPhrase(int code);
+};
+
+#endif // HTTP_SERVER_H
@@ -0,0 +1,187 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Log File - Persistent rotating binary log on LittleFS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "log_file.h"
+
+// =============================================================================
+// CONSTRUCTOR AND INITIALIZATION
+// =============================================================================
+
+LogFile::LogFile(Preferences& prefs, Logger& logger) : _preferences(prefs), _logger(logger) {
+}
+
+void LogFile::begin() {
+    _fileMutex = xSemaphoreCreateMutex();
+
+    File file = LittleFS.open(CURRENT_PATH, "r");
+    if (file) {
+        _currentFileSize = file.size();
+        file.close();
+    }
+
+    // Boot marker, so the decoder can tell which run each record belongs to
+    _bootCount = _preferences.getUInt("logBootCount", 0) + 1;
+    _preferences.putUInt("logBootCount", _bootCount);
+    char marker[24];
+    snprintf(marker, sizeof(marker), "boot %lu", (unsigned long)_bootCount);
+    appendRecord(millis(), LOG_NONE, "", marker);
+    _lastFlushMs = millis();
+
+    LOGI(_logger, "Log file: " + String(getStoredBytes()) + " bytes stored, boot " + String(_bootCount));
+}
+
+// =============================================================================
+// CORE FUNCTIONALITY
+// =============================================================================
+
+void LogFile::runLogFileLoop() {
+    if (xSemaphoreTake(_fileMutex, portMAX_DELAY) != pdTRUE) {
+        return;
+    }
+
+    Logger::LogEntry entry;
+    while (_logger.readEntry(_cursor, entry)) {
+        appendRecord(entry.timestamp, entry.level, entry.task, entry.message);
+        if (entry.level == LOG_ERROR) {
+            _batchHasError = true;
+        }
+    }
+
+    // Errors go out on the next pass so they survive a crash; routine records are batched
+    // to keep flash writes (and the cache stalls they cause) infrequent
+    bool due = millis() - _lastFlushMs >= FLUSH_INTERVAL_MS;
+    if (_batchLength > 0 && (_batchHasError || due || _batchLength >= BATCH_SIZE / 2)) {
+        writeBatch();
+    }
+
+    xSemaphoreGive(_fileMutex);
+}
+
+void LogFile::flush() {
+    if (xSemaphoreTake(_fileMutex, portMAX_DELAY) == pdTRUE) {
+        writeBatch();
+        xSemaphoreGive(_fileMutex);
+    }
+}
+
+void LogFile::sendTo(HttpServer& server) {
+    if (xSemaphoreTake(_fileMutex, portMAX_DELAY) != pdTRUE) {
+        server.send(503, "text/plain", "Log file busy");
+        return;
+    }
+
+    // Holding the lock keeps rotation from swapping files mid-download; records keep
+    // collecting in the logger's ring meanwhile
+    writeBatch();
+
+    const char* paths[] = { PREVIOUS_PATH, CURRENT_PATH };
+    size_t totalSize = 0;
+    for (const char* path : paths) {
+        File file = LittleFS.open(path, "r");
+        if (file) {
+            totalSize += file.size();
+            file.close();
+        }
+    }
+
+    server.sendHeader("Content-Disposition", "attachment; filename=\"discovery_drive_log.bin\"");
+    server.setContentLength(totalSize);
+    server.send(200, "application/octet-stream", "");
+
+    char buf[512];
+    for (const char* path : paths) {
+        File file = LittleFS.open(path, "r");
+        if (!file) {
+            continue;
+        }
+        size_t bytesRead;
+        while ((bytesRead = file.read((uint8_t*)buf, sizeof(buf))) > 0) {
+            server.sendContent(buf, bytesRead);
+        }
+        file.close();
+    }
+    server.sendContent("");
+
+    xSemaphoreGive(_fileMutex);
+}
+
+size_t LogFile::getStoredBytes() {
+    size_t total = 0;
+    if (xSemaphoreTake(_fileMutex, portMAX_DELAY) == pdTRUE) {
+        File file = LittleFS.open(PREVIOUS_PATH, "r");
+        if (file) {
+            total += file.size();
+            file.close();
+        }
+        total += _currentFileSize + _batchLength;
+        xSemaphoreGive(_fileMutex);
+    }
+    return total;
+}
+
+// =============================================================================
+// HELPER METHODS
+// =============================================================================
+
+void LogFile::appendRecord(uint32_t timestamp, uint8_t level, const char* task, const char* message) {
+    size_t taskLength = strnlen(task, Logger::TASK_NAME_SIZE - 1);
+    size_t messageLength = strnlen(message, Logger::MESSAGE_SIZE - 1);
+    size_t recordLength = RECORD_HEADER_SIZE + taskLength + messageLength;
+
+    if (_batchLength + recordLength > BATCH_SIZE) {
+        writeBatch();
+    }
+
+    uint8_t* out = _batch + _batchLength;
+    out[0] = RECORD_MAGIC;
+    out[1] = level;
+    out[2] = (uint8_t)taskLength;
+    out[3] = (uint8_t)messageLength;
+    out[4] = timestamp & 0xFF;
+    out[5] = (timestamp >> 8) & 0xFF;
+    out[6] = (timestamp >> 16) & 0xFF;
+    out[7] = (timestamp >> 24) & 0xFF;
+    memcpy(out + RECORD_HEADER_SIZE, task, taskLength);
+    memcpy(out + RECORD_HEADER_SIZE + taskLength, message, messageLength);
+    _batchLength += recordLength;
+}
+
+void LogFile::writeBatch() {
+    if (_batchLength == 0) {
+        return;
+    }
+
+    // Rotate whole files rather than trimming, so every write is a plain append
+    if (_currentFileSize + _batchLength > MAX_FILE_SIZE) {
+        LittleFS.remove(PREVIOUS_PATH);
+        LittleFS.rename(CURRENT_PATH, PREVIOUS_PATH);
+        _currentFileSize = 0;
+    }
+
+    File file = LittleFS.open(CURRENT_PATH, "a");
+    if (file) {
+        size_t written = file.write(_batch, _batchLength);
+        file.close();
+        _currentFileSize += written;
+    }
+
+    // On a failed write the batch is dropped rather than retried forever
+    _batchLength = 0;
+    _batchHasError = false;
+    _lastFlushMs = millis();
+}
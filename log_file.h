@@ -0,0 +1,86 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Log File - Persistent rotating binary log on LittleFS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LOG_FILE_H
+#define LOG_FILE_H
+
+// System includes
+#include <Arduino.h>
+#include <Preferences.h>
+#include <LittleFS.h>
+
+// Custom includes
+#include "logger.h"
+#include "http_server.h"
+
+// Drains the logger's record ring into a RAM batch and appends it to flash from its own
+// task, so logging callers never wait on LittleFS. Two files rotate: when the current one
+// would pass MAX_FILE_SIZE it becomes the previous one and a new file starts.
+//
+// Record layout (little-endian): magic 0xA5, level, task length, message length,
+// uint32 millis, then the task and message bytes. Level 0 marks a boot; its message
+// carries the boot count. tools/decode_log.py turns a download back into text.
+class LogFile {
+public:
+    // Constructor
+    LogFile(Preferences& prefs, Logger& logger);
+
+    // Core functionality
+    void begin();
+    void runLogFileLoop();
+    void flush();
+
+    // Sends previous then current file as one download
+    void sendTo(HttpServer& server);
+
+    // Status
+    size_t getStoredBytes();
+    uint32_t getBootCount() const { return _bootCount; }
+
+private:
+    static constexpr const char* CURRENT_PATH = "/log0.bin";
+    static constexpr const char* PREVIOUS_PATH = "/log1.bin";
+    static constexpr size_t MAX_FILE_SIZE = 16384;    // Two files; the 190 kB partition also holds the web UI
+    static constexpr size_t BATCH_SIZE = 2048;
+    static constexpr size_t RECORD_HEADER_SIZE = 8;
+    static constexpr uint8_t RECORD_MAGIC = 0xA5;
+    static constexpr unsigned long FLUSH_INTERVAL_MS = 10000;   // Batch routine records this long
+
+    // Dependencies
+    Preferences& _preferences;
+    Logger& _logger;
+
+    // Thread synchronization (log file task and web downloads)
+    SemaphoreHandle_t _fileMutex = NULL;
+
+    // Pending records not yet on flash
+    uint8_t _batch[BATCH_SIZE];
+    size_t _batchLength = 0;
+    bool _batchHasError = false;
+    unsigned long _lastFlushMs = 0;
+
+    uint32_t _cursor = 0;
+    size_t _currentFileSize = 0;
+    uint32_t _bootCount = 0;
+
+    // Helper methods
+    void appendRecord(uint32_t timestamp, uint8_t level, const char* task, const char* message);
+    void writeBatch();
+};
+
+#endif // LOG_FILE_H
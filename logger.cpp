@@ -23,12 +23,15 @@
 // =============================================================================
 
 Logger::Logger(Preferences& prefs) : _preferences(prefs) {
+    // Each slot starts out holding a published record from the lap before ticket 0
+    for (uint32_t i = 0; i < RING_SIZE; i++) {
+        _ring[i].sequence.store(publishedSequence(i - RING_SIZE), std::memory_order_relaxed);
+    }
 }
 
 void Logger::begin() {
-    // Create mutex for thread-safe log access
-    _logMessagesMutex = xSemaphoreCreateMutex();
-    
+    _serialMutex = xSemaphoreCreateMutex();
+
     // Load saved debug level from preferences
     int savedDebugLevel = _preferences.getInt("debugLevel", 1);
     _currentDebugLevel = savedDebugLevel;
@@ -50,17 +53,115 @@ void Logger::logMessage(LogLevel level, const String& message) {
     if (level > _currentDebugLevel) {
         return;
     }
-    
-    String levelStr = getLevelString(level);
-    String fullMessage = levelStr + message;
-    
-    // Output to Serial console only if not disabled
-    if (!_serialOutputDisabled) {
-        Serial.println(fullMessage);
+
+    // Claim the next ticket only once the record it replaces has been published. A writer
+    // then owns its slot until it publishes, so it can never be lapped mid-record; while one
+    // is stuck, a record that needs its slot is dropped rather than written over it.
+    uint32_t ticket = _head.load(std::memory_order_relaxed);
+    for (;;) {
+        uint32_t sequence = _ring[ticket % RING_SIZE].sequence.load(std::memory_order_acquire);
+        int32_t lap = (int32_t)(sequence - publishedSequence(ticket - RING_SIZE));
+        if (lap < 0) {
+            _droppedCount++;
+            return;
+        }
+        if (lap > 0) {
+            ticket = _head.load(std::memory_order_relaxed);  // Taken since head was read
+            continue;
+        }
+        if (_head.compare_exchange_weak(ticket, ticket + 1, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    // Released so a task that sees the mark also sees the head this claim advanced
+    LogRecord& slot = _ring[ticket % RING_SIZE];
+    slot.sequence.store(writingSequence(ticket), std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.timestamp = millis();
+    slot.level = level;
+    const char* taskName = pcTaskGetName(NULL);
+    strlcpy(slot.task, taskName != nullptr ? taskName : "", TASK_NAME_SIZE);
+    strlcpy(slot.message, message.c_str(), MESSAGE_SIZE);
+    slot.sequence.store(publishedSequence(ticket), std::memory_order_release);
+
+    if (_drainTask != NULL) {
+        xTaskNotifyGive(_drainTask);
+    } else {
+        // No drain task yet (early boot): print in place so nothing is held back
+        drainToSerial();
+    }
+}
+
+void Logger::attachDrainTask(TaskHandle_t drainTask) {
+    _drainTask = drainTask;
+}
+
+void Logger::drainToSerial() {
+    LogEntry entry;
+    while (readEntry(_serialCursor, entry)) {
+        // Serial output is skipped, not buffered, while disabled
+        if (!_serialOutputDisabled && lockSerial(portMAX_DELAY)) {
+            Serial.print(getLevelString(entry.level));
+            Serial.println(entry.message);
+            unlockSerial();
+        }
+    }
+}
+
+bool Logger::lockSerial(TickType_t wait) {
+    // Before begin() only setup() is running, so there is nobody to exclude
+    return _serialMutex == NULL || xSemaphoreTake(_serialMutex, wait) == pdTRUE;
+}
+
+void Logger::unlockSerial() {
+    if (_serialMutex != NULL) {
+        xSemaphoreGive(_serialMutex);
     }
-    
-    // Add to web log buffer for web interface
-    addToWebLog(fullMessage);
+}
+
+bool Logger::readEntry(uint32_t& cursor, LogEntry& entry) {
+    uint32_t head = _head.load(std::memory_order_acquire);
+
+    while (cursor != head) {
+        // Fell a whole ring behind: skip to the oldest record still present
+        if (head - cursor > RING_SIZE) {
+            _droppedCount += head - cursor - RING_SIZE;
+            cursor = head - RING_SIZE;
+        }
+
+        const LogRecord& slot = _ring[cursor % RING_SIZE];
+        if (slot.sequence.load(std::memory_order_acquire) != publishedSequence(cursor)) {
+            // Either the record is still being written, or writers lapped this reader since
+            // head was read and the slot holds (or is taking) a newer record. Any newer claim
+            // on the slot put head more than a ring ahead, so a fresh head tells them apart.
+            uint32_t latest = _head.load(std::memory_order_acquire);
+            if (latest - cursor <= RING_SIZE) {
+                return false;  // Claimed but still being written; pick it up next time
+            }
+            head = latest;
+            continue;  // Lapped: the check above skips to the oldest record still present
+        }
+
+        entry.timestamp = slot.timestamp;
+        entry.level = (LogLevel)slot.level;
+        memcpy(entry.task, slot.task, TASK_NAME_SIZE);
+        memcpy(entry.message, slot.message, MESSAGE_SIZE);
+        entry.task[TASK_NAME_SIZE - 1] = '\0';
+        entry.message[MESSAGE_SIZE - 1] = '\0';
+
+        // A writer that reused the slot during the copy leaves a different sequence behind
+        std::atomic_thread_fence(std::memory_order_acquire);
+        bool intact = slot.sequence.load(std::memory_order_relaxed) == publishedSequence(cursor);
+        cursor++;
+        if (intact) {
+            return true;
+        }
+        _droppedCount++;
+        head = _head.load(std::memory_order_acquire);
+    }
+    return false;
 }
 
 // =============================================================================
@@ -71,6 +172,7 @@ void Logger::setDebugLevel(int level) {
     if (level >= LOG_NONE && level <= LOG_VERBOSE) {
         _currentDebugLevel = level;
         _preferences.putInt("debugLevel", level);
+        _settingsVersion++;
         info("Debug level changed to: " + String(level));
     }
 }
@@ -86,6 +188,7 @@ int Logger::getDebugLevel() {
 void Logger::setSerialOutputDisabled(bool disabled) {
     _serialOutputDisabled = disabled;
     _preferences.putBool("serialDisabled", disabled);
+    _settingsVersion++;
     info("Serial output " + String(disabled ? "disabled" : "enabled"));
 }
 
@@ -99,48 +202,16 @@ bool Logger::getSerialOutputDisabled() {
 
 String Logger::getNewLogMessages() {
     String result = "";
-    
-    if (_logMessagesMutex != NULL && xSemaphoreTake(_logMessagesMutex, portMAX_DELAY) == pdTRUE) {
-        result = _newMessages;
-        _newMessages = "";  // Clear buffer after reading
-        xSemaphoreGive(_logMessagesMutex);
-    }
-    
-    return result;
-}
+    LogEntry entry;
 
-void Logger::addToWebLog(const String& message) {
-    if (_logMessagesMutex == NULL) {
-        return;
-    }
-    
-    if (xSemaphoreTake(_logMessagesMutex, portMAX_DELAY) == pdTRUE) {
-        // Add timestamp to message
-        String timestampedMessage = "[" + String(millis()) + "] " + message;
-        
-        // Append to new messages buffer
-        if (_newMessages.length() > 0) {
-            _newMessages += "\n";
+    while (readEntry(_webCursor, entry)) {
+        if (result.length() > 0) {
+            result += "\n";
         }
-        _newMessages += timestampedMessage;
-        
-        // Maintain reasonable buffer size
-        manageBufferSize();
-        
-        xSemaphoreGive(_logMessagesMutex);
+        result += "[" + String(entry.timestamp) + "] " + getLevelString(entry.level) + entry.message;
     }
-}
 
-void Logger::manageBufferSize() {
-    const size_t MAX_BUFFER_SIZE = 10000;  // 10KB buffer limit
-    
-    if (_newMessages.length() > MAX_BUFFER_SIZE) {
-        // Keep the most recent messages by removing older entries
-        int splitPos = _newMessages.indexOf('\n', _newMessages.length() / 2);
-        if (splitPos > 0) {
-            _newMessages = _newMessages.substring(splitPos + 1);
-        }
-    }
+    return result;
 }
 
 // =============================================================================
@@ -34,8 +34,44 @@ enum LogLevel {
     LOG_VERBOSE = 5
 };
 
+// Logging writes a compact record into a fixed ring without taking a lock, so any task
+// (including the control task) can log without heap churn or blocking. Consumers keep their
+// own cursor and format records when they drain them: the web UI on request, serial from
+// a drain task.
+// Lowest-priority level compiled in. Calls above it are removed by the compiler; build with
+// e.g. -DLOG_COMPILE_LEVEL=3 to drop debug and verbose logging from the image.
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL 5
+#endif
+
+// Logging macros check the level before the message expression is evaluated, so a
+// filtered call costs one atomic load and builds no Strings
+#define LOG_AT(logger, level, ...) \
+    do { \
+        if ((level) <= LOG_COMPILE_LEVEL && (logger).isEnabled(level)) { \
+            (logger).logMessage((level), __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define LOGE(logger, ...) LOG_AT(logger, LOG_ERROR, __VA_ARGS__)
+#define LOGW(logger, ...) LOG_AT(logger, LOG_WARN, __VA_ARGS__)
+#define LOGI(logger, ...) LOG_AT(logger, LOG_INFO, __VA_ARGS__)
+#define LOGD(logger, ...) LOG_AT(logger, LOG_DEBUG, __VA_ARGS__)
+#define LOGV(logger, ...) LOG_AT(logger, LOG_VERBOSE, __VA_ARGS__)
+
 class Logger {
 public:
+    static constexpr size_t TASK_NAME_SIZE = 12;
+    static constexpr size_t MESSAGE_SIZE = 112;
+
+    // A drained record, copied out of the ring
+    struct LogEntry {
+        uint32_t timestamp;             // millis() when logged
+        LogLevel level;
+        char task[TASK_NAME_SIZE];
+        char message[MESSAGE_SIZE];
+    };
+
     // Constructor
     Logger(Preferences& prefs);
 
@@ -43,14 +79,29 @@ public:
     void begin();
     void logMessage(LogLevel level, const String& message);
 
+    // Draining; readEntry() advances the caller's cursor and returns false when caught up
+    void attachDrainTask(TaskHandle_t drainTask);
+    void drainToSerial();
+    bool readEntry(uint32_t& cursor, LogEntry& entry);
+    uint32_t getDroppedCount() const { return _droppedCount; }
+
+    // Serial TX lock. Everything written to Serial goes out under it a whole line or reply
+    // at a time, so a log line never lands inside a reply a tracking host is parsing.
+    bool lockSerial(TickType_t wait);
+    void unlockSerial();
+
     // Debug level management
     void setDebugLevel(int level);
     int getDebugLevel();
+    bool isEnabled(LogLevel level) const { return level <= _currentDebugLevel.load(std::memory_order_relaxed); }
 
     // Serial output control
     void setSerialOutputDisabled(bool disabled);
     bool getSerialOutputDisabled();
 
+    // Bumped by both setters above, so cached copies of the settings know to refresh
+    uint32_t getSettingsVersion() const { return _settingsVersion; }
+
     // Web interface methods
     String getNewLogMessages();  // Get new messages since last call
 
@@ -68,18 +119,35 @@ private:
     // Configuration
     std::atomic<int> _currentDebugLevel = 1;  // Default to ERROR level
     std::atomic<bool> _serialOutputDisabled = false;  // Default to enabled
+    std::atomic<uint32_t> _settingsVersion = 0;
+
+    // Ring storage. A slot's sequence is odd while a ticket's record is being written and even
+    // once it is published, so readers can tell a finished record from one that is in flight
+    // or reused, and writers can tell whether the record they would replace is finished.
+    struct LogRecord {
+        std::atomic<uint32_t> sequence;
+        uint32_t timestamp;
+        uint8_t level;
+        char task[TASK_NAME_SIZE];
+        char message[MESSAGE_SIZE];
+    };
+    static constexpr uint32_t RING_SIZE = 128;
+    LogRecord _ring[RING_SIZE] = {};
+    std::atomic<uint32_t> _head = 0;            // Next ticket to claim
+    std::atomic<uint32_t> _droppedCount = 0;    // Records overwritten before a consumer read them, or
+                                                // not written because their slot was still in use
 
-    // Thread synchronization
-    SemaphoreHandle_t _logMessagesMutex = NULL;
+    static constexpr uint32_t writingSequence(uint32_t ticket) { return ticket * 2 + 1; }
+    static constexpr uint32_t publishedSequence(uint32_t ticket) { return ticket * 2 + 2; }
 
-    // Web log state
-    String _newMessages = "";           // Store new messages since last request
-    bool _clearRequested = false;       // Flag to signal browser to clear
+    // Consumer cursors, each owned by the one task that drains it
+    uint32_t _webCursor = 0;
+    uint32_t _serialCursor = 0;
+    TaskHandle_t _drainTask = NULL;
+    SemaphoreHandle_t _serialMutex = NULL;
 
     // Utility methods
-    void addToWebLog(const String& message);
-    void manageBufferSize();
-    String getLevelString(LogLevel level);
+    static String getLevelString(LogLevel level);
 };
 
 #endif // LOGGER_H
\ No newline at end of file
@@ -0,0 +1,77 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Metrics Writer - Prometheus text exposition streamed in fixed-size chunks.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "metrics_writer.h"
+
+// =============================================================================
+// CONSTRUCTOR
+// =============================================================================
+
+MetricsWriter::MetricsWriter(HttpServer& server) : _server(server) {
+}
+
+// =============================================================================
+// METRIC OUTPUT
+// =============================================================================
+
+void MetricsWriter::family(const char* name, const char* type, const char* help) {
+    reserve();
+    int written = snprintf(_buffer + _length, BUFFER_SIZE - _length,
+                           "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+    _length += constrain(written, 0, (int)(BUFFER_SIZE - _length - 1));
+}
+
+void MetricsWriter::sample(const char* name, const char* labels, double value) {
+    reserve();
+    int written = (labels != nullptr)
+        ? snprintf(_buffer + _length, BUFFER_SIZE - _length, "%s{%s} %.6g\n", name, labels, value)
+        : snprintf(_buffer + _length, BUFFER_SIZE - _length, "%s %.6g\n", name, value);
+    _length += constrain(written, 0, (int)(BUFFER_SIZE - _length - 1));
+}
+
+void MetricsWriter::sample(const char* name, const char* labels, uint32_t value) {
+    // Counters print as integers so large values keep every digit
+    reserve();
+    int written = (labels != nullptr)
+        ? snprintf(_buffer + _length, BUFFER_SIZE - _length, "%s{%s} %lu\n", name, labels, (unsigned long)value)
+        : snprintf(_buffer + _length, BUFFER_SIZE - _length, "%s %lu\n", name, (unsigned long)value);
+    _length += constrain(written, 0, (int)(BUFFER_SIZE - _length - 1));
+}
+
+void MetricsWriter::finish() {
+    flush();
+    // An empty chunk ends a chunked response
+    _server.sendContent("");
+}
+
+// =============================================================================
+// HELPER METHODS
+// =============================================================================
+
+void MetricsWriter::reserve() {
+    if (BUFFER_SIZE - _length < LINE_RESERVE) {
+        flush();
+    }
+}
+
+void MetricsWriter::flush() {
+    if (_length > 0) {
+        _server.sendContent(_buffer, _length);
+        _length = 0;
+    }
+}
@@ -0,0 +1,55 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Metrics Writer - Prometheus text exposition streamed in fixed-size chunks.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef METRICS_WRITER_H
+#define METRICS_WRITER_H
+
+// System includes
+#include <Arduino.h>
+
+// Custom includes
+#include "http_server.h"
+
+// Formats metrics straight into a stack buffer and hands full chunks to the web server,
+// so a scrape needs no JSON document and no String temporaries. The caller starts a
+// chunked response first; finish() sends the tail and the terminating chunk.
+class MetricsWriter {
+public:
+    // Constructor
+    MetricsWriter(HttpServer& server);
+
+    // Metric output; labels are pre-formatted (e.g. "axis=\"az\"") or nullptr
+    void family(const char* name, const char* type, const char* help);
+    void sample(const char* name, const char* labels, double value);
+    void sample(const char* name, const char* labels, uint32_t value);
+    void finish();
+
+private:
+    static constexpr size_t BUFFER_SIZE = 1024;
+    static constexpr size_t LINE_RESERVE = 160;   // Flush before a line could overflow
+
+    HttpServer& _server;
+    char _buffer[BUFFER_SIZE];
+    size_t _length = 0;
+
+    // Helper methods
+    void reserve();
+    void flush();
+};
+
+#endif // METRICS_WRITER_H
@@ -0,0 +1,143 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Motion Profile - Jerk-limited slew trajectory for a single axis.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "motion_profile.h"
+
+// =============================================================================
+// CONSTRUCTOR AND CONFIGURATION
+// =============================================================================
+
+MotionProfile::MotionProfile() {
+}
+
+void MotionProfile::setLimits(float maxVelocity, float maxAcceleration, float maxJerk) {
+    _maxVelocity = max(maxVelocity, 0.001f);
+    _maxAcceleration = max(maxAcceleration, 0.001f);
+    _maxJerk = max(maxJerk, 0.001f);
+}
+
+// =============================================================================
+// TRAJECTORY CONTROL
+// =============================================================================
+
+void MotionProfile::start(float distance) {
+    // Begin a new move from rest
+    _remaining = distance;
+    _velocity = 0;
+    _acceleration = 0;
+    _active = fabsf(distance) > FINISH_DISTANCE;
+}
+
+void MotionProfile::retarget(float distance) {
+    // Move the target but keep the current velocity and acceleration so the reference stays smooth
+    if (!_active) {
+        start(distance);
+        return;
+    }
+    _remaining = distance;
+}
+
+void MotionProfile::stop() {
+    _remaining = 0;
+    _velocity = 0;
+    _acceleration = 0;
+    _active = false;
+}
+
+void MotionProfile::update(float dt) {
+    if (!_active || dt <= 0) {
+        return;
+    }
+
+    // Work in a frame where the target is ahead
+    float direction = (_remaining >= 0) ? 1.0f : -1.0f;
+    float distance = fabsf(_remaining);
+    float velocity = _velocity * direction;
+    float acceleration = _acceleration * direction;
+
+    // Brake as soon as stopping from the next state would carry us past the target
+    float nextVelocity = velocity + acceleration * dt;
+    bool braking = nextVelocity > 0 &&
+                   stoppingDistance(nextVelocity, acceleration) + velocity * dt >= distance;
+
+    float jerk;
+    if (braking) {
+        jerk = -_maxJerk;
+    } else if (acceleration > 0 && velocity + acceleration * acceleration / (2 * _maxJerk) >= _maxVelocity) {
+        // Ease off so cruise velocity is reached without overshooting it
+        jerk = -_maxJerk;
+    } else if (velocity < _maxVelocity) {
+        jerk = _maxJerk;
+    } else {
+        jerk = (acceleration > 0) ? -_maxJerk : ((acceleration < 0) ? _maxJerk : 0);
+    }
+
+    acceleration = constrain(acceleration + jerk * dt, -_maxAcceleration, _maxAcceleration);
+    if (velocity + acceleration * dt > _maxVelocity) {
+        acceleration = (_maxVelocity - velocity) / dt;
+    }
+    velocity += acceleration * dt;
+    distance -= velocity * dt;
+
+    // Braking down to rest, reaching the target, or arriving slowly completes the move.
+    // At coarse time steps the last step can land slightly past the target; snap to it.
+    if ((braking && velocity <= 0) || (distance <= 0 && velocity > 0) ||
+        (fabsf(distance) < FINISH_DISTANCE && fabsf(velocity) < FINISH_VELOCITY)) {
+        stop();
+        return;
+    }
+
+    _remaining = distance * direction;
+    _velocity = velocity * direction;
+    _acceleration = acceleration * direction;
+}
+
+// =============================================================================
+// HELPER METHODS
+// =============================================================================
+
+float MotionProfile::stoppingDistance(float velocity, float acceleration) const {
+    // Distance covered while braking from (velocity, acceleration) to rest: ramp the
+    // acceleration down to the deceleration peak, hold it, then ramp it back to zero
+    const float A = _maxAcceleration;
+    const float J = _maxJerk;
+    acceleration = max(acceleration, -A);
+
+    float peak = sqrtf(max((2 * J * velocity + acceleration * acceleration) / 2, 0.0f));
+    if (peak <= A) {
+        // Triangular deceleration, never reaches the limit
+        peak = max(peak, -acceleration);
+        float t1 = (acceleration + peak) / J;
+        float d1 = velocity * t1 + acceleration * t1 * t1 / 2 - J * t1 * t1 * t1 / 6;
+        float v1 = velocity + acceleration * t1 - J * t1 * t1 / 2;
+        float t3 = peak / J;
+        float d3 = v1 * t3 - peak * t3 * t3 / 2 + J * t3 * t3 * t3 / 6;
+        return d1 + d3;
+    }
+
+    // Trapezoidal deceleration
+    float t1 = (acceleration + A) / J;
+    float d1 = velocity * t1 + acceleration * t1 * t1 / 2 - J * t1 * t1 * t1 / 6;
+    float v1 = velocity + acceleration * t1 - J * t1 * t1 / 2;
+    float t2 = (v1 - A * A / (2 * J)) / A;
+    float d2 = v1 * t2 - A * t2 * t2 / 2;
+    float v2 = v1 - A * t2;
+    float t3 = A / J;
+    float d3 = v2 * t3 - A * t3 * t3 / 2 + J * t3 * t3 * t3 / 6;
+    return d1 + d2 + d3;
+}
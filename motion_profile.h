@@ -0,0 +1,70 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Motion Profile - Jerk-limited slew trajectory for a single axis.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MOTION_PROFILE_H
+#define MOTION_PROFILE_H
+
+// System includes
+#include <Arduino.h>
+
+// Generates an S-curve reference that moves from the current position to the target
+// in (close to) minimum time without exceeding the velocity, acceleration and jerk limits.
+// The profile works on the remaining distance only, so callers can stay in error space
+// and keep their own angle wrapping rules.
+class MotionProfile {
+public:
+    // Constructor
+    MotionProfile();
+
+    // Configuration
+    void setLimits(float maxVelocity, float maxAcceleration, float maxJerk);
+
+    // Trajectory control
+    void start(float distance);
+    void retarget(float distance);
+    void stop();
+    void update(float dt);
+
+    // State access
+    bool isActive() const { return _active; }
+    float getRemaining() const { return _remaining; }
+    float getVelocity() const { return _velocity; }
+    float getAcceleration() const { return _acceleration; }
+
+private:
+    // Completion thresholds
+    static constexpr float FINISH_DISTANCE = 0.005f;  // Degrees
+    static constexpr float FINISH_VELOCITY = 0.05f;   // Degrees per second
+
+    // Limits
+    float _maxVelocity = 1.0f;
+    float _maxAcceleration = 1.0f;
+    float _maxJerk = 1.0f;
+
+    // Reference state; velocity and acceleration are positive towards the target
+    // while remaining > 0
+    float _remaining = 0;
+    float _velocity = 0;
+    float _acceleration = 0;
+    bool _active = false;
+
+    // Helper methods
+    float stoppingDistance(float velocity, float acceleration) const;
+};
+
+#endif // MOTION_PROFILE_H
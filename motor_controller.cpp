@@ -19,6 +19,70 @@
 #include "motor_controller.h"
 #include "weather_poller.h"  // Include for wind safety integration
 
+// =============================================================================
+// AS5600 SIN/COS LOOKUP TABLE
+// =============================================================================
+
+namespace {
+
+constexpr int AS5600_COUNTS = 4096;
+constexpr double AS5600_RAD_PER_COUNT = 2.0 * 3.14159265358979323846 / AS5600_COUNTS;
+
+// Taylor series, only ever evaluated at compile time on |x| <= pi/4
+constexpr double taylorSin(double x) {
+    double term = x;
+    double sum = x;
+    for (int n = 1; n < 12; n++) {
+        term *= -x * x / ((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double taylorCos(double x) {
+    double term = 1.0;
+    double sum = 1.0;
+    for (int n = 1; n < 12; n++) {
+        term *= -x * x / ((2 * n - 1) * (2 * n));
+        sum += term;
+    }
+    return sum;
+}
+
+// Sine of a raw count, folded into the first octant so the series stays accurate
+constexpr double sinOfCount(int count) {
+    int quadrant = count / (AS5600_COUNTS / 4);
+    int offset = count % (AS5600_COUNTS / 4);
+    double s = (offset <= AS5600_COUNTS / 8) ? taylorSin(offset * AS5600_RAD_PER_COUNT)
+                                             : taylorCos((AS5600_COUNTS / 4 - offset) * AS5600_RAD_PER_COUNT);
+    double c = (offset <= AS5600_COUNTS / 8) ? taylorCos(offset * AS5600_RAD_PER_COUNT)
+                                             : taylorSin((AS5600_COUNTS / 4 - offset) * AS5600_RAD_PER_COUNT);
+    return quadrant == 0 ? s : quadrant == 1 ? c : quadrant == 2 ? -s : -c;
+}
+
+struct As5600SinTable {
+    float value[AS5600_COUNTS];
+
+    constexpr As5600SinTable() : value() {
+        for (int i = 0; i < AS5600_COUNTS; i++) {
+            value[i] = static_cast<float>(sinOfCount(i));
+        }
+    }
+};
+
+// One table serves both functions: cos(n) = sin(n + 90 degrees)
+constexpr As5600SinTable AS5600_SIN_TABLE;
+
+inline float as5600Sin(uint16_t count) {
+    return AS5600_SIN_TABLE.value[count & (AS5600_COUNTS - 1)];
+}
+
+inline float as5600Cos(uint16_t count) {
+    return AS5600_SIN_TABLE.value[(count + AS5600_COUNTS / 4) & (AS5600_COUNTS - 1)];
+}
+
+} // namespace
+
 // =============================================================================
 // CONSTRUCTOR AND INITIALIZATION
 // =============================================================================
@@ -27,13 +91,8 @@ MotorSensorController::MotorSensorController(Preferences& prefs, INA219Manager&
     : _preferences(prefs), ina219Manager(ina219Manager), _logger(logger) {
     
     // Create mutexes for thread-safe access
-    _setPointMutex = xSemaphoreCreateMutex();
     _getAngleMutex = xSemaphoreCreateMutex();
-    _correctedAngleMutex = xSemaphoreCreateMutex();
-    _errorMutex = xSemaphoreCreateMutex();
-    _el_startAngleMutex = xSemaphoreCreateMutex();
     _windStowMutex = xSemaphoreCreateMutex();
-    _offsetMutex = xSemaphoreCreateMutex();
     
     // Initialize wind tracking
     _lastManualSetpointTime = millis();
@@ -49,10 +108,25 @@ void MotorSensorController::begin() {
     _MIN_EL_TOLERANCE = _preferences.getFloat("MIN_EL_TOL", 0.1);
     _maxPowerBeforeFault = _preferences.getInt("MAX_POWER", 10);
     _minVoltageThreshold = _preferences.getInt("MIN_VOLTAGE", 6);
+
+    _controllerMode = _preferences.getInt("ctrlMode", CONTROLLER_LEGACY);
+    _motionProfileEnabled = _preferences.getBool("motionProfile", false);
+    Ki_az = _preferences.getFloat("Ki_az", 0);
+    Kd_az = _preferences.getFloat("Kd_az", 0);
+    Kff_az = _preferences.getFloat("Kff_az", 11);
+    Ki_el = _preferences.getFloat("Ki_el", 0);
+    Kd_el = _preferences.getFloat("Kd_el", 0);
+    Kff_el = _preferences.getFloat("Kff_el", 33);
+
+    int controlPeriodUs = _preferences.getInt("ctrlPeriodUs", 0);
+    if (controlPeriodUs != 0 && (controlPeriodUs < MIN_CONTROL_PERIOD_US || controlPeriodUs > MAX_CONTROL_PERIOD_US)) {
+        controlPeriodUs = 0;
+    }
+    _controlPeriodUs = controlPeriodUs;
     _az_offset = _preferences.getFloat("az_offset", 0.0);
     _el_offset = _preferences.getFloat("el_offset", 0.0);
 
-    _logger.info("Angle offsets loaded - AZ: " + String(_az_offset, 3) + "°, EL: " + String(_el_offset, 3) + "°");
+    LOGI(_logger, "Angle offsets loaded - AZ: " + String(_az_offset.load(), 3) + "°, EL: " + String(_el_offset.load(), 3) + "°");
 
     // Configure motor control pins
     pinMode(_pwm_pin_az, OUTPUT);
@@ -77,35 +151,37 @@ void MotorSensorController::begin() {
     int el_magnetStatus = checkMagnetPresence(_el_hall_i2c_addr);
 
     // Log magnet status
-    _logger.info("AZ Magnet Detected (MD): " + String((az_magnetStatus & 32) > 0));
-    _logger.info("AZ Magnet Too Weak (ML): " + String((az_magnetStatus & 16) > 0));
-    _logger.info("AZ Magnet Too Strong (MH): " + String((az_magnetStatus & 8) > 0));
-    _logger.info("EL Magnet Detected (MD): " + String((el_magnetStatus & 32) > 0));
-    _logger.info("EL Magnet Too Weak (ML): " + String((el_magnetStatus & 16) > 0));
-    _logger.info("EL Magnet Too Strong (MH): " + String((el_magnetStatus & 8) > 0));
+    LOGI(_logger, "AZ Magnet Detected (MD): " + String((az_magnetStatus & 32) > 0));
+    LOGI(_logger, "AZ Magnet Too Weak (ML): " + String((az_magnetStatus & 16) > 0));
+    LOGI(_logger, "AZ Magnet Too Strong (MH): " + String((az_magnetStatus & 8) > 0));
+    LOGI(_logger, "EL Magnet Detected (MD): " + String((el_magnetStatus & 32) > 0));
+    LOGI(_logger, "EL Magnet Too Weak (ML): " + String((el_magnetStatus & 16) > 0));
+    LOGI(_logger, "EL Magnet Too Strong (MH): " + String((el_magnetStatus & 8) > 0));
 
     // Set magnet fault flags
     if ((az_magnetStatus & 32) == 0) {
-        _logger.error("NO AZ MAGNET DETECTED!");
+        LOGE(_logger, "NO AZ MAGNET DETECTED!");
         magnetFault = true;
     }
     
     if ((el_magnetStatus & 32) == 0) {
-        _logger.error("NO EL MAGNET DETECTED!");
+        LOGE(_logger, "NO EL MAGNET DETECTED!");
         magnetFault = true;
     }
 
     // Initialize azimuth positioning
     float degAngleAz = getAvgAngle(_az_hall_i2c_addr);
+    seedSampler(_azSampler, degAngleAz);
     _az_startAngle = 10; // Avoid 0 to prevent backlash switching between 0 and 359
     setCorrectedAngleAz(correctAngle(getAdjustedAzStartAngle(), degAngleAz));
     needs_unwind = _preferences.getInt("needs_unwind", 0);
 
     // Initialize elevation positioning
     float degAngleEl = getAvgAngle(_el_hall_i2c_addr);
+    seedSampler(_elSampler, degAngleEl);
     setElStartAngle(_preferences.getFloat("el_cal", degAngleEl));
 
-    _logger.info("EL START ANGLE: " + String(getElStartAngle()));
+    LOGI(_logger, "EL START ANGLE: " + String(getElStartAngle()));
     setCorrectedAngleEl(correctAngle(getAdjustedElStartAngle(), degAngleEl));
 
     // Set home position
@@ -114,6 +190,9 @@ void MotorSensorController::begin() {
     
     // Initialize manual setpoint time
     _lastManualSetpointTime = millis();
+
+    // Readers must see the boot position before the first control tick
+    publishTelemetry();
 }
 
 // =============================================================================
@@ -122,7 +201,12 @@ void MotorSensorController::begin() {
 
 void MotorSensorController::setWeatherPoller(WeatherPoller* weatherPoller) {
     _weatherPoller = weatherPoller;
-    _logger.info("Weather poller integration enabled");
+    LOGI(_logger, "Weather poller integration enabled");
+}
+
+void MotorSensorController::setPlantSimulator(PlantSimulator* plant) {
+    _plant = plant;
+    LOGW(_logger, "SIMULATED PLANT - motors and hall sensors are not being driven");
 }
 
 // =============================================================================
@@ -130,97 +214,137 @@ void MotorSensorController::setWeatherPoller(WeatherPoller* weatherPoller) {
 // =============================================================================
 
 void MotorSensorController::runControlLoop() {
+    _profiler.startCycle();
+
     // Update wind stow status first
     updateWindStowStatus();
     
     // Update wind tracking status
     updateWindTrackingStatus();
-    
-    // Get current setpoints and update flags
-    float current_setpoint_az = getSetPointAz();
-    float current_setpoint_el = getSetPointEl();    
-    bool setPointAzUpdated = _setPointAzUpdated;
-    bool setPointElUpdated = _setPointElUpdated;
-
-    // Reset update flags
-    if (_setPointAzUpdated) _setPointAzUpdated = false;
-    if (_setPointElUpdated) _setPointElUpdated = false;
-
-    // Read and process azimuth angle
-    float degAngleAz = getAvgAngle(_az_hall_i2c_addr);
+    _profiler.mark(ControlLoopProfiler::STAGE_WIND);
+    
+    // Measure the loop period for the PID and motion profile
+    unsigned long nowMicros = micros();
+    float dt = (_lastControlMicros == 0) ? 0.025f : (nowMicros - _lastControlMicros) / 1000000.0f;
+    dt = constrain(dt, 0.0005f, 0.1f);
+    _lastControlMicros = nowMicros;
+
+    // Consume update flags before reading setpoints; setters store the setpoint first,
+    // so a raised flag is always paired with the new value
+    bool setPointAzUpdated = _setPointAzUpdated.exchange(false);
+    bool setPointElUpdated = _setPointElUpdated.exchange(false);
+    float current_setpoint_az = _setpoint_az;
+    float current_setpoint_el = _setpoint_el;
+
+    // A live tracking stream supplies an interpolated reference every tick. Its start and
+    // end are treated as setpoint changes; the points in between are not, so the axes
+    // keep moving instead of restarting a move for every point
+    bool streaming = _setpointStream.sample(millis(), _streamSetpoint_az, _streamSetpoint_el);
+    if (streaming) {
+        current_setpoint_az = _streamSetpoint_az;
+        current_setpoint_el = _streamSetpoint_el;
+    }
+    if (streaming != _streamActive) {
+        _streamActive = streaming;
+        setPointAzUpdated = true;
+        setPointElUpdated = true;
+        LOGI(_logger, streaming ? "Tracking stream started" : "Tracking stream ended");
+    }
+    _profiler.mark(ControlLoopProfiler::STAGE_SETPOINT);
+
+    // Read and process azimuth angle (latest filtered value from the sensor task)
+    float degAngleAz = getLatestAngle(_azSampler, "AZ");
     setCorrectedAngleAz(correctAngle(getAdjustedAzStartAngle(), degAngleAz));
     
     if (!calMode) {
-        calcIfNeedsUnwind(getCorrectedAngleAz());
+        calcIfNeedsUnwind(_correctedAngle_az);
     }
 
     // Read and process elevation angle
-    float degAngleEl = getAvgAngle(_el_hall_i2c_addr);
+    float degAngleEl = getLatestAngle(_elSampler, "EL");
     setCorrectedAngleEl(correctAngle(getAdjustedElStartAngle(), degAngleEl));
+    _profiler.mark(ControlLoopProfiler::STAGE_SENSORS);
 
     // Calculate control errors
-    angle_shortest_error_az(current_setpoint_az, getCorrectedAngleAz());
-    angle_error_el(current_setpoint_el, getCorrectedAngleEl());
+    angle_shortest_error_az(current_setpoint_az, _correctedAngle_az);
+    angle_error_el(current_setpoint_el, _correctedAngle_el);
+    _profiler.mark(ControlLoopProfiler::STAGE_ERRORS);
 
     // Update error tracking for convergence safety
     if (!calMode) {
         updateErrorTracking();
         //checkStall(); // TEMP DISABLE
+        _profiler.mark(ControlLoopProfiler::STAGE_ERROR_TRACKING);
     }
 
     // Execute control logic - but check for movement blocking first
     if (!calMode) {
-        updateMotorControl(current_setpoint_az, current_setpoint_el, setPointAzUpdated, setPointElUpdated);
+        // One mode for the whole tick, so a change from the web never mixes PID and P output
+        _tickControllerMode = _controllerMode;
+        updateMotionProfiles(setPointAzUpdated, setPointElUpdated, dt);
+        updateMotorControl(setPointAzUpdated, setPointElUpdated);
         updateMotorPriority(setPointAzUpdated, setPointElUpdated);
+
+        if (_tickControllerMode == CONTROLLER_PID) {
+            // The PID follows the profile reference, so its feed-forward sees the profile velocity
+            updatePid(_azPid, _controlError_az, current_setpoint_az - _azProfile.getRemaining(),
+                      P_az, Ki_az, Kd_az, Kff_az, MIN_AZ_SPEED,
+                      setPointState_az && !_isAzMotorLatched && !global_fault, _azProfile.isActive(), dt);
+            updatePid(_elPid, _controlError_el, current_setpoint_el - _elProfile.getRemaining(),
+                      P_el, Ki_el, Kd_el, Kff_el, MIN_EL_SPEED,
+                      setPointState_el && !_isElMotorLatched && !global_fault, _elProfile.isActive(), dt);
+        }
+        _profiler.mark(ControlLoopProfiler::STAGE_CONTROL);
                 
         actuate_motor_az(MIN_AZ_SPEED);
         actuate_motor_el(MIN_EL_SPEED);
     } else {
         handleCalibrationMode();
     }
+    _profiler.mark(ControlLoopProfiler::STAGE_ACTUATION);
 
     handleOscillationDetection();
+    _profiler.mark(ControlLoopProfiler::STAGE_OSCILLATION);
+
+    publishTelemetry();
+    _profiler.mark(ControlLoopProfiler::STAGE_TELEMETRY);
+    _profiler.endCycle();
 }
 
 void MotorSensorController::runSafetyLoop() {
     String errorText = "";
-    bool hasNewErrors = false;
 
     // Check fault conditions
     if (badAngleFlag) {
         global_fault = true;
         errorText += "Bad angle.\n";
-        hasNewErrors = true;
     }
 
     if (magnetFault) {
         global_fault = true;
         errorText += "MAGNET NOT DETECTED.\n";
-        hasNewErrors = true;
     }
 
     if (i2cErrorFlag_az) {
         global_fault = true;
         errorText += "Communications error in AZ i2c communications.\n";
-        hasNewErrors = true;
     }
 
     if (i2cErrorFlag_el) {
         global_fault = true;
         errorText += "Communications error in EL i2c communications.\n";
-        hasNewErrors = true;
     }
 
     // Check elevation bounds (if not in calibration mode)
     if (!calMode) {
-        if ((getCorrectedAngleEl() > 100 && getCorrectedAngleEl() < 350) || isnan(getCorrectedAngleEl())) {
+        float correctedAngle_el = getCorrectedAngleEl();
+        if ((correctedAngle_el > 100 && correctedAngle_el < 350) || isnan(correctedAngle_el)) {
             outOfBoundsFault = true;
         }
 
         if (outOfBoundsFault) {
             global_fault = true;
-            errorText += "EL went out of bounds. Value: " + String(getCorrectedAngleEl()) + "\n";
-            hasNewErrors = true;
+            errorText += "EL went out of bounds. Value: " + String(correctedAngle_el) + "\n";
         }
     }
 
@@ -231,7 +355,6 @@ void MotorSensorController::runSafetyLoop() {
         if (overSpinFault) {
             global_fault = true;
             errorText += "Needs_unwind went beyond 1, AZ has over spun. Needs_unwind value: " + String(needs_unwind) + "\n";
-            hasNewErrors = true;
         }
     }
 
@@ -244,7 +367,6 @@ void MotorSensorController::runSafetyLoop() {
         if (overPowerFault) {
             global_fault = true;
             errorText += "Power exceeded " + String(getMaxPowerBeforeFault()) + "W. Rotator may be stuck or jammed. Power: " + String(powerValue) + "W\n";
-            hasNewErrors = true;
         }
 
         // Check voltage level (only when NOT in emergency wind stow)
@@ -254,7 +376,6 @@ void MotorSensorController::runSafetyLoop() {
         if (lowVoltageFault) {
             global_fault = true;
             errorText += "Voltage too low. Voltage: " + String(loadVoltageValue) + "V\n";
-            hasNewErrors = true;
         }
     } else {
         // During emergency wind stow, log power consumption but don't fault
@@ -263,7 +384,7 @@ void MotorSensorController::runSafetyLoop() {
         
         static unsigned long lastStowPowerLog = 0;
         if (millis() - lastStowPowerLog > 2000) { // Log every 2 seconds during stow
-            _logger.info("EMERGENCY STOW - Power: " + String(powerValue, 1) + "W, Voltage: " + 
+            LOGI(_logger, "EMERGENCY STOW - Power: " + String(powerValue, 1) + "W, Voltage: " + 
                         String(loadVoltageValue, 1) + "V (safety limits bypassed)");
             lastStowPowerLog = millis();
         }
@@ -280,7 +401,6 @@ void MotorSensorController::runSafetyLoop() {
         if (errorDivergenceFault) {
             global_fault = true;
             errorText += "MOTOR ERROR DIVERGENCE DETECTED. Errors are increasing instead of decreasing.\n";
-            hasNewErrors = true;
         }
     }
 
@@ -289,12 +409,72 @@ void MotorSensorController::runSafetyLoop() {
         setPWM(_pwm_pin_el, 255);
         setPWM(_pwm_pin_az, 255);
         errorText += "EMERGENCY ALL STOP. RESTART ESP32 TO CLEAR FAULTS.\n";
-        hasNewErrors = true;
         slowPrint(errorText, 0);
     }
 }
 
 
+void MotorSensorController::runSensorLoop() {
+    if (_getAngleMutex == NULL || xSemaphoreTake(_getAngleMutex, portMAX_DELAY) != pdTRUE) {
+        return;
+    }
+
+    // Interleave AZ and EL reads so both windows advance at the same rate
+    sampleSensor(_az_hall_i2c_addr, _azSampler);
+    sampleSensor(_el_hall_i2c_addr, _elSampler);
+
+    xSemaphoreGive(_getAngleMutex);
+}
+
+void MotorSensorController::attachControlTask(TaskHandle_t controlTask) {
+    _controlTask = controlTask;
+
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.callback = &MotorSensorController::controlTimerCallback;
+    timerArgs.arg = this;
+    timerArgs.dispatch_method = ESP_TIMER_TASK;
+    timerArgs.name = "control";
+
+    if (esp_timer_create(&timerArgs, &_controlTimer) != ESP_OK) {
+        LOGE(_logger, "Failed to create control timer, staying on the 25 ms loop");
+        _controlTimer = nullptr;
+        _controlPeriodUs = 0;
+        return;
+    }
+
+    applyControlPeriod();
+}
+
+void MotorSensorController::controlTimerCallback(void* arg) {
+    MotorSensorController* self = static_cast<MotorSensorController*>(arg);
+    xTaskNotifyGive(self->_controlTask);
+}
+
+void MotorSensorController::applyControlPeriod() {
+    if (_controlTimer == nullptr) {
+        return;
+    }
+
+    // Stop fails harmlessly if the timer was not running
+    esp_timer_stop(_controlTimer);
+
+    int periodUs = _controlPeriodUs;
+    if (periodUs > 0) {
+        esp_timer_start_periodic(_controlTimer, periodUs);
+        LOGI(_logger, "Control loop running at " + String(1000000 / periodUs) + " Hz");
+    } else {
+        LOGI(_logger, "Control loop running at legacy 25 ms period");
+    }
+}
+
+float MotorSensorController::getRampStep() {
+    // Keep the legacy ramp rate (10 counts per 25 ms) regardless of loop period
+    int periodUs = _controlPeriodUs > 0 ? _controlPeriodUs.load() : LEGACY_CONTROL_PERIOD_US;
+    float step = RAMP_STEP_PER_LEGACY_TICK * periodUs / LEGACY_CONTROL_PERIOD_US;
+    return _windStowActive ? step * 2 : step;  // Faster speed ramp during stow
+}
+
+
 // =============================================================================
 // WIND SAFETY METHODS
 // =============================================================================
@@ -332,10 +512,10 @@ void MotorSensorController::setWindStowActive(bool active, const String& reason,
         _windStowDirection = direction;
         
         if (active && !wasActive) {
-            _logger.warn("EMERGENCY WIND STOW ACTIVATED: " + reason + 
+            LOGW(_logger, "EMERGENCY WIND STOW ACTIVATED: " + reason + 
                        " - Moving to safe direction: " + String(direction, 1) + "°");
-            _logger.warn("POWER SAFETY OVERRIDES ENABLED - Power and voltage limits bypassed for emergency stow");
-            _logger.warn("Using emergency motor gains - AZ P=" + String(EMERGENCY_STOW_P_AZ) + 
+            LOGW(_logger, "POWER SAFETY OVERRIDES ENABLED - Power and voltage limits bypassed for emergency stow");
+            LOGW(_logger, "Using emergency motor gains - AZ P=" + String(EMERGENCY_STOW_P_AZ) + 
                        ", EL P=" + String(EMERGENCY_STOW_P_EL));
             
             // Clear any existing power/voltage faults to allow emergency movement
@@ -343,7 +523,7 @@ void MotorSensorController::setWindStowActive(bool active, const String& reason,
             lowVoltageFault = false;
             
         } else if (!active && wasActive) {
-            _logger.info("Emergency wind stow deactivated - normal operation and safety limits resumed");
+            LOGI(_logger, "Emergency wind stow deactivated - normal operation and safety limits resumed");
         }
         
         xSemaphoreGive(_windStowMutex);
@@ -411,17 +591,17 @@ void MotorSensorController::updateWindTrackingStatus() {
     bool shouldActivate = shouldActivateWindTracking();
     
     if (shouldActivate && !_windTrackingActive) {
-        _logger.info(">>> ACTIVATING wind tracking - 60 second timeout reached <<<");
+        LOGI(_logger, ">>> ACTIVATING wind tracking - 60 second timeout reached <<<");
         setWindTrackingActive(true);
         // Immediately perform wind tracking to move to current position
-        _logger.debug("Calling performWindTracking() immediately after activation");
+        LOGD(_logger, "Calling performWindTracking() immediately after activation");
         performWindTracking();
     } else if (!shouldActivate && _windTrackingActive) {
-        _logger.info(">>> DEACTIVATING wind tracking - conditions no longer met <<<");
+        LOGI(_logger, ">>> DEACTIVATING wind tracking - conditions no longer met <<<");
         setWindTrackingActive(false);
     } else if (_windTrackingActive) {
         // Continue normal wind tracking
-        _logger.debug("Continuing wind tracking (already active)");
+        LOGD(_logger, "Continuing wind tracking (already active)");
         performWindTracking();
     }
 }
@@ -429,22 +609,22 @@ void MotorSensorController::updateWindTrackingStatus() {
 
 bool MotorSensorController::shouldActivateWindTracking() {
     if (_weatherPoller == nullptr) {
-        _logger.debug("Wind tracking blocked: No weather poller");
+        LOGD(_logger, "Wind tracking blocked: No weather poller");
         return false;
     }
     
     if (!_weatherPoller->isWindBasedHomeEnabled()) {
-        _logger.debug("Wind tracking blocked: Wind-based home not enabled in settings");
+        LOGD(_logger, "Wind tracking blocked: Wind-based home not enabled in settings");
         return false;
     }
     
     if (_windStowActive) {
-        _logger.debug("Wind tracking blocked: Emergency wind stow active");
+        LOGD(_logger, "Wind tracking blocked: Emergency wind stow active");
         return false;
     }
     
     if (calMode) {
-        _logger.debug("Wind tracking blocked: Calibration mode active");
+        LOGD(_logger, "Wind tracking blocked: Calibration mode active");
         return false;
     }
     
@@ -453,22 +633,22 @@ bool MotorSensorController::shouldActivateWindTracking() {
     
     if (timeSinceManual < MANUAL_SETPOINT_TIMEOUT) {
         unsigned long remainingTime = MANUAL_SETPOINT_TIMEOUT - timeSinceManual;
-        _logger.debug("Wind tracking blocked: Manual timeout not reached (" + 
+        LOGD(_logger, "Wind tracking blocked: Manual timeout not reached (" + 
                      String(timeSinceManual/1000) + "s elapsed, " + 
                      String(remainingTime/1000) + "s remaining)");
         return false;
     }
     
     if (!_weatherPoller->isDataValid()) {
-        _logger.debug("Wind tracking blocked: Weather data not valid");
+        LOGD(_logger, "Wind tracking blocked: Weather data not valid");
         String error = _weatherPoller->getLastError();
         if (error.length() > 0) {
-            _logger.debug("  Weather error: " + error);
+            LOGD(_logger, "  Weather error: " + error);
         }
         return false;
     }
     
-    _logger.debug("Wind tracking CAN activate - all conditions met");
+    LOGD(_logger, "Wind tracking CAN activate - all conditions met");
     return true;
 }
 
@@ -479,10 +659,10 @@ void MotorSensorController::setWindTrackingActive(bool active) {
     if (active && !wasActive) {
         // Reset the last direction to force movement on first activation
         _lastWindTrackingDirection = -999.0;  // Invalid direction to force first update
-        _logger.info("Wind tracking ACTIVATED - will move to current wind home position");
-        _logger.debug("Reset last wind direction to force initial movement");
+        LOGI(_logger, "Wind tracking ACTIVATED - will move to current wind home position");
+        LOGD(_logger, "Reset last wind direction to force initial movement");
     } else if (!active && wasActive) {
-        _logger.info("Wind tracking DEACTIVATED");
+        LOGI(_logger, "Wind tracking DEACTIVATED");
     }
 }
 
@@ -494,14 +674,14 @@ void MotorSensorController::performWindTracking() {
     // Get current weather data
     WeatherData weatherData = _weatherPoller->getWeatherData();
     if (!weatherData.dataValid) {
-        _logger.debug("Wind tracking skipped: Weather data not valid");
+        LOGD(_logger, "Wind tracking skipped: Weather data not valid");
         return;
     }
     
     // Calculate optimal direction based on current wind
     float optimalDirection = _weatherPoller->calculateOptimalStowDirection(weatherData.currentWindDirection);
     
-    _logger.debug("Wind tracking check - Current wind: " + String(weatherData.currentWindDirection, 1) + 
+    LOGD(_logger, "Wind tracking check - Current wind: " + String(weatherData.currentWindDirection, 1) + 
                  "°, Optimal: " + String(optimalDirection, 1) + 
                  "°, Last: " + String(_lastWindTrackingDirection, 1) + "°");
     
@@ -513,20 +693,20 @@ void MotorSensorController::performWindTracking() {
             "INITIAL wind home positioning" : 
             "Wind direction change (" + String(directionChange, 1) + "°)";
         
-        _logger.info("WIND TRACKING UPDATE - " + reason);
-        _logger.info("  Current wind direction: " + String(weatherData.currentWindDirection, 1) + "°");
-        _logger.info("  Optimal dish direction: " + String(optimalDirection, 1) + "°");
-        _logger.info("  Previous dish direction: " + String(_lastWindTrackingDirection, 1) + "°");
+        LOGI(_logger, "WIND TRACKING UPDATE - " + reason);
+        LOGI(_logger, "  Current wind direction: " + String(weatherData.currentWindDirection, 1) + "°");
+        LOGI(_logger, "  Optimal dish direction: " + String(optimalDirection, 1) + "°");
+        LOGI(_logger, "  Previous dish direction: " + String(_lastWindTrackingDirection, 1) + "°");
         
         // Update setpoints using internal methods to avoid triggering manual command tracking
         setSetPointAzInternal(optimalDirection);
         setSetPointElInternal(0.0);  // Keep elevation at 0 for wind tracking
         
         _lastWindTrackingDirection = optimalDirection;
-        _logger.info("  New setpoints: Az=" + String(optimalDirection, 1) + "°, El=0.0°");
+        LOGI(_logger, "  New setpoints: Az=" + String(optimalDirection, 1) + "°, El=0.0°");
         
     } else {
-        _logger.debug("Wind tracking: No movement needed (direction unchanged)");
+        LOGD(_logger, "Wind tracking: No movement needed (direction unchanged)");
     }
 }
 
@@ -555,20 +735,20 @@ String MotorSensorController::getWindTrackingStatus() {
 void MotorSensorController::setSetPointAz(float value) {
     // Block external setpoint changes during wind stow (except during calibration)
     if (_windStowActive && !calMode) {
-        _logger.warn("Azimuth setpoint change blocked - wind stow active");
+        LOGW(_logger, "Azimuth setpoint change blocked - wind stow active");
         return;
     }
     
     // Record manual setpoint command time and deactivate wind tracking
     _lastManualSetpointTime = millis();
     
-    _logger.info("MANUAL AZ command: " + String(value, 2) + "°");
+    LOGI(_logger, "MANUAL AZ command: " + String(value, 2) + "°");
     if (_weatherPoller != nullptr && _weatherPoller->isWindBasedHomeEnabled()) {
-        _logger.info("  Wind home will activate in " + String(MANUAL_SETPOINT_TIMEOUT/1000) + " seconds");
+        LOGI(_logger, "  Wind home will activate in " + String(MANUAL_SETPOINT_TIMEOUT/1000) + " seconds");
     }
     
     if (_windTrackingActive) {
-        _logger.info("  Deactivating wind tracking due to manual command");
+        LOGI(_logger, "  Deactivating wind tracking due to manual command");
         setWindTrackingActive(false);
     }
     
@@ -578,20 +758,20 @@ void MotorSensorController::setSetPointAz(float value) {
 void MotorSensorController::setSetPointEl(float value) {
     // Block external setpoint changes during wind stow (except during calibration)
     if (_windStowActive && !calMode) {
-        _logger.warn("Elevation setpoint change blocked - wind stow active");
+        LOGW(_logger, "Elevation setpoint change blocked - wind stow active");
         return;
     }
     
     // Record manual setpoint command time and deactivate wind tracking
     _lastManualSetpointTime = millis();
     
-    _logger.info("MANUAL EL command: " + String(value, 2) + "°");
+    LOGI(_logger, "MANUAL EL command: " + String(value, 2) + "°");
     if (_weatherPoller != nullptr && _weatherPoller->isWindBasedHomeEnabled()) {
-        _logger.info("  Wind home will activate in " + String(MANUAL_SETPOINT_TIMEOUT/1000) + " seconds");
+        LOGI(_logger, "  Wind home will activate in " + String(MANUAL_SETPOINT_TIMEOUT/1000) + " seconds");
     }
     
     if (_windTrackingActive) {
-        _logger.info("  Deactivating wind tracking due to manual command");
+        LOGI(_logger, "  Deactivating wind tracking due to manual command");
         setWindTrackingActive(false);
     }
     
@@ -599,20 +779,39 @@ void MotorSensorController::setSetPointEl(float value) {
 }
 
 
-void MotorSensorController::setSetPointAzInternal(float value) {
-    if (_setPointMutex != NULL && xSemaphoreTake(_setPointMutex, portMAX_DELAY) == pdTRUE) {
-        _setpoint_az = value;
-        _setPointAzUpdated = true;
-        xSemaphoreGive(_setPointMutex);
+void MotorSensorController::streamSetPoint(float setpoint_az, float setpoint_el, unsigned long timeMs) {
+    // Block tracking during wind stow (except during calibration)
+    if (_windStowActive && !calMode) {
+        LOGW(_logger, "Tracking setpoint blocked - wind stow active");
+        return;
+    }
+
+    // A tracking client counts as manual control, but arrives too often to log every point
+    _lastManualSetpointTime = millis();
+
+    if (_windTrackingActive) {
+        LOGI(_logger, "Deactivating wind tracking due to tracking stream");
+        setWindTrackingActive(false);
     }
+
+    // Keep the stored setpoints on the newest point so the dish settles there if the
+    // stream stops; the update flags stay down, the control loop follows the stream
+    _setpoint_az = setpoint_az;
+    _setpoint_el = setpoint_el;
+    _setpointStream.push(setpoint_az, setpoint_el, timeMs);
+}
+
+void MotorSensorController::setSetPointAzInternal(float value) {
+    // Any direct setpoint takes over from a tracking stream
+    _setpointStream.clear();
+    _setpoint_az = value;
+    _setPointAzUpdated = true;
 }
 
 void MotorSensorController::setSetPointElInternal(float value) {
-    if (_setPointMutex != NULL && xSemaphoreTake(_setPointMutex, portMAX_DELAY) == pdTRUE) {
-        _setpoint_el = value;
-        _setPointElUpdated = true;
-        xSemaphoreGive(_setPointMutex);
-    }
+    _setpointStream.clear();
+    _setpoint_el = value;
+    _setPointElUpdated = true;
 }
 
 // =============================================================================
@@ -624,7 +823,7 @@ void MotorSensorController::updateErrorTracking() {
     
     // Update azimuth error tracking
     if (currentTime - _azErrorTracker.lastSampleTime >= ERROR_SAMPLE_INTERVAL) {
-        _azErrorTracker.errorHistory[_azErrorTracker.currentIndex] = abs(getErrorAz());
+        _azErrorTracker.errorHistory[_azErrorTracker.currentIndex] = abs(_error_az);
         _azErrorTracker.timestamps[_azErrorTracker.currentIndex] = currentTime;
         _azErrorTracker.currentIndex = (_azErrorTracker.currentIndex + 1) % ERROR_HISTORY_SIZE;
         _azErrorTracker.sampleCount = min(_azErrorTracker.sampleCount + 1, ERROR_HISTORY_SIZE);
@@ -634,7 +833,7 @@ void MotorSensorController::updateErrorTracking() {
     
     // Update elevation error tracking
     if (currentTime - _elErrorTracker.lastSampleTime >= ERROR_SAMPLE_INTERVAL) {
-        _elErrorTracker.errorHistory[_elErrorTracker.currentIndex] = abs(getErrorEl());
+        _elErrorTracker.errorHistory[_elErrorTracker.currentIndex] = abs(_error_el);
         _elErrorTracker.timestamps[_elErrorTracker.currentIndex] = currentTime;
         _elErrorTracker.currentIndex = (_elErrorTracker.currentIndex + 1) % ERROR_HISTORY_SIZE;
         _elErrorTracker.sampleCount = min(_elErrorTracker.sampleCount + 1, ERROR_HISTORY_SIZE);
@@ -680,7 +879,7 @@ void MotorSensorController::checkErrorConvergence() {
         
         if (isErrorDiverging(_azErrorTracker, _MIN_AZ_TOLERANCE)) {
             if (!errorDivergenceFault) {
-                _logger.error("AZ Error divergence detected");
+                LOGE(_logger, "AZ Error divergence detected");
                 errorDivergenceFault = true;
             }
         }
@@ -693,7 +892,7 @@ void MotorSensorController::checkErrorConvergence() {
         
         if (isErrorDiverging(_elErrorTracker, _MIN_EL_TOLERANCE)) {
             if (!errorDivergenceFault) {
-                _logger.error("EL Error divergence detected");
+                LOGE(_logger, "EL Error divergence detected");
                 errorDivergenceFault = true;
             }
         }
@@ -730,7 +929,7 @@ bool MotorSensorController::isErrorDiverging(const ErrorTracker& tracker, float
     bool isDiverging = (recentAvg > oldAvg * DIVERGENCE_THRESHOLD) && (recentAvg > tolerance * 2);
     
     if (isDiverging) {
-        _logger.debug("Divergence detected - Recent avg: " + String(recentAvg, 3) + 
+        LOGD(_logger, "Divergence detected - Recent avg: " + String(recentAvg, 3) + 
                      ", Old avg: " + String(oldAvg, 3) + ", Tolerance: " + String(tolerance, 3));
     }
     
@@ -753,7 +952,7 @@ bool MotorSensorController::isConvergenceStalled(const ErrorTracker& tracker, fl
     bool isStalled = (currentError > tolerance * 1.5) && (abs(changeRate) < STALL_THRESHOLD);
     
     if (isStalled) {
-        _logger.debug("Stall detected - Current error: " + String(currentError, 3) + 
+        LOGD(_logger, "Stall detected - Current error: " + String(currentError, 3) + 
                      ", Change rate: " + String(changeRate, 4) + " deg/s, Tolerance: " + String(tolerance, 3));
     }
     
@@ -801,11 +1000,17 @@ void MotorSensorController::resetErrorTracker(ErrorTracker& tracker) {
 
 void MotorSensorController::actuate_motor_az(int MIN_SPEED) {
     // Use emergency high P gain during wind stow for maximum torque
-    int effectiveP_az = _windStowActive ? EMERGENCY_STOW_P_AZ : P_az;
-    double error = getErrorAz() * effectiveP_az;
+    double error;
+    if (_windStowActive) {
+        error = _error_az * EMERGENCY_STOW_P_AZ;
+    } else if (_tickControllerMode == CONTROLLER_PID) {
+        error = _azPid.output;
+    } else {
+        error = _controlError_az * P_az;
+    }
 
     // Set direction based on error sign
-    digitalWrite(_ccw_pin_az, (error >= 0) ? LOW : HIGH);
+    setDirection(_ccw_pin_az, (error >= 0) ? LOW : HIGH);
 
     // Calculate target speed with constraints
     int targetSpeed = MIN_SPEED - constrain(abs(error), _maxAdjustedSpeed_az, MIN_SPEED);
@@ -819,24 +1024,24 @@ void MotorSensorController::actuate_motor_az(int MIN_SPEED) {
 
     // Control motor speed
     if (setPointState_az && !global_fault && !_isAzMotorLatched) {
-        // During emergency stow, use more aggressive speed changes
-        int speedDecrement = _windStowActive ? 20 : 10;  // Faster speed ramp during stow
+        // Ramp step scales with the loop period so acceleration is rate independent
+        float speedDecrement = getRampStep();
         
         if (_current_speed_az > targetSpeed) {
-            _current_speed_az = max(_current_speed_az - speedDecrement, targetSpeed);
+            _current_speed_az = max(_current_speed_az - speedDecrement, (float)targetSpeed);
         } else if (_current_speed_az < targetSpeed) {
-            _current_speed_az = min(_current_speed_az + speedDecrement, targetSpeed);
+            _current_speed_az = min(_current_speed_az + speedDecrement, (float)targetSpeed);
         }
-        setPWM(_pwm_pin_az, _current_speed_az);
+        setPWM(_pwm_pin_az, (int)_current_speed_az);
 
         if(_jitterAzMotors) {
-            _logger.info("Attempting recovery of stalled AZ motor with jitter");
+            LOGI(_logger, "Attempting recovery of stalled AZ motor with jitter");
             setPWM(_pwm_pin_az, 0);
-            digitalWrite(_ccw_pin_az, (error >= 0) ? HIGH : LOW);  // Brief opposite direction
+            setDirection(_ccw_pin_az, (error >= 0) ? HIGH : LOW);  // Brief opposite direction
             delayMicroseconds(150000);
-            digitalWrite(_ccw_pin_az, (error >= 0) ? LOW : HIGH);
+            setDirection(_ccw_pin_az, (error >= 0) ? LOW : HIGH);
             delayMicroseconds(150000);
-            setPWM(_pwm_pin_az, _current_speed_az);
+            setPWM(_pwm_pin_az, (int)_current_speed_az);
         }
     } else {
         // Stop motor
@@ -848,11 +1053,17 @@ void MotorSensorController::actuate_motor_az(int MIN_SPEED) {
 
 void MotorSensorController::actuate_motor_el(int MIN_SPEED) {
     // Use emergency high P gain during wind stow for maximum torque
-    int effectiveP_el = _windStowActive ? EMERGENCY_STOW_P_EL : P_el;
-    double error = getErrorEl() * effectiveP_el;
+    double error;
+    if (_windStowActive) {
+        error = _error_el * EMERGENCY_STOW_P_EL;
+    } else if (_tickControllerMode == CONTROLLER_PID) {
+        error = _elPid.output;
+    } else {
+        error = _controlError_el * P_el;
+    }
 
     // Set direction based on error sign
-    digitalWrite(_ccw_pin_el, (error >= 0) ? LOW : HIGH);
+    setDirection(_ccw_pin_el, (error >= 0) ? LOW : HIGH);
 
     // Calculate target speed with constraints
     int targetSpeed = MIN_SPEED - constrain(abs(error), _maxAdjustedSpeed_el, MIN_SPEED);
@@ -866,24 +1077,24 @@ void MotorSensorController::actuate_motor_el(int MIN_SPEED) {
 
     // Control motor speed
     if (setPointState_el && !global_fault && !_isElMotorLatched) {
-        // During emergency stow, use more aggressive speed changes
-        int speedDecrement = _windStowActive ? 20 : 10;  // Faster speed ramp during stow
+        // Ramp step scales with the loop period so acceleration is rate independent
+        float speedDecrement = getRampStep();
         
         if (_current_speed_el > targetSpeed) {
-            _current_speed_el = max(_current_speed_el - speedDecrement, targetSpeed);
+            _current_speed_el = max(_current_speed_el - speedDecrement, (float)targetSpeed);
         } else if (_current_speed_el < targetSpeed) {
-            _current_speed_el = min(_current_speed_el + speedDecrement, targetSpeed);
+            _current_speed_el = min(_current_speed_el + speedDecrement, (float)targetSpeed);
         }
-        setPWM(_pwm_pin_el, _current_speed_el);
+        setPWM(_pwm_pin_el, (int)_current_speed_el);
 
         if(_jitterElMotors) {
-            _logger.info("Attempting recovery of stalled EL motor with jitter");
+            LOGI(_logger, "Attempting recovery of stalled EL motor with jitter");
             setPWM(_pwm_pin_el, 0);
-            digitalWrite(_ccw_pin_el, (error >= 0) ? HIGH : LOW);  // Brief opposite direction
+            setDirection(_ccw_pin_el, (error >= 0) ? HIGH : LOW);  // Brief opposite direction
             delayMicroseconds(150000);
-            digitalWrite(_ccw_pin_el, (error >= 0) ? LOW : HIGH);
+            setDirection(_ccw_pin_el, (error >= 0) ? LOW : HIGH);
             delayMicroseconds(150000);
-            setPWM(_pwm_pin_el, _current_speed_el);
+            setPWM(_pwm_pin_el, (int)_current_speed_el);
         }
     } else {
         // Stop motor
@@ -892,10 +1103,12 @@ void MotorSensorController::actuate_motor_el(int MIN_SPEED) {
     }
 }
 
-void MotorSensorController::updateMotorControl(float currentSetPointAz, float currentSetPointEl, bool setPointAzUpdated, bool setPointElUpdated) {
-    // Determine if motors should be active based on error tolerance
-    setPointState_az = (fabs(getErrorAz()) > _MIN_AZ_TOLERANCE);
-    setPointState_el = (fabs(getErrorEl()) > _MIN_EL_TOLERANCE);
+void MotorSensorController::updateMotorControl(bool setPointAzUpdated, bool setPointElUpdated) {
+    // Determine if motors should be active based on error tolerance or a slew still in progress
+    bool azProfileActive = _azProfile.isActive();
+    bool elProfileActive = _elProfile.isActive();
+    setPointState_az = (fabs(_error_az) > _MIN_AZ_TOLERANCE) || azProfileActive;
+    setPointState_el = (fabs(_error_el) > _MIN_EL_TOLERANCE) || elProfileActive;
 
     // Reset latch parameters on setpoint changes
     if (setPointAzUpdated) {
@@ -913,24 +1126,38 @@ void MotorSensorController::updateMotorControl(float currentSetPointAz, float cu
     }
 
     // Detect overshoot (error sign flip)
-    bool az_sign_flipped = (_prev_error_az * getErrorAz() < 0) && 
+    bool az_sign_flipped = (_prev_error_az * _error_az < 0) && 
                           (fabs(_prev_error_az) > 0.0001) && 
-                          (fabs(getErrorAz()) > 0.0001);
-    bool el_sign_flipped = (_prev_error_el * getErrorEl() < 0) && 
+                          (fabs(_error_az) > 0.0001);
+    bool el_sign_flipped = (_prev_error_el * _error_el < 0) && 
                           (fabs(_prev_error_el) > 0.0001) && 
-                          (fabs(getErrorEl()) > 0.0001);
+                          (fabs(_error_el) > 0.0001);
 
-    // Latch motors on target reached or overshoot
-    if (!setPointState_az || az_sign_flipped) {
+    // Latch motors on target reached or overshoot; PID corrects its own overshoot, a
+    // streamed reference crosses the dish routinely, and nothing latches on overshoot
+    // until the slew profile has finished
+    bool latchOnOvershoot = (_tickControllerMode == CONTROLLER_LEGACY) && !_streamActive;
+    if (!setPointState_az || (az_sign_flipped && latchOnOvershoot && !azProfileActive)) {
         _isAzMotorLatched = true;
     }
 
-    if (!setPointState_el || el_sign_flipped) {
+    if (!setPointState_el || (el_sign_flipped && latchOnOvershoot && !elProfileActive)) {
         _isElMotorLatched = true;
     }
 
-    _prev_error_az = getErrorAz();
-    _prev_error_el = getErrorEl();
+    // A streamed reference keeps moving, so an axis that reached it re-arms as soon as it
+    // falls outside tolerance again rather than waiting for a new setpoint
+    if (_streamActive) {
+        if (setPointState_az) {
+            _isAzMotorLatched = false;
+        }
+        if (setPointState_el) {
+            _isElMotorLatched = false;
+        }
+    }
+
+    _prev_error_az = _error_az;
+    _prev_error_el = _error_el;
 }
 
 void MotorSensorController::updateMotorPriority(bool setPointAzUpdated, bool setPointElUpdated) {
@@ -939,7 +1166,7 @@ void MotorSensorController::updateMotorPriority(bool setPointAzUpdated, bool set
         // Determine priority based on normalized error when setpoint changes
         if (setPointAzUpdated || setPointElUpdated) {
             // Normalize by motor speeds (1.5RPM for az, 0.25RPM for el)
-            _az_priority = (fabs(getErrorAz()) / 1.5 > fabs(getErrorEl()) / 0.25);
+            _az_priority = (fabs(_error_az) / 1.5 > fabs(_error_el) / 0.25);
         }
         
         // Execute priority control
@@ -963,10 +1190,142 @@ void MotorSensorController::updateMotorPriority(bool setPointAzUpdated, bool set
     _maxAdjustedSpeed_el = setPointState_az ? max_dual_motor_el_speed : max_single_motor_el_speed;
 }
 
+// =============================================================================
+// MOTION PROFILE
+// =============================================================================
+
+void MotorSensorController::updateMotionProfiles(bool setPointAzUpdated, bool setPointElUpdated, float dt) {
+    // Wind stow and faults bypass the profile and drive straight at the target
+    if (!_motionProfileEnabled || _windStowActive || global_fault) {
+        _azProfile.stop();
+        _elProfile.stop();
+        _controlError_az = _error_az;
+        _controlError_el = _error_el;
+        return;
+    }
+
+    // Limits follow the configured speed caps, scaled from the nominal rates at full PWM
+    float azVelocity = max(NOMINAL_AZ_RATE * (255 - _maxAdjustedSpeed_az) / 255.0f, NOMINAL_AZ_RATE * 0.1f);
+    float elVelocity = max(NOMINAL_EL_RATE * (255 - _maxAdjustedSpeed_el) / 255.0f, NOMINAL_EL_RATE * 0.1f);
+    _azProfile.setLimits(azVelocity, azVelocity / PROFILE_ACCEL_TIME,
+                         azVelocity / (PROFILE_ACCEL_TIME * PROFILE_JERK_TIME));
+    _elProfile.setLimits(elVelocity, elVelocity / PROFILE_ACCEL_TIME,
+                         elVelocity / (PROFILE_ACCEL_TIME * PROFILE_JERK_TIME));
+
+    // A new setpoint starts from the current position, or moves the target of a slew in
+    // progress while keeping the reference where last tick's control error left it
+    if (setPointAzUpdated) {
+        if (_azProfile.isActive()) {
+            _azProfile.retarget(_error_az - _controlError_az);
+        } else {
+            _azProfile.start(_error_az);
+        }
+    }
+
+    if (setPointElUpdated) {
+        if (_elProfile.isActive()) {
+            _elProfile.retarget(_error_el - _controlError_el);
+        } else {
+            _elProfile.start(_error_el);
+        }
+    }
+
+    // In single motor mode the waiting axis holds its trajectory until it gets its turn
+    if (!singleMotorMode || _az_priority) {
+        _azProfile.update(dt);
+    }
+    if (!singleMotorMode || !_az_priority) {
+        _elProfile.update(dt);
+    }
+
+    _controlError_az = _error_az - _azProfile.getRemaining();
+    _controlError_el = _error_el - _elProfile.getRemaining();
+}
+
+// =============================================================================
+// PID CONTROL
+// =============================================================================
+
+void MotorSensorController::updatePid(PidState& pid, double error, float setpoint,
+                                      float Kp, float Ki, float Kd, float Kff, int maxDrive, bool active,
+                                      bool smoothReference, float dt) {
+    if (!active) {
+        resetPid(pid);
+        return;
+    }
+
+    if (!pid.initialized) {
+        pid.prevError = error;
+        pid.prevSetpoint = setpoint;
+        pid.initialized = true;
+    }
+
+    // Measurement change = setpoint change - error change, which avoids differentiating setpoint steps.
+    // Both axes wrap at 0/360, so fold the deltas back into +-180.
+    double setpointDelta = setpoint - pid.prevSetpoint;
+    if (setpointDelta > 180) setpointDelta -= 360;
+    else if (setpointDelta < -180) setpointDelta += 360;
+    double measuredDelta = setpointDelta - (error - pid.prevError);
+    if (measuredDelta > 180) measuredDelta -= 360;
+    else if (measuredDelta < -180) measuredDelta += 360;
+    pid.prevError = error;
+    pid.prevSetpoint = setpoint;
+
+    // Large setpoint jumps are new targets, not a trajectory to feed forward
+    double setpointVelocity = (fabs(setpointDelta) > PID_SETPOINT_STEP) ? 0 : setpointDelta / dt;
+
+    pid.measuredRate += (measuredDelta / dt - pid.measuredRate) * (dt / (PID_DERIVATIVE_TAU + dt));
+    // A profile reference moves every tick and is already smooth; filtering it as well would
+    // keep feeding forward for a second after the profile stops, driving the axis past the target
+    if (smoothReference) {
+        pid.setpointRate = setpointVelocity;
+    } else {
+        pid.setpointRate += (setpointVelocity - pid.setpointRate) * (dt / (PID_FEEDFORWARD_TAU + dt));
+    }
+
+    double proportional = Kp * error;
+    double derivative = -Kd * pid.measuredRate;
+    double feedForward = Kff * pid.setpointRate;
+
+    // Anti-windup: integrate only while there is drive headroom, or when it unwinds the integral
+    double candidate = pid.integral + Ki * error * dt;
+    if (fabs(proportional + candidate + derivative + feedForward) < maxDrive || fabs(candidate) < fabs(pid.integral)) {
+        pid.integral = constrain(candidate, (double)-maxDrive, (double)maxDrive);
+    }
+
+    pid.output = proportional + pid.integral + derivative + feedForward;
+}
+
+void MotorSensorController::resetPid(PidState& pid) {
+    pid.integral = 0;
+    pid.measuredRate = 0;
+    pid.setpointRate = 0;
+    pid.output = 0;
+    pid.initialized = false;
+}
+
 void MotorSensorController::setPWM(int pin, int PWM) {
+    if (pin == _pwm_pin_az) {
+        _pwmOutput_az = PWM;
+    } else {
+        _pwmOutput_el = PWM;
+    }
+
+    if (_plant != nullptr) {
+        _plant->setPwm(pin == _pwm_pin_az ? PlantSimulator::AXIS_AZ : PlantSimulator::AXIS_EL, PWM);
+        return;
+    }
     analogWrite(pin, PWM);
 }
 
+void MotorSensorController::setDirection(int pin, int level) {
+    if (_plant != nullptr) {
+        _plant->setDirection(pin == _ccw_pin_az ? PlantSimulator::AXIS_AZ : PlantSimulator::AXIS_EL, level == HIGH);
+        return;
+    }
+    digitalWrite(pin, level);
+}
+
 // =============================================================================
 // REMAINING METHODS (unchanged from original - angle calculation, sensor reading, etc.)
 // =============================================================================
@@ -1060,29 +1419,27 @@ void MotorSensorController::calcIfNeedsUnwind(float correctedAngle_az) {
 
 float MotorSensorController::getAvgAngle(int i2c_addr) {
     if (_getAngleMutex == NULL || xSemaphoreTake(_getAngleMutex, portMAX_DELAY) != pdTRUE) {
-        _logger.error("Failed to take mutex in getAvgAngle");
+        LOGE(_logger, "Failed to take mutex in getAvgAngle");
         badAngleFlag = true;
         return 0;
     }
 
-    // Verify magnet presence before reading
-    int magnetStatus = checkMagnetPresence(i2c_addr);
-    if ((magnetStatus & 32) == 0) {
-        _logger.error("MAGNET WENT MISSING DURING ROUTINE ANGLE READ!");
-        magnetFault = true;
-    }
-
-    float angles[_numAvg];
+    uint16_t rawCounts[_numAvg];
     int validReadings = 0;
     int errorCounter = 0;
     const int MAX_ATTEMPTS = _numAvg * 2;
     
-    // Collect angle readings
+    // Collect angle readings; each burst also carries the magnet status
     for (int attempt = 0; attempt < MAX_ATTEMPTS && validReadings < _numAvg; attempt++) {
-        float rawAngle = ReadRawAngle(i2c_addr);
+        uint16_t rawCount;
+        uint8_t status;
         
-        if (rawAngle != -999) {
-            angles[validReadings++] = rawAngle;
+        if (readSensorBurst(i2c_addr, rawCount, status)) {
+            if (validReadings == 0 && (status & 32) == 0) {
+                LOGE(_logger, "MAGNET WENT MISSING DURING ROUTINE ANGLE READ!");
+                magnetFault = true;
+            }
+            rawCounts[validReadings++] = rawCount;
         } else {
             errorCounter++;
             if (errorCounter > _numAvg) break;
@@ -1094,129 +1451,182 @@ float MotorSensorController::getAvgAngle(int i2c_addr) {
     // Handle insufficient readings
     if (validReadings == 0) {
         xSemaphoreGive(_getAngleMutex);
-        _logger.error("Failed to get any valid angle readings");
+        LOGE(_logger, "Failed to get any valid angle readings");
         badAngleFlag = true;
         return 0;
     }
 
-    float angleMean = calculateAngleMeanWithDiscard(angles, validReadings);
+    float angleMean = calculateAngleMeanWithDiscard(rawCounts, validReadings);
     xSemaphoreGive(_getAngleMutex);
     
     return angleMean;
 }
 
-float MotorSensorController::ReadRawAngle(int i2c_addr) {
-    uint8_t buffer[2];
-    const unsigned long timeout = 3000;
+void MotorSensorController::sampleSensor(int i2c_addr, AngleSampler& sampler) {
+    uint16_t rawCount;
+    uint8_t status;
+    if (readSensorBurst(i2c_addr, rawCount, status)) {
+        sampler.lastStatus = status;
+        sampler.rawWindow[sampler.currentIndex] = rawCount;
+        sampler.currentIndex = (sampler.currentIndex + 1) % _numAvg;
+        sampler.sampleCount = min(sampler.sampleCount + 1, _numAvg);
+
+        sampler.filteredAngle = calculateAngleMeanWithDiscard(sampler.rawWindow, sampler.sampleCount);
+        sampler.lastUpdateTime = millis();
+    }
+
+    // Status arrives with every burst, but the magnet only needs evaluating every so often
+    if (++sampler.samplesSinceMagnetCheck >= MAGNET_CHECK_INTERVAL) {
+        sampler.samplesSinceMagnetCheck = 0;
+        if ((sampler.lastStatus & 32) == 0) {
+            LOGE(_logger, "MAGNET WENT MISSING DURING ROUTINE ANGLE READ!");
+            magnetFault = true;
+        }
+    }
+}
+
+void MotorSensorController::seedSampler(AngleSampler& sampler, float angle) {
+    sampler.currentIndex = 0;
+    sampler.sampleCount = 0;
+    sampler.samplesSinceMagnetCheck = 0;
+    sampler.lastStatus = 0;
+    sampler.filteredAngle = angle;
+    sampler.lastUpdateTime = millis();
+}
+
+float MotorSensorController::getLatestAngle(AngleSampler& sampler, const char* axis) {
+    // Never block the control loop on I2C; fault instead if the sensor task stops delivering
+    unsigned long lastUpdate = sampler.lastUpdateTime.load();
+    if (millis() - lastUpdate > ANGLE_STALE_TIMEOUT) {
+        if (!badAngleFlag) {
+            LOGE(_logger, String(axis) + " angle samples are stale");
+        }
+        badAngleFlag = true;
+    }
+    return sampler.filteredAngle.load();
+}
 
-    // Request angle data
+bool MotorSensorController::readSensorBurst(int i2c_addr, uint16_t& rawCount, uint8_t& status) {
+    uint8_t buffer[AS5600_BURST_LENGTH];
+    unsigned long startMicros = micros();
+
+    if (_plant != nullptr) {
+        PlantSimulator::Axis axis = (i2c_addr == _az_hall_i2c_addr) ? PlantSimulator::AXIS_AZ : PlantSimulator::AXIS_EL;
+        rawCount = _plant->readRawCount(axis);
+        status = _plant->readStatus(axis);
+        recordI2CTransaction(i2c_addr, startMicros, true);
+        return true;
+    }
+
+    // STATUS (0x0B) and RAW ANGLE (0x0C/0x0D) sit next to each other, so a single
+    // auto-incrementing read returns both. ANGLE (0x0E/0x0F) is skipped: ZPOS/MPOS are
+    // never programmed, so it always equals RAW ANGLE.
     Wire.beginTransmission(i2c_addr);
-    Wire.write(0x0C);
+    Wire.write(AS5600_REG_STATUS);
     byte error = Wire.endTransmission(false);
 
     if (error != 0) {
-        _logger.error("I2C error during transmission to sensor 0x" + String(i2c_addr, HEX) + ": " + String(error));
+        recordI2CTransaction(i2c_addr, startMicros, false);
+        LOGE(_logger, "I2C error during transmission to sensor 0x" + String(i2c_addr, HEX) + ": " + String(error));
         updateI2CErrorCounter(i2c_addr);
-        return -999;
+        return false;
     }
 
-    delayMicroseconds(25);
-    byte bytesReceived = Wire.requestFrom(i2c_addr, 2);
+    byte bytesReceived = Wire.requestFrom(i2c_addr, AS5600_BURST_LENGTH);
 
-    if (bytesReceived != 2) {
-        _logger.error("I2C error: Requested 2 bytes but received " + String(bytesReceived) + " from 0x" + String(i2c_addr, HEX));
+    if (bytesReceived != AS5600_BURST_LENGTH) {
+        recordI2CTransaction(i2c_addr, startMicros, false);
+        LOGE(_logger, "I2C error: Requested " + String(AS5600_BURST_LENGTH) + " bytes but received " + String(bytesReceived) + " from 0x" + String(i2c_addr, HEX));
         updateI2CErrorCounter(i2c_addr);
-        return -999;
+        return false;
     }
 
+    // requestFrom() has already buffered the whole burst
+    Wire.readBytes(buffer, AS5600_BURST_LENGTH);
+    recordI2CTransaction(i2c_addr, startMicros, true);
     resetI2CErrorCounter(i2c_addr);
 
-    // Timeout check
-    unsigned long startTime = millis();
-    while (Wire.available() < 2) {
-        if (millis() - startTime > timeout) {
-            _logger.error("Timeout waiting for bytes from hall sensor");
-            return -999;
-        }
-    }
+    status = buffer[0];
+    rawCount = (((uint16_t)buffer[1] << 8) | buffer[2]) & 0x0FFF;
+    return true;
+}
 
-    // Read and process data
-    Wire.readBytes(buffer, 2);
-    word rawAngleValue = ((uint16_t)buffer[0] << 8) | buffer[1];
-    return rawAngleValue * 0.087890625; // Convert to degrees
+void MotorSensorController::recordI2CTransaction(int i2c_addr, unsigned long startMicros, bool success) {
+    I2CStats& stats = (i2c_addr == _az_hall_i2c_addr) ? _azI2CStats : _elI2CStats;
+    uint32_t elapsed = micros() - startMicros;
+
+    // Only the bus holder writes these, so plain load/store is enough
+    uint32_t count = stats.transactions.load() + 1;
+    stats.transactions = count;
+    if (!success) {
+        stats.errors = stats.errors.load() + 1;
+    }
+    // Exponential average, seeded by the first transaction
+    float avg = stats.avgMicros.load();
+    stats.avgMicros = (count == 1) ? (float)elapsed : avg + ((float)elapsed - avg) * 0.01f;
+    if (elapsed > stats.maxMicros.load()) {
+        stats.maxMicros = elapsed;
+    }
 }
 
 int MotorSensorController::checkMagnetPresence(int i2c_addr) {
-    int magnetStatus = 0;
-    byte error;
-    
-    while (true) {
-        Wire.beginTransmission(i2c_addr);
-        Wire.write(0x0B); // Status register
-        error = Wire.endTransmission();
-        
-        if (error != 0) {
-            _logger.error("I2C error during transmission to sensor 0x" + String(i2c_addr, HEX) + ": " + String(error));
-            updateI2CErrorCounter(i2c_addr);
-            
-            // Check consecutive error limit
-            if ((i2c_addr == _az_hall_i2c_addr && _consecutivei2cErrors_az > MAX_CONSECUTIVE_ERRORS) ||
-                (i2c_addr == _el_hall_i2c_addr && _consecutivei2cErrors_el > MAX_CONSECUTIVE_ERRORS)) {
-                if (i2c_addr == _az_hall_i2c_addr) i2cErrorFlag_az = true;
-                else i2cErrorFlag_el = true;
-                return -999;
-            }
-            continue;
+    // Bounded retries; updateI2CErrorCounter() raises the I2C error flag on the way
+    for (int attempt = 0; attempt <= MAX_CONSECUTIVE_ERRORS; attempt++) {
+        uint16_t rawCount;
+        uint8_t status;
+        if (readSensorBurst(i2c_addr, rawCount, status)) {
+            return status;
         }
-        
-        Wire.requestFrom(i2c_addr, 1);
-        while (Wire.available() == 0);
-        magnetStatus = Wire.read();
-        break;
     }
 
-    resetI2CErrorCounter(i2c_addr);
-    return magnetStatus;
+    if (i2c_addr == _az_hall_i2c_addr) i2cErrorFlag_az = true;
+    else i2cErrorFlag_el = true;
+    return -999;
 }
 
-float MotorSensorController::calculateAngleMeanWithDiscard(float* array, int size) {
-    float x[size], y[size];
-
-    // Convert angles to unit vectors
-    for (int i = 0; i < size; i++) {
-        float angleRad = array[i] * PI / 180.0;
-        x[i] = cos(angleRad);
-        y[i] = sin(angleRad);
-    }
-
-    // Calculate means
+float MotorSensorController::calculateAngleMeanWithDiscard(const uint16_t* rawCounts, int size) {
+    // Convert counts to unit vectors via the lookup table
     float xSum = 0, ySum = 0;
     for (int i = 0; i < size; i++) {
-        xSum += x[i];
-        ySum += y[i];
+        xSum += as5600Cos(rawCounts[i]);
+        ySum += as5600Sin(rawCounts[i]);
     }
     float xMean = xSum / size;
     float yMean = ySum / size;
 
-    // Calculate standard deviations
-    float sumX = 0, sumY = 0;
+    // Sample standard deviations about the mean. A one-pass sum of squares cancels badly in
+    // float here: a few counts of noise is a variance of ~1e-5 against squares summing to ~10.
+    float xSqSum = 0, ySqSum = 0;
     for (int i = 0; i < size; i++) {
-        sumX += pow(x[i] - xMean, 2);
-        sumY += pow(y[i] - yMean, 2);
+        float dx = as5600Cos(rawCounts[i]) - xMean;
+        float dy = as5600Sin(rawCounts[i]) - yMean;
+        xSqSum += dx * dx;
+        ySqSum += dy * dy;
     }
-    float stdDevX = sqrt(sumX / (size > 1 ? size - 1 : 1));
-    float stdDevY = sqrt(sumY / (size > 1 ? size - 1 : 1));
+    float divisor = (size > 1 ? size - 1 : 1);
+    float stdDevX = sqrtf(xSqSum / divisor);
+    float stdDevY = sqrtf(ySqSum / divisor);
 
     // Calculate final mean excluding outliers
-    xSum = ySum = 0;
+    float keptXSum = 0, keptYSum = 0;
+    int keptCount = 0;
     for (int i = 0; i < size; i++) {
-        if ((fabs(x[i] - xMean) <= 2.0 * stdDevX) && (fabs(y[i] - yMean) <= 2.0 * stdDevY)) {
-            xSum += x[i];
-            ySum += y[i];
+        float x = as5600Cos(rawCounts[i]);
+        float y = as5600Sin(rawCounts[i]);
+        if ((fabsf(x - xMean) <= 2.0f * stdDevX) && (fabsf(y - yMean) <= 2.0f * stdDevY)) {
+            keptXSum += x;
+            keptYSum += y;
+            keptCount++;
         }
     }
 
-    return atan2(ySum, xSum) * 180.0 / PI;
+    // Identical samples can round to a zero deviation and reject everything; fall back to the plain mean
+    if (keptCount == 0) {
+        keptXSum = xSum;
+        keptYSum = ySum;
+    }
+
+    return atan2f(keptYSum, keptXSum) * 180.0f / PI;
 }
 
 // =============================================================================
@@ -1224,101 +1634,113 @@ float MotorSensorController::calculateAngleMeanWithDiscard(float* array, int siz
 // =============================================================================
 
 float MotorSensorController::getSetPointAz() {
-    float result = 0;
-    if (_setPointMutex != NULL && xSemaphoreTake(_setPointMutex, portMAX_DELAY) == pdTRUE) {
-        result = _setpoint_az;
-        xSemaphoreGive(_setPointMutex);
-    }
-    return result;
+    return _setpoint_az;
 }
 
 float MotorSensorController::getSetPointEl() {
-    float result = 0;
-    if (_setPointMutex != NULL && xSemaphoreTake(_setPointMutex, portMAX_DELAY) == pdTRUE) {
-        result = _setpoint_el;
-        xSemaphoreGive(_setPointMutex);
-    }
-    return result;
+    return _setpoint_el;
 }
 
+// Angles and errors belong to the control task; other tasks read them from the snapshot
 void MotorSensorController::setCorrectedAngleAz(float value) {
-    if (_correctedAngleMutex != NULL && xSemaphoreTake(_correctedAngleMutex, portMAX_DELAY) == pdTRUE) {
-        _correctedAngle_az = value;
-        xSemaphoreGive(_correctedAngleMutex);
-    }
+    _correctedAngle_az = value;
 }
 
 void MotorSensorController::setCorrectedAngleEl(float value) {
-    if (_correctedAngleMutex != NULL && xSemaphoreTake(_correctedAngleMutex, portMAX_DELAY) == pdTRUE) {
-        _correctedAngle_el = value;
-        xSemaphoreGive(_correctedAngleMutex);
-    }
+    _correctedAngle_el = value;
 }
 
 float MotorSensorController::getCorrectedAngleAz() {
-    float result = 0;
-    if (_correctedAngleMutex != NULL && xSemaphoreTake(_correctedAngleMutex, portMAX_DELAY) == pdTRUE) {
-        result = _correctedAngle_az;
-        xSemaphoreGive(_correctedAngleMutex);
-    }
-    return result;
+    return getTelemetry().correctedAngle_az;
 }
 
 float MotorSensorController::getCorrectedAngleEl() {
-    float result = 0;
-    if (_correctedAngleMutex != NULL && xSemaphoreTake(_correctedAngleMutex, portMAX_DELAY) == pdTRUE) {
-        result = _correctedAngle_el;
-        xSemaphoreGive(_correctedAngleMutex);
-    }
-    return result;
+    return getTelemetry().correctedAngle_el;
 }
 
 double MotorSensorController::getErrorAz() {
-    double result = 0;
-    if (_errorMutex != NULL && xSemaphoreTake(_errorMutex, portMAX_DELAY) == pdTRUE) {
-        result = _error_az;
-        xSemaphoreGive(_errorMutex);
-    }
-    return result;
+    return getTelemetry().error_az;
 }
 
 void MotorSensorController::setErrorAz(float value) {
-    if (_errorMutex != NULL && xSemaphoreTake(_errorMutex, portMAX_DELAY) == pdTRUE) {
-        _error_az = value;
-        xSemaphoreGive(_errorMutex);
-    }
+    _error_az = value;
 }
 
 double MotorSensorController::getErrorEl() {
-    double result = 0;
-    if (_errorMutex != NULL && xSemaphoreTake(_errorMutex, portMAX_DELAY) == pdTRUE) {
-        result = _error_el;
-        xSemaphoreGive(_errorMutex);
-    }
-    return result;
+    return getTelemetry().error_el;
 }
 
 void MotorSensorController::setErrorEl(float value) {
-    if (_errorMutex != NULL && xSemaphoreTake(_errorMutex, portMAX_DELAY) == pdTRUE) {
-        _error_el = value;
-        xSemaphoreGive(_errorMutex);
-    }
+    _error_el = value;
 }
 
 float MotorSensorController::getElStartAngle() {
-    float result = 0;
-    if (_el_startAngleMutex != NULL && xSemaphoreTake(_el_startAngleMutex, portMAX_DELAY) == pdTRUE) {
-        result = _el_startAngle;
-        xSemaphoreGive(_el_startAngleMutex);
-    }
-    return result;
+    return _el_startAngle;
 }
 
 void MotorSensorController::setElStartAngle(float value) {
-    if (_el_startAngleMutex != NULL && xSemaphoreTake(_el_startAngleMutex, portMAX_DELAY) == pdTRUE) {
-        _preferences.putFloat("el_cal", value);
-        _el_startAngle = value;
-        xSemaphoreGive(_el_startAngleMutex);
+    _preferences.putFloat("el_cal", value);
+    _el_startAngle = value;
+}
+
+// =============================================================================
+// TELEMETRY SNAPSHOT
+// =============================================================================
+
+void MotorSensorController::publishTelemetry() {
+    MotorTelemetry snapshot;
+    snapshot.timestamp = millis();
+    snapshot.setpoint_az = _streamActive ? _streamSetpoint_az : _setpoint_az.load();
+    snapshot.setpoint_el = _streamActive ? _streamSetpoint_el : _setpoint_el.load();
+    snapshot.correctedAngle_az = _correctedAngle_az;
+    snapshot.correctedAngle_el = _correctedAngle_el;
+    snapshot.error_az = _error_az;
+    snapshot.error_el = _error_el;
+    snapshot.el_startAngle = _el_startAngle;
+    snapshot.az_offset = _az_offset;
+    snapshot.el_offset = _el_offset;
+    snapshot.needs_unwind = needs_unwind;
+    snapshot.setPointState_az = setPointState_az;
+    snapshot.setPointState_el = setPointState_el;
+    snapshot.isAzMotorLatched = _isAzMotorLatched;
+    snapshot.isElMotorLatched = _isElMotorLatched;
+    snapshot.streaming = _streamActive;
+    snapshot.pwm_az = _pwmOutput_az;
+    snapshot.pwm_el = _pwmOutput_el;
+
+    // Only the control task publishes, so the sequence just brackets the copy
+    uint32_t seq = _telemetrySeq.load(std::memory_order_relaxed);
+    _telemetrySeq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    _telemetry = snapshot;
+    _telemetrySeq.store(seq + 2, std::memory_order_release);
+}
+
+MotorSensorController::MotorTelemetry MotorSensorController::getTelemetry() {
+    MotorTelemetry snapshot;
+
+    _telemetryReads++;
+    for (uint32_t attempt = 1;; attempt++) {
+        uint32_t before = _telemetrySeq.load(std::memory_order_acquire);
+        if ((before & 1) == 0) {
+            snapshot = _telemetry;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (_telemetrySeq.load(std::memory_order_relaxed) == before) {
+                return snapshot;
+            }
+        }
+        _telemetryRetries++;
+
+        // A publish takes well under a microsecond, so a few retries normally see it through.
+        // If not, the writer was preempted mid-publish: yield so it can finish, and if it sits
+        // below us in priority a yield will not run it, so sleep a tick.
+        if (attempt % TELEMETRY_SPIN_LIMIT == 0) {
+            if (attempt < TELEMETRY_SPIN_LIMIT * TELEMETRY_YIELD_LIMIT) {
+                taskYIELD();
+            } else {
+                vTaskDelay(1);
+            }
+        }
     }
 }
 
@@ -1330,7 +1752,8 @@ void MotorSensorController::setMinVoltageThreshold(int value) {
     if (value > 0 && value < 20) {
         _minVoltageThreshold = value;
         _preferences.putInt("MIN_VOLTAGE", value);
-        _logger.info("MIN_VOLTAGE_THRESHOLD set to: " + String(value) + "V");
+        _settingsVersion++;
+        LOGI(_logger, "MIN_VOLTAGE_THRESHOLD set to: " + String(value) + "V");
     }
 }
 
@@ -1342,6 +1765,7 @@ void MotorSensorController::setMaxPowerBeforeFault(int value) {
     if (value > 0 && value < 25) {
         _maxPowerBeforeFault = value;
         _preferences.putInt("MAX_POWER", value);
+        _settingsVersion++;
     }
 }
 
@@ -1353,7 +1777,8 @@ void MotorSensorController::setPEl(int value) {
     if (value >= -1000 && value <= 1000) {
         P_el = value;
         _preferences.putInt("P_el", value);
-        _logger.info("P_el set to: " + String(value));
+        _settingsVersion++;
+        LOGI(_logger, "P_el set to: " + String(value));
     }
 }
 
@@ -1361,7 +1786,88 @@ void MotorSensorController::setPAz(int value) {
     if (value >= -1000 && value <= 1000) {
         P_az = value;
         _preferences.putInt("P_az", value);
-        _logger.info("P_az set to: " + String(value));
+        _settingsVersion++;
+        LOGI(_logger, "P_az set to: " + String(value));
+    }
+}
+
+void MotorSensorController::setControllerMode(int value) {
+    if (value == CONTROLLER_LEGACY || value == CONTROLLER_PID) {
+        _controllerMode = value;
+        _preferences.putInt("ctrlMode", value);
+        _settingsVersion++;
+        LOGI(_logger, "Controller mode set to: " + String(value == CONTROLLER_PID ? "PID" : "Legacy P"));
+    }
+}
+
+void MotorSensorController::setMotionProfileEnabled(bool enabled) {
+    _motionProfileEnabled = enabled;
+    _preferences.putBool("motionProfile", enabled);
+    _settingsVersion++;
+    LOGI(_logger, "Motion profile " + String(enabled ? "enabled" : "disabled"));
+}
+
+void MotorSensorController::setKiAz(float value) {
+    if (value >= 0 && value <= 1000) {
+        Ki_az = value;
+        _preferences.putFloat("Ki_az", value);
+        _settingsVersion++;
+        LOGI(_logger, "Ki_az set to: " + String(value));
+    }
+}
+
+void MotorSensorController::setKdAz(float value) {
+    if (value >= 0 && value <= 1000) {
+        Kd_az = value;
+        _preferences.putFloat("Kd_az", value);
+        _settingsVersion++;
+        LOGI(_logger, "Kd_az set to: " + String(value));
+    }
+}
+
+void MotorSensorController::setKffAz(float value) {
+    if (value >= 0 && value <= 1000) {
+        Kff_az = value;
+        _preferences.putFloat("Kff_az", value);
+        _settingsVersion++;
+        LOGI(_logger, "Kff_az set to: " + String(value));
+    }
+}
+
+void MotorSensorController::setKiEl(float value) {
+    if (value >= 0 && value <= 1000) {
+        Ki_el = value;
+        _preferences.putFloat("Ki_el", value);
+        _settingsVersion++;
+        LOGI(_logger, "Ki_el set to: " + String(value));
+    }
+}
+
+void MotorSensorController::setKdEl(float value) {
+    if (value >= 0 && value <= 1000) {
+        Kd_el = value;
+        _preferences.putFloat("Kd_el", value);
+        _settingsVersion++;
+        LOGI(_logger, "Kd_el set to: " + String(value));
+    }
+}
+
+void MotorSensorController::setKffEl(float value) {
+    if (value >= 0 && value <= 1000) {
+        Kff_el = value;
+        _preferences.putFloat("Kff_el", value);
+        _settingsVersion++;
+        LOGI(_logger, "Kff_el set to: " + String(value));
+    }
+}
+
+void MotorSensorController::setControlPeriodUs(int value) {
+    if (value == 0 || (value >= MIN_CONTROL_PERIOD_US && value <= MAX_CONTROL_PERIOD_US)) {
+        _controlPeriodUs = value;
+        _preferences.putInt("ctrlPeriodUs", value);
+        _settingsVersion++;
+        LOGI(_logger, "Control period set to: " + String(value) + "us");
+        applyControlPeriod();
     }
 }
 
@@ -1369,7 +1875,8 @@ void MotorSensorController::setMinElSpeed(int value) {
     if (value >= 0 && value <= 255) {
         MIN_EL_SPEED = value;
         _preferences.putInt("MIN_EL_SPEED", value);
-        _logger.info("MIN_EL_SPEED set to: " + String(value));
+        _settingsVersion++;
+        LOGI(_logger, "MIN_EL_SPEED set to: " + String(value));
     }
 }
 
@@ -1377,7 +1884,8 @@ void MotorSensorController::setMinAzSpeed(int value) {
     if (value >= 0 && value <= 255) {
         MIN_AZ_SPEED = value;
         _preferences.putInt("MIN_AZ_SPEED", value);
-        _logger.info("MIN_AZ_SPEED set to: " + String(value));
+        _settingsVersion++;
+        LOGI(_logger, "MIN_AZ_SPEED set to: " + String(value));
     }
 }
 
@@ -1385,7 +1893,8 @@ void MotorSensorController::setMinAzTolerance(float value) {
     if (value > 0 && value <= 10.0) {
         _MIN_AZ_TOLERANCE = value;
         _preferences.putFloat("MIN_AZ_TOL", value);
-        _logger.info("MIN_AZ_TOLERANCE set to: " + String(value));
+        _settingsVersion++;
+        LOGI(_logger, "MIN_AZ_TOLERANCE set to: " + String(value));
     }
 }
 
@@ -1393,60 +1902,47 @@ void MotorSensorController::setMinElTolerance(float value) {
     if (value > 0 && value <= 10.0) {
         _MIN_EL_TOLERANCE = value;
         _preferences.putFloat("MIN_EL_TOL", value);
-        _logger.info("MIN_EL_TOLERANCE set to: " + String(value));
+        _settingsVersion++;
+        LOGI(_logger, "MIN_EL_TOLERANCE set to: " + String(value));
     }
 }
 
 float MotorSensorController::getAzOffset() {
-    float result = 0.0;
-    if (_offsetMutex != NULL && xSemaphoreTake(_offsetMutex, portMAX_DELAY) == pdTRUE) {
-        result = _az_offset;
-        xSemaphoreGive(_offsetMutex);
-    }
-    return result;
+    return _az_offset;
 }
 
 void MotorSensorController::setAzOffset(float offset) {
     // Validate offset range (±180 degrees should be sufficient)
     if (offset < -180.0 || offset > 180.0) {
-        _logger.warn("AZ offset out of range: " + String(offset, 3) + "° (range: ±180°)");
+        LOGW(_logger, "AZ offset out of range: " + String(offset, 3) + "° (range: ±180°)");
         return;
     }
     
-    if (_offsetMutex != NULL && xSemaphoreTake(_offsetMutex, portMAX_DELAY) == pdTRUE) {
-        _az_offset = offset;
-        _preferences.putFloat("az_offset", offset);
-        _setPointAzUpdated = true;
-        xSemaphoreGive(_offsetMutex);
-    }
+    _az_offset = offset;
+    _preferences.putFloat("az_offset", offset);
+    _settingsVersion++;
+    _setPointAzUpdated = true;
     
-    _logger.info("AZ angle offset set to: " + String(offset, 3) + "°");
+    LOGI(_logger, "AZ angle offset set to: " + String(offset, 3) + "°");
 }
 
 float MotorSensorController::getElOffset() {
-    float result = 0.0;
-    if (_offsetMutex != NULL && xSemaphoreTake(_offsetMutex, portMAX_DELAY) == pdTRUE) {
-        result = _el_offset;
-        xSemaphoreGive(_offsetMutex);
-    }
-    return result;
+    return _el_offset;
 }
 
 void MotorSensorController::setElOffset(float offset) {
     // Validate offset range (±5 degrees should be sufficient for elevation)
     if (offset < -5.0 || offset > 5.0) {
-        _logger.warn("EL offset out of range: " + String(offset, 3) + "° (range: ±5°)");
+        LOGW(_logger, "EL offset out of range: " + String(offset, 3) + "° (range: ±5°)");
         return;
     }
     
-    if (_offsetMutex != NULL && xSemaphoreTake(_offsetMutex, portMAX_DELAY) == pdTRUE) {
-        _el_offset = offset;
-        _preferences.putFloat("el_offset", offset);
-        _setPointElUpdated = true;
-        xSemaphoreGive(_offsetMutex);
-    }
+    _el_offset = offset;
+    _preferences.putFloat("el_offset", offset);
+    _settingsVersion++;
+    _setPointElUpdated = true;
     
-    _logger.info("EL angle offset set to: " + String(offset, 3) + "°");
+    LOGI(_logger, "EL angle offset set to: " + String(offset, 3) + "°");
 }
 
 // Helper methods to get offset-adjusted start angles
@@ -1470,10 +1966,10 @@ void MotorSensorController::activateCalMode(bool on) {
         global_fault = false;
         setPWM(_pwm_pin_az, 255);
         setPWM(_pwm_pin_el, 255);
-        _logger.info("calMode set to true");
+        LOGI(_logger, "calMode set to true");
     } else {
         calMode = false;
-        _logger.info("calMode set to false");
+        LOGI(_logger, "calMode set to false");
     }
 }
 
@@ -1501,29 +1997,27 @@ void MotorSensorController::handleCalibrationMode() {
             _calMoveStartTime = millis();
             _calState = 1;
         } else {
-            analogWrite(_pwm_pin_az, 255);
-            analogWrite(_pwm_pin_el, 255);
+            setPWM(_pwm_pin_az, 255);
+            setPWM(_pwm_pin_el, 255);
             digitalWrite(_pwm_pin_az, 1);
             digitalWrite(_pwm_pin_el, 1);
         }
     } else if (_calState == 1) {
-        int directionPin, pwmPin;
+        int directionPin = _ccw_pin_el;
+        int pwmPin = _pwm_pin_el;
         
         if (_calAxis.equalsIgnoreCase("AZ")) {
             directionPin = _ccw_pin_az;
             pwmPin = _pwm_pin_az;
-        } else if (_calAxis.equalsIgnoreCase("EL")) {
-            directionPin = _ccw_pin_el;
-            pwmPin = _pwm_pin_el;
         }
         
-        digitalWrite(directionPin, _calRunTime > 0);
-        analogWrite(pwmPin, 0);
+        setDirection(directionPin, _calRunTime > 0);
+        setPWM(pwmPin, 0);
 
         unsigned long elapsedTime = millis() - _calMoveStartTime;
         if (elapsedTime > abs(_calRunTime)) {
-            analogWrite(_pwm_pin_az, 255);
-            analogWrite(_pwm_pin_el, 255);
+            setPWM(_pwm_pin_az, 255);
+            setPWM(_pwm_pin_el, 255);
             _calRunTime = 0;
             _calAxis = "";
             _calState = 0;
@@ -1541,24 +2035,24 @@ void MotorSensorController::handleOscillationDetection() {
         _preferences.putInt("needs_unwind", needs_unwind);
         _prev_needs_unwind = needs_unwind;
 
-        _logger.warn("THIS SHOULD NOT BE RUNNING CONSTANTLY OR THE EEPROM COULD CORRUPT");
+        LOGW(_logger, "THIS SHOULD NOT BE RUNNING CONSTANTLY OR THE EEPROM COULD CORRUPT");
 
         // Start or continue oscillation detection
         if (!_oscillationTimerActive) {
             _oscillationTimerStart = millis();
             _oscillationTimerActive = true;
             _oscillationCount = 1;
-            _logger.info("Oscillation detection timer started");
+            LOGI(_logger, "Oscillation detection timer started");
         } else {
             _oscillationCount++;
-            _logger.info("Oscillation count: " + String(_oscillationCount));
+            LOGI(_logger, "Oscillation count: " + String(_oscillationCount));
             
             // Check for excessive oscillation
             if (_oscillationCount >= 10) {
-                float currentAngle = getCorrectedAngleAz();
+                float currentAngle = _correctedAngle_az;
                 float newSetpoint = (currentAngle <= 180.0) ? currentAngle - 1 : currentAngle + 1;
                 
-                _logger.warn("Excessive oscillation detected! Moving " + String((currentAngle <= 180.0) ? "-1°" : "+1°"));
+                LOGW(_logger, "Excessive oscillation detected! Moving " + String((currentAngle <= 180.0) ? "-1°" : "+1°"));
                 setSetPointAzInternal(newSetpoint);
                 
                 _oscillationTimerActive = false;
@@ -1571,7 +2065,7 @@ void MotorSensorController::handleOscillationDetection() {
     if (_oscillationTimerActive && (millis() - _oscillationTimerStart >= 60000)) {
         _oscillationTimerActive = false;
         _oscillationCount = 0;
-        _logger.info("Oscillation detection timer expired, count was: " + String(_oscillationCount));
+        LOGI(_logger, "Oscillation detection timer expired, count was: " + String(_oscillationCount));
     }
 }
 
@@ -1581,7 +2075,18 @@ void MotorSensorController::slowPrint(const String& message, int messageID) {
     
     unsigned long currentTime = millis();
     if (currentTime - lastPrintTimes[messageID] >= printDelay) {
-        _logger.error(message);
+        // One record per line; a multi-line report would be cut at Logger::MESSAGE_SIZE
+        int start = 0;
+        while (start < (int)message.length()) {
+            int end = message.indexOf('\n', start);
+            if (end < 0) {
+                end = message.length();
+            }
+            if (end > start) {
+                LOGE(_logger, message.substring(start, end));
+            }
+            start = end + 1;
+        }
         lastPrintTimes[messageID] = currentTime;
     }
 }
@@ -1600,6 +2105,14 @@ void MotorSensorController::updateI2CErrorCounter(int i2c_addr) {
     }
 }
 
+const MotorSensorController::I2CStats& MotorSensorController::getI2CStatsAz() const {
+    return _azI2CStats;
+}
+
+const MotorSensorController::I2CStats& MotorSensorController::getI2CStatsEl() const {
+    return _elI2CStats;
+}
+
 void MotorSensorController::resetI2CErrorCounter(int i2c_addr) {
     if (i2c_addr == _az_hall_i2c_addr) {
         _consecutivei2cErrors_az = 0;
@@ -1626,7 +2139,7 @@ void MotorSensorController::playOdeToJoy() {
     
     // Musical note frequencies
     const int NOTE_D3 = 147, NOTE_CS4 = 277, NOTE_D4 = 294, NOTE_E4 = 330;
-    const int NOTE_FS4 = 370, NOTE_G4 = 392, NOTE_A4 = 440, NOTE_B4 = 494;
+    const int NOTE_FS4 = 370, NOTE_G4 = 392;
     
     // Ode to Joy melody
     const int melody[] = {
@@ -1651,7 +2164,7 @@ void MotorSensorController::playOdeToJoy() {
     digitalWrite(_ccw_pin_az, 1);
     Serial.println("Playing Ode to Joy on motors...");
     
-    for (int noteIndex = 0; noteIndex < sizeof(melody)/sizeof(melody[0]); noteIndex++) {
+    for (size_t noteIndex = 0; noteIndex < sizeof(melody)/sizeof(melody[0]); noteIndex++) {
         analogWriteFrequency(musicPin, melody[noteIndex]);   
         analogWrite(musicPin, soundPWM);
         delay(noteDurations[noteIndex]);
@@ -1664,5 +2177,5 @@ void MotorSensorController::playOdeToJoy() {
     setPWM(musicPin, 255);
     activateCalMode(previousCalMode);
     
-    _logger.info("Ode to Joy finished");
+    LOGI(_logger, "Ode to Joy finished");
 }
\ No newline at end of file
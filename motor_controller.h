@@ -24,16 +24,43 @@
 #include <atomic>
 #include <Wire.h>
 #include <Preferences.h>
+#include <esp_timer.h>
 
 // Custom includes
 #include "ina219_manager.h"
 #include "logger.h"
+#include "motion_profile.h"
+#include "setpoint_stream.h"
+#include "plant_simulator.h"
+#include "control_profiler.h"
 
 // Forward declaration to avoid circular dependency
 class WeatherPoller;
 
 class MotorSensorController {
 public:
+    // Consistent copy of the control state, published once per control tick
+    struct MotorTelemetry {
+        unsigned long timestamp = 0;
+        float setpoint_az = 0;
+        float setpoint_el = 0;
+        float correctedAngle_az = 0;
+        float correctedAngle_el = 0;
+        double error_az = 0;
+        double error_el = 0;
+        float el_startAngle = 0;
+        float az_offset = 0;
+        float el_offset = 0;
+        int needs_unwind = 0;
+        bool setPointState_az = false;
+        bool setPointState_el = false;
+        bool isAzMotorLatched = false;
+        bool isElMotorLatched = false;
+        bool streaming = false;
+        int pwm_az = 255;
+        int pwm_el = 255;
+    };
+
     // Constructor
     MotorSensorController(Preferences& prefs, INA219Manager& ina219Manager, Logger& logger);
 
@@ -41,15 +68,39 @@ public:
     void begin();
     void runControlLoop();
     void runSafetyLoop();
+    void runSensorLoop();
+
+    // High-rate control mode: an esp_timer paces the control task instead of a 25 ms delay
+    static constexpr int LEGACY_CONTROL_PERIOD_US = 25000;  // vTaskDelayUntil period in legacy mode
+    void attachControlTask(TaskHandle_t controlTask);
+    bool isHighRateControl() const { return _controlPeriodUs > 0; }
+    int getControlPeriodUs() const { return _controlPeriodUs; }
+    void setControlPeriodUs(int value);
     
     // Weather integration
     void setWeatherPoller(WeatherPoller* weatherPoller);
 
+    // Bench testing: route motor and hall sensor I/O to a simulated plant
+    void setPlantSimulator(PlantSimulator* plant);
+
+    // Lock-free snapshot of the latest control tick
+    MotorTelemetry getTelemetry();
+    uint32_t getTelemetryReads() const { return _telemetryReads; }
+    uint32_t getTelemetryRetries() const { return _telemetryRetries; }
+
+    // Per-stage timing of runControlLoop
+    ControlLoopProfiler& getProfiler() { return _profiler; }
+
     // Setpoint and angle access methods
     float getSetPointAz();
     float getSetPointEl();
     void setSetPointAz(float setpoint_az);
     void setSetPointEl(float setpoint_el);
+
+    // Tracking stream: time-tagged points from a tracking client, followed continuously
+    void streamSetPoint(float setpoint_az, float setpoint_el, unsigned long timeMs);
+    bool isStreaming() const { return _streamActive; }
+    unsigned long getStreamPointCount() const { return _setpointStream.getPointCount(); }
     void setErrorAz(float value);
     void setErrorEl(float value);
     
@@ -80,15 +131,34 @@ public:
     int getMinAzSpeed() const { return MIN_AZ_SPEED; }
     float getMinAzTolerance() const { return _MIN_AZ_TOLERANCE; }
     float getMinElTolerance() const { return _MIN_EL_TOLERANCE; }
+    int getControllerMode() const { return _controllerMode; }
+    bool getMotionProfileEnabled() const { return _motionProfileEnabled; }
+    float getKiAz() const { return Ki_az; }
+    float getKdAz() const { return Kd_az; }
+    float getKffAz() const { return Kff_az; }
+    float getKiEl() const { return Ki_el; }
+    float getKdEl() const { return Kd_el; }
+    float getKffEl() const { return Kff_el; }
     
     // Configuration parameter setters
     void setPEl(int value);
     void setPAz(int value);
+    void setControllerMode(int value);
+    void setMotionProfileEnabled(bool enabled);
+    void setKiAz(float value);
+    void setKdAz(float value);
+    void setKffAz(float value);
+    void setKiEl(float value);
+    void setKdEl(float value);
+    void setKffEl(float value);
     void setMinElSpeed(int value);
     void setMinAzSpeed(int value);
     void setMinAzTolerance(float value);
     void setMinElTolerance(float value);
 
+    // Bumped by every setter above, so cached copies of the configuration know to refresh
+    uint32_t getSettingsVersion() const { return _settingsVersion; }
+
     // Calibration and special functions
     void activateCalMode(bool on);
     void calMoveMotor(const String& runTimeStr, const String& axis);
@@ -114,6 +184,9 @@ public:
     void updateI2CErrorCounter(int i2c_addr);
     void resetI2CErrorCounter(int i2c_addr);
 
+    // Circular mean in degrees (-180..180] of raw AS5600 counts, discarding samples beyond 2 sigma
+    static float calculateAngleMeanWithDiscard(const uint16_t* rawCounts, int size);
+
     // Motor control state
     std::atomic<bool> setPointState_az = false;
     std::atomic<bool> setPointState_el = false;
@@ -153,12 +226,29 @@ public:
     std::atomic<int> max_single_motor_az_speed = 0;
     std::atomic<int> max_single_motor_el_speed = 0;
 
+    // Per-sensor I2C transaction timing, updated by whoever holds the sensor bus
+    struct I2CStats {
+        std::atomic<uint32_t> transactions{0};
+        std::atomic<uint32_t> errors{0};
+        std::atomic<float> avgMicros{0};
+        std::atomic<uint32_t> maxMicros{0};
+    };
+
+    const I2CStats& getI2CStatsAz() const;
+    const I2CStats& getI2CStatsEl() const;
+
 private:
     // Dependencies
     Preferences& _preferences;
     INA219Manager& ina219Manager;
     Logger& _logger;
     WeatherPoller* _weatherPoller = nullptr;
+    PlantSimulator* _plant = nullptr;
+
+    // Last PWM written to each motor driver (255 is stopped). The control task drives the
+    // motors and the safety task stops them, so both write these.
+    std::atomic<int> _pwmOutput_az = 255;
+    std::atomic<int> _pwmOutput_el = 255;
 
     // Hardware configuration constants
     static constexpr int _el_hall_i2c_addr = 0x36;  // AS5600
@@ -174,7 +264,32 @@ private:
     static constexpr int MAX_EL_SPEED = 0;
     
     static constexpr int _numAvg = 10;              // Sensor averaging samples
+    static constexpr float AS5600_DEG_PER_COUNT = 0.087890625f;  // 360 / 4096
+    static constexpr unsigned long ANGLE_STALE_TIMEOUT = 250;     // ms without a good sample before faulting
+    static constexpr uint8_t AS5600_REG_STATUS = 0x0B;           // STATUS, followed by RAW ANGLE high/low
+    static constexpr int AS5600_BURST_LENGTH = 3;                 // STATUS + RAW ANGLE in one auto-incrementing read
+    static constexpr int MAGNET_CHECK_INTERVAL = 50;              // Samples between magnet status evaluations
     static constexpr uint8_t MAX_CONSECUTIVE_ERRORS = 5;
+    static constexpr uint32_t TELEMETRY_SPIN_LIMIT = 8;           // Snapshot retries before yielding the core
+    static constexpr uint32_t TELEMETRY_YIELD_LIMIT = 4;          // Yields before sleeping a tick instead
+
+    // Control loop timing
+    static constexpr int MIN_CONTROL_PERIOD_US = 1000;      // 1 kHz
+    static constexpr int MAX_CONTROL_PERIOD_US = 5000;      // 200 Hz
+    static constexpr float RAMP_STEP_PER_LEGACY_TICK = 10.0f;  // PWM counts per 25 ms, doubled during stow
+
+    // Controller selection and PID tuning
+    static constexpr int CONTROLLER_LEGACY = 0;             // P control with latch on overshoot
+    static constexpr int CONTROLLER_PID = 1;                // PID with setpoint velocity feed-forward
+    static constexpr float PID_DERIVATIVE_TAU = 0.1f;       // s, low-pass on the measured rate
+    static constexpr float PID_FEEDFORWARD_TAU = 1.0f;      // s, smooths setpoints that arrive about once a second
+    static constexpr float PID_SETPOINT_STEP = 5.0f;        // Degrees; larger jumps are moves, not motion to follow
+
+    // Motion profile limits, derived from the nominal motor rates at full PWM
+    static constexpr float NOMINAL_AZ_RATE = 9.0f;          // deg/s (1.5 RPM)
+    static constexpr float NOMINAL_EL_RATE = 1.5f;          // deg/s (0.25 RPM)
+    static constexpr float PROFILE_ACCEL_TIME = 0.5f;       // s from rest to max velocity
+    static constexpr float PROFILE_JERK_TIME = 0.25f;       // s from zero to max acceleration
 
     // Error convergence safety constants
     static constexpr int ERROR_HISTORY_SIZE = 20;              // Number of error samples to track
@@ -195,22 +310,39 @@ private:
     // Control parameters (configurable)
     int P_el = 100;
     int P_az = 5;
+    // Written by the web and serial tasks, read by the control task
+    std::atomic<int> _controllerMode = CONTROLLER_LEGACY;
+    std::atomic<bool> _motionProfileEnabled = false;
+    std::atomic<float> Ki_az = 0;
+    std::atomic<float> Kd_az = 0;
+    std::atomic<float> Kff_az = 11;     // ~MIN_AZ_SPEED counts for the nominal 9 deg/s
+    std::atomic<float> Ki_el = 0;
+    std::atomic<float> Kd_el = 0;
+    std::atomic<float> Kff_el = 33;     // ~MIN_EL_SPEED counts for the nominal 1.5 deg/s
+    int _tickControllerMode = CONTROLLER_LEGACY;    // _controllerMode latched once per control tick
+    std::atomic<uint32_t> _settingsVersion = 0;
     float _MIN_AZ_TOLERANCE = 1.5;
     float _MIN_EL_TOLERANCE = 0.1;
     std::atomic<int> _maxPowerBeforeFault = 10;
     std::atomic<int> _minVoltageThreshold = 6;
 
     // Angle offset parameters (NEW)
-    float _az_offset = 0.0;
-    float _el_offset = 0.0;
-
-    // Setpoints and errors (thread-safe)
-    volatile float _setpoint_az = 0;
-    volatile float _setpoint_el = 0;
-    volatile double _error_az = 0;
-    volatile double _error_el = 0;
-    volatile float _correctedAngle_az = 0;
-    volatile float _correctedAngle_el = 0;
+    std::atomic<float> _az_offset = 0.0;
+    std::atomic<float> _el_offset = 0.0;
+
+    // Setpoints are written by any task; errors and angles only by the control task
+    std::atomic<float> _setpoint_az = 0;
+    std::atomic<float> _setpoint_el = 0;
+    double _error_az = 0;
+    double _error_el = 0;
+    float _correctedAngle_az = 0;
+    float _correctedAngle_el = 0;
+
+    // Telemetry seqlock: odd sequence means a publish is in progress
+    MotorTelemetry _telemetry;
+    std::atomic<uint32_t> _telemetrySeq = 0;
+    std::atomic<uint32_t> _telemetryReads = 0;
+    std::atomic<uint32_t> _telemetryRetries = 0;
     
     // Update flags
     std::atomic<bool> _setPointAzUpdated = false;
@@ -218,8 +350,8 @@ private:
     std::atomic<bool> _az_priority = true;
     
     // Motor control state
-    int _current_speed_az = 0;
-    int _current_speed_el = 0;
+    float _current_speed_az = 0;
+    float _current_speed_el = 0;
     double _last_error_az = 0;
     double _last_error_el = 0;
     double _prev_error_az = 0.0;
@@ -231,7 +363,7 @@ private:
     
     // Angle and positioning state
     float _az_startAngle = 0;
-    float _el_startAngle = 0;
+    std::atomic<float> _el_startAngle = 0;
     int _prev_needs_unwind = 0;
     int _quadrantNumber_az = 0;
     int _previousquadrantNumber_az = 0;
@@ -282,22 +414,81 @@ private:
     ErrorTracker _azErrorTracker;
     ErrorTracker _elErrorTracker;
 
+    // Per-axis PID state; output is signed drive in the same units as error * P
+    struct PidState {
+        double integral;
+        double prevError;
+        float prevSetpoint;
+        double measuredRate;
+        double setpointRate;
+        double output;
+        bool initialized;
+
+        PidState() : integral(0), prevError(0), prevSetpoint(0), measuredRate(0),
+                     setpointRate(0), output(0), initialized(false) {}
+    };
+
+    PidState _azPid;
+    PidState _elPid;
+    unsigned long _lastControlMicros = 0;
+
+    // Slew trajectories; the control error is the error to the profile reference, not the target
+    MotionProfile _azProfile;
+    MotionProfile _elProfile;
+    double _controlError_az = 0;
+    double _controlError_el = 0;
+
+    // Tracking setpoints; while the stream is live its reference replaces the stored setpoints
+    SetpointStream _setpointStream;
+    std::atomic<bool> _streamActive = false;
+    float _streamSetpoint_az = 0;
+    float _streamSetpoint_el = 0;
+
+    // Stage timing for the control loop, written by the control task only
+    ControlLoopProfiler _profiler;
+
+    // Rolling window of raw AS5600 counts, filled by the sensor task and read by the control loop
+    struct AngleSampler {
+        uint16_t rawWindow[_numAvg];
+        int currentIndex;
+        int sampleCount;
+        int samplesSinceMagnetCheck;
+        uint8_t lastStatus;
+        std::atomic<float> filteredAngle;
+        std::atomic<unsigned long> lastUpdateTime;
+
+        AngleSampler() : currentIndex(0), sampleCount(0), samplesSinceMagnetCheck(0), lastStatus(0),
+                         filteredAngle(0), lastUpdateTime(0) {
+            memset(rawWindow, 0, sizeof(rawWindow));
+        }
+    };
+
+    AngleSampler _azSampler;
+    AngleSampler _elSampler;
+
+    I2CStats _azI2CStats;
+    I2CStats _elI2CStats;
+
+    // High-rate control timer (0 = legacy 25 ms loop)
+    std::atomic<int> _controlPeriodUs = 0;
+    esp_timer_handle_t _controlTimer = nullptr;
+    TaskHandle_t _controlTask = NULL;
+
     // Thread synchronization
-    SemaphoreHandle_t _setPointMutex = NULL;
-    SemaphoreHandle_t _getAngleMutex = NULL;
-    SemaphoreHandle_t _correctedAngleMutex = NULL;
-    SemaphoreHandle_t _errorMutex = NULL;
-    SemaphoreHandle_t _el_startAngleMutex = NULL;
+    SemaphoreHandle_t _getAngleMutex = NULL;   // Owns the sensor I2C bus
     SemaphoreHandle_t _windStowMutex = NULL;
-    SemaphoreHandle_t _offsetMutex = NULL;  // NEW: For thread-safe offset access
 
     // Motor control methods
     void actuate_motor_az(int min_speed);
     void actuate_motor_el(int min_speed);
     void setPWM(int pin, int pwm_value);
-    void updateMotorControl(float current_setpoint_az, float current_setpoint_el, 
-                           bool setPointAzUpdated, bool setPointElUpdated);
+    void setDirection(int pin, int level);
+    void updateMotorControl(bool setPointAzUpdated, bool setPointElUpdated);
     void updateMotorPriority(bool setPointAzUpdated, bool setPointElUpdated);
+    void publishTelemetry();
+    float getRampStep();
+    void applyControlPeriod();
+    static void controlTimerCallback(void* arg);
     
     // Wind safety methods
     void updateWindStowStatus();
@@ -322,9 +513,12 @@ private:
     
     // Sensor interface methods
     float getAvgAngle(int i2c_addr);
-    float ReadRawAngle(int i2c_addr);
+    bool readSensorBurst(int i2c_addr, uint16_t& rawCount, uint8_t& status);
+    void recordI2CTransaction(int i2c_addr, unsigned long startMicros, bool success);
+    void sampleSensor(int i2c_addr, AngleSampler& sampler);
+    void seedSampler(AngleSampler& sampler, float angle);
+    float getLatestAngle(AngleSampler& sampler, const char* axis);
     int checkMagnetPresence(int i2c_addr);
-    float calculateAngleMeanWithDiscard(float* array, int size);
     
     // Error convergence safety methods
     void updateErrorTracking();
@@ -332,6 +526,15 @@ private:
     bool isErrorDiverging(const ErrorTracker& tracker, float tolerance);
     bool isConvergenceStalled(const ErrorTracker& tracker, float tolerance);
     void resetErrorTracker(ErrorTracker& tracker);
+
+    // PID methods
+    void updatePid(PidState& pid, double error, float setpoint,
+                   float Kp, float Ki, float Kd, float Kff, int maxDrive, bool active,
+                   bool smoothReference, float dt);
+    void resetPid(PidState& pid);
+
+    // Motion profile methods
+    void updateMotionProfiles(bool setPointAzUpdated, bool setPointElUpdated, float dt);
     float calculateErrorChangeRate(const ErrorTracker& tracker);
     void checkStall();
     
@@ -0,0 +1,186 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Plant Simulator - Simulated motors, AS5600 hall sensors and INA219 for bench testing.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "plant_simulator.h"
+
+// =============================================================================
+// CONSTRUCTOR AND CONFIGURATION
+// =============================================================================
+
+PlantSimulator::PlantSimulator() {
+    // Defaults match the nominal drive train: 9 deg/s in azimuth, 1.5 deg/s in elevation,
+    // drawing together about 8 W at full drive, inside the default 10 W fault limit
+    AxisParams az = {9.0f, 0.05f, 0.08f, 250.0f, 0.02f};
+    AxisParams el = {1.5f, 0.08f, 0.12f, 350.0f, 0.02f};
+    _axes[AXIS_AZ] = {az, 0.0f, 0.0f, 255, false, AS5600_STATUS_MAGNET_DETECTED};
+    _axes[AXIS_EL] = {el, 0.0f, 0.0f, 255, false, AS5600_STATUS_MAGNET_DETECTED};
+}
+
+void PlantSimulator::setAxisParams(Axis axis, const AxisParams& params) {
+    portENTER_CRITICAL(&_lock);
+    _axes[axis].params = params;
+    portEXIT_CRITICAL(&_lock);
+}
+
+void PlantSimulator::setAngle(Axis axis, float angle) {
+    portENTER_CRITICAL(&_lock);
+    _axes[axis].angle = angle;
+    _axes[axis].velocity = 0;
+    portEXIT_CRITICAL(&_lock);
+}
+
+void PlantSimulator::setMagnetStatus(Axis axis, uint8_t status) {
+    // Fault injection: clearing MD makes the controller see a missing magnet on this axis
+    portENTER_CRITICAL(&_lock);
+    _axes[axis].magnetStatus = status;
+    portEXIT_CRITICAL(&_lock);
+}
+
+// =============================================================================
+// ACTUATOR INPUTS
+// =============================================================================
+
+void PlantSimulator::setPwm(Axis axis, int pwm) {
+    portENTER_CRITICAL(&_lock);
+    _axes[axis].pwm = constrain(pwm, 0, 255);
+    portEXIT_CRITICAL(&_lock);
+}
+
+void PlantSimulator::setDirection(Axis axis, bool high) {
+    portENTER_CRITICAL(&_lock);
+    _axes[axis].directionHigh = high;
+    portEXIT_CRITICAL(&_lock);
+}
+
+// =============================================================================
+// TIME
+// =============================================================================
+
+void PlantSimulator::update(unsigned long nowMicros) {
+    float dt = 0;
+    portENTER_CRITICAL(&_lock);
+    if (_lastUpdateMicros != 0) {
+        dt = (nowMicros - _lastUpdateMicros) / 1000000.0f;
+    }
+    _lastUpdateMicros = nowMicros;
+    portEXIT_CRITICAL(&_lock);
+
+    if (dt > 0) {
+        step(dt);
+    }
+}
+
+void PlantSimulator::step(float dt) {
+    portENTER_CRITICAL(&_lock);
+    // Integrate long gaps in slices so the first-order response stays stable
+    while (dt > 0) {
+        float slice = min(dt, MAX_STEP);
+        stepAxis(_axes[AXIS_AZ], slice);
+        stepAxis(_axes[AXIS_EL], slice);
+        dt -= slice;
+    }
+    portEXIT_CRITICAL(&_lock);
+}
+
+// =============================================================================
+// SENSOR OUTPUTS
+// =============================================================================
+
+uint16_t PlantSimulator::readRawCount(Axis axis) {
+    update(micros());
+
+    portENTER_CRITICAL(&_lock);
+    float angle = _axes[axis].angle + nextNoise() * _axes[axis].params.sensorNoise;
+    portEXIT_CRITICAL(&_lock);
+
+    // The AS5600 reports the shaft angle modulo one turn in 12 bits
+    angle = fmodf(angle, 360.0f);
+    if (angle < 0) {
+        angle += 360.0f;
+    }
+    return (uint16_t)(angle * 4096.0f / 360.0f) & 0x0FFF;
+}
+
+uint8_t PlantSimulator::readStatus(Axis axis) {
+    portENTER_CRITICAL(&_lock);
+    uint8_t status = _axes[axis].magnetStatus;
+    portEXIT_CRITICAL(&_lock);
+    return status;
+}
+
+float PlantSimulator::readShuntVoltage_mV() {
+    portENTER_CRITICAL(&_lock);
+    float current = totalCurrent_mA();
+    portEXIT_CRITICAL(&_lock);
+    return current * SHUNT_RESISTANCE;
+}
+
+float PlantSimulator::readBusVoltage_V() {
+    portENTER_CRITICAL(&_lock);
+    float current = totalCurrent_mA();
+    portEXIT_CRITICAL(&_lock);
+    return SUPPLY_VOLTAGE - (current / 1000.0f) * (SUPPLY_RESISTANCE + SHUNT_RESISTANCE);
+}
+
+// =============================================================================
+// STATE ACCESS
+// =============================================================================
+
+float PlantSimulator::getAngle(Axis axis) {
+    portENTER_CRITICAL(&_lock);
+    float angle = _axes[axis].angle;
+    portEXIT_CRITICAL(&_lock);
+    return angle;
+}
+
+float PlantSimulator::getVelocity(Axis axis) {
+    portENTER_CRITICAL(&_lock);
+    float velocity = _axes[axis].velocity;
+    portEXIT_CRITICAL(&_lock);
+    return velocity;
+}
+
+// =============================================================================
+// HELPER METHODS
+// =============================================================================
+
+void PlantSimulator::stepAxis(AxisState& axis, float dt) {
+    // Speed settles towards the drive level above the static friction deadband
+    float drive = driveFraction(axis);
+    float effective = max((drive - axis.params.deadband) / (1.0f - axis.params.deadband), 0.0f);
+    float targetVelocity = effective * axis.params.maxRate * (axis.directionHigh ? -1.0f : 1.0f);
+
+    axis.velocity += (targetVelocity - axis.velocity) * min(dt / axis.params.timeConstant, 1.0f);
+    axis.angle += axis.velocity * dt;
+}
+
+float PlantSimulator::driveFraction(const AxisState& axis) const {
+    return (255 - axis.pwm) / 255.0f;
+}
+
+float PlantSimulator::totalCurrent_mA() const {
+    return IDLE_CURRENT +
+           driveFraction(_axes[AXIS_AZ]) * _axes[AXIS_AZ].params.runCurrent +
+           driveFraction(_axes[AXIS_EL]) * _axes[AXIS_EL].params.runCurrent;
+}
+
+float PlantSimulator::nextNoise() {
+    // Small deterministic LCG so runs are repeatable; returns -1..1
+    _noiseState = _noiseState * 1664525u + 1013904223u;
+    return ((_noiseState >> 8) / 8388608.0f) - 1.0f;
+}
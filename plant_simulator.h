@@ -0,0 +1,107 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Plant Simulator - Simulated motors, AS5600 hall sensors and INA219 for bench testing.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PLANT_SIMULATOR_H
+#define PLANT_SIMULATOR_H
+
+// System includes
+#include <Arduino.h>
+
+// Stands in for the physical dish: two geared DC motors with a first-order speed response,
+// static friction and a shared supply, read back through AS5600-style 12-bit angle counts
+// and INA219-style shunt and bus voltages. The motor controller and INA219 manager route
+// their I/O here when a simulator is attached, so control changes can be exercised without
+// hardware. update() advances the model in real time; step() advances it by an explicit dt
+// for callers that want to run faster than real time.
+class PlantSimulator {
+public:
+    enum Axis {
+        AXIS_AZ = 0,
+        AXIS_EL = 1
+    };
+
+    struct AxisParams {
+        float maxRate;        // Output shaft speed at full PWM, degrees per second
+        float timeConstant;   // Mechanical time constant, seconds
+        float deadband;       // Drive fraction needed to overcome static friction
+        float runCurrent;     // Extra current at full drive, mA
+        float sensorNoise;    // Peak angle noise, degrees
+    };
+
+    // Constructor
+    PlantSimulator();
+
+    // AS5600 STATUS bits; a healthy sensor reports only MD
+    static constexpr uint8_t AS5600_STATUS_MAGNET_HIGH = 0x08;
+    static constexpr uint8_t AS5600_STATUS_MAGNET_LOW = 0x10;
+    static constexpr uint8_t AS5600_STATUS_MAGNET_DETECTED = 0x20;
+
+    // Configuration
+    void setAxisParams(Axis axis, const AxisParams& params);
+    void setAngle(Axis axis, float angle);
+    void setMagnetStatus(Axis axis, uint8_t status);
+
+    // Actuator inputs; PWM is inverted like the motor drivers (255 stopped, 0 full speed)
+    // and a LOW direction pin drives the angle up
+    void setPwm(Axis axis, int pwm);
+    void setDirection(Axis axis, bool high);
+
+    // Time
+    void update(unsigned long nowMicros);
+    void step(float dt);
+
+    // Sensor outputs
+    uint16_t readRawCount(Axis axis);
+    uint8_t readStatus(Axis axis);
+    float readShuntVoltage_mV();
+    float readBusVoltage_V();
+
+    // State access
+    float getAngle(Axis axis);
+    float getVelocity(Axis axis);
+
+private:
+    // Electrical model
+    static constexpr float SUPPLY_VOLTAGE = 12.0f;     // Volts
+    static constexpr float SUPPLY_RESISTANCE = 0.5f;   // Ohms, supply plus wiring
+    static constexpr float IDLE_CURRENT = 80.0f;       // mA, electronics with both motors stopped
+    static constexpr float SHUNT_RESISTANCE = 0.01f;   // Ohms, as assumed by INA219Manager
+    static constexpr float MAX_STEP = 0.01f;           // Seconds; longer gaps are integrated in slices
+
+    struct AxisState {
+        AxisParams params;
+        float angle;
+        float velocity;
+        int pwm;
+        bool directionHigh;
+        uint8_t magnetStatus;
+    };
+
+    AxisState _axes[2];
+    unsigned long _lastUpdateMicros = 0;
+    uint32_t _noiseState = 12345;
+    portMUX_TYPE _lock = portMUX_INITIALIZER_UNLOCKED;
+
+    // Helper methods
+    void stepAxis(AxisState& axis, float dt);
+    float driveFraction(const AxisState& axis) const;
+    float totalCurrent_mA() const;
+    float nextNoise();
+};
+
+#endif // PLANT_SIMULATOR_H
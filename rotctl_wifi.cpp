@@ -18,140 +18,381 @@
 
 #include "rotctl_wifi.h"
 
+// Upper bounds of the latency histogram buckets in microseconds
+static const uint32_t LATENCY_BUCKET_BOUNDS[RotctlWifi::LATENCY_BUCKETS] = {
+    100, 250, 500, 1000, 2500, 5000, 10000, UINT32_MAX
+};
+
 RotctlWifi::RotctlWifi(Preferences& prefs, MotorSensorController& motorSensorCtrl, Logger& logger)
-    : _preferences(prefs), _motorSensorCtrl(motorSensorCtrl), _logger(logger) {
+    : _logger(logger), _motorSensorCtrl(motorSensorCtrl), _preferences(prefs) {
 }
 
 void RotctlWifi::begin() {
-    _rotator_server = new WiFiServer(_preferences.getInt("rotctl_port", DEFAULT_ROTCTL_PORT));
-    _rotator_server->begin();
-    _logger.info("Rotator rotctl TCP server started");
+    _clientMutex = xSemaphoreCreateMutex();
+
+    int port = _preferences.getInt("rotctl_port", DEFAULT_ROTCTL_PORT);
+    _listenFd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (_listenFd < 0) {
+        LOGE(_logger, "rotctl: failed to create socket");
+        return;
+    }
+
+    int reuse = 1;
+    setsockopt(_listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(_listenFd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(_listenFd, MAX_CLIENTS) < 0) {
+        LOGE(_logger, "rotctl: failed to listen on port " + String(port));
+        close(_listenFd);
+        _listenFd = -1;
+        return;
+    }
+    fcntl(_listenFd, F_SETFL, O_NONBLOCK);
+
+    LOGI(_logger, "Rotator rotctl TCP server started");
 }
 
-void RotctlWifi::rotctlWifiLoop(bool serialActive, bool stellariumOn) {
-    // If stellarium polling is on, or serial is active, disconnect rotctl client
-    if (stellariumOn || serialActive) {
-        if (_rotator_client && _rotator_client.connected()) {
-            disconnectClient();
+void RotctlWifi::rotctlWifiLoop(bool serialActive, bool stellariumOn, bool udpActive) {
+    if (_listenFd < 0) {
+        vTaskDelay(pdMS_TO_TICKS(1000));  // No server to wait on; keep the caller from spinning
+        return;
+    }
+
+    // Only this task changes the client table, so the fd set can be built without the lock
+    fd_set readSet;
+    FD_ZERO(&readSet);
+    FD_SET(_listenFd, &readSet);
+    int maxFd = _listenFd;
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        if (_clients[i].fd >= 0) {
+            FD_SET(_clients[i].fd, &readSet);
+            maxFd = max(maxFd, _clients[i].fd);
         }
+    }
+
+    // The timeout only bounds how stale the control checks below can get
+    struct timeval timeout = { 0, SELECT_TIMEOUT_MS * 1000 };
+    int ready = select(maxFd + 1, &readSet, NULL, NULL, &timeout);
+    _readyMicros = micros();
+    if (ready < 0) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+
+    if (xSemaphoreTake(_clientMutex, portMAX_DELAY) != pdTRUE) {
         return;
     }
-    
-    // Handle rotator control for GPredict and Look4Sat direct control
-    handleClientConnection();
-    handleClientCommands();
-    
-    // Check for disconnected clients
-    if (_rotator_client && !_rotator_client.connected()) {
-        disconnectClient();
+
+    // Stellarium, the serial port and a UDP controller take precedence; rotctl clients stay
+    // connected read-only meanwhile
+    bool motionAllowed = !stellariumOn && !serialActive && !udpActive;
+    if (_controller != NO_CONTROLLER) {
+        bool idle = millis() - _clients[_controller].stats.lastActivityMs > CLIENT_TIMEOUT;
+        if (!motionAllowed || idle) {
+            LOGI(_logger, "rotctl: " + String(_clients[_controller].stats.ip) + " released control");
+            _clients[_controller].stats.controller = false;
+            _controller = NO_CONTROLLER;
+        }
+    }
+
+    if (ready > 0) {
+        if (FD_ISSET(_listenFd, &readSet)) {
+            acceptClients(motionAllowed);
+        }
+        for (int i = 0; i < MAX_CLIENTS; i++) {
+            if (_clients[i].fd >= 0 && FD_ISSET(_clients[i].fd, &readSet)) {
+                readClient(i, motionAllowed);
+            }
+        }
     }
+
+    xSemaphoreGive(_clientMutex);
 }
 
-void RotctlWifi::handleClientConnection() {
-    if (!_rotator_client || !_rotator_client.connected()) {
-        _rotator_client = _rotator_server->available();
-        if (_rotator_client) {
-            _logger.info("New client connected");
-            _rotctl_client_ip = _rotator_client.remoteIP().toString();
-            _rotator_client.setTimeout(60);
-            _lastClientActivity = millis();
+void RotctlWifi::acceptClients(bool motionAllowed) {
+    for (;;) {
+        struct sockaddr_in addr;
+        socklen_t addrLength = sizeof(addr);
+        int fd = accept(_listenFd, (struct sockaddr*)&addr, &addrLength);
+        if (fd < 0) {
+            return;  // Backlog drained
+        }
+        fcntl(fd, F_SETFL, O_NONBLOCK);
+        // Replies are a line or two; send them now rather than waiting for Nagle to coalesce
+        int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        String ip = IPAddress(addr.sin_addr.s_addr).toString();
+
+        int slot = -1;
+        for (int i = 0; i < MAX_CLIENTS && slot < 0; i++) {
+            if (_clients[i].fd < 0) {
+                slot = i;
+            }
+        }
+
+        // Table full: make room by dropping the longest-idle read-only client, if it has gone quiet
+        if (slot < 0) {
+            uint32_t now = millis();
+            uint32_t longestIdle = CLIENT_TIMEOUT;
+            for (int i = 0; i < MAX_CLIENTS; i++) {
+                uint32_t idle = now - _clients[i].stats.lastActivityMs;
+                if (i != _controller && idle > longestIdle) {
+                    longestIdle = idle;
+                    slot = i;
+                }
+            }
+            if (slot >= 0) {
+                LOGW(_logger, "rotctl: dropping idle client " + String(_clients[slot].stats.ip));
+                closeClient(slot);
+            }
         }
+
+        if (slot < 0) {
+            LOGW(_logger, "rotctl: refused " + ip + ", all " + String(MAX_CLIENTS) + " slots busy");
+            close(fd);
+            continue;
+        }
+
+        Client& client = _clients[slot];
+        client.fd = fd;
+        client.closing = false;
+        client.rxLength = 0;
+        client.txLength = 0;
+        client.repliesPending = 0;
+        client.stats = {};
+        client.stats.connected = true;
+        strlcpy(client.stats.ip, ip.c_str(), sizeof(client.stats.ip));
+        client.stats.connectedMs = millis();
+        client.stats.lastActivityMs = client.stats.connectedMs;
+        _clientCount++;
+
+        LOGI(_logger, "New client connected: " + ip + (motionAllowed ? "" : " (read-only while another source controls)"));
     }
 }
 
-void RotctlWifi::handleClientCommands() {
-    if (!_rotator_client || !_rotator_client.connected()) {
-        _rotctl_client_ip = "NO ROTCTL CONNECTION";
-        return;
+void RotctlWifi::readClient(int index, bool motionAllowed) {
+    Client& client = _clients[index];
+
+    // Drain the socket: a pipelining client may have sent many commands since the last pass
+    while (client.fd >= 0 && !client.closing) {
+        size_t space = RX_BUFFER_SIZE - client.rxLength;
+        int received = recv(client.fd, client.rx + client.rxLength, space, 0);
+        if (received == 0 || (received < 0 && errno != EWOULDBLOCK && errno != EAGAIN)) {
+            LOGI(_logger, "rotctl: " + String(client.stats.ip) + " disconnected");
+            closeClient(index);
+            return;
+        }
+        if (received < 0) {
+            break;
+        }
+
+        client.stats.bytesIn += received;
+        client.rxLength += received;
+        processLines(index, motionAllowed);
+
+        if ((size_t)received < space) {
+            break;
+        }
+    }
+
+    if (client.fd >= 0) {
+        flushReplies(index);
+    }
+    if (client.fd >= 0 && client.closing) {
+        closeClient(index);
+    }
+}
+
+void RotctlWifi::processLines(int index, bool motionAllowed) {
+    Client& client = _clients[index];
+    size_t start = 0;
+
+    for (size_t i = 0; i < client.rxLength && client.fd >= 0 && !client.closing; i++) {
+        if (client.rx[i] != '\n') {
+            continue;
+        }
+        client.rx[i] = '\0';
+        if (i > start && client.rx[i - 1] == '\r') {
+            client.rx[i - 1] = '\0';
+        }
+        if (client.rx[start] != '\0') {
+            handleCommand(index, client.rx + start, motionAllowed);
+        }
+        start = i + 1;
     }
-    
-    if (_rotator_client.available() <= 0) {
+    if (client.fd < 0) {
         return;
     }
-    
-    String request = readCommandFromClient();
-    if (request.length() == 0) {
+
+    // A full buffer with no newline can never complete; drop it rather than stall the client
+    if (start == 0 && client.rxLength == RX_BUFFER_SIZE) {
+        LOGW(_logger, "rotctl: discarding unterminated input from " + String(client.stats.ip));
+        client.rxLength = 0;
         return;
     }
-    
-    _logger.info("Received message: " + request);
-    
-    // Handle different rotctl commands
-    if (request.startsWith("\\P") || request.startsWith("P")) {
-        handlePositionCommand(request);
-    } else if (request == "p") {
-        handleGetPositionCommand();
-    } else if (request == "s") {
-        handleStopCommand();
-    } else if (request == "R") {
-        handleResetCommand();
-    } else {
-        _logger.error("Unexpected message format: " + request);
-    }
-    
-    _lastClientActivity = millis();
-}
-
-String RotctlWifi::readCommandFromClient() {
-    String request = "";
-    unsigned long startMillis = millis();
-    
-    // Manual command reading to avoid blocking on readStringUntil('\n')
-    while (millis() - startMillis < READ_TIMEOUT) {
-        char c;
-        while (_rotator_client.available()) {
-            c = _rotator_client.read();
-            if (c == '\n') {
-                return request;
+
+    client.rxLength -= start;
+    memmove(client.rx, client.rx + start, client.rxLength);
+}
+
+void RotctlWifi::handleCommand(int index, char* line, bool motionAllowed) {
+    Client& client = _clients[index];
+    client.stats.commands++;
+    client.stats.lastActivityMs = millis();
+    client.repliesPending++;
+    _totalCommands++;
+
+    LOGV(_logger, "rotctl " + String(client.stats.ip) + ": " + line);
+
+    char* args = line;
+    Command command = parseCommand(args);
+    switch (command) {
+        case CMD_SET_POS:
+            if (claimControl(index, motionAllowed)) {
+                handlePositionCommand(index, args);
             }
-            request += c;
-        }
-        if (c == '\n') {
             break;
+        case CMD_GET_POS:
+            handleGetPositionCommand(index);
+            break;
+        case CMD_STOP:
+            if (claimControl(index, motionAllowed)) {
+                handleStopCommand();
+                appendReply(index, "RPRT 0\n");
+            }
+            break;
+        case CMD_RESET:
+            if (claimControl(index, motionAllowed)) {
+                handleResetCommand();
+                appendReply(index, "RPRT 0\n");
+            }
+            break;
+        case CMD_GET_INFO:
+            appendReply(index, "Discovery Drive\n");
+            break;
+        case CMD_DUMP_STATE:
+            handleDumpStateCommand(index);
+            break;
+        case CMD_QUIT:
+            client.closing = true;
+            break;
+        default:
+            LOGW(_logger, "Unexpected message format: " + String(line));
+            appendReply(index, "RPRT -4\n");  // Not implemented
+            break;
+    }
+}
+
+RotctlWifi::Command RotctlWifi::parseCommand(char*& line) {
+    // Long form "\set_pos 10 20" or short form "P 10 20"; "\P" is accepted as short form
+    struct CommandName {
+        char shortName;
+        const char* longName;
+        Command command;
+    };
+    static const CommandName COMMANDS[] = {
+        { 'P', "set_pos", CMD_SET_POS },
+        { 'p', "get_pos", CMD_GET_POS },
+        { 'S', "stop", CMD_STOP },
+        { 's', "stop", CMD_STOP },          // Accepted by earlier firmware
+        { 'R', "reset", CMD_RESET },
+        { '_', "get_info", CMD_GET_INFO },
+        { '\0', "dump_state", CMD_DUMP_STATE },
+        { 'q', "quit", CMD_QUIT },
+        { 'Q', "quit", CMD_QUIT },
+    };
+
+    char* name = (*line == '\\') ? line + 1 : line;
+    char* end = name;
+    while (*end != '\0' && *end != ' ') {
+        end++;
+    }
+    size_t nameLength = end - name;
+    line = end;
+
+    for (const CommandName& entry : COMMANDS) {
+        if (nameLength == 1 && *name == entry.shortName) {
+            return entry.command;
         }
+        if (nameLength > 1 && strncmp(name, entry.longName, nameLength) == 0 &&
+            entry.longName[nameLength] == '\0') {
+            return entry.command;
+        }
+    }
+    return CMD_UNKNOWN;
+}
+
+bool RotctlWifi::claimControl(int index, bool motionAllowed) {
+    if (motionAllowed && _controller == NO_CONTROLLER) {
+        _controller = index;
+        _clients[index].stats.controller = true;
+        LOGI(_logger, "rotctl: " + String(_clients[index].stats.ip) + " took control");
     }
-    
-    return request;
+
+    if (_controller == index) {
+        return true;
+    }
+
+    _clients[index].stats.rejected++;
+    _totalRejected++;
+    appendReply(index, "RPRT -9\n");
+    return false;
 }
 
-void RotctlWifi::handlePositionCommand(const String& request) {
-    float az, el;
-    
-    if (request.startsWith("\\P")) {
-        sscanf(request.c_str(), "\\P %f %f", &az, &el);
-    } else {
-        sscanf(request.c_str(), "P %f %f", &az, &el);
+void RotctlWifi::handlePositionCommand(int index, const char* args) {
+    char* end;
+    float az = strtof(args, &end);
+    bool valid = end != args;
+    args = end;
+    float el = strtof(args, &end);
+    valid = valid && end != args;
+
+    if (!valid) {
+        appendReply(index, "RPRT -1\n");  // Invalid parameter
+        return;
     }
-    
+
     az = cleanupAzimuth(az);
     el = cleanupElevation(el);
-    
-    _motorSensorCtrl.setSetPointAz(az);
-    _motorSensorCtrl.setSetPointEl(el);
-    
-    _logger.info("Parsed Azimuth: " + String(_motorSensorCtrl.getSetPointAz(), 2) +
-                 ", Elevation: " + String(_motorSensorCtrl.getSetPointEl(), 2));
-    
-    _rotator_client.print("RPRT 0\n");
-}
-
-void RotctlWifi::handleGetPositionCommand() {
-    float el = _motorSensorCtrl.getCorrectedAngleEl();
-    
+
+    // Tracking clients send a position every second or so; stream them so the dish
+    // follows continuously rather than starting a new move for each one
+    _motorSensorCtrl.streamSetPoint(az, el, millis());
+
+    LOGD(_logger, "Parsed Azimuth: " + String(az, 2) + ", Elevation: " + String(el, 2));
+
+    appendReply(index, "RPRT 0\n");
+}
+
+void RotctlWifi::handleGetPositionCommand(int index) {
+    // One snapshot so AZ and EL come from the same control tick
+    MotorSensorController::MotorTelemetry telemetry = _motorSensorCtrl.getTelemetry();
+    float el = telemetry.correctedAngle_el;
+
     // Hack to stop it breaking displays in satdump when el sits at ~359.99 instead of 0
     if (el > 359) {
         el = 0;
     }
-    
-    String response = String(_motorSensorCtrl.getCorrectedAngleAz(), 2) + "\n" + 
-                     String(el, 2) + "\n";
-    _rotator_client.print(response);
-    _logger.info("Responded with position: " + response);
+
+    char response[32];
+    int length = snprintf(response, sizeof(response), "%.2f\n%.2f\n", telemetry.correctedAngle_az, el);
+    appendReply(index, response, length);
+}
+
+void RotctlWifi::handleDumpStateCommand(int index) {
+    // Hamlib 4 netrotctl layout: protocol version, model, then key=value lines up to "done"
+    appendReply(index, "1\n2\n"
+                       "min_az=0.000000\nmax_az=360.000000\n"
+                       "min_el=0.000000\nmax_el=90.000000\n"
+                       "south_zero=0\nrot_type=AzEl\ndone\n");
 }
 
 void RotctlWifi::handleStopCommand() {
-    _motorSensorCtrl.setSetPointAz(_motorSensorCtrl.getCorrectedAngleAz());
-    _motorSensorCtrl.setSetPointEl(_motorSensorCtrl.getCorrectedAngleEl());
+    MotorSensorController::MotorTelemetry telemetry = _motorSensorCtrl.getTelemetry();
+    _motorSensorCtrl.setSetPointAz(telemetry.correctedAngle_az);
+    _motorSensorCtrl.setSetPointEl(telemetry.correctedAngle_el);
 }
 
 void RotctlWifi::handleResetCommand() {
@@ -159,16 +400,53 @@ void RotctlWifi::handleResetCommand() {
     _motorSensorCtrl.setSetPointEl(0);
 }
 
+void RotctlWifi::appendReply(int index, const char* text) {
+    appendReply(index, text, strlen(text));
+}
+
+void RotctlWifi::appendReply(int index, const char* text, size_t length) {
+    Client& client = _clients[index];
+    if (client.txLength + length > TX_BUFFER_SIZE) {
+        flushReplies(index);
+        if (client.fd < 0) {
+            return;
+        }
+    }
+    memcpy(client.tx + client.txLength, text, length);
+    client.txLength += length;
+}
+
+void RotctlWifi::flushReplies(int index) {
+    Client& client = _clients[index];
+    if (client.txLength == 0) {
+        return;
+    }
+
+    int sent = send(client.fd, client.tx, client.txLength, 0);
+
+    // Replies are small next to the socket buffer; if they do not fit the peer has stopped reading
+    if (sent != (int)client.txLength) {
+        LOGW(_logger, "rotctl: " + String(client.stats.ip) + " stopped reading, disconnecting");
+        closeClient(index);
+        return;
+    }
+    client.stats.bytesOut += sent;
+    client.txLength = 0;
+
+    recordLatency(micros() - _readyMicros, client.repliesPending);
+    client.repliesPending = 0;
+}
+
 float RotctlWifi::cleanupAzimuth(float az) {
     if (isnan(az)) {
         az = 0;
     }
-    
+
     az = fmod(az, 360.0);
     if (az < 0) {
         az += 360.0;
     }
-    
+
     return az;
 }
 
@@ -176,23 +454,107 @@ float RotctlWifi::cleanupElevation(float el) {
     if (isnan(el)) {
         el = 0;
     }
-    
+
     if (el < 0) el = 0;
     if (el > 90) el = 90;
-    
+
     return el;
 }
 
-void RotctlWifi::disconnectClient() {
-    _rotctl_client_ip = "NO ROTCTL CONNECTION";
-    _rotator_client.stop();
-    _rotator_client = WiFiClient();
+void RotctlWifi::closeClient(int index) {
+    Client& client = _clients[index];
+    if (client.fd < 0) {
+        return;
+    }
+
+    close(client.fd);
+    client.fd = -1;
+    client.closing = false;
+    client.rxLength = 0;
+    client.txLength = 0;
+    client.repliesPending = 0;
+    client.stats.connected = false;
+    client.stats.controller = false;
+    if (_controller == index) {
+        _controller = NO_CONTROLLER;
+    }
+    _clientCount--;
 }
 
 String RotctlWifi::getRotctlClientIP() {
-    return _rotctl_client_ip;
+    String ip = "NO ROTCTL CONNECTION";
+    if (xSemaphoreTake(_clientMutex, portMAX_DELAY) == pdTRUE) {
+        if (_controller != NO_CONTROLLER) {
+            ip = _clients[_controller].stats.ip;
+        }
+        xSemaphoreGive(_clientMutex);
+    }
+    return ip;
 }
 
 bool RotctlWifi::isRotctlConnected() {
-    return _rotator_client.connected();
-}
\ No newline at end of file
+    return _clientCount > 0;
+}
+
+bool RotctlWifi::getClientStats(int index, ClientStats& stats) {
+    if (index < 0 || index >= MAX_CLIENTS) {
+        return false;
+    }
+    if (xSemaphoreTake(_clientMutex, portMAX_DELAY) != pdTRUE) {
+        return false;
+    }
+    stats = _clients[index].stats;
+    xSemaphoreGive(_clientMutex);
+    return stats.connected;
+}
+
+void RotctlWifi::recordLatency(uint32_t micros, uint32_t commands) {
+    // Replies batched into one write all waited the same time
+    int bucket = 0;
+    while (micros > LATENCY_BUCKET_BOUNDS[bucket]) {
+        bucket++;
+    }
+    _latencyBuckets[bucket] += commands;
+    _latencyCount += commands;
+    _latencySumMicros += (uint64_t)micros * commands;
+    _latencyMaxMicros = max(_latencyMaxMicros, micros);
+}
+
+RotctlWifi::LatencyStats RotctlWifi::getLatencyStats() {
+    LatencyStats stats = {};
+    if (xSemaphoreTake(_clientMutex, portMAX_DELAY) != pdTRUE) {
+        return stats;
+    }
+    stats.count = _latencyCount;
+    memcpy(stats.buckets, _latencyBuckets, sizeof(stats.buckets));
+    stats.maxMicros = _latencyMaxMicros;
+    stats.meanMicros = (_latencyCount > 0) ? (float)((double)_latencySumMicros / _latencyCount) : 0;
+    xSemaphoreGive(_clientMutex);
+
+    uint32_t seen = 0;
+    for (int i = 0; i < LATENCY_BUCKETS && stats.count > 0; i++) {
+        seen += stats.buckets[i];
+        if (stats.p50Micros == 0 && seen >= stats.count - stats.count / 2) {
+            stats.p50Micros = min(LATENCY_BUCKET_BOUNDS[i], stats.maxMicros);
+        }
+        if (seen >= stats.count - stats.count / 100) {
+            stats.p99Micros = min(LATENCY_BUCKET_BOUNDS[i], stats.maxMicros);
+            break;
+        }
+    }
+    return stats;
+}
+
+void RotctlWifi::resetLatencyStats() {
+    if (xSemaphoreTake(_clientMutex, portMAX_DELAY) == pdTRUE) {
+        memset(_latencyBuckets, 0, sizeof(_latencyBuckets));
+        _latencyCount = 0;
+        _latencySumMicros = 0;
+        _latencyMaxMicros = 0;
+        xSemaphoreGive(_clientMutex);
+    }
+}
+
+uint32_t RotctlWifi::getLatencyBucketBound(int index) {
+    return LATENCY_BUCKET_BOUNDS[index];
+}
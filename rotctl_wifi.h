@@ -21,46 +21,140 @@
 
 //#include <Arduino.h>
 #include <Preferences.h>
-#include <WiFiServer.h>
-#include <WiFiClient.h>
+#include <IPAddress.h>
+#include <lwip/sockets.h>
+#include <atomic>
 
 #include "motor_controller.h"
 #include "logger.h"
 
+// rotctl server for several clients at once. The first client to send a motion command
+// (P, S, R) becomes the controller; every other client may poll the position but gets
+// "RPRT -9" (rejected) for motion commands. All sockets are non-blocking and serviced
+// through one select() per loop, so a stalled client never holds up the others.
+//
+// Commands are framed in a fixed per-client buffer and parsed in place: every complete
+// line received is handled in the same pass and the replies go out in a single write.
+//
+// rotctlWifiLoop() blocks in select() until a socket is readable, so connections are
+// accepted and commands answered as soon as they arrive rather than on a polling tick.
+// The time from select() waking to the reply being written is kept as a histogram.
 class RotctlWifi {
 public:
+    static constexpr int MAX_CLIENTS = 4;
+    static constexpr int LATENCY_BUCKETS = 8;
+
+    struct ClientStats {
+        bool connected;
+        bool controller;
+        char ip[16];
+        uint32_t connectedMs;       // millis() when accepted
+        uint32_t lastActivityMs;    // millis() of the last received command
+        uint32_t commands;
+        uint32_t rejected;          // Motion commands refused because another client controls
+        uint32_t bytesIn;
+        uint32_t bytesOut;
+    };
+
+    struct LatencyStats {
+        uint32_t count;
+        uint32_t buckets[LATENCY_BUCKETS];
+        uint32_t p50Micros;         // Upper bound of the bucket holding the percentile
+        uint32_t p99Micros;
+        uint32_t maxMicros;
+        float meanMicros;
+    };
+
     RotctlWifi(Preferences& prefs, MotorSensorController& motorController, Logger& logger);
-    
+
     void begin();
-    void rotctlWifiLoop(bool serialActive, bool stellariumOn);
-    
+    void rotctlWifiLoop(bool serialActive, bool stellariumOn, bool udpActive);
+
+    // The controlling client's IP, or "NO ROTCTL CONNECTION" when nobody controls
     String getRotctlClientIP();
     bool isRotctlConnected();
 
+    // Statistics
+    int getClientCount() const { return _clientCount; }
+    bool getClientStats(int index, ClientStats& stats);
+    uint32_t getTotalCommands() const { return _totalCommands; }
+    uint32_t getTotalRejected() const { return _totalRejected; }
+
+    // Command-to-reply latency; the last bucket's bound is UINT32_MAX
+    LatencyStats getLatencyStats();
+    void resetLatencyStats();
+    static uint32_t getLatencyBucketBound(int index);
+
 private:
-    static const unsigned long CLIENT_TIMEOUT = 10000;  // 10 seconds timeout
-    static const unsigned long READ_TIMEOUT = 1000;     // 1 second read timeout
+    static const unsigned long CLIENT_TIMEOUT = 10000;  // Idle clients lose control and may be evicted
     static const int DEFAULT_ROTCTL_PORT = 4533;
-    
-    void handleClientConnection();
-    void handleClientCommands();
-    void handlePositionCommand(const String& request);
-    void handleGetPositionCommand();
+    static const unsigned long SELECT_TIMEOUT_MS = 250;  // Longest wait before re-checking control
+    static constexpr int NO_CONTROLLER = -1;
+    static constexpr size_t RX_BUFFER_SIZE = 128;       // Longest accepted command line
+    static constexpr size_t TX_BUFFER_SIZE = 512;       // Replies to one read, sent as one write
+
+    enum Command {
+        CMD_SET_POS,
+        CMD_GET_POS,
+        CMD_STOP,
+        CMD_RESET,
+        CMD_GET_INFO,
+        CMD_DUMP_STATE,
+        CMD_QUIT,
+        CMD_UNKNOWN
+    };
+
+    struct Client {
+        int fd = -1;
+        bool closing = false;               // Close once pending replies are sent
+        char rx[RX_BUFFER_SIZE];            // Received bytes not yet terminated by a newline
+        size_t rxLength = 0;
+        char tx[TX_BUFFER_SIZE];
+        size_t txLength = 0;
+        uint32_t repliesPending = 0;        // Commands answered in tx but not yet sent
+        ClientStats stats = {};
+    };
+
+    void acceptClients(bool motionAllowed);
+    void readClient(int index, bool motionAllowed);
+    void processLines(int index, bool motionAllowed);
+    void handleCommand(int index, char* line, bool motionAllowed);
+    Command parseCommand(char*& line);
+    bool claimControl(int index, bool motionAllowed);
+    void handlePositionCommand(int index, const char* args);
+    void handleGetPositionCommand(int index);
+    void handleDumpStateCommand(int index);
     void handleStopCommand();
     void handleResetCommand();
-    void disconnectClient();
-    String readCommandFromClient();
+    void appendReply(int index, const char* text, size_t length);
+    void appendReply(int index, const char* text);
+    void flushReplies(int index);
+    void closeClient(int index);
+    void recordLatency(uint32_t micros, uint32_t commands);
     float cleanupAzimuth(float az);
     float cleanupElevation(float el);
-    
+
     Logger& _logger;
     MotorSensorController& _motorSensorCtrl;
     Preferences& _preferences;
-    
-    WiFiServer* _rotator_server;
-    WiFiClient _rotator_client;
-    String _rotctl_client_ip = "NO ROTCTL CONNECTION";
-    unsigned long _lastClientActivity = 0;
+
+    int _listenFd = -1;
+    Client _clients[MAX_CLIENTS];
+    int _controller = NO_CONTROLLER;
+
+    // Guards the client table against readers in the web and polling tasks
+    SemaphoreHandle_t _clientMutex = NULL;
+
+    // Latency histogram, guarded by the client mutex
+    uint32_t _readyMicros = 0;              // When select() last woke
+    uint32_t _latencyBuckets[LATENCY_BUCKETS] = {};
+    uint32_t _latencyCount = 0;
+    uint64_t _latencySumMicros = 0;
+    uint32_t _latencyMaxMicros = 0;
+
+    std::atomic<int> _clientCount = 0;
+    std::atomic<uint32_t> _totalCommands = 0;
+    std::atomic<uint32_t> _totalRejected = 0;
 };
 
-#endif
\ No newline at end of file
+#endif
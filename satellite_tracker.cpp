@@ -0,0 +1,254 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Satellite Tracker - Autonomous tracking from an uploaded TLE.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "satellite_tracker.h"
+#include <sys/time.h>
+
+// =============================================================================
+// CONSTRUCTOR AND INITIALIZATION
+// =============================================================================
+
+SatelliteTracker::SatelliteTracker(Preferences& prefs, MotorSensorController& motorSensorCtrl,
+                                   WeatherPoller& weatherPoller, Logger& logger)
+    : _preferences(prefs), _motorSensorCtrl(motorSensorCtrl), _weatherPoller(weatherPoller), _logger(logger) {
+}
+
+void SatelliteTracker::begin() {
+    _tleMutex = xSemaphoreCreateMutex();
+
+    // Propagation needs UTC; SNTP keeps the clock synced once WiFi is up
+    configTime(0, 0, "pool.ntp.org", "time.google.com");
+
+    // Restore the last uploaded elements
+    String name = _preferences.getString("tleName", "");
+    String line1 = _preferences.getString("tleLine1", "");
+    String line2 = _preferences.getString("tleLine2", "");
+    if (line1.length() > 0 && line2.length() > 0) {
+        Sgp4::Result result = _sgp4.loadTle(line1.c_str(), line2.c_str());
+        if (result == Sgp4::OK) {
+            _satelliteName = name;
+        } else {
+            LOGW(_logger, "Stored TLE rejected (code " + String((int)result) + ")");
+        }
+    }
+
+    _trackingOn = _preferences.getBool("trackingOn", false);
+
+    LOGI(_logger, "SatelliteTracker initialized - " +
+                 (_sgp4.isLoaded() ? "TLE: " + _satelliteName : String("no TLE loaded")));
+}
+
+// =============================================================================
+// CORE FUNCTIONALITY
+// =============================================================================
+
+void SatelliteTracker::runTrackingLoop(bool serialActive, String rotctl_client_ip, bool stellariumOn) {
+    // Work on a copy so a TLE upload never blocks on a propagation in progress
+    Sgp4 sgp4;
+    xSemaphoreTake(_tleMutex, portMAX_DELAY);
+    sgp4 = _sgp4;
+    xSemaphoreGive(_tleMutex);
+
+    TrackingState state = checkPreconditions(sgp4.isLoaded(), serialActive, rotctl_client_ip, stellariumOn);
+    if (state != STATE_TRACKING) {
+        setState(state);
+        return;
+    }
+
+    double now = currentUnixTime();
+    unsigned long nowMs = millis();
+
+    // Each point is computed one lead time ahead; the motor controller interpolates towards
+    // it at control rate, so the dish is already moving along the pass between propagations
+    float az, el, range;
+    unsigned long startMicros = micros();
+    bool valid = computeLookAngles(sgp4, now + LEAD_TIME_MS / 1000.0, az, el, range);
+    unsigned long elapsed = micros() - startMicros;
+    _lastPropagationMicros = elapsed;
+    if (elapsed > _maxPropagationMicros) {
+        _maxPropagationMicros = elapsed;
+    }
+
+    if (!valid) {
+        setState(STATE_ERROR);
+        return;
+    }
+
+    _azimuth = az;
+    _elevation = el;
+    _range = range;
+
+    if (el < MIN_ELEVATION) {
+        setState(STATE_BELOW_HORIZON);
+        return;
+    }
+
+    // Anchor a new stream at the current position so the first segment has a velocity
+    if (!_motorSensorCtrl.isStreaming()) {
+        float nowAz, nowEl, nowRange;
+        if (computeLookAngles(sgp4, now, nowAz, nowEl, nowRange) && nowEl >= MIN_ELEVATION) {
+            _motorSensorCtrl.streamSetPoint(nowAz, nowEl, nowMs);
+        }
+    }
+
+    _motorSensorCtrl.streamSetPoint(az, el, nowMs + LEAD_TIME_MS);
+    setState(STATE_TRACKING);
+}
+
+SatelliteTracker::TrackingState SatelliteTracker::checkPreconditions(bool tleLoaded, bool serialActive,
+                                                                    String rotctl_client_ip, bool stellariumOn) {
+    if (!getTrackingOn()) {
+        return STATE_OFF;
+    }
+    if (!tleLoaded) {
+        return STATE_NO_TLE;
+    }
+    if (!_weatherPoller.isLocationConfigured()) {
+        return STATE_NO_LOCATION;
+    }
+    if (time(nullptr) < MIN_VALID_TIME) {
+        return STATE_NO_TIME;
+    }
+    // Like Stellarium, yield to any client that is driving the rotator directly
+    if (serialActive || stellariumOn || rotctl_client_ip != "NO ROTCTL CONNECTION") {
+        return STATE_OTHER_CLIENT;
+    }
+    return STATE_TRACKING;
+}
+
+bool SatelliteTracker::computeLookAngles(const Sgp4& sgp4, double unixTime, float& az, float& el, float& range) {
+    double teme[3];
+    if (sgp4.propagate((unixTime - sgp4.getEpochUnix()) / 60.0, teme) != Sgp4::OK) {
+        return false;
+    }
+
+    double azimuth, elevation, distance;
+    Sgp4::lookAngles(teme, unixTime, _weatherPoller.getLatitude(), _weatherPoller.getLongitude(),
+                     azimuth, elevation, distance);
+    az = azimuth;
+    el = elevation;
+    range = distance;
+    return true;
+}
+
+void SatelliteTracker::setState(TrackingState state) {
+    TrackingState previous = _state.exchange(state);
+    if (previous != state) {
+        LOGI(_logger, "Satellite tracking: " + getStateText());
+    }
+}
+
+// =============================================================================
+// TLE MANAGEMENT
+// =============================================================================
+
+bool SatelliteTracker::setTLE(const String& name, const String& line1, const String& line2) {
+    String l1 = line1;
+    String l2 = line2;
+    String satName = name;
+    l1.trim();
+    l2.trim();
+    satName.trim();
+
+    Sgp4 sgp4;
+    Sgp4::Result result = sgp4.loadTle(l1.c_str(), l2.c_str());
+    if (result != Sgp4::OK) {
+        LOGW(_logger, "TLE rejected (code " + String((int)result) + ")");
+        return false;
+    }
+
+    if (satName.length() == 0) {
+        satName = "NORAD " + String(sgp4.getCatalogNumber());
+    }
+
+    xSemaphoreTake(_tleMutex, portMAX_DELAY);
+    _sgp4 = sgp4;
+    _satelliteName = satName;
+    xSemaphoreGive(_tleMutex);
+    _settingsVersion++;
+
+    _preferences.putString("tleName", satName);
+    _preferences.putString("tleLine1", l1);
+    _preferences.putString("tleLine2", l2);
+
+    LOGI(_logger, "TLE loaded for " + satName + ", period " + String(sgp4.getPeriodMinutes(), 1) + " min");
+    return true;
+}
+
+String SatelliteTracker::getSatelliteName() {
+    xSemaphoreTake(_tleMutex, portMAX_DELAY);
+    String name = _sgp4.isLoaded() ? _satelliteName : String("NO TLE");
+    xSemaphoreGive(_tleMutex);
+    return name;
+}
+
+String SatelliteTracker::getTleEpochText() {
+    xSemaphoreTake(_tleMutex, portMAX_DELAY);
+    bool loaded = _sgp4.isLoaded();
+    double epoch = _sgp4.getEpochUnix();
+    xSemaphoreGive(_tleMutex);
+
+    if (!loaded) {
+        return "-";
+    }
+
+    time_t epochTime = (time_t)epoch;
+    struct tm epochTm;
+    gmtime_r(&epochTime, &epochTm);
+    char buffer[32];
+    strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M UTC", &epochTm);
+    return String(buffer);
+}
+
+// =============================================================================
+// TRACKING MODE GETTERS AND SETTERS
+// =============================================================================
+
+bool SatelliteTracker::getTrackingOn() {
+    return _trackingOn;
+}
+
+void SatelliteTracker::setTrackingOn(bool on) {
+    _trackingOn = on;
+    _preferences.putBool("trackingOn", on);
+    _settingsVersion++;
+}
+
+String SatelliteTracker::getStateText() {
+    switch (_state.load()) {
+        case STATE_OFF:            return "Off";
+        case STATE_NO_TLE:         return "No TLE loaded";
+        case STATE_NO_LOCATION:    return "Station location not set";
+        case STATE_NO_TIME:        return "Waiting for NTP time";
+        case STATE_OTHER_CLIENT:   return "Paused - another client is in control";
+        case STATE_BELOW_HORIZON:  return "Below horizon";
+        case STATE_TRACKING:       return "Tracking";
+        case STATE_ERROR:          return "Propagation error";
+    }
+    return "Unknown";
+}
+
+// =============================================================================
+// UTILITY METHODS
+// =============================================================================
+
+double SatelliteTracker::currentUnixTime() {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
@@ -0,0 +1,110 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Satellite Tracker - Autonomous tracking from an uploaded TLE.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SATELLITE_TRACKER_H
+#define SATELLITE_TRACKER_H
+
+// System includes
+#include <Preferences.h>
+#include <atomic>
+
+// Custom includes
+#include "motor_controller.h"
+#include "weather_poller.h"
+#include "logger.h"
+#include "sgp4.h"
+
+class SatelliteTracker {
+public:
+    // Tracking states reported to the UI
+    enum TrackingState {
+        STATE_OFF = 0,
+        STATE_NO_TLE,
+        STATE_NO_LOCATION,
+        STATE_NO_TIME,
+        STATE_OTHER_CLIENT,
+        STATE_BELOW_HORIZON,
+        STATE_TRACKING,
+        STATE_ERROR
+    };
+
+    // Constructor
+    SatelliteTracker(Preferences& prefs, MotorSensorController& motorController, WeatherPoller& weatherPoller, Logger& logger);
+
+    // Core functionality
+    void begin();
+    void runTrackingLoop(bool serialActive, String rotctl_client_ip, bool stellariumOn);
+
+    // TLE management; returns false and leaves the current elements in place if the lines are invalid
+    bool setTLE(const String& name, const String& line1, const String& line2);
+    String getSatelliteName();
+    String getTleEpochText();
+
+    // Tracking mode getters and setters
+    bool getTrackingOn();
+    void setTrackingOn(bool on);
+
+    // Bumped whenever the elements or the tracking switch change
+    uint32_t getSettingsVersion() const { return _settingsVersion; }
+
+    // Status access
+    TrackingState getState() { return _state; }
+    String getStateText();
+    float getAzimuth() { return _azimuth; }
+    float getElevation() { return _elevation; }
+    float getRange() { return _range; }
+    unsigned long getLastPropagationMicros() { return _lastPropagationMicros; }
+    unsigned long getMaxPropagationMicros() { return _maxPropagationMicros; }
+
+private:
+    // Dependencies
+    Preferences& _preferences;
+    MotorSensorController& _motorSensorCtrl;
+    WeatherPoller& _weatherPoller;
+    Logger& _logger;
+
+    // Tracking constants
+    static constexpr unsigned long LEAD_TIME_MS = 1000;    // Each point is computed this far ahead and interpolated up to
+    static constexpr float MIN_ELEVATION = 0.0f;            // Degrees
+    static constexpr time_t MIN_VALID_TIME = 1600000000;    // Anything earlier means NTP has not synced yet
+
+    // Elements, shared between the web task and the tracking task
+    SemaphoreHandle_t _tleMutex = NULL;
+    Sgp4 _sgp4;
+    String _satelliteName = "";
+
+    // State variables (thread-safe)
+    std::atomic<bool> _trackingOn = false;
+    std::atomic<uint32_t> _settingsVersion = 0;
+    std::atomic<TrackingState> _state = STATE_OFF;
+    std::atomic<float> _azimuth = 0;
+    std::atomic<float> _elevation = 0;
+    std::atomic<float> _range = 0;
+    std::atomic<unsigned long> _lastPropagationMicros = 0;
+    std::atomic<unsigned long> _maxPropagationMicros = 0;
+
+    // Core functionality helpers
+    TrackingState checkPreconditions(bool tleLoaded, bool serialActive, String rotctl_client_ip, bool stellariumOn);
+    bool computeLookAngles(const Sgp4& sgp4, double unixTime, float& az, float& el, float& range);
+    void setState(TrackingState state);
+
+    // Utility methods
+    static double currentUnixTime();
+};
+
+#endif // SATELLITE_TRACKER_H
@@ -18,6 +18,8 @@
 
 #include "serial_manager.h"
 
+SerialManager* SerialManager::_instance = nullptr;
+
 // =============================================================================
 // CONSTRUCTOR AND INITIALIZATION
 // =============================================================================
@@ -27,35 +29,93 @@ SerialManager::SerialManager(Preferences& prefs, MotorSensorController& motorSen
 }
 
 void SerialManager::begin() {
-    _inputString.reserve(30);  // Reserve space for input string
-    _stringComplete = false;
-    _logger.info("SerialManager initialized");
+    _inputString.reserve(MAX_LINE_LENGTH);  // Lines never grow past this, so no reallocation
+    _statsMutex = xSemaphoreCreateMutex();
+    LOGI(_logger, "SerialManager initialized");
+}
+
+void SerialManager::attachSerialTask(TaskHandle_t serialTask) {
+    _serialTask = serialTask;
+    _instance = this;
+
+#if ARDUINO_USB_CDC_ON_BOOT && !ARDUINO_USB_MODE
+    // USB-OTG (TinyUSB) CDC, the configuration the board is built with
+    Serial.onEvent(ARDUINO_USB_CDC_RX_EVENT, [](void*, esp_event_base_t, int32_t, void*) { onSerialRx(); });
+#elif ARDUINO_USB_CDC_ON_BOOT
+    // Hardware USB-Serial/JTAG
+    Serial.onEvent(ARDUINO_HW_CDC_RX_EVENT, [](void*, esp_event_base_t, int32_t, void*) { onSerialRx(); });
+#else
+    // UART; the driver's event task calls back on FIFO threshold or RX idle
+    Serial.onReceive(onSerialRx);
+#endif
+}
+
+// Runs in the driver's event task, not an ISR
+void SerialManager::onSerialRx() {
+    SerialManager* self = _instance;
+    if (self == nullptr || self->_serialTask == NULL) {
+        return;
+    }
+    uint32_t expected = 0;
+    uint32_t now = micros();
+    self->_rxEventMicros.compare_exchange_strong(expected, now == 0 ? 1 : now);
+    xTaskNotifyGive(self->_serialTask);
 }
 
 // =============================================================================
 // CORE FUNCTIONALITY
 // =============================================================================
 
-void SerialManager::runSerialLoop() {
+TickType_t SerialManager::runSerialLoop() {
     readSerialInput();
-    
-    if (_stringComplete) {
-        processCommand();
-        resetInputBuffer();
-    }
-    
+    flushTx();
     updateSerialActivityStatus();
+
+    // Come straight back while replies wait for room in the driver
+    return _txLength > 0 ? 1 : pdMS_TO_TICKS(_idleWaitMs);
+}
+
+SerialManager::LatencyStats SerialManager::getLatencyStats() {
+    LatencyStats stats = {};
+    if (_statsMutex == NULL || xSemaphoreTake(_statsMutex, pdMS_TO_TICKS(10)) != pdTRUE) {
+        return stats;
+    }
+    stats.count = _latencyCount;
+    stats.lastMicros = _latencyLastMicros;
+    stats.maxMicros = _latencyMaxMicros;
+    stats.meanMicros = _latencyCount > 0 ? (float)_latencySumMicros / _latencyCount : 0.0f;
+    xSemaphoreGive(_statsMutex);
+    return stats;
 }
 
 void SerialManager::readSerialInput() {
+    // Replies are timed from the RX event; a backstop wake with data waiting times from now
+    uint32_t rxMicros = _rxEventMicros.exchange(0);
+    if (rxMicros == 0) {
+        rxMicros = micros();
+    }
+
+    // Handle every complete line already received, not one per wakeup
     while (Serial.available()) {
         char inChar = (char)Serial.read();
-        _inputString += inChar;
-        
+
         if (inChar == '\n' || inChar == '\r') {
-            _stringComplete = true;
-            break;
+            if (!_lineOverflow) {
+                _lineMicros = rxMicros;
+                processCommand();
+            }
+            resetInputBuffer();
+            continue;
         }
+
+        if (_inputString.length() >= MAX_LINE_LENGTH) {
+            if (!_lineOverflow) {
+                LOGW(_logger, "Serial line longer than " + String(MAX_LINE_LENGTH) + " characters discarded");
+                _lineOverflow = true;
+            }
+            continue;
+        }
+        _inputString += inChar;
     }
 }
 
@@ -65,6 +125,7 @@ void SerialManager::processCommand() {
     if (_inputString.length() == 0) {
         return;
     }
+    _commandCount++;
 
     // Process different command types
     if (processPositionQueries()) return;
@@ -74,7 +135,7 @@ void SerialManager::processCommand() {
     if (processSystemCommands()) return;
     
     // If no command matched, log unknown command
-    _logger.warn("Unknown serial command: " + _inputString);
+    LOGW(_logger, "Unknown serial command: " + _inputString);
 }
 
 // =============================================================================
@@ -82,31 +143,36 @@ void SerialManager::processCommand() {
 // =============================================================================
 
 bool SerialManager::processPositionQueries() {
+    char reply[48];
+
     if (_inputString == "AZ EL") {
-        Serial.print("AZ");
-        Serial.print(_motorSensorCtrl.getCorrectedAngleAz());
-        Serial.print(" EL");
-        Serial.println(_motorSensorCtrl.getCorrectedAngleEl());
+        MotorSensorController::MotorTelemetry telemetry = _motorSensorCtrl.getTelemetry();
+        snprintf(reply, sizeof(reply), "AZ%.2f EL%.2f\r\n", telemetry.correctedAngle_az, telemetry.correctedAngle_el);
+        queueReply(reply);
         updateSerialActivity();
         return true;
     }
     
     if (_inputString == "AZ") {
-        Serial.print("AZ");
-        Serial.println(_motorSensorCtrl.getCorrectedAngleAz());
+        snprintf(reply, sizeof(reply), "AZ%.2f\r\n", _motorSensorCtrl.getCorrectedAngleAz());
+        queueReply(reply);
         updateSerialActivity();
         return true;
     }
     
     if (_inputString == "EL") {
-        Serial.print("EL");
-        Serial.println(_motorSensorCtrl.getCorrectedAngleEl());
+        snprintf(reply, sizeof(reply), "EL%.2f\r\n", _motorSensorCtrl.getCorrectedAngleEl());
+        queueReply(reply);
         updateSerialActivity();
         return true;
     }
     
     if (_inputString.startsWith("STATUS")) {
+        // Human-readable dump, far larger than the ring; written directly after queued replies
+        _logger.lockSerial(portMAX_DELAY);
+        drainTxBlocking();
         printStatusInfo();
+        _logger.unlockSerial();
         updateSerialActivity();
         return true;
     }
@@ -168,14 +234,14 @@ bool SerialManager::processCalibrationCommands() {
     }
     
     if (_inputString.startsWith("CAL_ON")) {
-        _logger.info("CAL MODE ON");
+        LOGI(_logger, "CAL MODE ON");
         _motorSensorCtrl.calMode = true;
         updateSerialActivity();
         return true;
     }
     
     if (_inputString.startsWith("CAL_OFF")) {
-        _logger.info("CAL MODE OFF");
+        LOGI(_logger, "CAL MODE OFF");
         _motorSensorCtrl.calMode = false;
         updateSerialActivity();
         return true;
@@ -194,7 +260,7 @@ bool SerialManager::processSystemCommands() {
     if (_inputString.startsWith("RESET_WEB_PW")) {
         _preferences.putString("loginUser", "");
         _preferences.putString("loginPassword", "");
-        _logger.info("Web Interface Password Reset!");
+        LOGI(_logger, "Web Interface Password Reset!");
         updateSerialActivity();
         return true;
     }
@@ -215,7 +281,7 @@ bool SerialManager::processSystemCommands() {
 void SerialManager::parseAndSetPosition() {
     int delimiterIndex = _inputString.indexOf(' ');
     if (delimiterIndex == -1) {
-        _logger.warn("Invalid AZ EL command format: " + _inputString);
+        LOGW(_logger, "Invalid AZ EL command format: " + _inputString);
         return;
     }
     
@@ -232,11 +298,10 @@ void SerialManager::parseAndSetPosition() {
     float el = el_number.toFloat();
     el = validateAndCleanElevation(el);
 
-    // Set motor positions
-    _motorSensorCtrl.setSetPointAz(az);
-    _motorSensorCtrl.setSetPointEl(el);
+    // Position commands come from tracking software, so follow them as a stream
+    _motorSensorCtrl.streamSetPoint(az, el, millis());
     
-    _logger.info("Serial position command - Az: " + String(az, 2) + "°, El: " + String(el, 2) + "°");
+    LOGI(_logger, "Serial position command - Az: " + String(az, 2) + "°, El: " + String(el, 2) + "°");
 }
 
 float SerialManager::validateAndCleanAzimuth(float az) {
@@ -268,18 +333,21 @@ void SerialManager::printStatusInfo() {
     
     // === CURRENT POSITION & SETPOINTS ===
     Serial.println("--- Current Position & Setpoints ---");
-    Serial.println("Corrected Angle Elevation: " + String(_motorSensorCtrl.getCorrectedAngleEl(), 2) + "°");
-    Serial.println("Corrected Angle Azimuth: " + String(_motorSensorCtrl.getCorrectedAngleAz(), 2) + "°");
-    Serial.println("Azimuth Setpoint: " + String(_motorSensorCtrl.getSetPointAz(), 2) + "°");
-    Serial.println("Elevation Setpoint: " + String(_motorSensorCtrl.getSetPointEl(), 2) + "°");
-    Serial.println("Azimuth State: " + String(_motorSensorCtrl.setPointState_az ? "ACTIVE" : "STOPPED"));
-    Serial.println("Elevation State: " + String(_motorSensorCtrl.setPointState_el ? "ACTIVE" : "STOPPED"));
-    Serial.println("Azimuth Error: " + String(_motorSensorCtrl.getErrorAz(), 3) + "°");
-    Serial.println("Elevation Error: " + String(_motorSensorCtrl.getErrorEl(), 3) + "°");
-    Serial.println("Elevation Tare Angle: " + String(_motorSensorCtrl.getElStartAngle(), 2) + "°");
-    Serial.println("Needs Unwind: " + String(_motorSensorCtrl.needs_unwind));
-    Serial.println("Azimuth Angle Offset: " + String(_motorSensorCtrl.getAzOffset(), 3) + "°");
-    Serial.println("Elevation Angle Offset: " + String(_motorSensorCtrl.getElOffset(), 3) + "°");
+    MotorSensorController::MotorTelemetry telemetry = _motorSensorCtrl.getTelemetry();
+    Serial.println("Corrected Angle Elevation: " + String(telemetry.correctedAngle_el, 2) + "°");
+    Serial.println("Corrected Angle Azimuth: " + String(telemetry.correctedAngle_az, 2) + "°");
+    Serial.println("Azimuth Setpoint: " + String(telemetry.setpoint_az, 2) + "°");
+    Serial.println("Elevation Setpoint: " + String(telemetry.setpoint_el, 2) + "°");
+    Serial.println("Azimuth State: " + String(telemetry.setPointState_az ? "ACTIVE" : "STOPPED"));
+    Serial.println("Elevation State: " + String(telemetry.setPointState_el ? "ACTIVE" : "STOPPED"));
+    Serial.println("Azimuth Error: " + String(telemetry.error_az, 3) + "°");
+    Serial.println("Elevation Error: " + String(telemetry.error_el, 3) + "°");
+    Serial.println("Elevation Tare Angle: " + String(telemetry.el_startAngle, 2) + "°");
+    Serial.println("Needs Unwind: " + String(telemetry.needs_unwind));
+    Serial.println("Azimuth Angle Offset: " + String(telemetry.az_offset, 3) + "°");
+    Serial.println("Elevation Angle Offset: " + String(telemetry.el_offset, 3) + "°");
+    Serial.println("Tracking Stream: " + String(telemetry.streaming ? "ACTIVE" : "IDLE") +
+                   " (" + String(_motorSensorCtrl.getStreamPointCount()) + " points received)");
     
     // === SYSTEM STATUS & ERRORS ===
     Serial.println("--- System Status & Errors ---");
@@ -292,6 +360,32 @@ void SerialManager::printStatusInfo() {
     Serial.println("AZ Motor Latched: " + String(_motorSensorCtrl._isAzMotorLatched ? "TRUE" : "FALSE"));
     Serial.println("EL Motor Latched: " + String(_motorSensorCtrl._isElMotorLatched ? "TRUE" : "FALSE"));
     Serial.println("Serial Active: " + String(serialActive ? "TRUE" : "FALSE"));
+    LatencyStats latency = getLatencyStats();
+    Serial.println("Serial Reply Latency: " + String(latency.lastMicros) + "us last, " + String(latency.meanMicros, 1) +
+                   "us avg, " + String(latency.maxMicros) + "us max (" + String(latency.count) + " replies, " +
+                   String(_txDropped.load()) + " dropped)");
+    
+    // === HALL SENSOR I2C ===
+    Serial.println("--- Hall Sensor I2C ---");
+    const MotorSensorController::I2CStats& azStats = _motorSensorCtrl.getI2CStatsAz();
+    const MotorSensorController::I2CStats& elStats = _motorSensorCtrl.getI2CStatsEl();
+    Serial.println("AZ Transactions: " + String(azStats.transactions.load()) + " (" + String(azStats.errors.load()) + " errors)");
+    Serial.println("AZ Transaction Time: " + String(azStats.avgMicros.load(), 1) + "us avg, " + String(azStats.maxMicros.load()) + "us max");
+    Serial.println("EL Transactions: " + String(elStats.transactions.load()) + " (" + String(elStats.errors.load()) + " errors)");
+    Serial.println("EL Transaction Time: " + String(elStats.avgMicros.load(), 1) + "us avg, " + String(elStats.maxMicros.load()) + "us max");
+    Serial.println("Telemetry Snapshot Reads: " + String(_motorSensorCtrl.getTelemetryReads()) + " (" + String(_motorSensorCtrl.getTelemetryRetries()) + " retries)");
+    
+    // === CONTROL LOOP PROFILE ===
+    Serial.println("--- Control Loop Profile (us: min / mean / p99 / max) ---");
+    ControlLoopProfiler& profiler = _motorSensorCtrl.getProfiler();
+    for (int i = 0; i < ControlLoopProfiler::STAGE_COUNT; i++) {
+        ControlLoopProfiler::Stage stage = (ControlLoopProfiler::Stage)i;
+        ControlLoopProfiler::StageStats stats = profiler.getStats(stage);
+        Serial.println(String(ControlLoopProfiler::getStageName(stage)) + ": " +
+                       String(stats.minMicros, 1) + " / " + String(stats.meanMicros, 1) + " / " +
+                       String(stats.p99Micros, 1) + " / " + String(stats.maxMicros, 1) +
+                       " (" + String(stats.count) + " ticks)");
+    }
     
     // === MOTOR CONFIGURATION ===
     Serial.println("--- Motor Configuration ---");
@@ -307,11 +401,16 @@ void SerialManager::printStatusInfo() {
     Serial.println("--- Advanced Parameters ---");
     Serial.println("P_el (Elevation P-Gain): " + String(_motorSensorCtrl.getPEl()));
     Serial.println("P_az (Azimuth P-Gain): " + String(_motorSensorCtrl.getPAz()));
+    Serial.println("Controller Mode: " + String(_motorSensorCtrl.getControllerMode() == 1 ? "PID" : "P (latch on overshoot)"));
+    Serial.println("Motion Profile: " + String(_motorSensorCtrl.getMotionProfileEnabled() ? "ON" : "OFF"));
+    Serial.println("AZ Ki/Kd/Kff: " + String(_motorSensorCtrl.getKiAz()) + " / " + String(_motorSensorCtrl.getKdAz()) + " / " + String(_motorSensorCtrl.getKffAz()));
+    Serial.println("EL Ki/Kd/Kff: " + String(_motorSensorCtrl.getKiEl()) + " / " + String(_motorSensorCtrl.getKdEl()) + " / " + String(_motorSensorCtrl.getKffEl()));
     Serial.println("MIN_EL_SPEED: " + String(_motorSensorCtrl.getMinElSpeed()));
     Serial.println("MIN_AZ_SPEED: " + String(_motorSensorCtrl.getMinAzSpeed()));
     Serial.println("MIN_AZ_TOLERANCE: " + String(_motorSensorCtrl.getMinAzTolerance(), 3) + "°");
     Serial.println("MIN_EL_TOLERANCE: " + String(_motorSensorCtrl.getMinElTolerance(), 3) + "°");
     Serial.println("MAX_FAULT_POWER: " + String(_motorSensorCtrl.getMaxPowerBeforeFault()) + "W");
+    Serial.println("CONTROL_PERIOD_US: " + String(_motorSensorCtrl.getControlPeriodUs()) + (_motorSensorCtrl.isHighRateControl() ? "us" : " (25 ms loop)"));
     
     // === NETWORK CONFIGURATION ===
     Serial.println("--- Network Configuration ---");
@@ -324,6 +423,11 @@ void SerialManager::printStatusInfo() {
     Serial.println("Stellarium Polling: " + String(_preferences.getBool("stellariumOn", false) ? "ON" : "OFF"));
     Serial.println("Stellarium Server IP: " + _preferences.getString("stelServIP", "NO IP SET"));
     Serial.println("Stellarium Server Port: " + _preferences.getString("stelServPort", "8090"));
+
+    // === SATELLITE TRACKING ===
+    Serial.println("--- Satellite Tracking ---");
+    Serial.println("Satellite Tracking: " + String(_preferences.getBool("trackingOn", false) ? "ON" : "OFF"));
+    Serial.println("Satellite: " + _preferences.getString("tleName", "NO TLE"));
     
     // === AUTHENTICATION ===
     Serial.println("--- Authentication ---");
@@ -349,15 +453,102 @@ void SerialManager::updateSerialActivity() {
 }
 
 void SerialManager::updateSerialActivityStatus() {
-    if (millis() - _lastSerialActivity > _serialActiveTimeout) {
-        serialActive = false;
-        delay(1000);  // Throttle when inactive
-    } else {
-        serialActive = true;
-    }
+    serialActive = millis() - _lastSerialActivity <= _serialActiveTimeout;
 }
 
 void SerialManager::resetInputBuffer() {
     _inputString = "";
-    _stringComplete = false;
+    _lineOverflow = false;
+}
+
+// =============================================================================
+// TX RING
+// =============================================================================
+
+void SerialManager::queueReply(const char* text) {
+    size_t length = strlen(text);
+    if (length > TX_BUFFER_SIZE - _txLength) {
+        // The host is not reading; drop whole replies rather than block or split one
+        _txDropped++;
+        return;
+    }
+
+    size_t tail = (_txHead + _txLength) % TX_BUFFER_SIZE;
+    size_t first = min(length, TX_BUFFER_SIZE - tail);
+    memcpy(_txBuffer + tail, text, first);
+    memcpy(_txBuffer, text + first, length - first);
+    _txLength += length;
+
+    if (_repliesPending == 0) {
+        _pendingSinceMicros = _lineMicros;
+    }
+    _repliesPending++;
+}
+
+void SerialManager::flushTx() {
+    // Replies go out whole, under the serial lock, so the log drain task can only write
+    // between them. If the log holds the lock, try again on the next pass.
+    if (_txLength == 0 || !_logger.lockSerial(0)) {
+        return;
+    }
+    while (_txLength > 0) {
+        // Never hand the driver more than it can take without blocking
+        size_t length = nextReplyLength();
+        if (Serial.availableForWrite() < (int)length) {
+            break;
+        }
+        if (!writeTx(length)) {
+            break;
+        }
+    }
+    _logger.unlockSerial();
+
+    if (_txLength == 0) {
+        recordLatency();
+    }
+}
+
+void SerialManager::drainTxBlocking() {
+    writeTx(_txLength);
+    recordLatency();
+}
+
+size_t SerialManager::nextReplyLength() {
+    // Every reply ends in a newline
+    for (size_t i = 0; i < _txLength; i++) {
+        if (_txBuffer[(_txHead + i) % TX_BUFFER_SIZE] == '\n') {
+            return i + 1;
+        }
+    }
+    return _txLength;
+}
+
+bool SerialManager::writeTx(size_t length) {
+    while (length > 0) {
+        size_t chunk = min(length, TX_BUFFER_SIZE - _txHead);
+        size_t written = Serial.write((const uint8_t*)_txBuffer + _txHead, chunk);
+        if (written == 0) {
+            return false;
+        }
+        _txHead = (_txHead + written) % TX_BUFFER_SIZE;
+        _txLength -= written;
+        length -= written;
+    }
+    return true;
+}
+
+void SerialManager::recordLatency() {
+    if (_repliesPending == 0) {
+        return;
+    }
+    uint32_t elapsed = micros() - _pendingSinceMicros;
+    if (_statsMutex != NULL && xSemaphoreTake(_statsMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
+        // Replies that left together share the oldest one's latency
+        _latencyCount += _repliesPending;
+        _latencySumMicros += (uint64_t)elapsed * _repliesPending;
+        _latencyLastMicros = elapsed;
+        _latencyMaxMicros = max(_latencyMaxMicros, elapsed);
+        xSemaphoreGive(_statsMutex);
+    }
+    _repliesPending = 0;
 }
\ No newline at end of file
@@ -22,19 +22,38 @@
 // System includes
 #include <Arduino.h>
 #include <Preferences.h>
+#include <atomic>
 
 // Custom includes
 #include "motor_controller.h"
 #include "logger.h"
 
+// The serial task sleeps until the USB-CDC/UART driver reports received bytes, then frames
+// and handles every complete line in the same pass. Query replies are queued in a TX ring and
+// each is written only once the driver has room for all of it, so a host that stops reading
+// never stalls the task and log lines never split a reply. The time from the RX event to the
+// reply being handed to the driver is recorded.
 class SerialManager {
 public:
+    struct LatencyStats {
+        uint32_t count;             // Replies timed
+        uint32_t lastMicros;
+        uint32_t maxMicros;
+        float meanMicros;
+    };
+
     // Constructor
     SerialManager(Preferences& prefs, MotorSensorController& motorController, Logger& logger);
 
     // Core functionality
     void begin();
-    void runSerialLoop();
+    void attachSerialTask(TaskHandle_t serialTask);
+    TickType_t runSerialLoop();  // Returns how long the task may sleep waiting for RX
+
+    // Statistics
+    LatencyStats getLatencyStats();
+    uint32_t getCommandCount() const { return _commandCount; }
+    uint32_t getTxDropped() const { return _txDropped; }
 
     // Public state variables
     std::atomic<bool> serialActive = false;
@@ -50,6 +69,15 @@ private:
     void processCommand();
     void updateSerialActivityStatus();
     void resetInputBuffer();
+    static void onSerialRx();
+
+    // TX ring helpers
+    void queueReply(const char* text);
+    void flushTx();
+    void drainTxBlocking();
+    size_t nextReplyLength();
+    bool writeTx(size_t length);
+    void recordLatency();
 
     // Command processing methods
     bool processPositionQueries();
@@ -67,11 +95,37 @@ private:
 
     // Configuration constants
     static constexpr unsigned long _serialActiveTimeout = 10000;  // 10 seconds timeout
+    static constexpr unsigned long _idleWaitMs = 1000;            // Backstop wake to age serialActive
+    static constexpr size_t MAX_LINE_LENGTH = 64;                  // Longer lines are discarded
+    static constexpr size_t TX_BUFFER_SIZE = 512;
 
     // Serial communication state
     String _inputString = "";
-    bool _stringComplete = false;
+    bool _lineOverflow = false;             // Discarding the rest of an overlong line
     unsigned long _lastSerialActivity = 0;  // Timestamp of last serial activity
+
+    // RX event wakeup; the driver callback has no context argument, so it goes through the instance
+    static SerialManager* _instance;
+    TaskHandle_t _serialTask = NULL;
+    std::atomic<uint32_t> _rxEventMicros = 0;  // First RX event not yet handled, 0 when none
+    uint32_t _lineMicros = 0;                  // RX time of the line being processed
+
+    // TX ring, touched only by the serial task
+    char _txBuffer[TX_BUFFER_SIZE];
+    size_t _txHead = 0;                     // Oldest unsent byte
+    size_t _txLength = 0;
+
+    // Latency of the oldest reply still in the ring, and the totals; guarded by _statsMutex
+    SemaphoreHandle_t _statsMutex = NULL;
+    uint32_t _pendingSinceMicros = 0;
+    uint32_t _repliesPending = 0;
+    uint32_t _latencyCount = 0;
+    uint32_t _latencyLastMicros = 0;
+    uint32_t _latencyMaxMicros = 0;
+    uint64_t _latencySumMicros = 0;
+
+    std::atomic<uint32_t> _commandCount = 0;
+    std::atomic<uint32_t> _txDropped = 0;   // Replies discarded because the ring was full
 };
 
 #endif // SERIAL_MANAGER_H
\ No newline at end of file
@@ -0,0 +1,155 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Setpoint Stream - Time-tagged tracking setpoints with interpolation.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "setpoint_stream.h"
+
+// =============================================================================
+// CONSTRUCTOR
+// =============================================================================
+
+SetpointStream::SetpointStream() {
+}
+
+// =============================================================================
+// STREAM INPUT
+// =============================================================================
+
+void SetpointStream::push(float az, float el, unsigned long timeMs) {
+    portENTER_CRITICAL(&_lock);
+
+    // A point at or before the newest one replaces the tail of the plan, so a client that
+    // re-sends or corrects its schedule never leaves time running backwards in the ring
+    while (_count > 0) {
+        const Point& newest = _points[(_head + _count - 1) % CAPACITY];
+        if ((long)(timeMs - newest.timeMs) > 0) {
+            break;
+        }
+        _count--;
+    }
+
+    // A full ring drops its oldest point
+    if (_count == CAPACITY) {
+        _head = (_head + 1) % CAPACITY;
+        _count--;
+    }
+
+    _points[(_head + _count) % CAPACITY] = {az, el, timeMs};
+    _count++;
+    _pointCount++;
+
+    portEXIT_CRITICAL(&_lock);
+}
+
+void SetpointStream::clear() {
+    portENTER_CRITICAL(&_lock);
+    _head = 0;
+    _count = 0;
+    portEXIT_CRITICAL(&_lock);
+}
+
+// =============================================================================
+// REFERENCE OUTPUT
+// =============================================================================
+
+bool SetpointStream::sample(unsigned long nowMs, float& az, float& el) {
+    // Copy the ring out so the interpolation runs outside the critical section
+    Point points[CAPACITY];
+    int count;
+
+    portENTER_CRITICAL(&_lock);
+    count = _count;
+    for (int i = 0; i < count; i++) {
+        points[i] = _points[(_head + i) % CAPACITY];
+    }
+    portEXIT_CRITICAL(&_lock);
+
+    if (count == 0) {
+        return false;
+    }
+
+    const Point& newest = points[count - 1];
+    long sinceNewest = (long)(nowMs - newest.timeMs);
+    if (sinceNewest > (long)STREAM_TIMEOUT) {
+        return false;
+    }
+
+    // Before the first point, hold it
+    if ((long)(nowMs - points[0].timeMs) <= 0) {
+        az = points[0].az;
+        el = points[0].el;
+        return true;
+    }
+
+    // Inside the queued points, interpolate along the segment that spans now
+    for (int i = 0; i < count - 1; i++) {
+        const Point& a = points[i];
+        const Point& b = points[i + 1];
+        if ((long)(nowMs - b.timeMs) < 0) {
+            unsigned long span = b.timeMs - a.timeMs;
+            float fraction = (span > MAX_SEGMENT) ? 0.0f : (float)(nowMs - a.timeMs) / span;
+            az = normalizeAzimuth(a.az + azimuthDelta(a.az, b.az) * fraction);
+            el = a.el + (b.el - a.el) * fraction;
+            return true;
+        }
+    }
+
+    // Past the newest point, carry on at the last segment's velocity for a while
+    az = newest.az;
+    el = newest.el;
+    if (count >= 2) {
+        const Point& previous = points[count - 2];
+        unsigned long span = newest.timeMs - previous.timeMs;
+        if (span <= MAX_SEGMENT) {
+            float ahead = (float)min((unsigned long)sinceNewest, MAX_EXTRAPOLATION) / span;
+            az = normalizeAzimuth(newest.az + azimuthDelta(previous.az, newest.az) * ahead);
+            el = constrain(newest.el + (newest.el - previous.el) * ahead, 0.0f, 90.0f);
+        }
+    }
+    return true;
+}
+
+bool SetpointStream::isActive(unsigned long nowMs) {
+    portENTER_CRITICAL(&_lock);
+    bool active = _count > 0 &&
+                  (long)(nowMs - _points[(_head + _count - 1) % CAPACITY].timeMs) <= (long)STREAM_TIMEOUT;
+    portEXIT_CRITICAL(&_lock);
+    return active;
+}
+
+// =============================================================================
+// HELPER METHODS
+// =============================================================================
+
+float SetpointStream::azimuthDelta(float from, float to) {
+    // Shortest signed path, so a pass through north does not swing the long way round
+    float delta = fmodf(to - from, 360.0f);
+    if (delta > 180.0f) {
+        delta -= 360.0f;
+    } else if (delta < -180.0f) {
+        delta += 360.0f;
+    }
+    return delta;
+}
+
+float SetpointStream::normalizeAzimuth(float az) {
+    az = fmodf(az, 360.0f);
+    if (az < 0) {
+        az += 360.0f;
+    }
+    return az;
+}
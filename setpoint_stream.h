@@ -0,0 +1,71 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * Setpoint Stream - Time-tagged tracking setpoints with interpolation.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SETPOINT_STREAM_H
+#define SETPOINT_STREAM_H
+
+// System includes
+#include <Arduino.h>
+
+// Holds the most recent time-tagged pointing setpoints from a tracking client and
+// turns them into a continuous reference. Between points the reference is linearly
+// interpolated; past the newest point it keeps moving at the last segment's velocity
+// for a bounded time, then holds. Points are pushed from the network tasks and
+// sampled by the control task.
+class SetpointStream {
+public:
+    // Constructor
+    SetpointStream();
+
+    // Stream input
+    void push(float az, float el, unsigned long timeMs);
+    void clear();
+
+    // Reference output; returns false when there is no live stream
+    bool sample(unsigned long nowMs, float& az, float& el);
+
+    // State access
+    bool isActive(unsigned long nowMs);
+    unsigned long getPointCount() const { return _pointCount; }
+
+private:
+    struct Point {
+        float az;
+        float el;
+        unsigned long timeMs;
+    };
+
+    // Stream limits
+    static constexpr int CAPACITY = 8;
+    static constexpr unsigned long STREAM_TIMEOUT = 5000;      // No new point for this long ends the stream
+    static constexpr unsigned long MAX_EXTRAPOLATION = 2000;   // Hold position after running this far past the last point
+    static constexpr unsigned long MAX_SEGMENT = 10000;        // Wider gaps are treated as a jump, not a velocity
+
+    // Ring of points ordered by time, oldest at _head
+    Point _points[CAPACITY];
+    int _head = 0;
+    int _count = 0;
+    unsigned long _pointCount = 0;
+    portMUX_TYPE _lock = portMUX_INITIALIZER_UNLOCKED;
+
+    // Helper methods
+    static float azimuthDelta(float from, float to);
+    static float normalizeAzimuth(float az);
+};
+
+#endif // SETPOINT_STREAM_H
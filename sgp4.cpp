@@ -0,0 +1,402 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * SGP4 - Near-earth orbit propagator for two-line element sets.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sgp4.h"
+
+// =============================================================================
+// CONSTRUCTOR AND ELEMENT LOADING
+// =============================================================================
+
+Sgp4::Sgp4() {
+}
+
+Sgp4::Result Sgp4::loadTle(const char* line1, const char* line2) {
+    _loaded = false;
+
+    if (strlen(line1) < 69 || strlen(line2) < 69 || line1[0] != '1' || line2[0] != '2') {
+        return ERROR_FORMAT;
+    }
+    if (!checksumValid(line1) || !checksumValid(line2)) {
+        return ERROR_CHECKSUM;
+    }
+
+    _catalogNumber = (int)parseField(line1, 2, 5);
+
+    // Epoch: two digit year and fractional day of year
+    int year = (int)parseField(line1, 18, 2);
+    year += (year < 57) ? 2000 : 1900;
+    double epochDay = parseField(line1, 20, 12);
+    long days = 0;
+    for (int y = 1970; y < year; y++) {
+        days += ((y % 4 == 0 && y % 100 != 0) || y % 400 == 0) ? 366 : 365;
+    }
+    _epochUnix = (days + epochDay - 1.0) * 86400.0;
+
+    _bstar = parseExponentField(line1, 53);
+
+    const double deg2rad = PI / 180.0;
+    _inclo = parseField(line2, 8, 8) * deg2rad;
+    _nodeo = parseField(line2, 17, 8) * deg2rad;
+    _ecco = parseField(line2, 26, 7) * 1.0e-7;
+    _argpo = parseField(line2, 34, 8) * deg2rad;
+    _mo = parseField(line2, 43, 8) * deg2rad;
+    double noKozai = parseField(line2, 52, 11) * 2 * PI / 1440.0;
+
+    if (noKozai <= 0) {
+        return ERROR_MEAN_MOTION;
+    }
+    if (_ecco >= 1.0) {
+        return ERROR_ECCENTRICITY;
+    }
+
+    initialise(noKozai);
+
+    if (2 * PI / _no >= DEEP_SPACE_PERIOD) {
+        return ERROR_DEEP_SPACE;
+    }
+
+    _loaded = true;
+    return OK;
+}
+
+// =============================================================================
+// PROPAGATION
+// =============================================================================
+
+Sgp4::Result Sgp4::propagate(double tsince, double position[3], double velocity[3]) const {
+    const double twoPi = 2 * PI;
+    const double x2o3 = 2.0 / 3.0;
+
+    // Secular gravity and atmospheric drag
+    double xmdf = _mo + _mdot * tsince;
+    double argpdf = _argpo + _argpdot * tsince;
+    double nodedf = _nodeo + _nodedot * tsince;
+    double argpm = argpdf;
+    double mm = xmdf;
+    double t2 = tsince * tsince;
+    double nodem = nodedf + _nodecf * t2;
+    double tempa = 1.0 - _cc1 * tsince;
+    double tempe = _bstar * _cc4 * tsince;
+    double templ = _t2cof * t2;
+
+    if (!_isimp) {
+        double delomg = _omgcof * tsince;
+        double delmtemp = 1.0 + _eta * cos(xmdf);
+        double delm = _xmcof * (delmtemp * delmtemp * delmtemp - _delmo);
+        double temp = delomg + delm;
+        mm = xmdf + temp;
+        argpm = argpdf - temp;
+        double t3 = t2 * tsince;
+        double t4 = t3 * tsince;
+        tempa = tempa - _d2 * t2 - _d3 * t3 - _d4 * t4;
+        tempe = tempe + _bstar * _cc5 * (sin(mm) - _sinmao);
+        templ = templ + _t3cof * t3 + t4 * (_t4cof + tsince * _t5cof);
+    }
+
+    double am = pow(XKE / _no, x2o3) * tempa * tempa;
+    double nm = XKE / pow(am, 1.5);
+    double em = _ecco - tempe;
+    if (em >= 1.0 || em < -0.001) {
+        return ERROR_ECCENTRICITY;
+    }
+    if (em < 1.0e-6) {
+        em = 1.0e-6;
+    }
+
+    mm = mm + _no * templ;
+    double xlm = mm + argpm + nodem;
+    nodem = fmod(nodem, twoPi);
+    argpm = fmod(argpm, twoPi);
+    xlm = fmod(xlm, twoPi);
+    mm = fmod(xlm - argpm - nodem, twoPi);
+
+    // Long period periodics
+    double axnl = em * cos(argpm);
+    double temp = 1.0 / (am * (1.0 - em * em));
+    double aynl = em * sin(argpm) + temp * _aycof;
+    double xl = mm + argpm + nodem + temp * _xlcof * axnl;
+
+    // Solve Kepler's equation
+    double u = fmod(xl - nodem, twoPi);
+    double eo1 = u;
+    double tem5 = 9999.9;
+    double sineo1 = 0;
+    double coseo1 = 0;
+    for (int ktr = 1; fabs(tem5) >= 1.0e-12 && ktr <= 10; ktr++) {
+        sineo1 = sin(eo1);
+        coseo1 = cos(eo1);
+        tem5 = 1.0 - coseo1 * axnl - sineo1 * aynl;
+        tem5 = (u - aynl * coseo1 + axnl * sineo1 - eo1) / tem5;
+        if (fabs(tem5) >= 0.95) {
+            tem5 = (tem5 > 0.0) ? 0.95 : -0.95;
+        }
+        eo1 = eo1 + tem5;
+    }
+
+    // Short period preliminary quantities
+    double ecose = axnl * coseo1 + aynl * sineo1;
+    double esine = axnl * sineo1 - aynl * coseo1;
+    double el2 = axnl * axnl + aynl * aynl;
+    double pl = am * (1.0 - el2);
+    if (pl < 0.0) {
+        return ERROR_SEMI_LATUS_RECTUM;
+    }
+
+    double rl = am * (1.0 - ecose);
+    double betal = sqrt(1.0 - el2);
+    temp = esine / (1.0 + betal);
+    double sinu = am / rl * (sineo1 - aynl - axnl * temp);
+    double cosu = am / rl * (coseo1 - axnl + aynl * temp);
+    double su = atan2(sinu, cosu);
+    double sin2u = (cosu + cosu) * sinu;
+    double cos2u = 1.0 - 2.0 * sinu * sinu;
+    temp = 1.0 / pl;
+    double temp1 = 0.5 * J2 * temp;
+    double temp2 = temp1 * temp;
+
+    // Update for short period periodics
+    double cosip = cos(_inclo);
+    double sinip = sin(_inclo);
+    double mrt = rl * (1.0 - 1.5 * temp2 * betal * _con41) + 0.5 * temp1 * _x1mth2 * cos2u;
+    su = su - 0.25 * temp2 * _x7thm1 * sin2u;
+    double xnode = nodem + 1.5 * temp2 * cosip * sin2u;
+    double xinc = _inclo + 1.5 * temp2 * cosip * sinip * cos2u;
+    // Radial and transverse rates, in earth radii per XKE minute
+    double mvt = sqrt(am) * esine / rl - nm * temp1 * _x1mth2 * sin2u / XKE;
+    double rvdot = sqrt(pl) / rl + nm * temp1 * (_x1mth2 * cos2u + 1.5 * _con41) / XKE;
+
+    if (mrt < 1.0) {
+        return ERROR_DECAYED;
+    }
+
+    // Orientation vectors
+    double sinsu = sin(su);
+    double cossu = cos(su);
+    double snod = sin(xnode);
+    double cnod = cos(xnode);
+    double sini = sin(xinc);
+    double cosi = cos(xinc);
+    double xmx = -snod * cosi;
+    double xmy = cnod * cosi;
+
+    position[0] = mrt * (xmx * sinsu + cnod * cossu) * RADIUS_EARTH;
+    position[1] = mrt * (xmy * sinsu + snod * cossu) * RADIUS_EARTH;
+    position[2] = mrt * (sini * sinsu) * RADIUS_EARTH;
+
+    if (velocity != nullptr) {
+        const double kmPerSecond = RADIUS_EARTH * XKE / 60.0;
+        velocity[0] = (mvt * (xmx * sinsu + cnod * cossu) + rvdot * (xmx * cossu - cnod * sinsu)) * kmPerSecond;
+        velocity[1] = (mvt * (xmy * sinsu + snod * cossu) + rvdot * (xmy * cossu - snod * sinsu)) * kmPerSecond;
+        velocity[2] = (mvt * (sini * sinsu) + rvdot * (sini * cossu)) * kmPerSecond;
+    }
+    return OK;
+}
+
+// =============================================================================
+// TIME AND FRAME HELPERS
+// =============================================================================
+
+double Sgp4::gmst(double unixTime) {
+    // IAU-82 Greenwich mean sidereal time, in radians; centuries counted from J2000
+    double tut1 = (unixTime / 86400.0 - 10957.5) / 36525.0;
+    double temp = -6.2e-6 * tut1 * tut1 * tut1 + 0.093104 * tut1 * tut1 +
+                  (876600.0 * 3600.0 + 8640184.812866) * tut1 + 67310.54841;
+    temp = fmod(temp * (PI / 180.0) / 240.0, 2 * PI);
+    if (temp < 0.0) {
+        temp += 2 * PI;
+    }
+    return temp;
+}
+
+void Sgp4::lookAngles(const double teme[3], double unixTime, double latitude, double longitude,
+                      double& azimuth, double& elevation, double& range) {
+    // TEME to earth-fixed, ignoring polar motion
+    double theta = gmst(unixTime);
+    double cosTheta = cos(theta);
+    double sinTheta = sin(theta);
+    double sat[3] = {
+        cosTheta * teme[0] + sinTheta * teme[1],
+        -sinTheta * teme[0] + cosTheta * teme[1],
+        teme[2]
+    };
+
+    // Station on the WGS-84 ellipsoid at sea level
+    const double a = 6378.137;
+    const double f = 1.0 / 298.257223563;
+    const double e2 = f * (2.0 - f);
+    double lat = latitude * PI / 180.0;
+    double lon = longitude * PI / 180.0;
+    double sinLat = sin(lat);
+    double cosLat = cos(lat);
+    double sinLon = sin(lon);
+    double cosLon = cos(lon);
+    double n = a / sqrt(1.0 - e2 * sinLat * sinLat);
+    double dx = sat[0] - n * cosLat * cosLon;
+    double dy = sat[1] - n * cosLat * sinLon;
+    double dz = sat[2] - n * (1.0 - e2) * sinLat;
+
+    // Rotate the line of sight into the local south-east-zenith frame
+    double south = sinLat * cosLon * dx + sinLat * sinLon * dy - cosLat * dz;
+    double east = -sinLon * dx + cosLon * dy;
+    double zenith = cosLat * cosLon * dx + cosLat * sinLon * dy + sinLat * dz;
+    range = sqrt(dx * dx + dy * dy + dz * dz);
+
+    azimuth = atan2(east, -south) * 180.0 / PI;
+    if (azimuth < 0) {
+        azimuth += 360.0;
+    }
+    elevation = asin(zenith / range) * 180.0 / PI;
+}
+
+// =============================================================================
+// HELPER METHODS
+// =============================================================================
+
+void Sgp4::initialise(double noKozai) {
+    const double x2o3 = 2.0 / 3.0;
+    const double ss = 78.0 / RADIUS_EARTH + 1.0;
+    const double qzms2t = pow((120.0 - 78.0) / RADIUS_EARTH, 4);
+
+    // Recover the original mean motion and semi-major axis from the Kozai mean motion
+    double eccsq = _ecco * _ecco;
+    double omeosq = 1.0 - eccsq;
+    double rteosq = sqrt(omeosq);
+    double cosio = cos(_inclo);
+    double cosio2 = cosio * cosio;
+    double ak = pow(XKE / noKozai, x2o3);
+    double d1 = 0.75 * J2 * (3.0 * cosio2 - 1.0) / (rteosq * omeosq);
+    double del = d1 / (ak * ak);
+    double adel = ak * (1.0 - del * del - del * (1.0 / 3.0 + 134.0 * del * del / 81.0));
+    del = d1 / (adel * adel);
+    _no = noKozai / (1.0 + del);
+
+    double ao = pow(XKE / _no, x2o3);
+    double sinio = sin(_inclo);
+    double po = ao * omeosq;
+    double con42 = 1.0 - 5.0 * cosio2;
+    _con41 = -con42 - cosio2 - cosio2;
+    double posq = po * po;
+    double rp = ao * (1.0 - _ecco);
+
+    // Very low perigees use a simplified drag model
+    _isimp = rp < (220.0 / RADIUS_EARTH + 1.0);
+
+    double sfour = ss;
+    double qzms24 = qzms2t;
+    double perige = (rp - 1.0) * RADIUS_EARTH;
+    if (perige < 156.0) {
+        sfour = perige - 78.0;
+        if (perige < 98.0) {
+            sfour = 20.0;
+        }
+        qzms24 = pow((120.0 - sfour) / RADIUS_EARTH, 4);
+        sfour = sfour / RADIUS_EARTH + 1.0;
+    }
+
+    double pinvsq = 1.0 / posq;
+    double tsi = 1.0 / (ao - sfour);
+    _eta = ao * _ecco * tsi;
+    double etasq = _eta * _eta;
+    double eeta = _ecco * _eta;
+    double psisq = fabs(1.0 - etasq);
+    double coef = qzms24 * pow(tsi, 4);
+    double coef1 = coef / pow(psisq, 3.5);
+    double cc2 = coef1 * _no * (ao * (1.0 + 1.5 * etasq + eeta * (4.0 + etasq)) +
+                 0.375 * J2 * tsi / psisq * _con41 * (8.0 + 3.0 * etasq * (8.0 + etasq)));
+    _cc1 = _bstar * cc2;
+    double cc3 = 0.0;
+    if (_ecco > 1.0e-4) {
+        cc3 = -2.0 * coef * tsi * J3OJ2 * _no * sinio / _ecco;
+    }
+    _x1mth2 = 1.0 - cosio2;
+    _cc4 = 2.0 * _no * coef1 * ao * omeosq *
+           (_eta * (2.0 + 0.5 * etasq) + _ecco * (0.5 + 2.0 * etasq) -
+            J2 * tsi / (ao * psisq) *
+            (-3.0 * _con41 * (1.0 - 2.0 * eeta + etasq * (1.5 - 0.5 * eeta)) +
+             0.75 * _x1mth2 * (2.0 * etasq - eeta * (1.0 + etasq)) * cos(2.0 * _argpo)));
+    _cc5 = 2.0 * coef1 * ao * omeosq * (1.0 + 2.75 * (etasq + eeta) + eeta * etasq);
+
+    // Secular rates
+    double cosio4 = cosio2 * cosio2;
+    double temp1 = 1.5 * J2 * pinvsq * _no;
+    double temp2 = 0.5 * temp1 * J2 * pinvsq;
+    double temp3 = -0.46875 * J4 * pinvsq * pinvsq * _no;
+    _mdot = _no + 0.5 * temp1 * rteosq * _con41 + 0.0625 * temp2 * rteosq * (13.0 - 78.0 * cosio2 + 137.0 * cosio4);
+    _argpdot = -0.5 * temp1 * con42 + 0.0625 * temp2 * (7.0 - 114.0 * cosio2 + 395.0 * cosio4) +
+               temp3 * (3.0 - 36.0 * cosio2 + 49.0 * cosio4);
+    double xhdot1 = -temp1 * cosio;
+    _nodedot = xhdot1 + (0.5 * temp2 * (4.0 - 19.0 * cosio2) + 2.0 * temp3 * (3.0 - 7.0 * cosio2)) * cosio;
+    _omgcof = _bstar * cc3 * cos(_argpo);
+    _xmcof = 0.0;
+    if (_ecco > 1.0e-4) {
+        _xmcof = -x2o3 * coef * _bstar / eeta;
+    }
+    _nodecf = 3.5 * omeosq * xhdot1 * _cc1;
+    _t2cof = 1.5 * _cc1;
+
+    // Avoid a divide by zero for inclinations of 180 degrees
+    double xlcofDenominator = (fabs(cosio + 1.0) > 1.5e-12) ? (1.0 + cosio) : 1.5e-12;
+    _xlcof = -0.25 * J3OJ2 * sinio * (3.0 + 5.0 * cosio) / xlcofDenominator;
+    _aycof = -0.5 * J3OJ2 * sinio;
+    double delmotemp = 1.0 + _eta * cos(_mo);
+    _delmo = delmotemp * delmotemp * delmotemp;
+    _sinmao = sin(_mo);
+    _x7thm1 = 7.0 * cosio2 - 1.0;
+
+    if (!_isimp) {
+        double cc1sq = _cc1 * _cc1;
+        _d2 = 4.0 * ao * tsi * cc1sq;
+        double temp = _d2 * tsi * _cc1 / 3.0;
+        _d3 = (17.0 * ao + sfour) * temp;
+        _d4 = 0.5 * temp * ao * tsi * (221.0 * ao + 31.0 * sfour) * _cc1;
+        _t3cof = _d2 + 2.0 * cc1sq;
+        _t4cof = 0.25 * (3.0 * _d3 + _cc1 * (12.0 * _d2 + 10.0 * cc1sq));
+        _t5cof = 0.2 * (3.0 * _d4 + 12.0 * _cc1 * _d3 + 6.0 * _d2 * _d2 + 15.0 * cc1sq * (2.0 * _d2 + cc1sq));
+    }
+}
+
+bool Sgp4::checksumValid(const char* line) {
+    // Modulo 10 sum of the digits, with minus signs counting as one
+    int sum = 0;
+    for (int i = 0; i < 68; i++) {
+        if (line[i] >= '0' && line[i] <= '9') {
+            sum += line[i] - '0';
+        } else if (line[i] == '-') {
+            sum += 1;
+        }
+    }
+    return (sum % 10) == (line[68] - '0');
+}
+
+double Sgp4::parseField(const char* line, int start, int length) {
+    char buffer[16];
+    length = min(length, (int)sizeof(buffer) - 1);
+    memcpy(buffer, line + start, length);
+    buffer[length] = '\0';
+    return atof(buffer);
+}
+
+double Sgp4::parseExponentField(const char* line, int start) {
+    // Assumed decimal point with a trailing power of ten: " 12345-3" is 0.12345e-3
+    double mantissa = parseField(line, start + 1, 5) * 1.0e-5;
+    if (line[start] == '-') {
+        mantissa = -mantissa;
+    }
+    int exponent = (int)parseField(line, start + 6, 2);
+    return mantissa * pow(10.0, exponent);
+}
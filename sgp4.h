@@ -0,0 +1,104 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * SGP4 - Near-earth orbit propagator for two-line element sets.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SGP4_H
+#define SGP4_H
+
+// System includes
+#include <Arduino.h>
+
+// SGP4 as published in Spacetrack Report #3 and revised by Vallado et al. (2006),
+// WGS-72 constants, near-earth branch only. Orbits with a period of 225 minutes or
+// more need the SDP4 deep-space terms and are rejected when the elements are loaded.
+class Sgp4 {
+public:
+    // Result codes, matching the reference implementation where they overlap
+    enum Result {
+        OK = 0,
+        ERROR_ECCENTRICITY = 1,
+        ERROR_MEAN_MOTION = 2,
+        ERROR_SEMI_LATUS_RECTUM = 4,
+        ERROR_DECAYED = 6,
+        ERROR_FORMAT = 10,
+        ERROR_CHECKSUM = 11,
+        ERROR_DEEP_SPACE = 12
+    };
+
+    // Constructor
+    Sgp4();
+
+    // Element loading; returns OK or the reason the lines were rejected
+    Result loadTle(const char* line1, const char* line2);
+    bool isLoaded() const { return _loaded; }
+
+    // Position (km) and, if wanted, velocity (km/s) in the TEME frame at the given minutes
+    // since the element epoch
+    Result propagate(double tsince, double position[3], double velocity[3] = nullptr) const;
+
+    // Element access
+    double getEpochUnix() const { return _epochUnix; }
+    int getCatalogNumber() const { return _catalogNumber; }
+    double getPeriodMinutes() const { return 2 * PI / _no; }
+
+    // Time and frame helpers
+    static double gmst(double unixTime);
+
+    // Azimuth and elevation (degrees) and range (km) of a TEME position from a sea-level
+    // station at the given geodetic latitude and longitude (degrees)
+    static void lookAngles(const double teme[3], double unixTime, double latitude, double longitude,
+                           double& azimuth, double& elevation, double& range);
+
+private:
+    // WGS-72 constants
+    static constexpr double RADIUS_EARTH = 6378.135;                 // km
+    static constexpr double XKE = 0.0743669161331734132;             // sqrt(GM) in earth radii^1.5 per minute
+    static constexpr double J2 = 0.001082616;
+    static constexpr double J3 = -0.00000253881;
+    static constexpr double J4 = -0.00000165597;
+    static constexpr double J3OJ2 = J3 / J2;
+    static constexpr double DEEP_SPACE_PERIOD = 225.0;               // Minutes
+
+    // Mean elements from the TLE
+    bool _loaded = false;
+    int _catalogNumber = 0;
+    double _epochUnix = 0;
+    double _bstar = 0;
+    double _ecco = 0;
+    double _inclo = 0;
+    double _nodeo = 0;
+    double _argpo = 0;
+    double _mo = 0;
+    double _no = 0;  // Un-Kozai'd mean motion, radians per minute
+
+    // Secular and drag coefficients from initialisation
+    bool _isimp = false;
+    double _aycof = 0, _con41 = 0, _cc1 = 0, _cc4 = 0, _cc5 = 0;
+    double _d2 = 0, _d3 = 0, _d4 = 0, _delmo = 0, _eta = 0;
+    double _argpdot = 0, _omgcof = 0, _sinmao = 0;
+    double _t2cof = 0, _t3cof = 0, _t4cof = 0, _t5cof = 0;
+    double _x1mth2 = 0, _x7thm1 = 0, _mdot = 0, _nodedot = 0;
+    double _xlcof = 0, _xmcof = 0, _nodecf = 0;
+
+    // Helper methods
+    void initialise(double noKozai);
+    static bool checksumValid(const char* line);
+    static double parseField(const char* line, int start, int length);
+    static double parseExponentField(const char* line, int start);
+};
+
+#endif // SGP4_H
@@ -29,7 +29,7 @@ StellariumPoller::StellariumPoller(Preferences& prefs, MotorSensorController& mo
 
 void StellariumPoller::begin() {
     // Initialize any required resources here
-    _logger.info("StellariumPoller initialized");
+    LOGI(_logger, "StellariumPoller initialized");
 }
 
 // =============================================================================
@@ -44,7 +44,7 @@ void StellariumPoller::runStellariumLoop(bool serialActive, String rotctl_client
     }
 
     if (!wifiConnected) {
-        _logger.error("WiFi Disconnected");
+        LOGE(_logger, "WiFi Disconnected");
         setStellariumConnActive(false);
         return;
     }
@@ -72,7 +72,7 @@ bool StellariumPoller::pollStellariumData() {
     String stellariumURL = "http://" + stellariumServerIP + ":" + stellariumServerPort + "/api/objects/info";
 
     if (!http.begin(stellariumURL)) {
-        _logger.error("HTTP begin failed for: " + stellariumURL);
+        LOGE(_logger, "HTTP begin failed for: " + stellariumURL);
         return false;
     }
 
@@ -86,7 +86,7 @@ bool StellariumPoller::pollStellariumData() {
         String payload = http.getString();
         success = processApiResponse(payload);
     } else {
-        _logger.error("HTTP request failed with code: " + String(httpResponseCode));
+        LOGE(_logger, "HTTP request failed with code: " + String(httpResponseCode));
     }
 
     http.end();
@@ -98,14 +98,14 @@ bool StellariumPoller::processApiResponse(const String& payload) {
     String azAltStr = getValue(payload, "Az./Alt.: ", " ");
     
     if (azAltStr == "") {
-        _logger.info("No Az./Alt. data found in Stellarium response");
+        LOGI(_logger, "No Az./Alt. data found in Stellarium response");
         return false;
     }
 
     // Parse azimuth and elevation values
     int separatorIndex = azAltStr.indexOf('/');
     if (separatorIndex == -1) {
-        _logger.error("Invalid Az./Alt. format: " + azAltStr);
+        LOGE(_logger, "Invalid Az./Alt. format: " + azAltStr);
         return false;
     }
 
@@ -124,11 +124,10 @@ bool StellariumPoller::processApiResponse(const String& payload) {
     if (el < 0) el = 0;
     if (el > 90) el = 90;
 
-    // Update motor controller setpoints
-    _motorSensorCtrl.setSetPointAz(az);
-    _motorSensorCtrl.setSetPointEl(el);
+    // Stream the target so the dish follows the sky between polls
+    _motorSensorCtrl.streamSetPoint(az, el, millis());
 
-    _logger.info("Stellarium target - Az: " + String(az, 2) + "°, El: " + String(el, 2) + "°");
+    LOGI(_logger, "Stellarium target - Az: " + String(az, 2) + "°, El: " + String(el, 2) + "°");
     
     return true;
 }
@@ -158,7 +157,7 @@ double StellariumPoller::parseDMS(String dms) {
 
     // Validate format
     if (degIndex == -1 || minIndex == -1 || secIndex == -1) {
-        _logger.warn("Invalid DMS format: " + dms);
+        LOGW(_logger, "Invalid DMS format: " + dms);
         return 0.0;
     }
 
@@ -196,5 +195,6 @@ bool StellariumPoller::getStellariumOn() {
 
 void StellariumPoller::setStellariumOn(bool on) {
     _stellariumOn = on;
-    _logger.info("Stellarium polling " + String(on ? "enabled" : "disabled"));
+    _settingsVersion++;
+    LOGI(_logger, "Stellarium polling " + String(on ? "enabled" : "disabled"));
 }
\ No newline at end of file
@@ -46,6 +46,9 @@ public:
     bool getStellariumOn();
     void setStellariumOn(bool on);
 
+    // Bumped whenever polling is switched on or off
+    uint32_t getSettingsVersion() const { return _settingsVersion; }
+
 private:
     // Dependencies
     Preferences& _preferences;
@@ -55,6 +58,7 @@ private:
     // State variables (thread-safe)
     std::atomic<bool> _stellariumOn = false;
     std::atomic<bool> _stellariumConnActive = false;
+    std::atomic<uint32_t> _settingsVersion = 0;
 
     // Core functionality helpers
     bool shouldPollStellarium(bool serialActive, String rotctl_client_ip);
@@ -0,0 +1,74 @@
+#!/usr/bin/env python3
+#
+# Firmware for the discovery-drive satellite dish rotator.
+# compress_assets.py - Write precompressed .gz copies of the web UI assets.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Run before building or uploading the LittleFS image. The web server serves
+# <file>.gz with Content-Encoding: gzip when it exists and the browser accepts
+# gzip. index.html is templated on the device and png is already compressed,
+# so only the script and stylesheet are handled.
+#
+# The gzip header comment carries the FNV-1a fingerprint of the plain file. The
+# firmware compares it with the plain file on LittleFS and ignores a .gz that was
+# built from a different version, so a forgotten run costs compression, never
+# correctness. The .gz files are build outputs and are not committed.
+
+import os
+import struct
+import sys
+import zlib
+
+ASSETS = ["script.js", "styles.css"]
+
+GZIP_FCOMMENT = 0x10
+
+
+def fnv1a(data):
+    # Matches WebServerManager::fingerprintFile()
+    value = 2166136261
+    for byte in data:
+        value = ((value ^ byte) * 16777619) & 0xFFFFFFFF
+    return value
+
+
+def gzip_with_comment(raw, comment):
+    # RFC 1952 member: header with FCOMMENT and a zero mtime, raw deflate, CRC-32, size.
+    # The zero mtime keeps the output byte-identical across runs, so the on-device ETag
+    # only changes when the source does.
+    header = struct.pack("<BBBBIBB", 0x1F, 0x8B, 8, GZIP_FCOMMENT, 0, 2, 255) + comment + b"\0"
+    compressor = zlib.compressobj(9, zlib.DEFLATED, -zlib.MAX_WBITS)
+    body = compressor.compress(raw) + compressor.flush()
+    trailer = struct.pack("<II", zlib.crc32(raw) & 0xFFFFFFFF, len(raw) & 0xFFFFFFFF)
+    return header + body + trailer
+
+
+def main():
+    data_dir = sys.argv[1] if len(sys.argv) > 1 else os.path.join(os.path.dirname(__file__), "..", "data")
+
+    for name in ASSETS:
+        path = os.path.join(data_dir, name)
+        with open(path, "rb") as f:
+            raw = f.read()
+
+        packed = gzip_with_comment(raw, b"fnv1a=%08x" % fnv1a(raw))
+        with open(path + ".gz", "wb") as f:
+            f.write(packed)
+
+        print("%-12s %7d -> %6d bytes (%.0f%%)" % (name, len(raw), len(packed), 100.0 * len(packed) / len(raw)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+#
+# Firmware for the discovery-drive satellite dish rotator.
+# decode_log.py - Print the binary log downloaded from /downloadLog as text.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Record layout (see log_file.h), little-endian: magic 0xA5, level, task length,
+# message length, uint32 millis since boot, task bytes, message bytes. Level 0
+# records mark a boot. A damaged record (power lost mid-write) is skipped by
+# scanning forward to the next magic byte.
+
+import struct
+import sys
+
+MAGIC = 0xA5
+HEADER = struct.Struct("<BBBBI")
+LEVELS = {1: "ERROR", 2: "WARN", 3: "INFO", 4: "DEBUG", 5: "VERB"}
+
+
+def decode(data):
+    offset = 0
+    skipped = 0
+    while offset + HEADER.size <= len(data):
+        magic, level, task_len, msg_len, timestamp = HEADER.unpack_from(data, offset)
+        end = offset + HEADER.size + task_len + msg_len
+        if magic != MAGIC or level > 5 or end > len(data):
+            offset += 1
+            skipped += 1
+            continue
+
+        if skipped:
+            print("-- skipped %d damaged bytes --" % skipped)
+            skipped = 0
+
+        body = offset + HEADER.size
+        task = data[body:body + task_len].decode("utf-8", "replace")
+        message = data[body + task_len:end].decode("utf-8", "replace")
+        offset = end
+
+        if level == 0:
+            print("===== %s =====" % message)
+            continue
+
+        seconds = timestamp / 1000.0
+        print("[%10.3f] %-5s %-12s %s" % (seconds, LEVELS[level], task, message))
+
+    if skipped or offset < len(data):
+        print("-- skipped %d damaged bytes --" % (skipped + len(data) - offset))
+
+
+def main():
+    if len(sys.argv) != 2:
+        print("usage: decode_log.py <discovery_drive_log.bin>")
+        sys.exit(1)
+
+    with open(sys.argv[1], "rb") as f:
+        decode(f.read())
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,265 @@
+#!/usr/bin/env python3
+#
+# Firmware for the discovery-drive satellite dish rotator.
+# http_load.py - Measure web UI request latency with several clients connected.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Reproduces what open UI tabs ask of the web server, for --seconds:
+# - --streams clients hold /events open, as each tab does
+# - --pollers clients fetch /telemetry?logs=1 back to back, the UI's fallback when it
+#   has no event stream, and revalidate /config with If-None-Match between polls
+# - --controllers clients post /update_variable with the current setpoints, as the Go
+#   button does; the setpoints are read from /telemetry first so the dish holds still
+# - with --upload-kbps, one client trickles a multipart upload to /fileupdate at that
+#   rate for the whole run. The file is named http_load.bin, a type the device refuses,
+#   so nothing is written to flash, but the body is still received in full.
+#
+# Each client keeps one connection open and reuses it (HTTP keep-alive), reconnecting
+# only when the server closes it. Prints requests per second and p50/p99/max latency
+# per route, and how many connections each route needed.
+#
+#   python3 tools/http_load.py 192.168.1.50
+#   python3 tools/http_load.py 192.168.1.50 --streams 2 --pollers 2 --controllers 1 --upload-kbps 20
+
+import argparse
+import base64
+import http.client
+import json
+import threading
+import time
+import urllib.parse
+
+
+class LoadClient(threading.Thread):
+    def __init__(self, args, headers, method, path, body, deadline, revalidate_config=False):
+        super().__init__(daemon=True)
+        self.args = args
+        self.headers = headers
+        self.method = method
+        self.path = path
+        self.body = body
+        self.deadline = deadline
+        self.revalidate_config = revalidate_config
+        self.config_etag = None
+        self.latencies = []
+        self.config_latencies = []
+        self.failures = 0
+        self.connections = 0
+        self.error = None
+        self.connection = None
+
+    def request(self, method, path, body, headers):
+        if self.connection is None:
+            self.connection = http.client.HTTPConnection(self.args.host, self.args.port, timeout=10)
+            self.connections += 1
+        start = time.perf_counter()
+        try:
+            self.connection.request(method, path, body=body, headers=headers)
+            response = self.connection.getresponse()
+            response.read()
+        except (OSError, http.client.HTTPException) as e:
+            self.connection.close()
+            self.connection = None
+            self.failures += 1
+            self.error = e
+            return None, 0
+        if response.will_close:
+            self.connection.close()
+            self.connection = None
+        return response, time.perf_counter() - start
+
+    def run(self):
+        while time.monotonic() < self.deadline:
+            response, latency = self.request(self.method, self.path, self.body, self.headers)
+            if response is None:
+                continue
+            if response.status >= 400:
+                self.failures += 1
+                continue
+            self.latencies.append(latency)
+
+            if self.revalidate_config:
+                headers = dict(self.headers)
+                if self.config_etag:
+                    headers["If-None-Match"] = self.config_etag
+                response, latency = self.request("GET", "/config", None, headers)
+                if response is not None and response.status in (200, 304):
+                    self.config_etag = response.getheader("ETag", self.config_etag)
+                    self.config_latencies.append(latency)
+        if self.connection is not None:
+            self.connection.close()
+
+
+class StreamClient(threading.Thread):
+    def __init__(self, args, headers, deadline):
+        super().__init__(daemon=True)
+        self.args = args
+        self.headers = headers
+        self.deadline = deadline
+        self.events = 0
+        self.connections = 0
+        self.error = None
+
+    def run(self):
+        while time.monotonic() < self.deadline:
+            connection = http.client.HTTPConnection(self.args.host, self.args.port, timeout=20)
+            self.connections += 1
+            try:
+                connection.request("GET", "/events", headers=self.headers)
+                response = connection.getresponse()
+                if response.status != 200:
+                    self.error = "HTTP %d" % response.status
+                    response.read()
+                    time.sleep(3)
+                    continue
+                while time.monotonic() < self.deadline:
+                    line = response.fp.readline()
+                    if not line:
+                        break
+                    if line.startswith(b"data:"):
+                        self.events += 1
+            except (OSError, http.client.HTTPException) as e:
+                self.error = e
+            finally:
+                connection.close()
+
+
+class SlowUpload(threading.Thread):
+    BOUNDARY = "httpload7d1f3a"
+
+    def __init__(self, args, headers, deadline):
+        super().__init__(daemon=True)
+        self.args = args
+        self.headers = headers
+        self.deadline = deadline
+        self.sent = 0
+        self.status = None
+        self.error = None
+
+    def run(self):
+        head = ("--%s\r\nContent-Disposition: form-data; name=\"file\"; filename=\"http_load.bin\"\r\n"
+                "Content-Type: application/octet-stream\r\n\r\n" % self.BOUNDARY).encode()
+        tail = ("\r\n--%s--\r\n" % self.BOUNDARY).encode()
+        rate = self.args.upload_kbps * 1024
+        size = int(rate * max(1.0, self.deadline - time.monotonic()))
+        chunk = b"\0" * max(1, int(rate / 10))
+        try:
+            connection = http.client.HTTPConnection(self.args.host, self.args.port, timeout=30)
+            connection.putrequest("POST", "/fileupdate")
+            for name, value in self.headers.items():
+                connection.putheader(name, value)
+            connection.putheader("Content-Type", "multipart/form-data; boundary=" + self.BOUNDARY)
+            connection.putheader("Content-Length", str(len(head) + size + len(tail)))
+            connection.endheaders()
+            connection.send(head)
+            remaining = size
+            while remaining > 0:
+                piece = chunk[:remaining]
+                connection.send(piece)
+                remaining -= len(piece)
+                self.sent += len(piece)
+                time.sleep(0.1)
+            connection.send(tail)
+            response = connection.getresponse()
+            response.read()
+            self.status = response.status
+            connection.close()
+        except (OSError, http.client.HTTPException) as e:
+            self.error = e
+
+
+def percentile(values, fraction):
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(fraction * len(ordered)))]
+
+
+def print_route(name, latencies, failures, connections, seconds, error):
+    if not latencies:
+        print("%-24s  no replies (%d failed, last error: %s)" % (name, failures, error))
+        return
+    print("%-24s %6d %7.1f %7.1f %7.1f %7.1f %7d %6s" % (
+        name, len(latencies), len(latencies) / seconds,
+        1000 * percentile(latencies, 0.5),
+        1000 * percentile(latencies, 0.99),
+        1000 * max(latencies), failures, connections))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="web UI latency under load")
+    parser.add_argument("host")
+    parser.add_argument("--port", type=int, default=80)
+    parser.add_argument("--streams", type=int, default=1)
+    parser.add_argument("--pollers", type=int, default=1)
+    parser.add_argument("--controllers", type=int, default=1)
+    parser.add_argument("--upload-kbps", type=float, default=0.0)
+    parser.add_argument("--seconds", type=float, default=10.0)
+    parser.add_argument("--user", default="")
+    parser.add_argument("--password", default="")
+    args = parser.parse_args()
+
+    headers = {}
+    if args.user:
+        token = base64.b64encode(("%s:%s" % (args.user, args.password)).encode()).decode()
+        headers["Authorization"] = "Basic " + token
+
+    connection = http.client.HTTPConnection(args.host, args.port, timeout=10)
+    connection.request("GET", "/telemetry", headers=headers)
+    telemetry = json.loads(connection.getresponse().read())
+    connection.close()
+    hold = urllib.parse.urlencode({
+        "new_setpoint_az": "%.2f" % telemetry["setpoint_az"],
+        "new_setpoint_el": "%.2f" % telemetry["setpoint_el"],
+    })
+    post_headers = dict(headers, **{"Content-Type": "application/x-www-form-urlencoded"})
+
+    deadline = time.monotonic() + args.seconds
+    streams = [StreamClient(args, headers, deadline) for _ in range(args.streams)]
+    pollers = [LoadClient(args, headers, "GET", "/telemetry?logs=1", None, deadline, revalidate_config=True)
+               for _ in range(args.pollers)]
+    controllers = [LoadClient(args, post_headers, "POST", "/update_variable", hold, deadline)
+                   for _ in range(args.controllers)]
+    upload = SlowUpload(args, headers, deadline) if args.upload_kbps > 0 else None
+    threads = streams + pollers + controllers + ([upload] if upload else [])
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join(args.seconds + 60)
+
+    print("%d streams, %d pollers, %d controllers%s for %.0f s against %s:%d" % (
+        args.streams, args.pollers, args.controllers,
+        ", upload at %.0f KiB/s" % args.upload_kbps if upload else "",
+        args.seconds, args.host, args.port))
+    print("route                      reqs   req/s  p50 ms  p99 ms  max ms  failed  conns")
+    if pollers:
+        print_route("GET /telemetry?logs=1", [t for c in pollers for t in c.latencies],
+                    sum(c.failures for c in pollers), sum(c.connections for c in pollers),
+                    args.seconds, pollers[0].error)
+        print_route("GET /config", [t for c in pollers for t in c.config_latencies],
+                    0, "shared", args.seconds, pollers[0].error)
+    if controllers:
+        print_route("POST /update_variable", [t for c in controllers for t in c.latencies],
+                    sum(c.failures for c in controllers), sum(c.connections for c in controllers),
+                    args.seconds, controllers[0].error)
+    for i, stream in enumerate(streams):
+        print("GET /events #%d: %d events over %d connection(s)%s" % (
+            i, stream.events, stream.connections,
+            ", last error: %s" % stream.error if stream.error else ""))
+    if upload:
+        print("POST /fileupdate: %d bytes sent, status %s%s" % (
+            upload.sent, upload.status, ", error: %s" % upload.error if upload.error else ""))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+#
+# Firmware for the discovery-drive satellite dish rotator.
+# rotctl_load.py - Measure rotctl command throughput with several clients connected.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Opens --clients connections to the rotator. Each one sends a command, waits for
+# the reply and repeats for --seconds. The first client acts as the controller and
+# sends "P <az> <el>" holding the current position. The others poll "p" like a
+# monitoring tool. Prints commands per second and reply latency for every client.
+# With --pipeline N each client writes N commands at once before reading the N
+# replies (latency is then per batch), which measures the parser rather than the
+# network round trip.
+#
+#   python3 tools/rotctl_load.py 192.168.1.50 --clients 4 --seconds 20
+#   python3 tools/rotctl_load.py 192.168.1.50 --clients 1 --pipeline 16
+
+import argparse
+import socket
+import threading
+import time
+
+
+class LoadClient(threading.Thread):
+    def __init__(self, host, port, controller, deadline, pipeline):
+        super().__init__(daemon=True)
+        self.host = host
+        self.port = port
+        self.controller = controller
+        self.deadline = deadline
+        self.pipeline = pipeline
+        self.commands = 0
+        self.latencies = []
+        self.rejected = 0
+        self.error = None
+
+    def run(self):
+        try:
+            with socket.create_connection((self.host, self.port), timeout=5) as sock:
+                sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+                reader = sock.makefile("rb")
+
+                sock.sendall(b"p\n")
+                az = float(reader.readline())
+                el = float(reader.readline())
+
+                if self.controller:
+                    command = b"P %.2f %.2f\n" % (az, el)
+                else:
+                    command = b"p\n"
+
+                while time.monotonic() < self.deadline:
+                    start = time.perf_counter()
+                    sock.sendall(command * self.pipeline)
+                    for _ in range(self.pipeline):
+                        first = reader.readline()
+                        if self.controller:
+                            if first.strip() != b"RPRT 0":
+                                self.rejected += 1
+                        elif first.startswith(b"RPRT"):
+                            self.rejected += 1
+                        else:
+                            reader.readline()
+                    self.commands += self.pipeline
+                    self.latencies.append(time.perf_counter() - start)
+        except (OSError, ValueError) as e:
+            self.error = e
+
+
+def percentile(values, fraction):
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(fraction * len(ordered)))]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="rotctl throughput test")
+    parser.add_argument("host")
+    parser.add_argument("--port", type=int, default=4533)
+    parser.add_argument("--clients", type=int, default=4)
+    parser.add_argument("--seconds", type=float, default=10.0)
+    parser.add_argument("--pipeline", type=int, default=1, help="commands per write")
+    args = parser.parse_args()
+
+    deadline = time.monotonic() + args.seconds
+    clients = [LoadClient(args.host, args.port, i == 0, deadline, args.pipeline) for i in range(args.clients)]
+    for client in clients:
+        client.start()
+    for client in clients:
+        client.join()
+
+    total = 0
+    print("client  role        cmds   cmd/s  p50 ms  p99 ms  max ms  rejected")
+    for i, client in enumerate(clients):
+        role = "controller" if client.controller else "poller"
+        if client.error is not None:
+            print("%6d  %-10s  failed: %s" % (i, role, client.error))
+            continue
+        count = client.commands
+        total += count
+        if count == 0:
+            print("%6d  %-10s  no replies" % (i, role))
+            continue
+        print("%6d  %-10s %5d %7.1f %7.2f %7.2f %7.2f %9d" % (
+            i, role, count, count / args.seconds,
+            1000 * percentile(client.latencies, 0.5),
+            1000 * percentile(client.latencies, 0.99),
+            1000 * max(client.latencies),
+            client.rejected))
+    print("total %d commands, %.1f cmd/s" % (total, total / args.seconds))
+
+
+if __name__ == "__main__":
+    main()
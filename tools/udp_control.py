@@ -0,0 +1,227 @@
+#!/usr/bin/env python3
+#
+# Firmware for the discovery-drive satellite dish rotator.
+# udp_control.py - Reference client and benchmark for the binary UDP control protocol.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Packet layout is defined in udp_control.h; everything is little-endian.
+#
+#   python3 tools/udp_control.py poll 192.168.1.50
+#   python3 tools/udp_control.py sweep 192.168.1.50 --rate 50 --seconds 30
+#   python3 tools/udp_control.py bench 192.168.1.50 --rate 100 --seconds 10
+#   python3 tools/udp_control.py bench --loopback --rate 0
+#
+# "sweep" streams a slow azimuth sweep around the current position with a
+# short look-ahead batch in every packet. "bench" sends polls at --rate (0 =
+# as fast as replies come back) and reports throughput, round-trip time and
+# loss. --loopback runs the benchmark against an in-process emulator of the
+# device instead of real hardware, to measure the client and protocol overhead.
+
+import argparse
+import collections
+import math
+import socket
+import struct
+import threading
+import time
+
+MAGIC = 0x4444
+VERSION = 1
+PACKET_SETPOINTS = 0x01
+PACKET_POLL = 0x02
+PACKET_TELEMETRY = 0x81
+
+HEADER = struct.Struct("<HBBII")
+BATCH = struct.Struct("<B3x")
+SETPOINT = struct.Struct("<iff")
+TELEMETRY = struct.Struct("<I7fBBBB")
+MAX_SETPOINTS = 8
+
+STATUS_FLAGS = [(0x01, "controller"), (0x02, "rejected"), (0x04, "stale"), (0x08, "streaming"),
+                (0x10, "az_latched"), (0x20, "el_latched"), (0x40, "fault")]
+
+Telemetry = collections.namedtuple("Telemetry", [
+    "sequence", "rtt_ms", "device_ms", "az", "el", "velocity_az", "velocity_el",
+    "setpoint_az", "setpoint_el", "power_w", "pwm_az", "pwm_el", "status", "accepted"])
+
+
+def status_text(status):
+    return ",".join(name for bit, name in STATUS_FLAGS if status & bit) or "-"
+
+
+class UdpControlClient:
+    def __init__(self, host, port, timeout=0.5):
+        self.address = (host, port)
+        self.sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self.sock.settimeout(timeout)
+        self.sequence = 0
+        self.start = time.perf_counter()
+
+    def _now_us(self):
+        return int((time.perf_counter() - self.start) * 1e6) & 0xFFFFFFFF
+
+    def _send(self, packet_type, body=b""):
+        self.sequence = (self.sequence + 1) & 0xFFFFFFFF
+        header = HEADER.pack(MAGIC, VERSION, packet_type, self.sequence, self._now_us())
+        self.sock.sendto(header + body, self.address)
+        return self.sequence
+
+    def send_poll(self):
+        return self._send(PACKET_POLL)
+
+    def send_setpoints(self, points):
+        """points: up to 8 (offset_ms, az, el) tuples, offsets relative to arrival."""
+        body = BATCH.pack(len(points)) + b"".join(SETPOINT.pack(int(t), az, el) for t, az, el in points)
+        return self._send(PACKET_SETPOINTS, body)
+
+    def receive(self):
+        """Next telemetry frame, or None on timeout or a packet that is not telemetry."""
+        try:
+            data = self.sock.recv(256)
+        except socket.timeout:
+            return None
+        if len(data) < HEADER.size + TELEMETRY.size:
+            return None
+        magic, version, packet_type, sequence, sent_us = HEADER.unpack_from(data)
+        if magic != MAGIC or version != VERSION or packet_type != PACKET_TELEMETRY:
+            return None
+        rtt_ms = ((self._now_us() - sent_us) & 0xFFFFFFFF) / 1000.0
+        return Telemetry(sequence, rtt_ms, *TELEMETRY.unpack_from(data, HEADER.size))
+
+    def poll(self):
+        sequence = self.send_poll()
+        while True:
+            frame = self.receive()
+            if frame is None or frame.sequence == sequence:
+                return frame
+
+
+class LoopbackDevice(threading.Thread):
+    """Answers the protocol like the firmware, holding a fixed position."""
+
+    def __init__(self):
+        super().__init__(daemon=True)
+        self.sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self.sock.bind(("127.0.0.1", 0))
+        self.port = self.sock.getsockname()[1]
+        self.setpoint = (180.0, 45.0)
+
+    def run(self):
+        start = time.monotonic()
+        while True:
+            data, sender = self.sock.recvfrom(256)
+            if len(data) < HEADER.size:
+                continue
+            magic, version, packet_type, sequence, sent_us = HEADER.unpack_from(data)
+            accepted = 0
+            if packet_type == PACKET_SETPOINTS and len(data) >= HEADER.size + BATCH.size:
+                count = BATCH.unpack_from(data, HEADER.size)[0]
+                for i in range(min(count, MAX_SETPOINTS)):
+                    _, az, el = SETPOINT.unpack_from(data, HEADER.size + BATCH.size + i * SETPOINT.size)
+                    self.setpoint = (az % 360.0, min(max(el, 0.0), 90.0))
+                    accepted += 1
+            device_ms = int((time.monotonic() - start) * 1000) & 0xFFFFFFFF
+            reply = HEADER.pack(MAGIC, VERSION, PACKET_TELEMETRY, sequence, sent_us) + TELEMETRY.pack(
+                device_ms, self.setpoint[0], self.setpoint[1], 0.0, 0.0,
+                self.setpoint[0], self.setpoint[1], 0.0, 255, 255, 0x01, accepted)
+            self.sock.sendto(reply, sender)
+
+
+def run_poll(client, args):
+    frame = client.poll()
+    if frame is None:
+        print("no reply")
+        return
+    print("az %.2f el %.2f  vel %.2f/%.2f deg/s  setpoint %.2f/%.2f  pwm %d/%d  %.2f W  status %s  rtt %.2f ms" % (
+        frame.az, frame.el, frame.velocity_az, frame.velocity_el, frame.setpoint_az, frame.setpoint_el,
+        frame.pwm_az, frame.pwm_el, frame.power_w, status_text(frame.status), frame.rtt_ms))
+
+
+def run_sweep(client, args):
+    start = client.poll()
+    if start is None:
+        print("no reply")
+        return
+    period = 1.0 / args.rate
+    lookahead = [i * period * 1000 for i in range(args.batch)]
+    t0 = time.monotonic()
+    next_send = t0
+    while time.monotonic() - t0 < args.seconds:
+        t = time.monotonic() - t0
+        points = [(offset, start.az + args.amplitude * math.sin(2 * math.pi * (t + offset / 1000.0) / args.sweep_period), start.el)
+                  for offset in lookahead]
+        client.send_setpoints(points)
+        frame = client.receive()
+        if frame is not None:
+            print("t %6.2f  az %7.2f -> %7.2f  el %6.2f  vel %6.2f  %s" % (
+                t, frame.az, frame.setpoint_az, frame.el, frame.velocity_az, status_text(frame.status)))
+        next_send += period
+        time.sleep(max(0.0, next_send - time.monotonic()))
+
+
+def run_bench(client, args):
+    rtts = []
+    sent = 0
+    t0 = time.monotonic()
+    next_send = t0
+    while time.monotonic() - t0 < args.seconds:
+        sent += 1
+        frame = client.poll()
+        if frame is not None:
+            rtts.append(frame.rtt_ms)
+        if args.rate > 0:
+            next_send += 1.0 / args.rate
+            time.sleep(max(0.0, next_send - time.monotonic()))
+    elapsed = time.monotonic() - t0
+
+    if not rtts:
+        print("no replies to %d requests" % sent)
+        return
+    rtts.sort()
+    print("%d requests, %d replies (%.1f%% lost), %.1f frames/s" % (
+        sent, len(rtts), 100.0 * (sent - len(rtts)) / sent, len(rtts) / elapsed))
+    print("rtt ms: min %.3f  p50 %.3f  p99 %.3f  max %.3f" % (
+        rtts[0], rtts[len(rtts) // 2], rtts[min(len(rtts) - 1, int(0.99 * len(rtts)))], rtts[-1]))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Discovery Drive UDP control client")
+    parser.add_argument("command", choices=["poll", "sweep", "bench"])
+    parser.add_argument("host", nargs="?", help="rotator address (omit with --loopback)")
+    parser.add_argument("--port", type=int, default=4534)
+    parser.add_argument("--loopback", action="store_true", help="talk to an in-process emulator")
+    parser.add_argument("--rate", type=float, default=50.0, help="packets per second (bench: 0 = flat out)")
+    parser.add_argument("--seconds", type=float, default=10.0)
+    parser.add_argument("--batch", type=int, default=4, help="sweep: look-ahead setpoints per packet")
+    parser.add_argument("--amplitude", type=float, default=10.0, help="sweep: degrees either side")
+    parser.add_argument("--sweep-period", type=float, default=20.0, help="sweep: seconds per cycle")
+    args = parser.parse_args()
+
+    if args.loopback:
+        device = LoopbackDevice()
+        device.start()
+        host, port = "127.0.0.1", device.port
+    elif args.host:
+        host, port = args.host, args.port
+    else:
+        parser.error("host is required without --loopback")
+    args.batch = max(1, min(args.batch, MAX_SETPOINTS))
+
+    client = UdpControlClient(host, port)
+    {"poll": run_poll, "sweep": run_sweep, "bench": run_bench}[args.command](client, args)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+#
+# Firmware for the discovery-drive satellite dish rotator.
+# web_poll_bench.py - Compare the /variable poll against /telemetry plus a revalidated /config.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Fetches each resource --count times, one request at a time, and reports the body
+# size, the on-device build time from the Server-Timing header and the round trip.
+# "/config 304" sends If-None-Match with the ETag from a first fetch. That is what a
+# revalidation costs when nothing has changed. The UI only revalidates /config when
+# configVersion moves. With an event stream open it makes no polls at all. Without a
+# stream it polls /telemetry at the fast rate, where it used to poll /variable. The
+# last lines compare one of those polls before (/variable) and after (/telemetry).
+#
+#   python3 tools/web_poll_bench.py 192.168.1.50
+#   python3 tools/web_poll_bench.py 192.168.1.50 --count 200 --user admin --password secret
+
+import argparse
+import base64
+import http.client
+import re
+import time
+
+
+def percentile(values, fraction):
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(fraction * len(ordered)))]
+
+
+class Sample:
+    def __init__(self):
+        self.sizes = []
+        self.builds = []
+        self.rounds = []
+
+
+def fetch(host, port, path, headers):
+    connection = http.client.HTTPConnection(host, port, timeout=10)
+    start = time.perf_counter()
+    connection.request("GET", path, headers=headers)
+    response = connection.getresponse()
+    body = response.read()
+    elapsed = time.perf_counter() - start
+    connection.close()
+    return response, body, elapsed
+
+
+def measure(host, port, path, headers, count, expect):
+    sample = Sample()
+    for _ in range(count):
+        response, body, elapsed = fetch(host, port, path, headers)
+        if response.status != expect:
+            raise SystemExit("%s: HTTP %d, expected %d" % (path, response.status, expect))
+        sample.sizes.append(len(body))
+        sample.rounds.append(elapsed)
+        timing = re.search(r"dur=([0-9.]+)", response.getheader("Server-Timing", ""))
+        if timing:
+            sample.builds.append(float(timing.group(1)))
+    return sample
+
+
+def row(name, sample):
+    build = ("%7.2f %7.2f" % (percentile(sample.builds, 0.5), percentile(sample.builds, 0.99))
+             if sample.builds else "      -       -")
+    print("%-14s %8.0f  %s  %7.1f %7.1f" % (
+        name, sum(sample.sizes) / len(sample.sizes), build,
+        1000 * percentile(sample.rounds, 0.5), 1000 * percentile(sample.rounds, 0.99)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="/variable against /telemetry + /config")
+    parser.add_argument("host")
+    parser.add_argument("--port", type=int, default=80)
+    parser.add_argument("--count", type=int, default=100)
+    parser.add_argument("--user", default="")
+    parser.add_argument("--password", default="")
+    args = parser.parse_args()
+
+    headers = {}
+    if args.user:
+        token = base64.b64encode(("%s:%s" % (args.user, args.password)).encode()).decode()
+        headers["Authorization"] = "Basic " + token
+
+    response, _, _ = fetch(args.host, args.port, "/config", headers)
+    etag = response.getheader("ETag")
+    if response.status != 200 or not etag:
+        raise SystemExit("/config: HTTP %d, ETag %r" % (response.status, etag))
+
+    variable = measure(args.host, args.port, "/variable", headers, args.count, 200)
+    telemetry = measure(args.host, args.port, "/telemetry", headers, args.count, 200)
+    config = measure(args.host, args.port, "/config", headers, args.count, 200)
+    revalidated = measure(args.host, args.port, "/config", dict(headers, **{"If-None-Match": etag}),
+                          args.count, 304)
+
+    print("%d requests each to %s:%d" % (args.count, args.host, args.port))
+    print("resource          bytes  build ms p50/p99  round ms p50/p99")
+    row("/variable", variable)
+    row("/telemetry", telemetry)
+    row("/config 200", config)
+    row("/config 304", revalidated)
+
+    before_bytes = sum(variable.sizes) / args.count
+    after_bytes = sum(telemetry.sizes) / args.count
+    before_build = percentile(variable.builds, 0.5) if variable.builds else 0
+    after_build = percentile(telemetry.builds, 0.5) if telemetry.builds else 0
+    print("per fallback poll: %-18s %6.0f bytes, build %.2f ms" % ("before, /variable", before_bytes, before_build))
+    print("per fallback poll: %-18s %6.0f bytes, build %.2f ms" % ("after, /telemetry", after_bytes, after_build))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,247 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * UDP Control - Binary high-rate setpoint and telemetry protocol over UDP.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "udp_control.h"
+
+// =============================================================================
+// CONSTRUCTOR AND INITIALIZATION
+// =============================================================================
+
+UdpControl::UdpControl(Preferences& prefs, MotorSensorController& motorController, INA219Manager& ina219Manager, Logger& logger)
+    : _preferences(prefs), _motorSensorCtrl(motorController), _ina219Manager(ina219Manager), _logger(logger) {
+}
+
+void UdpControl::begin() {
+    int port = _preferences.getInt("udpCtlPort", DEFAULT_UDP_PORT);
+    _socketFd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (_socketFd < 0) {
+        LOGE(_logger, "UDP control: failed to create socket");
+        return;
+    }
+
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(_socketFd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        LOGE(_logger, "UDP control: failed to bind port " + String(port));
+        close(_socketFd);
+        _socketFd = -1;
+        return;
+    }
+    fcntl(_socketFd, F_SETFL, O_NONBLOCK);
+
+    LOGI(_logger, "UDP control listening on port " + String(port));
+}
+
+// =============================================================================
+// CORE FUNCTIONALITY
+// =============================================================================
+
+void UdpControl::runUdpControlLoop(bool motionAllowed) {
+    if (_socketFd < 0) {
+        vTaskDelay(pdMS_TO_TICKS(1000));  // No socket to wait on; keep the caller from spinning
+        return;
+    }
+
+    fd_set readSet;
+    FD_ZERO(&readSet);
+    FD_SET(_socketFd, &readSet);
+    struct timeval timeout = { 0, SELECT_TIMEOUT_MS * 1000 };
+    int ready = select(_socketFd + 1, &readSet, NULL, NULL, &timeout);
+    if (ready < 0) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+        return;
+    }
+
+    if (_controllerAddr != 0 && (!motionAllowed || millis() - _controllerLastMs > CONTROL_TIMEOUT)) {
+        LOGI(_logger, "UDP control: " + getControllerIP() + " released control");
+        _controllerAddr = 0;
+    }
+
+    // Drain everything queued so a burst is answered in one wakeup
+    uint8_t packet[MAX_PACKET_SIZE];
+    for (;;) {
+        struct sockaddr_in from;
+        socklen_t fromLength = sizeof(from);
+        int received = recvfrom(_socketFd, packet, sizeof(packet), 0, (struct sockaddr*)&from, &fromLength);
+        if (received < 0) {
+            break;
+        }
+        handlePacket(packet, received, from, motionAllowed);
+    }
+}
+
+String UdpControl::getControllerIP() {
+    uint32_t addr = _controllerAddr;
+    return IPAddress(addr).toString();
+}
+
+// =============================================================================
+// HELPER METHODS
+// =============================================================================
+
+void UdpControl::handlePacket(const uint8_t* data, size_t length, const struct sockaddr_in& from, bool motionAllowed) {
+    Header header;
+    if (length < sizeof(Header)) {
+        _packetsMalformed++;
+        return;
+    }
+    memcpy(&header, data, sizeof(Header));
+    if (header.magic != MAGIC || header.version != PROTOCOL_VERSION) {
+        _packetsMalformed++;
+        LOGD(_logger, "UDP control: ignoring packet with bad magic or version");
+        return;
+    }
+    bool valid = (header.type == PACKET_POLL) ||
+                 (header.type == PACKET_SETPOINTS && isValidSetpointBatch(data, length));
+    if (!valid) {
+        _packetsMalformed++;
+        return;
+    }
+    _packetsReceived++;
+
+    uint8_t status = 0;
+    uint8_t accepted = 0;
+    if (header.type == PACKET_SETPOINTS) {
+        accepted = applySetpoints(data, header, from, motionAllowed, status);
+    }
+
+    sendTelemetry(header, from, status, accepted);
+}
+
+bool UdpControl::isValidSetpointBatch(const uint8_t* data, size_t length) {
+    SetpointBatch batch;
+    if (length < sizeof(Header) + sizeof(SetpointBatch)) {
+        return false;
+    }
+    memcpy(&batch, data + sizeof(Header), sizeof(SetpointBatch));
+    if (batch.count > MAX_SETPOINTS ||
+        length < sizeof(Header) + sizeof(SetpointBatch) + batch.count * sizeof(Setpoint)) {
+        return false;
+    }
+
+    // fmod() turns an infinite azimuth into NaN, so every point must be finite
+    const uint8_t* cursor = data + sizeof(Header) + sizeof(SetpointBatch);
+    for (int i = 0; i < batch.count; i++) {
+        Setpoint point;
+        memcpy(&point, cursor, sizeof(Setpoint));
+        cursor += sizeof(Setpoint);
+        if (!isfinite(point.az) || !isfinite(point.el)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The packet has passed isValidSetpointBatch()
+uint8_t UdpControl::applySetpoints(const uint8_t* data, const Header& header,
+                                   const struct sockaddr_in& from, bool motionAllowed, uint8_t& status) {
+    SetpointBatch batch;
+    memcpy(&batch, data + sizeof(Header), sizeof(SetpointBatch));
+
+    bool isController = _controllerAddr == from.sin_addr.s_addr && _controllerPort == from.sin_port;
+    if (!isController) {
+        if (!motionAllowed || _controllerAddr != 0) {
+            _packetsRejected++;
+            status |= STATUS_REJECTED;
+            return 0;
+        }
+        _controllerAddr = from.sin_addr.s_addr;
+        _controllerPort = from.sin_port;
+        _controllerSequence = header.sequence - 1;
+        LOGI(_logger, "UDP control: " + getControllerIP() + " took control");
+    }
+    _controllerLastMs = millis();
+
+    // Datagrams can arrive reordered or duplicated; only strictly newer batches move the dish
+    int32_t step = (int32_t)(header.sequence - _controllerSequence);
+    if (step <= 0) {
+        status |= STATUS_STALE;
+        return 0;
+    }
+    _packetsLost += step - 1;
+    _controllerSequence = header.sequence;
+
+    unsigned long arrivalMs = millis();
+    const uint8_t* cursor = data + sizeof(Header) + sizeof(SetpointBatch);
+    uint8_t accepted = 0;
+    for (int i = 0; i < batch.count; i++) {
+        Setpoint point;
+        memcpy(&point, cursor, sizeof(Setpoint));
+        cursor += sizeof(Setpoint);
+
+        // Same limits as rotctl: azimuth wraps, elevation clamps to the horizon and zenith
+        float az = fmod(point.az, 360.0f);
+        if (az < 0) {
+            az += 360.0f;
+        }
+        float el = constrain(point.el, 0.0f, 90.0f);
+        _motorSensorCtrl.streamSetPoint(az, el, arrivalMs + point.offsetMs);
+        accepted++;
+    }
+    _setpointsApplied += accepted;
+    return accepted;
+}
+
+void UdpControl::sendTelemetry(const Header& request, const struct sockaddr_in& to, uint8_t status, uint8_t accepted) {
+    MotorSensorController::MotorTelemetry telemetry = _motorSensorCtrl.getTelemetry();
+
+    // Differentiate over a few control ticks; a single 25 ms tick is mostly sensor noise
+    unsigned long elapsedMs = telemetry.timestamp - _lastTelemetryMs;
+    if (elapsedMs >= 50) {
+        if (_lastTelemetryMs != 0 && elapsedMs < 1000) {
+            float deltaAz = telemetry.correctedAngle_az - _lastAz;
+            if (deltaAz > 180.0f) deltaAz -= 360.0f;
+            if (deltaAz < -180.0f) deltaAz += 360.0f;
+            _velocityAz = deltaAz * 1000.0f / elapsedMs;
+            _velocityEl = (telemetry.correctedAngle_el - _lastEl) * 1000.0f / elapsedMs;
+        }
+        _lastTelemetryMs = telemetry.timestamp;
+        _lastAz = telemetry.correctedAngle_az;
+        _lastEl = telemetry.correctedAngle_el;
+    }
+
+    if (_controllerAddr == to.sin_addr.s_addr && _controllerPort == to.sin_port) status |= STATUS_CONTROLLER;
+    if (telemetry.streaming) status |= STATUS_STREAMING;
+    if (telemetry.isAzMotorLatched) status |= STATUS_AZ_LATCHED;
+    if (telemetry.isElMotorLatched) status |= STATUS_EL_LATCHED;
+    if (_motorSensorCtrl.global_fault) status |= STATUS_FAULT;
+
+    uint8_t reply[sizeof(Header) + sizeof(Telemetry)];
+    Header header = request;
+    header.type = PACKET_TELEMETRY;
+
+    Telemetry frame;
+    frame.deviceMs = millis();
+    frame.az = telemetry.correctedAngle_az;
+    frame.el = telemetry.correctedAngle_el;
+    frame.velocityAz = _velocityAz;
+    frame.velocityEl = _velocityEl;
+    frame.setpointAz = telemetry.setpoint_az;
+    frame.setpointEl = telemetry.setpoint_el;
+    frame.powerW = _ina219Manager.getPower();
+    frame.pwmAz = (uint8_t)telemetry.pwm_az;
+    frame.pwmEl = (uint8_t)telemetry.pwm_el;
+    frame.status = status;
+    frame.accepted = accepted;
+
+    memcpy(reply, &header, sizeof(Header));
+    memcpy(reply + sizeof(Header), &frame, sizeof(Telemetry));
+    sendto(_socketFd, reply, sizeof(reply), 0, (const struct sockaddr*)&to, sizeof(to));
+}
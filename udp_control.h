@@ -0,0 +1,164 @@
+/*
+ * Firmware for the discovery-drive satellite dish rotator.
+ * UDP Control - Binary high-rate setpoint and telemetry protocol over UDP.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UDP_CONTROL_H
+#define UDP_CONTROL_H
+
+// System includes
+#include <Arduino.h>
+#include <Preferences.h>
+#include <IPAddress.h>
+#include <lwip/sockets.h>
+#include <atomic>
+
+// Custom includes
+#include "motor_controller.h"
+#include "ina219_manager.h"
+#include "logger.h"
+
+// Compact binary protocol for closed-loop tracking experiments at 50-100 Hz. Every request
+// is answered with one telemetry datagram, so the client gets position back at the rate it
+// sends. Setpoint batches are time-tagged relative to arrival and go into the same setpoint
+// stream as rotctl "P" commands. As with rotctl, the first sender of setpoints becomes the
+// controller; it keeps control until it stays silent for CONTROL_TIMEOUT.
+//
+// All fields are little-endian (the ESP32's byte order). tools/udp_control.py is the
+// reference client.
+class UdpControl {
+public:
+    static constexpr uint16_t MAGIC = 0x4444;             // "DD"
+    static constexpr uint8_t PROTOCOL_VERSION = 1;
+    static constexpr int MAX_SETPOINTS = 8;                // Matches the setpoint stream's depth
+
+    enum PacketType : uint8_t {
+        PACKET_SETPOINTS = 0x01,    // Header, SetpointBatch, count x Setpoint
+        PACKET_POLL = 0x02,         // Header only
+        PACKET_TELEMETRY = 0x81     // Header, Telemetry
+    };
+
+    // Telemetry status bits
+    enum StatusFlag : uint8_t {
+        STATUS_CONTROLLER = 0x01,   // The receiver of this frame is the controller
+        STATUS_REJECTED = 0x02,     // Setpoints ignored: another source controls
+        STATUS_STALE = 0x04,        // Setpoints ignored: sequence not newer than the last one
+        STATUS_STREAMING = 0x08,    // The control loop is following a setpoint stream
+        STATUS_AZ_LATCHED = 0x10,
+        STATUS_EL_LATCHED = 0x20,
+        STATUS_FAULT = 0x40
+    };
+
+    struct __attribute__((packed)) Header {
+        uint16_t magic;
+        uint8_t version;
+        uint8_t type;
+        uint32_t sequence;          // Sender's counter; replies echo the request's
+        uint32_t timestampUs;       // Sender's clock; replies echo the request's
+    };
+
+    struct __attribute__((packed)) SetpointBatch {
+        uint8_t count;
+        uint8_t reserved[3];
+    };
+
+    struct __attribute__((packed)) Setpoint {
+        int32_t offsetMs;           // Time of the point relative to arrival of the packet
+        float az;
+        float el;
+    };
+
+    struct __attribute__((packed)) Telemetry {
+        uint32_t deviceMs;          // millis() when the frame was built
+        float az;
+        float el;
+        float velocityAz;           // deg/s
+        float velocityEl;
+        float setpointAz;
+        float setpointEl;
+        float powerW;
+        uint8_t pwmAz;              // Inverted: 255 is stopped
+        uint8_t pwmEl;
+        uint8_t status;             // StatusFlag bits
+        uint8_t accepted;           // Setpoints applied from the request
+    };
+
+    static_assert(sizeof(Header) == 12, "UDP header layout");
+    static_assert(sizeof(Setpoint) == 12, "UDP setpoint layout");
+    static_assert(sizeof(Telemetry) == 36, "UDP telemetry layout");
+
+    // Constructor
+    UdpControl(Preferences& prefs, MotorSensorController& motorController, INA219Manager& ina219Manager, Logger& logger);
+
+    // Core functionality; the loop blocks until a datagram arrives or the poll timeout passes
+    void begin();
+    void runUdpControlLoop(bool motionAllowed);
+
+    // Control state
+    bool isControlling() const { return _controllerAddr != 0; }
+    String getControllerIP();
+
+    // Statistics; a datagram counts as received only once it has passed validation,
+    // so it is either received or malformed, never both
+    uint32_t getPacketsReceived() const { return _packetsReceived; }
+    uint32_t getSetpointsApplied() const { return _setpointsApplied; }
+    uint32_t getPacketsLost() const { return _packetsLost; }
+    uint32_t getPacketsRejected() const { return _packetsRejected; }
+    uint32_t getPacketsMalformed() const { return _packetsMalformed; }
+
+private:
+    static const int DEFAULT_UDP_PORT = 4534;
+    static const unsigned long CONTROL_TIMEOUT = 2000;     // Controller silent this long releases control
+    static const unsigned long SELECT_TIMEOUT_MS = 250;
+    static constexpr size_t MAX_PACKET_SIZE = sizeof(Header) + sizeof(SetpointBatch) + MAX_SETPOINTS * sizeof(Setpoint);
+
+    // Dependencies
+    Preferences& _preferences;
+    MotorSensorController& _motorSensorCtrl;
+    INA219Manager& _ina219Manager;
+    Logger& _logger;
+
+    int _socketFd = -1;
+
+    // Controller, owned by the UDP task; address and port in network byte order
+    std::atomic<uint32_t> _controllerAddr = 0;
+    uint16_t _controllerPort = 0;
+    uint32_t _controllerSequence = 0;
+    unsigned long _controllerLastMs = 0;
+
+    // Velocity estimate from successive control ticks
+    unsigned long _lastTelemetryMs = 0;
+    float _lastAz = 0;
+    float _lastEl = 0;
+    float _velocityAz = 0;
+    float _velocityEl = 0;
+
+    // Statistics
+    std::atomic<uint32_t> _packetsReceived = 0;
+    std::atomic<uint32_t> _setpointsApplied = 0;
+    std::atomic<uint32_t> _packetsLost = 0;
+    std::atomic<uint32_t> _packetsRejected = 0;
+    std::atomic<uint32_t> _packetsMalformed = 0;
+
+    // Helper methods
+    void handlePacket(const uint8_t* data, size_t length, const struct sockaddr_in& from, bool motionAllowed);
+    bool isValidSetpointBatch(const uint8_t* data, size_t length);
+    uint8_t applySetpoints(const uint8_t* data, const Header& header,
+                           const struct sockaddr_in& from, bool motionAllowed, uint8_t& status);
+    void sendTelemetry(const Header& request, const struct sockaddr_in& to, uint8_t status, uint8_t accepted);
+};
+
+#endif // UDP_CONTROL_H
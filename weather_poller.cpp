@@ -55,7 +55,7 @@ void WeatherPoller::begin() {
         // Force immediate update on first boot if fully configured
         if (_pollingEnabled) {
             _forceUpdate = true;
-            _logger.info("Weather system configured - will fetch data immediately");
+            LOGI(_logger, "Weather system configured - will fetch data immediately");
         }
     } else if (isLocationConfigured() && !isApiKeyConfigured()) {
         configStatus += "Location set but API key missing";
@@ -65,11 +65,11 @@ void WeatherPoller::begin() {
         configStatus += "Not configured (missing location and API key)";
     }
     
-    _logger.info(configStatus);
+    LOGI(_logger, configStatus);
     
     // Log wind safety configuration
     if (_windSafetyEnabled) {
-        _logger.info("Wind safety enabled - Speed threshold: " + String(_windSpeedThreshold.load(), 1) + 
+        LOGI(_logger, "Wind safety enabled - Speed threshold: " + String(_windSpeedThreshold.load(), 1) + 
                     " km/h, Gust threshold: " + String(_windGustThreshold.load(), 1) + " km/h");
     }
 }
@@ -106,9 +106,9 @@ void WeatherPoller::runWeatherLoop(bool wifiConnected) {
     if (pollWeatherData()) {
         _lastSuccessTime = millis();
         updateWindSafetyStatus(); // Update wind safety after successful poll
-        _logger.info("Weather data updated successfully");
+        LOGI(_logger, "Weather data updated successfully");
     } else {
-        _logger.warn("Failed to update weather data");
+        LOGW(_logger, "Failed to update weather data");
     }
     
     _forceUpdate = false;
@@ -130,7 +130,7 @@ bool WeatherPoller::shouldPollWeather() {
     
     // First boot scenario - poll immediately if we've never successfully updated
     if (_lastSuccessTime == 0 && timeSinceLastPoll > 5000) { // Wait 5 seconds after boot for system to settle
-        _logger.debug("First weather poll attempt after boot");
+        LOGD(_logger, "First weather poll attempt after boot");
         return true;
     }
     
@@ -154,7 +154,7 @@ bool WeatherPoller::pollWeatherData() {
         return false;
     }
     
-    _logger.debug("Polling weather API: " + apiUrl);
+    LOGD(_logger, "Polling weather API: " + apiUrl);
     
     // Use explicit scoping to ensure HTTPClient is properly destroyed
     bool success = false;
@@ -182,16 +182,16 @@ bool WeatherPoller::pollWeatherData() {
             payload = String();
         } else if (httpResponseCode == 401) {
             setErrorState("Invalid API key");
-            _logger.error("WeatherAPI authentication failed - check API key");
+            LOGE(_logger, "WeatherAPI authentication failed - check API key");
         } else if (httpResponseCode == 403) {
             setErrorState("API key quota exceeded");
-            _logger.error("WeatherAPI quota exceeded");
+            LOGE(_logger, "WeatherAPI quota exceeded");
         } else if (httpResponseCode > 0) {
             setErrorState("HTTP error: " + String(httpResponseCode));
-            _logger.error("WeatherAPI HTTP error: " + String(httpResponseCode));
+            LOGE(_logger, "WeatherAPI HTTP error: " + String(httpResponseCode));
         } else {
             setErrorState("Network error: " + String(httpResponseCode));
-            _logger.error("WeatherAPI network error: " + String(httpResponseCode));
+            LOGE(_logger, "WeatherAPI network error: " + String(httpResponseCode));
         }
         
         // Explicitly end the HTTP connection
@@ -282,7 +282,7 @@ void WeatherPoller::updateWindSafetyStatus() {
     }
     
     if (!isDataValid()) {
-        _logger.warn("Cannot update wind safety - no valid weather data");
+        LOGW(_logger, "Cannot update wind safety - no valid weather data");
         return;
     }
     
@@ -317,7 +317,7 @@ bool WeatherPoller::checkCurrentWindConditions() {
     bool gustExceeded = data.currentWindGust > gustThreshold;
     
     if (speedExceeded || gustExceeded) {
-        _logger.info("Current wind conditions exceed thresholds - Speed: " + 
+        LOGI(_logger, "Current wind conditions exceed thresholds - Speed: " + 
                     String(data.currentWindSpeed, 1) + " km/h (limit: " + String(speedThreshold, 1) + 
                     "), Gust: " + String(data.currentWindGust, 1) + " km/h (limit: " + String(gustThreshold, 1) + ")");
         return true;
@@ -334,7 +334,7 @@ bool WeatherPoller::checkForecastWindConditions() {
     
     // Check next hour forecast (index 0)
     if (data.forecastWindSpeed[0] > speedThreshold || data.forecastWindGust[0] > gustThreshold) {
-        _logger.info("Next hour forecast exceeds thresholds - Speed: " + 
+        LOGI(_logger, "Next hour forecast exceeds thresholds - Speed: " + 
                     String(data.forecastWindSpeed[0], 1) + " km/h (limit: " + String(speedThreshold, 1) + 
                     "), Gust: " + String(data.forecastWindGust[0], 1) + " km/h (limit: " + String(gustThreshold, 1) + ")");
         return true;
@@ -356,12 +356,12 @@ void WeatherPoller::setEmergencyStowState(bool active, const String& reason) {
             _windSafetyData.currentStowDirection = calculateOptimalStowDirection(data.currentWindDirection);
             
             if (!wasActive) {
-                _logger.warn("EMERGENCY WIND STOW ACTIVATED: " + reason + 
+                LOGW(_logger, "EMERGENCY WIND STOW ACTIVATED: " + reason + 
                            " - Stow direction: " + String(_windSafetyData.currentStowDirection, 1) + "°");
             }
         } else {
             if (wasActive) {
-                _logger.info("Emergency wind stow deactivated - conditions have improved");
+                LOGI(_logger, "Emergency wind stow deactivated - conditions have improved");
             }
             _windSafetyData.currentStowDirection = 0.0;
         }
@@ -414,7 +414,8 @@ bool WeatherPoller::shouldActivateEmergencyStow() {
 void WeatherPoller::setWindSafetyEnabled(bool enabled) {
     _windSafetyEnabled = enabled;
     _preferences.putBool("wind_safety_en", enabled);
-    _logger.info("Wind safety " + String(enabled ? "enabled" : "disabled"));
+    _settingsVersion++;
+    LOGI(_logger, "Wind safety " + String(enabled ? "enabled" : "disabled"));
     
     if (!enabled) {
         setEmergencyStowState(false, "");
@@ -429,7 +430,8 @@ void WeatherPoller::setWindSpeedThreshold(float threshold) {
     if (threshold > 0 && threshold <= 200) {
         _windSpeedThreshold = threshold;
         _preferences.putFloat("wind_speed_thr", threshold);
-        _logger.info("Wind speed threshold set to: " + String(threshold, 1) + " km/h");
+        _settingsVersion++;
+        LOGI(_logger, "Wind speed threshold set to: " + String(threshold, 1) + " km/h");
     }
 }
 
@@ -441,7 +443,8 @@ void WeatherPoller::setWindGustThreshold(float threshold) {
     if (threshold > 0 && threshold <= 200) {
         _windGustThreshold = threshold;
         _preferences.putFloat("wind_gust_thr", threshold);
-        _logger.info("Wind gust threshold set to: " + String(threshold, 1) + " km/h");
+        _settingsVersion++;
+        LOGI(_logger, "Wind gust threshold set to: " + String(threshold, 1) + " km/h");
     }
 }
 
@@ -452,7 +455,8 @@ float WeatherPoller::getWindGustThreshold() {
 void WeatherPoller::setWindBasedHomeEnabled(bool enabled) {
     _windBasedHomeEnabled = enabled;
     _preferences.putBool("wind_based_home", enabled);
-    _logger.info("Wind-based home positioning " + String(enabled ? "enabled" : "disabled"));
+    _settingsVersion++;
+    LOGI(_logger, "Wind-based home positioning " + String(enabled ? "enabled" : "disabled"));
 }
 
 bool WeatherPoller::isWindBasedHomeEnabled() {
@@ -465,7 +469,7 @@ bool WeatherPoller::isWindBasedHomeEnabled() {
 
 bool WeatherPoller::extractCurrentWeather(JsonDocument& doc) {
     if (!doc.containsKey("current")) {
-        _logger.warn("No current weather data in WeatherAPI response");
+        LOGW(_logger, "No current weather data in WeatherAPI response");
         return false;
     }
     
@@ -489,7 +493,7 @@ bool WeatherPoller::extractCurrentWeather(JsonDocument& doc) {
         
         xSemaphoreGive(_weatherDataMutex);
         
-        _logger.debug("Current wind: " + String(_weatherData.currentWindSpeed, 1) + " km/h, " +
+        LOGD(_logger, "Current wind: " + String(_weatherData.currentWindSpeed, 1) + " km/h, " +
                      "Direction: " + String(_weatherData.currentWindDirection, 0) + "°, " +
                      "Gusts: " + String(_weatherData.currentWindGust, 1) + " km/h");
         return true;
@@ -500,25 +504,25 @@ bool WeatherPoller::extractCurrentWeather(JsonDocument& doc) {
 
 bool WeatherPoller::extractForecastWeather(JsonDocument& doc) {
     if (!doc.containsKey("forecast") || !doc["forecast"].containsKey("forecastday")) {
-        _logger.warn("No forecast data in WeatherAPI response");
+        LOGW(_logger, "No forecast data in WeatherAPI response");
         return false;
     }
     
     JsonArray forecastDays = doc["forecast"]["forecastday"];
     if (forecastDays.size() == 0) {
-        _logger.warn("Empty forecast array");
+        LOGW(_logger, "Empty forecast array");
         return false;
     }
     
     JsonObject today = forecastDays[0];
     if (!today.containsKey("hour")) {
-        _logger.warn("No hourly data in forecast");
+        LOGW(_logger, "No hourly data in forecast");
         return false;
     }
     
     JsonArray hours = today["hour"];
     if (hours.size() == 0) {
-        _logger.warn("Empty hourly forecast array");
+        LOGW(_logger, "Empty hourly forecast array");
         return false;
     }
     
@@ -535,7 +539,7 @@ bool WeatherPoller::extractForecastWeather(JsonDocument& doc) {
         int forecastCount = 0;
         int currentHour = getCurrentHourFromTime(currentTimeStr);
         
-        _logger.debug("Current time: " + currentTimeStr + ", current hour: " + String(currentHour) + ", looking for hours > " + String(currentHour));
+        LOGD(_logger, "Current time: " + currentTimeStr + ", current hour: " + String(currentHour) + ", looking for hours > " + String(currentHour));
         
         // Find the next available hours starting from current hour + 1
         for (size_t i = 0; i < hours.size() && forecastCount < 3; i++) {
@@ -554,7 +558,7 @@ bool WeatherPoller::extractForecastWeather(JsonDocument& doc) {
                 _weatherData.forecastWindDirection[forecastCount] = validateWindDirection(hour["wind_degree"]);
                 _weatherData.forecastWindGust[forecastCount] = validateWindSpeed(hour["gust_kph"]);
                 
-                _logger.debug("Forecast " + String(forecastCount) + ": " + hourTime + 
+                LOGD(_logger, "Forecast " + String(forecastCount) + ": " + hourTime + 
                              " - Wind: " + String(_weatherData.forecastWindSpeed[forecastCount], 1) + " km/h");
                 
                 forecastCount++;
@@ -581,7 +585,7 @@ bool WeatherPoller::extractForecastWeather(JsonDocument& doc) {
                     _weatherData.forecastWindDirection[forecastCount] = validateWindDirection(hour["wind_degree"]);
                     _weatherData.forecastWindGust[forecastCount] = validateWindSpeed(hour["gust_kph"]);
                     
-                    _logger.debug("Tomorrow forecast " + String(forecastCount) + ": " + hourTime + 
+                    LOGD(_logger, "Tomorrow forecast " + String(forecastCount) + ": " + hourTime + 
                                  " - Wind: " + String(_weatherData.forecastWindSpeed[forecastCount], 1) + " km/h");
                     
                     forecastCount++;
@@ -591,7 +595,7 @@ bool WeatherPoller::extractForecastWeather(JsonDocument& doc) {
         
         xSemaphoreGive(_weatherDataMutex);
         
-        _logger.debug("Forecast extracted for next " + String(forecastCount) + " hours");
+        LOGD(_logger, "Forecast extracted for next " + String(forecastCount) + " hours");
         return (forecastCount > 0);
     }
     
@@ -627,7 +631,7 @@ void WeatherPoller::setErrorState(const String& error) {
         _weatherData.dataValid = false;
         xSemaphoreGive(_weatherDataMutex);
     }
-    _logger.error("Weather polling error: " + error);
+    LOGE(_logger, "Weather polling error: " + error);
 }
 
 // =============================================================================
@@ -636,7 +640,7 @@ void WeatherPoller::setErrorState(const String& error) {
 
 bool WeatherPoller::setLocation(float latitude, float longitude) {
     if (!isValidCoordinate(latitude, longitude)) {
-        _logger.error("Invalid coordinates: " + String(latitude, 6) + ", " + String(longitude, 6));
+        LOGE(_logger, "Invalid coordinates: " + String(latitude, 6) + ", " + String(longitude, 6));
         return false;
     }
     
@@ -646,8 +650,9 @@ bool WeatherPoller::setLocation(float latitude, float longitude) {
     // Save to preferences
     _preferences.putFloat("weather_lat", latitude);
     _preferences.putFloat("weather_lon", longitude);
+    _settingsVersion++;
     
-    _logger.info("Weather location set to: " + String(latitude, 6) + ", " + String(longitude, 6));
+    LOGI(_logger, "Weather location set to: " + String(latitude, 6) + ", " + String(longitude, 6));
     
     // Clear old data and force update if now fully configured
     if (isFullyConfigured() && _pollingEnabled) {
@@ -663,7 +668,7 @@ bool WeatherPoller::setApiKey(const String& apiKey) {
     trimmedKey.trim();
     
     if (!isValidApiKey(trimmedKey)) {
-        _logger.error("Invalid API key format");
+        LOGE(_logger, "Invalid API key format");
         return false;
     }
     
@@ -674,8 +679,9 @@ bool WeatherPoller::setApiKey(const String& apiKey) {
     
     // Save to preferences
     _preferences.putString("weather_api_key", trimmedKey);
+    _settingsVersion++;
     
-    _logger.info("WeatherAPI key configured");
+    LOGI(_logger, "WeatherAPI key configured");
     
     // Clear old data and force update if now fully configured
     if (isFullyConfigured() && _pollingEnabled) {
@@ -765,7 +771,7 @@ unsigned long WeatherPoller::getLastUpdateTime() {
 
 void WeatherPoller::forceUpdate() {
     _forceUpdate = true;
-    _logger.debug("Weather update forced");
+    LOGD(_logger, "Weather update forced");
 }
 
 bool WeatherPoller::isPollingEnabled() {
@@ -775,7 +781,8 @@ bool WeatherPoller::isPollingEnabled() {
 void WeatherPoller::setPollingEnabled(bool enabled) {
     _pollingEnabled = enabled;
     _preferences.putBool("weather_enabled", enabled);
-    _logger.info("Weather polling " + String(enabled ? "enabled" : "disabled"));
+    _settingsVersion++;
+    LOGI(_logger, "Weather polling " + String(enabled ? "enabled" : "disabled"));
     
     if (!enabled) {
         clearWeatherData();
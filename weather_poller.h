@@ -91,6 +91,9 @@ public:
     float getWindGustThreshold();
     void setWindBasedHomeEnabled(bool enabled);
     bool isWindBasedHomeEnabled();
+
+    // Bumped by every configuration setter, so cached copies of the settings know to refresh
+    uint32_t getSettingsVersion() const { return _settingsVersion.load(); }
     
     WindSafetyData getWindSafetyData();
     bool shouldActivateEmergencyStow();
@@ -113,6 +116,7 @@ private:
     std::atomic<float> _windSpeedThreshold{50.0};    // km/h
     std::atomic<float> _windGustThreshold{60.0};     // km/h
     std::atomic<bool> _windBasedHomeEnabled{false};
+    std::atomic<uint32_t> _settingsVersion{0};
     
     // Timing constants
     static constexpr unsigned long POLL_INTERVAL_MS = 300000; // 5 minutes
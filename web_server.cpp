@@ -24,26 +24,41 @@
 
 WebServerManager::WebServerManager(Preferences& prefs, MotorSensorController& motorController, INA219Manager& ina219Manager, 
                 StellariumPoller& stellariumPoller, WeatherPoller& weatherPoller, SerialManager& serialManager, 
-                WiFiManager& wifiManager, RotctlWifi& rotctlWifi, Logger& logger)
+                WiFiManager& wifiManager, RotctlWifi& rotctlWifi, UdpControl& udpControl, SatelliteTracker& satelliteTracker, LogFile& logFile, Logger& logger)
     : preferences(prefs), msc(motorController), ina219Manager(ina219Manager), stellariumPoller(stellariumPoller),
-      weatherPoller(weatherPoller), serialManager(serialManager), wifiManager(wifiManager), rotctlWifi(rotctlWifi), _logger(logger) {
+      weatherPoller(weatherPoller), serialManager(serialManager), wifiManager(wifiManager), rotctlWifi(rotctlWifi),
+      udpControl(udpControl), satelliteTracker(satelliteTracker), logFile(logFile), _logger(logger) {
     
     _fileMutex = xSemaphoreCreateMutex();
     _loginUserMutex = xSemaphoreCreateMutex();
 }
 
 void WebServerManager::begin() {
-    server = new WebServer(preferences.getInt("http_port", 80));
+    server = new HttpServer(preferences.getInt("http_port", 80));
+    _configEpoch = esp_random();
+    refreshStaticAssets();
+    scanIndexTemplate();
 
     wifi_ssid = preferences.getString("wifi_ssid", "");
     wifi_password = preferences.getString("wifi_password", "");
     _loginUser = preferences.getString("loginUser", "");
     _loginPassword = preferences.getString("loginPassword", "");
 
+    int eventIntervalMs = preferences.getInt("sseIntervalMs", DEFAULT_EVENT_INTERVAL_MS);
+    if (eventIntervalMs >= MIN_EVENT_INTERVAL_MS && eventIntervalMs <= MAX_EVENT_INTERVAL_MS) {
+        _eventIntervalMs = eventIntervalMs;
+    }
+
     setupRoutes();
+    server->onClose([this](int fd) {
+        _eventStream.removeClient(fd);
+    });
 
-    server->begin();
-    _logger.info("HTTP server started");
+    if (server->begin()) {
+        LOGI(_logger, "HTTP server started");
+    } else {
+        LOGE(_logger, "HTTP server failed to start");
+    }
 }
 
 // =============================================================================
@@ -72,7 +87,7 @@ void WebServerManager::setupRoutes() {
     // Debug and error handling
     setupDebugRoutes();
     
-    _logger.debug("All routes registered");
+    LOGD(_logger, "All routes registered");
 }
 
 void WebServerManager::setupStaticRoutes() {
@@ -101,20 +116,7 @@ void WebServerManager::setupMainPageRoutes() {
             }
         }
 
-        String html = loadIndexHTML();
-        if (html == "") {
-            server->send(500, "text/plain", "Failed to load HTML template");
-            return;
-        }
-
-        // Replace template variables
-        html.replace("%var_calmode_checked%", msc.calMode ? "checked" : "");
-        html.replace("%var_singleMotorMode_checked%", msc.singleMotorMode ? "checked" : "");
-        
-        bool stellariumOn = preferences.getBool("stellariumOn", false);
-        html.replace("%var_stellariumOn_checked%", stellariumOn ? "checked" : "");
-
-        server->send(200, "text/html", html);
+        streamIndexHTML();
     });
 
     // OTA Update routes
@@ -151,21 +153,21 @@ void WebServerManager::setupSystemControlRoutes() {
         ESP.restart();
     });
 
-    server->on("/setDebugLevel", HTTP_POST, [this]() {
+    onConfigRoute("/setDebugLevel", HTTP_POST, [this]() {
         if (server->hasArg("debugLevel")) {
             int debugLevel = server->arg("debugLevel").toInt();
             _logger.setDebugLevel(debugLevel);
-            _logger.info("Debug level changed via web interface to: " + String(debugLevel));
+            LOGI(_logger, "Debug level changed via web interface to: " + String(debugLevel));
         }
         server->send(204);
     });
 
-    server->on("/setSerialOutputDisabled", HTTP_GET, [this]() {
+    onConfigRoute("/setSerialOutputDisabled", HTTP_GET, [this]() {
         if (server->hasArg("disabled")) {
             String disabledStr = server->arg("disabled");
             bool disabled = (disabledStr == "true");
             _logger.setSerialOutputDisabled(disabled);
-            _logger.info("Serial output " + String(disabled ? "disabled" : "enabled") + " via web interface");
+            LOGI(_logger, "Serial output " + String(disabled ? "disabled" : "enabled") + " via web interface");
             server->send(200, "text/plain", "Serial output " + String(disabled ? "disabled" : "enabled"));
         } else {
             server->send(400, "text/plain", "Missing disabled parameter");
@@ -208,7 +210,7 @@ void WebServerManager::setupMotorControlRoutes() {
         // Check if wind-based home is enabled
         if (weatherPoller.isWindBasedHomeEnabled()) {
             homeAz = weatherPoller.getWindBasedHomePosition();
-            _logger.info("Using wind-based home position: " + String(homeAz, 1) + "°");
+            LOGI(_logger, "Using wind-based home position: " + String(homeAz, 1) + "°");
         }
         
         msc.setSetPointAz(homeAz);
@@ -262,20 +264,20 @@ void WebServerManager::setupMotorControlRoutes() {
     server->on("/setSingleMotorModeOn", HTTP_GET, [this]() {
         msc.singleMotorMode = true;
         preferences.putBool("singleMotorMode", msc.singleMotorMode);
-        _logger.debug("SingleMotorMode On");
+        LOGD(_logger, "SingleMotorMode On");
         server->send(200, "text/plain", "SingleMotorMode ON");
     });
 
     server->on("/setSingleMotorModeOff", HTTP_GET, [this]() {
         msc.singleMotorMode = false;
         preferences.putBool("singleMotorMode", msc.singleMotorMode);
-        _logger.debug("SingleMotorMode OFF");
+        LOGD(_logger, "SingleMotorMode OFF");
         server->send(200, "text/plain", "SingleMotorMode OFF");
     });
 }
 
 void WebServerManager::setupConfigurationRoutes() {
-    server->on("/setPassword", HTTP_POST, [this]() {
+    onConfigRoute("/setPassword", HTTP_POST, [this]() {
         if (server->hasArg("loginUser")) {
             String loginUser = server->arg("loginUser");
             setLoginUser(loginUser);
@@ -291,7 +293,7 @@ void WebServerManager::setupConfigurationRoutes() {
         server->send(204);
     });
 
-    server->on("/setWiFi", HTTP_POST, [this]() {
+    onConfigRoute("/setWiFi", HTTP_POST, [this]() {
         bool hotspotMode = server->hasArg("hotspot");
 
         if (hotspotMode) {
@@ -314,7 +316,7 @@ void WebServerManager::setupConfigurationRoutes() {
         }
     });
 
-    server->on("/setPorts", HTTP_POST, [this]() {
+    onConfigRoute("/setPorts", HTTP_POST, [this]() {
         bool updated = false;
 
         if (server->hasArg("http_port")) {
@@ -345,7 +347,7 @@ void WebServerManager::setupConfigurationRoutes() {
         }
     });
 
-    server->on("/setDualMotorMaxSpeed", HTTP_POST, [this]() {
+    onConfigRoute("/setDualMotorMaxSpeed", HTTP_POST, [this]() {
         if (server->hasArg("maxDualMotorAzSpeed")) {
             String azSpeedValue = server->arg("maxDualMotorAzSpeed");
             if (azSpeedValue.length() > 0) {
@@ -364,7 +366,7 @@ void WebServerManager::setupConfigurationRoutes() {
         server->send(204);
     });
 
-    server->on("/setSingleMotorMaxSpeed", HTTP_POST, [this]() {
+    onConfigRoute("/setSingleMotorMaxSpeed", HTTP_POST, [this]() {
         if (server->hasArg("maxSingleMotorAzSpeed")) {
             String azSpeedValue = server->arg("maxSingleMotorAzSpeed");
             if (azSpeedValue.length() > 0) {
@@ -383,7 +385,7 @@ void WebServerManager::setupConfigurationRoutes() {
         server->send(204);
     });
 
-    server->on("/setStellarium", HTTP_POST, [this]() {
+    onConfigRoute("/setStellarium", HTTP_POST, [this]() {
         if (server->hasArg("stellariumServerIP")) {
             String serverIP = server->arg("stellariumServerIP");
             if (serverIP.length() > 0) {
@@ -400,7 +402,21 @@ void WebServerManager::setupConfigurationRoutes() {
         server->send(204);
     });
 
-    server->on("/setAdvancedParams", HTTP_POST, [this]() {
+    onConfigRoute("/setTLE", HTTP_POST, [this]() {
+        if (!server->hasArg("tleLine1") || !server->hasArg("tleLine2")) {
+            server->send(400, "text/plain", "Missing TLE lines");
+            return;
+        }
+
+        String name = server->hasArg("tleName") ? server->arg("tleName") : "";
+        if (satelliteTracker.setTLE(name, server->arg("tleLine1"), server->arg("tleLine2"))) {
+            server->send(204);
+        } else {
+            server->send(400, "text/plain", "Invalid TLE (check format, checksums, and that the orbit is near-earth)");
+        }
+    });
+
+    onConfigRoute("/setAdvancedParams", HTTP_POST, [this]() {
         bool updated = false;
         
         // Helper lambda for parameter validation and setting
@@ -438,12 +454,22 @@ void WebServerManager::setupConfigurationRoutes() {
         setIntParam("MIN_AZ_SPEED", [this](int v) { msc.setMinAzSpeed(v); }, 0, 255);
         setIntParam("MAX_FAULT_POWER", [this](int v) { msc.setMaxPowerBeforeFault(v); }, 1, 25);
         setIntParam("MIN_VOLTAGE_THRESHOLD", [this](int v) { msc.setMinVoltageThreshold(v); }, 1, 20);
+        setIntParam("CONTROL_PERIOD_US", [this](int v) { msc.setControlPeriodUs(v); }, 0, 5000);
+        setIntParam("CONTROLLER_MODE", [this](int v) { msc.setControllerMode(v); }, 0, 1);
+        setIntParam("MOTION_PROFILE", [this](int v) { msc.setMotionProfileEnabled(v == 1); }, 0, 1);
+        setIntParam("EVENT_INTERVAL_MS", [this](int v) { setEventIntervalMs(v); }, MIN_EVENT_INTERVAL_MS, MAX_EVENT_INTERVAL_MS);
         
         setFloatParam("MIN_AZ_TOLERANCE", [this](float v) { msc.setMinAzTolerance(v); }, 0.1f, 10.0f);
         setFloatParam("MIN_EL_TOLERANCE", [this](float v) { msc.setMinElTolerance(v); }, 0.1f, 10.0f);
+        setFloatParam("Ki_az", [this](float v) { msc.setKiAz(v); }, 0.0f, 1000.0f);
+        setFloatParam("Kd_az", [this](float v) { msc.setKdAz(v); }, 0.0f, 1000.0f);
+        setFloatParam("Kff_az", [this](float v) { msc.setKffAz(v); }, 0.0f, 1000.0f);
+        setFloatParam("Ki_el", [this](float v) { msc.setKiEl(v); }, 0.0f, 1000.0f);
+        setFloatParam("Kd_el", [this](float v) { msc.setKdEl(v); }, 0.0f, 1000.0f);
+        setFloatParam("Kff_el", [this](float v) { msc.setKffEl(v); }, 0.0f, 1000.0f);
         
         if (updated) {
-            _logger.info("Advanced parameters updated via web interface");
+            LOGI(_logger, "Advanced parameters updated via web interface");
         }
         
         server->send(204);
@@ -451,7 +477,7 @@ void WebServerManager::setupConfigurationRoutes() {
 
     // Weather configuration routes
 
-    server->on("/setWeatherApiKey", HTTP_POST, [this]() {
+    onConfigRoute("/setWeatherApiKey", HTTP_POST, [this]() {
         if (server->hasArg("weatherApiKey")) {
             String apiKey = server->arg("weatherApiKey");
             apiKey.trim();
@@ -459,10 +485,10 @@ void WebServerManager::setupConfigurationRoutes() {
             if (apiKey.length() == 0) {
                 // Allow clearing the API key
                 weatherPoller.setApiKey("");
-                _logger.info("Weather API key cleared via web interface");
+                LOGI(_logger, "Weather API key cleared via web interface");
                 server->send(200, "text/plain", "API key cleared");
             } else if (weatherPoller.setApiKey(apiKey)) {
-                _logger.info("Weather API key updated via web interface");
+                LOGI(_logger, "Weather API key updated via web interface");
                 server->send(204);
             } else {
                 server->send(400, "text/plain", "Invalid API key format");
@@ -473,7 +499,7 @@ void WebServerManager::setupConfigurationRoutes() {
     });
 
 
-    server->on("/setWeatherLocation", HTTP_POST, [this]() {
+    onConfigRoute("/setWeatherLocation", HTTP_POST, [this]() {
         bool updated = false;
         
         if (server->hasArg("latitude") && server->hasArg("longitude")) {
@@ -487,20 +513,20 @@ void WebServerManager::setupConfigurationRoutes() {
                 float lat = latStr.toFloat();
                 float lon = lonStr.toFloat();
                 
-                _logger.debug("Received weather location: " + String(lat, 6) + ", " + String(lon, 6));
+                LOGD(_logger, "Received weather location: " + String(lat, 6) + ", " + String(lon, 6));
                 
                 if (weatherPoller.setLocation(lat, lon)) {
                     updated = true;
-                    _logger.info("Weather location updated via web interface: " + 
+                    LOGI(_logger, "Weather location updated via web interface: " + 
                                 String(lat, 6) + ", " + String(lon, 6));
                 } else {
-                    _logger.error("Invalid coordinates received: " + String(lat, 6) + ", " + String(lon, 6));
+                    LOGE(_logger, "Invalid coordinates received: " + String(lat, 6) + ", " + String(lon, 6));
                     server->send(400, "text/plain", "Invalid coordinates");
                     return;
                 }
             }
         } else {
-            _logger.error("Missing latitude or longitude parameters");
+            LOGE(_logger, "Missing latitude or longitude parameters");
         }
         
         if (updated) {
@@ -510,12 +536,12 @@ void WebServerManager::setupConfigurationRoutes() {
         }
     });
 
-    server->on("/weatherOn", HTTP_GET, [this]() {
+    onConfigRoute("/weatherOn", HTTP_GET, [this]() {
         weatherPoller.setPollingEnabled(true);
         server->send(200, "text/plain", "Weather polling ON");
     });
 
-    server->on("/weatherOff", HTTP_GET, [this]() {
+    onConfigRoute("/weatherOff", HTTP_GET, [this]() {
         weatherPoller.setPollingEnabled(false);
         server->send(200, "text/plain", "Weather polling OFF");
     });
@@ -531,27 +557,27 @@ void WebServerManager::setupConfigurationRoutes() {
 
 
     // Wind safety configuration routes
-    server->on("/windSafetyOn", HTTP_GET, [this]() {
+    onConfigRoute("/windSafetyOn", HTTP_GET, [this]() {
         weatherPoller.setWindSafetyEnabled(true);
         server->send(200, "text/plain", "Wind safety ON");
     });
 
-    server->on("/windSafetyOff", HTTP_GET, [this]() {
+    onConfigRoute("/windSafetyOff", HTTP_GET, [this]() {
         weatherPoller.setWindSafetyEnabled(false);
         server->send(200, "text/plain", "Wind safety OFF");
     });
 
-    server->on("/windBasedHomeOn", HTTP_GET, [this]() {
+    onConfigRoute("/windBasedHomeOn", HTTP_GET, [this]() {
         weatherPoller.setWindBasedHomeEnabled(true);
         server->send(200, "text/plain", "Wind-based home positioning ON");
     });
 
-    server->on("/windBasedHomeOff", HTTP_GET, [this]() {
+    onConfigRoute("/windBasedHomeOff", HTTP_GET, [this]() {
         weatherPoller.setWindBasedHomeEnabled(false);
         server->send(200, "text/plain", "Wind-based home positioning OFF");
     });
 
-    server->on("/setWindThresholds", HTTP_POST, [this]() {
+    onConfigRoute("/setWindThresholds", HTTP_POST, [this]() {
         bool updated = false;
         
         if (server->hasArg("windSpeedThreshold")) {
@@ -562,7 +588,7 @@ void WebServerManager::setupConfigurationRoutes() {
                 if (speed >= 10.0 && speed <= 200.0) {
                     weatherPoller.setWindSpeedThreshold(speed);
                     updated = true;
-                    _logger.info("Wind speed threshold set to: " + String(speed, 1) + " km/h");
+                    LOGI(_logger, "Wind speed threshold set to: " + String(speed, 1) + " km/h");
                 }
             }
         }
@@ -575,7 +601,7 @@ void WebServerManager::setupConfigurationRoutes() {
                 if (gust >= 10.0 && gust <= 200.0) {
                     weatherPoller.setWindGustThreshold(gust);
                     updated = true;
-                    _logger.info("Wind gust threshold set to: " + String(gust, 1) + " km/h");
+                    LOGI(_logger, "Wind gust threshold set to: " + String(gust, 1) + " km/h");
                 }
             }
         }
@@ -587,7 +613,7 @@ void WebServerManager::setupConfigurationRoutes() {
         }
     });
 
-    server->on("/setAngleOffsets", HTTP_POST, [this]() {
+    onConfigRoute("/setAngleOffsets", HTTP_POST, [this]() {
         bool updated = false;
         
         if (server->hasArg("azOffset")) {
@@ -598,9 +624,9 @@ void WebServerManager::setupConfigurationRoutes() {
                 if (azOffset >= -180.0 && azOffset <= 180.0) {
                     msc.setAzOffset(azOffset);
                     updated = true;
-                    _logger.info("AZ angle offset set to: " + String(azOffset, 3) + "° via web interface");
+                    LOGI(_logger, "AZ angle offset set to: " + String(azOffset, 3) + "° via web interface");
                 } else {
-                    _logger.warn("AZ offset out of range: " + String(azOffset, 3) + "°");
+                    LOGW(_logger, "AZ offset out of range: " + String(azOffset, 3) + "°");
                 }
             }
         }
@@ -613,9 +639,9 @@ void WebServerManager::setupConfigurationRoutes() {
                 if (elOffset >= -45.0 && elOffset <= 45.0) {
                     msc.setElOffset(elOffset);
                     updated = true;
-                    _logger.info("EL angle offset set to: " + String(elOffset, 3) + "° via web interface");
+                    LOGI(_logger, "EL angle offset set to: " + String(elOffset, 3) + "° via web interface");
                 } else {
-                    _logger.warn("EL offset out of range: " + String(elOffset, 3) + "°");
+                    LOGW(_logger, "EL offset out of range: " + String(elOffset, 3) + "°");
                 }
             }
         }
@@ -632,33 +658,69 @@ void WebServerManager::setupConfigurationRoutes() {
 }
 
 void WebServerManager::setupAPIRoutes() {
-    server->on("/stellariumOn", HTTP_GET, [this]() {
+    onConfigRoute("/stellariumOn", HTTP_GET, [this]() {
         stellariumPoller.setStellariumOn(true);
         preferences.putBool("stellariumOn", true);
         server->send(200, "text/plain", "Stellarium ON");
     });
 
-    server->on("/stellariumOff", HTTP_GET, [this]() {
+    onConfigRoute("/stellariumOff", HTTP_GET, [this]() {
         stellariumPoller.setStellariumOn(false);
         preferences.putBool("stellariumOn", false);
         server->send(200, "text/plain", "Stellarium OFF");
     });
 
+    onConfigRoute("/trackingOn", HTTP_GET, [this]() {
+        satelliteTracker.setTrackingOn(true);
+        server->send(200, "text/plain", "Tracking ON");
+    });
+
+    onConfigRoute("/trackingOff", HTTP_GET, [this]() {
+        satelliteTracker.setTrackingOn(false);
+        server->send(200, "text/plain", "Tracking OFF");
+    });
+
+    // Prometheus scrape target, streamed without building a document
+    server->on("/metrics", HTTP_GET, [this]() {
+        handleMetrics();
+    });
+
+    // Configuration, revalidated with If-None-Match, and everything else the UI shows as plain numbers
+    server->on("/config", HTTP_GET, [this]() {
+        handleConfig();
+    });
+
+    server->on("/telemetry", HTTP_GET, [this]() {
+        handleTelemetry();
+    });
+
+    // Push channel for the UI: full frame on connect, then only the fields that changed
+    server->on("/events", HTTP_GET, [this]() {
+        if (!_eventStream.addClient(server->getHandle(), server->client())) {
+            server->send(503, "text/plain", "Too many event stream clients");
+            return;
+        }
+        // The stream wrote its own response and keeps writing to the socket from here on
+        server->detachClient();
+    });
+
     server->on("/variable", HTTP_GET, [this]() {
+        unsigned long buildStart = micros();
         static DynamicJsonDocument doc(8192);
         doc.clear();
 
-        // Motor and control data
-        doc["correctedAngle_el"] = String(msc.getCorrectedAngleEl());
-        doc["correctedAngle_az"] = String(msc.getCorrectedAngleAz());
-        doc["setpoint_az"] = String(msc.getSetPointAz());
-        doc["setpoint_el"] = String(msc.getSetPointEl());
-        doc["setPointState_az"] = String((int)msc.setPointState_az);
-        doc["setPointState_el"] = String((int)msc.setPointState_el);
-        doc["error_az"] = String(msc.getErrorAz());
-        doc["error_el"] = String(msc.getErrorEl());
-        doc["el_startAngle"] = String(msc.getElStartAngle());
-        doc["needs_unwind"] = String(msc.needs_unwind);
+        // Motor and control data, all from the same control tick
+        MotorSensorController::MotorTelemetry telemetry = msc.getTelemetry();
+        doc["correctedAngle_el"] = String(telemetry.correctedAngle_el);
+        doc["correctedAngle_az"] = String(telemetry.correctedAngle_az);
+        doc["setpoint_az"] = String(telemetry.setpoint_az);
+        doc["setpoint_el"] = String(telemetry.setpoint_el);
+        doc["setPointState_az"] = String((int)telemetry.setPointState_az);
+        doc["setPointState_el"] = String((int)telemetry.setPointState_el);
+        doc["error_az"] = String(telemetry.error_az);
+        doc["error_el"] = String(telemetry.error_el);
+        doc["el_startAngle"] = String(telemetry.el_startAngle);
+        doc["needs_unwind"] = String(telemetry.needs_unwind);
         
         // Status flags
         doc["calMode"] = msc.calMode ? "ON" : "OFF";
@@ -667,8 +729,8 @@ void WebServerManager::setupAPIRoutes() {
         doc["faultTripped"] = String((int)msc.global_fault);
         doc["badAngleFlag"] = String((int)msc.badAngleFlag);
         doc["magnetFault"] = String((int)msc.magnetFault);
-        doc["isAzMotorLatched"] = String(msc._isAzMotorLatched);
-        doc["isElMotorLatched"] = String(msc._isElMotorLatched);
+        doc["isAzMotorLatched"] = String(telemetry.isAzMotorLatched);
+        doc["isElMotorLatched"] = String(telemetry.isElMotorLatched);
 
         // Configuration data
         doc["http_port"] = String(preferences.getInt("http_port", 80));
@@ -695,6 +757,17 @@ void WebServerManager::setupAPIRoutes() {
         doc["stellariumServerPortText"] = preferences.getString("stelServPort", "8090");
         doc["stellariumConnActive"] = stellariumPoller.getStellariumConnActive() ? "Connected" : "Disconnected";
 
+        // Satellite tracking data
+        doc["trackingOnText"] = satelliteTracker.getTrackingOn() ? "ON" : "OFF";
+        doc["trackingState"] = satelliteTracker.getStateText();
+        doc["trackingSatName"] = satelliteTracker.getSatelliteName();
+        doc["trackingTleEpoch"] = satelliteTracker.getTleEpochText();
+        doc["trackingAz"] = String(satelliteTracker.getAzimuth(), 2);
+        doc["trackingEl"] = String(satelliteTracker.getElevation(), 2);
+        doc["trackingRange"] = String(satelliteTracker.getRange(), 0);
+        doc["trackingPropUs"] = String(satelliteTracker.getLastPropagationMicros()) + " / " +
+                                String(satelliteTracker.getMaxPropagationMicros());
+
         // Advanced parameters
         doc["toleranceAz"] = String(msc.getMinAzTolerance());
         doc["toleranceEl"] = String(msc.getMinElTolerance());
@@ -706,8 +779,18 @@ void WebServerManager::setupAPIRoutes() {
         doc["MIN_EL_TOLERANCE"] = String(msc.getMinElTolerance());
         doc["MAX_FAULT_POWER"] = String(msc.getMaxPowerBeforeFault());
         doc["MIN_VOLTAGE_THRESHOLD"] = String(msc.getMinVoltageThreshold());
-        doc["azOffset"] = String(msc.getAzOffset(), 3);
-        doc["elOffset"] = String(msc.getElOffset(), 3);
+        doc["CONTROL_PERIOD_US"] = String(msc.getControlPeriodUs());
+        doc["CONTROLLER_MODE"] = String(msc.getControllerMode());
+        doc["MOTION_PROFILE"] = String((int)msc.getMotionProfileEnabled());
+        doc["EVENT_INTERVAL_MS"] = String(getEventIntervalMs());
+        doc["Ki_az"] = String(msc.getKiAz());
+        doc["Kd_az"] = String(msc.getKdAz());
+        doc["Kff_az"] = String(msc.getKffAz());
+        doc["Ki_el"] = String(msc.getKiEl());
+        doc["Kd_el"] = String(msc.getKdEl());
+        doc["Kff_el"] = String(msc.getKffEl());
+        doc["azOffset"] = String(telemetry.az_offset, 3);
+        doc["elOffset"] = String(telemetry.el_offset, 3);
 
         // Power and connectivity data
         doc["inputVoltage"] = String(ina219Manager.getLoadVoltage());
@@ -719,6 +802,12 @@ void WebServerManager::setupAPIRoutes() {
         doc["level"] = wifiManager.getSignalStrengthLevel(rssi);
         doc["ip_addr"] = wifiManager.ip_addr;
         doc["rotctl_client_ip"] = rotctlWifi.getRotctlClientIP();
+        doc["rotctl_clients"] = String(rotctlWifi.getClientCount());
+        char rotctlLatency[64];
+        char rotctlHistogram[64];
+        formatRotctlLatency(rotctlLatency, sizeof(rotctlLatency), rotctlHistogram, sizeof(rotctlHistogram));
+        doc["rotctl_latency"] = rotctlLatency;
+        doc["rotctl_latency_hist"] = rotctlHistogram;
         doc["bssid"] = wifiManager.getCurrentBSSID();
         doc["wifi_channel"] = wifiManager.getCurrentWiFiChannel();
 
@@ -784,21 +873,108 @@ void WebServerManager::setupAPIRoutes() {
 
         String json;
         serializeJson(doc, json);
+        server->sendHeader("Server-Timing", "build;dur=" + String((micros() - buildStart) / 1000.0f, 3));
         server->send(200, "application/json", json);
     });
 }
 
 void WebServerManager::setupDebugRoutes() {
+    // Control loop stage timing; ?reset=1 clears the histograms after reporting
+    server->on("/profile", HTTP_GET, [this]() {
+        DynamicJsonDocument doc(2048);
+        ControlLoopProfiler& profiler = msc.getProfiler();
+
+        JsonArray stages = doc.createNestedArray("stages");
+        for (int i = 0; i < ControlLoopProfiler::STAGE_COUNT; i++) {
+            ControlLoopProfiler::Stage stage = (ControlLoopProfiler::Stage)i;
+            ControlLoopProfiler::StageStats stats = profiler.getStats(stage);
+            JsonObject entry = stages.createNestedObject();
+            entry["name"] = ControlLoopProfiler::getStageName(stage);
+            entry["count"] = stats.count;
+            entry["min_us"] = stats.minMicros;
+            entry["mean_us"] = stats.meanMicros;
+            entry["p99_us"] = stats.p99Micros;
+            entry["max_us"] = stats.maxMicros;
+        }
+        doc["control_period_us"] = msc.isHighRateControl() ? msc.getControlPeriodUs()
+                                                             : MotorSensorController::LEGACY_CONTROL_PERIOD_US;
+
+        if (server->hasArg("reset") && server->arg("reset") == "1") {
+            profiler.reset();
+        }
+
+        String response;
+        serializeJson(doc, response);
+        server->send(200, "application/json", response);
+    });
+
+    // Connected rotctl clients and their command counters
+    server->on("/rotctl", HTTP_GET, [this]() {
+        DynamicJsonDocument doc(2048);
+        JsonArray clients = doc.createNestedArray("clients");
+        uint32_t now = millis();
+        for (int i = 0; i < RotctlWifi::MAX_CLIENTS; i++) {
+            RotctlWifi::ClientStats stats;
+            if (!rotctlWifi.getClientStats(i, stats)) {
+                continue;
+            }
+            JsonObject entry = clients.createNestedObject();
+            entry["ip"] = stats.ip;
+            entry["controller"] = stats.controller;
+            entry["connected_s"] = (now - stats.connectedMs) / 1000;
+            entry["idle_ms"] = now - stats.lastActivityMs;
+            entry["commands"] = stats.commands;
+            entry["rejected"] = stats.rejected;
+            entry["bytes_in"] = stats.bytesIn;
+            entry["bytes_out"] = stats.bytesOut;
+        }
+        doc["total_commands"] = rotctlWifi.getTotalCommands();
+        doc["total_rejected"] = rotctlWifi.getTotalRejected();
+
+        // Command-to-reply latency; ?reset=1 clears it after reporting
+        RotctlWifi::LatencyStats latency = rotctlWifi.getLatencyStats();
+        JsonObject latencyJson = doc.createNestedObject("latency");
+        latencyJson["count"] = latency.count;
+        latencyJson["mean_us"] = latency.meanMicros;
+        latencyJson["p50_us"] = latency.p50Micros;
+        latencyJson["p99_us"] = latency.p99Micros;
+        latencyJson["max_us"] = latency.maxMicros;
+        JsonArray buckets = latencyJson.createNestedArray("buckets");
+        for (int i = 0; i < RotctlWifi::LATENCY_BUCKETS; i++) {
+            JsonObject bucket = buckets.createNestedObject();
+            uint32_t bound = RotctlWifi::getLatencyBucketBound(i);
+            if (bound == UINT32_MAX) {
+                bucket["le_us"] = "inf";
+            } else {
+                bucket["le_us"] = bound;
+            }
+            bucket["count"] = latency.buckets[i];
+        }
+        if (server->hasArg("reset") && server->arg("reset") == "1") {
+            rotctlWifi.resetLatencyStats();
+        }
+
+        String response;
+        serializeJson(doc, response);
+        server->send(200, "application/json", response);
+    });
+
+    // Persistent binary log (previous and current file); decode with tools/decode_log.py.
+    // Streamed from the worker task, since it holds the log file for the whole download.
+    server->onBackground("/downloadLog", HTTP_GET, [this]() {
+        logFile.sendTo(*server);
+    });
+
     // Catch-all handler for debugging
     server->onNotFound([this]() {
         String method = (server->method() == HTTP_GET) ? "GET" : 
                        (server->method() == HTTP_POST) ? "POST" : "OTHER";
         
-        _logger.debug("404 - " + method + " " + server->uri());
+        LOGD(_logger, "404 - " + method + " " + server->uri());
         
         if (server->method() == HTTP_POST) {
             String contentType = server->header("Content-Type");
-            _logger.debug("Content-Type: " + contentType);
+            LOGD(_logger, "Content-Type: " + contentType);
         }
         
         server->send(404, "text/plain", "Not Found: " + method + " " + server->uri());
@@ -806,6 +982,522 @@ void WebServerManager::setupDebugRoutes() {
 }
 
 // [Rest of the file remains the same - all the OTA upload methods, utility methods, etc.]
+// =============================================================================
+// METRICS
+// =============================================================================
+
+void WebServerManager::handleMetrics() {
+    server->setContentLength(HttpServer::CONTENT_LENGTH_UNKNOWN);
+    server->send(200, "text/plain; version=0.0.4", "");
+
+    MetricsWriter out(*server);
+    MotorSensorController::MotorTelemetry telemetry = msc.getTelemetry();
+
+    // Position and control
+    out.family("dd_angle_degrees", "gauge", "Corrected dish angle.");
+    out.sample("dd_angle_degrees", "axis=\"az\"", (double)telemetry.correctedAngle_az);
+    out.sample("dd_angle_degrees", "axis=\"el\"", (double)telemetry.correctedAngle_el);
+    out.family("dd_setpoint_degrees", "gauge", "Setpoint being tracked.");
+    out.sample("dd_setpoint_degrees", "axis=\"az\"", (double)telemetry.setpoint_az);
+    out.sample("dd_setpoint_degrees", "axis=\"el\"", (double)telemetry.setpoint_el);
+    out.family("dd_error_degrees", "gauge", "Control error.");
+    out.sample("dd_error_degrees", "axis=\"az\"", telemetry.error_az);
+    out.sample("dd_error_degrees", "axis=\"el\"", telemetry.error_el);
+    out.family("dd_motor_pwm", "gauge", "Motor driver PWM, inverted (255 is stopped).");
+    out.sample("dd_motor_pwm", "axis=\"az\"", (uint32_t)telemetry.pwm_az);
+    out.sample("dd_motor_pwm", "axis=\"el\"", (uint32_t)telemetry.pwm_el);
+    out.family("dd_motor_active", "gauge", "1 while the axis is outside tolerance or slewing.");
+    out.sample("dd_motor_active", "axis=\"az\"", (uint32_t)telemetry.setPointState_az);
+    out.sample("dd_motor_active", "axis=\"el\"", (uint32_t)telemetry.setPointState_el);
+    out.family("dd_motor_latched", "gauge", "1 while the axis is latched off.");
+    out.sample("dd_motor_latched", "axis=\"az\"", (uint32_t)telemetry.isAzMotorLatched);
+    out.sample("dd_motor_latched", "axis=\"el\"", (uint32_t)telemetry.isElMotorLatched);
+    out.family("dd_needs_unwind", "gauge", "Azimuth cable wrap count.");
+    out.sample("dd_needs_unwind", nullptr, (double)telemetry.needs_unwind);
+    out.family("dd_tracking_stream_active", "gauge", "1 while following a setpoint stream.");
+    out.sample("dd_tracking_stream_active", nullptr, (uint32_t)telemetry.streaming);
+
+    // Power
+    out.family("dd_input_voltage_volts", "gauge", "Supply voltage.");
+    out.sample("dd_input_voltage_volts", nullptr, (double)ina219Manager.getLoadVoltage());
+    out.family("dd_current_amps", "gauge", "Supply current.");
+    out.sample("dd_current_amps", nullptr, (double)(ina219Manager.getCurrent() / 1000));
+    out.family("dd_power_watts", "gauge", "Rotator power draw.");
+    out.sample("dd_power_watts", nullptr, (double)ina219Manager.getPower());
+
+    // Faults
+    out.family("dd_fault", "gauge", "Fault and status flags.");
+    out.sample("dd_fault", "flag=\"global\"", (uint32_t)msc.global_fault);
+    out.sample("dd_fault", "flag=\"bad_angle\"", (uint32_t)msc.badAngleFlag);
+    out.sample("dd_fault", "flag=\"magnet\"", (uint32_t)msc.magnetFault);
+    out.sample("dd_fault", "flag=\"i2c_az\"", (uint32_t)msc.i2cErrorFlag_az);
+    out.sample("dd_fault", "flag=\"i2c_el\"", (uint32_t)msc.i2cErrorFlag_el);
+    out.sample("dd_fault", "flag=\"over_power\"", (uint32_t)msc.overPowerFault);
+    out.sample("dd_fault", "flag=\"low_voltage\"", (uint32_t)msc.lowVoltageFault);
+    out.sample("dd_fault", "flag=\"error_divergence\"", (uint32_t)msc.errorDivergenceFault);
+    out.family("dd_wind_stow_active", "gauge", "1 while the dish is stowed for wind.");
+    out.sample("dd_wind_stow_active", nullptr, (uint32_t)msc._windStowActive);
+
+    // Hall sensor I2C
+    const MotorSensorController::I2CStats& azStats = msc.getI2CStatsAz();
+    const MotorSensorController::I2CStats& elStats = msc.getI2CStatsEl();
+    out.family("dd_i2c_transactions_total", "counter", "Hall sensor I2C transactions.");
+    out.sample("dd_i2c_transactions_total", "axis=\"az\"", azStats.transactions.load());
+    out.sample("dd_i2c_transactions_total", "axis=\"el\"", elStats.transactions.load());
+    out.family("dd_i2c_errors_total", "counter", "Failed hall sensor I2C transactions.");
+    out.sample("dd_i2c_errors_total", "axis=\"az\"", azStats.errors.load());
+    out.sample("dd_i2c_errors_total", "axis=\"el\"", elStats.errors.load());
+    out.family("dd_i2c_transaction_max_microseconds", "gauge", "Slowest hall sensor I2C transaction.");
+    out.sample("dd_i2c_transaction_max_microseconds", "axis=\"az\"", azStats.maxMicros.load());
+    out.sample("dd_i2c_transaction_max_microseconds", "axis=\"el\"", elStats.maxMicros.load());
+
+    // Control loop timing
+    ControlLoopProfiler& profiler = msc.getProfiler();
+    char labels[48];
+    out.family("dd_control_stage_microseconds", "gauge", "Control loop stage time by statistic.");
+    for (int i = 0; i < ControlLoopProfiler::STAGE_COUNT; i++) {
+        ControlLoopProfiler::Stage stage = (ControlLoopProfiler::Stage)i;
+        ControlLoopProfiler::StageStats stats = profiler.getStats(stage);
+        const char* name = ControlLoopProfiler::getStageName(stage);
+        snprintf(labels, sizeof(labels), "stage=\"%s\",stat=\"mean\"", name);
+        out.sample("dd_control_stage_microseconds", labels, (double)stats.meanMicros);
+        snprintf(labels, sizeof(labels), "stage=\"%s\",stat=\"p99\"", name);
+        out.sample("dd_control_stage_microseconds", labels, (double)stats.p99Micros);
+        snprintf(labels, sizeof(labels), "stage=\"%s\",stat=\"max\"", name);
+        out.sample("dd_control_stage_microseconds", labels, (double)stats.maxMicros);
+    }
+    out.family("dd_control_ticks_total", "counter", "Control loop ticks profiled.");
+    out.sample("dd_control_ticks_total", nullptr, profiler.getStats(ControlLoopProfiler::STAGE_TOTAL).count);
+
+    // System
+    out.family("dd_heap_free_bytes", "gauge", "Free heap.");
+    out.sample("dd_heap_free_bytes", nullptr, ESP.getFreeHeap());
+    out.family("dd_heap_min_free_bytes", "gauge", "Lowest free heap since boot.");
+    out.sample("dd_heap_min_free_bytes", nullptr, ESP.getMinFreeHeap());
+    out.family("dd_heap_max_alloc_bytes", "gauge", "Largest allocatable heap block.");
+    out.sample("dd_heap_max_alloc_bytes", nullptr, ESP.getMaxAllocHeap());
+    out.family("dd_wifi_rssi_dbm", "gauge", "WiFi signal strength, 0 when not in station mode.");
+    out.sample("dd_wifi_rssi_dbm", nullptr, (double)wifiManager.getRSSI());
+    out.family("dd_uptime_seconds", "counter", "Time since boot.");
+    out.sample("dd_uptime_seconds", nullptr, (uint32_t)(millis() / 1000));
+    out.family("dd_log_dropped_total", "counter", "Log records overwritten before a consumer read them.");
+    out.sample("dd_log_dropped_total", nullptr, _logger.getDroppedCount());
+    out.family("dd_rotctl_clients", "gauge", "Connected rotctl clients.");
+    out.sample("dd_rotctl_clients", nullptr, (uint32_t)rotctlWifi.getClientCount());
+    out.family("dd_rotctl_commands_total", "counter", "rotctl commands received from all clients.");
+    out.sample("dd_rotctl_commands_total", nullptr, rotctlWifi.getTotalCommands());
+    out.family("dd_rotctl_rejected_total", "counter", "rotctl motion commands refused from read-only clients.");
+    out.sample("dd_rotctl_rejected_total", nullptr, rotctlWifi.getTotalRejected());
+    RotctlWifi::LatencyStats rotctlLatency = rotctlWifi.getLatencyStats();
+    out.family("dd_rotctl_reply_latency_microseconds", "histogram", "rotctl command-to-reply latency.");
+    uint32_t cumulative = 0;
+    for (int i = 0; i < RotctlWifi::LATENCY_BUCKETS; i++) {
+        char le[24];
+        uint32_t bound = RotctlWifi::getLatencyBucketBound(i);
+        if (bound == UINT32_MAX) {
+            snprintf(le, sizeof(le), "le=\"+Inf\"");
+        } else {
+            snprintf(le, sizeof(le), "le=\"%lu\"", (unsigned long)bound);
+        }
+        cumulative += rotctlLatency.buckets[i];
+        out.sample("dd_rotctl_reply_latency_microseconds_bucket", le, cumulative);
+    }
+    out.sample("dd_rotctl_reply_latency_microseconds_sum", nullptr, (double)rotctlLatency.meanMicros * rotctlLatency.count);
+    out.sample("dd_rotctl_reply_latency_microseconds_count", nullptr, rotctlLatency.count);
+    SerialManager::LatencyStats serialLatency = serialManager.getLatencyStats();
+    out.family("dd_serial_commands_total", "counter", "Serial commands received.");
+    out.sample("dd_serial_commands_total", nullptr, serialManager.getCommandCount());
+    out.family("dd_serial_tx_dropped_total", "counter", "Serial replies dropped because the host was not reading.");
+    out.sample("dd_serial_tx_dropped_total", nullptr, serialManager.getTxDropped());
+    out.family("dd_serial_reply_latency_microseconds", "gauge", "Serial RX event to reply written, by statistic.");
+    out.sample("dd_serial_reply_latency_microseconds", "stat=\"last\"", serialLatency.lastMicros);
+    out.sample("dd_serial_reply_latency_microseconds", "stat=\"mean\"", (double)serialLatency.meanMicros);
+    out.sample("dd_serial_reply_latency_microseconds", "stat=\"max\"", serialLatency.maxMicros);
+    out.family("dd_serial_replies_total", "counter", "Serial replies timed for latency.");
+    out.sample("dd_serial_replies_total", nullptr, serialLatency.count);
+    out.family("dd_udp_packets_total", "counter", "UDP control packets by outcome.");
+    out.sample("dd_udp_packets_total", "result=\"received\"", udpControl.getPacketsReceived());
+    out.sample("dd_udp_packets_total", "result=\"lost\"", udpControl.getPacketsLost());
+    out.sample("dd_udp_packets_total", "result=\"rejected\"", udpControl.getPacketsRejected());
+    out.sample("dd_udp_packets_total", "result=\"malformed\"", udpControl.getPacketsMalformed());
+    out.family("dd_udp_setpoints_total", "counter", "Setpoints applied from UDP control batches.");
+    out.sample("dd_udp_setpoints_total", nullptr, udpControl.getSetpointsApplied());
+    out.family("dd_event_clients", "gauge", "Browsers subscribed to /events.");
+    out.sample("dd_event_clients", nullptr, (uint32_t)_eventStream.getClientCount());
+
+    out.finish();
+}
+
+// =============================================================================
+// EVENT STREAM
+// =============================================================================
+
+void WebServerManager::pushEvents() {
+    // One frame at a time; if the server task is still busy with the last one, skip this one
+    if (server == nullptr || _eventsQueued.exchange(true)) {
+        return;
+    }
+    if (!server->queueWork(writeEventsOnServer, this)) {
+        _eventsQueued = false;
+    }
+}
+
+void WebServerManager::writeEventsOnServer(void* arg) {
+    WebServerManager* manager = (WebServerManager*)arg;
+    manager->writeEvents();
+    manager->_eventsQueued = false;
+}
+
+void WebServerManager::writeEvents() {
+    if (_eventStream.getClientCount() == 0) {
+        return;
+    }
+
+    // Everything the UI shows except configuration, which it fetches from /config whenever
+    // configVersion moves. Values are formatted exactly like /variable.
+    MotorSensorController::MotorTelemetry telemetry = msc.getTelemetry();
+    _eventStream.beginFrame();
+    _eventStream.setField("correctedAngle_el", telemetry.correctedAngle_el);
+    _eventStream.setField("correctedAngle_az", telemetry.correctedAngle_az);
+    _eventStream.setField("setpoint_az", telemetry.setpoint_az);
+    _eventStream.setField("setpoint_el", telemetry.setpoint_el);
+    _eventStream.setField("setPointState_az", (int)telemetry.setPointState_az);
+    _eventStream.setField("setPointState_el", (int)telemetry.setPointState_el);
+    _eventStream.setField("error_az", (float)telemetry.error_az);
+    _eventStream.setField("error_el", (float)telemetry.error_el);
+    _eventStream.setField("el_startAngle", telemetry.el_startAngle);
+    _eventStream.setField("needs_unwind", telemetry.needs_unwind);
+    _eventStream.setField("isAzMotorLatched", (int)telemetry.isAzMotorLatched);
+    _eventStream.setField("isElMotorLatched", (int)telemetry.isElMotorLatched);
+    _eventStream.setField("azOffset", telemetry.az_offset, 3);
+    _eventStream.setField("elOffset", telemetry.el_offset, 3);
+
+    _eventStream.setField("calMode", msc.calMode ? "ON" : "OFF");
+    _eventStream.setField("i2cErrorFlag_az", (int)msc.i2cErrorFlag_az);
+    _eventStream.setField("i2cErrorFlag_el", (int)msc.i2cErrorFlag_el);
+    _eventStream.setField("faultTripped", (int)msc.global_fault);
+    _eventStream.setField("badAngleFlag", (int)msc.badAngleFlag);
+    _eventStream.setField("magnetFault", (int)msc.magnetFault);
+    _eventStream.setField("singleMotorModeText", msc.singleMotorMode ? "ON" : "OFF");
+    _eventStream.setField("serialActive", (int)serialManager.serialActive);
+    _eventStream.setField("stellariumConnActive", stellariumPoller.getStellariumConnActive() ? "Connected" : "Disconnected");
+
+    _eventStream.setField("trackingOnText", satelliteTracker.getTrackingOn() ? "ON" : "OFF");
+    _eventStream.setField("trackingState", satelliteTracker.getStateText());
+    _eventStream.setField("trackingSatName", satelliteTracker.getSatelliteName());
+    _eventStream.setField("trackingTleEpoch", satelliteTracker.getTleEpochText());
+    _eventStream.setField("trackingAz", satelliteTracker.getAzimuth(), 2);
+    _eventStream.setField("trackingEl", satelliteTracker.getElevation(), 2);
+    _eventStream.setField("trackingRange", satelliteTracker.getRange(), 0);
+    char propagation[32];
+    snprintf(propagation, sizeof(propagation), "%lu / %lu",
+             (unsigned long)satelliteTracker.getLastPropagationMicros(),
+             (unsigned long)satelliteTracker.getMaxPropagationMicros());
+    _eventStream.setField("trackingPropUs", propagation);
+
+    _eventStream.setField("inputVoltage", ina219Manager.getLoadVoltage());
+    _eventStream.setField("currentDraw", ina219Manager.getCurrent() / 1000);
+    _eventStream.setField("rotatorPowerDraw", ina219Manager.getPower());
+    int rssi = wifiManager.getRSSI();
+    _eventStream.setField("rssi", rssi);
+    _eventStream.setField("level", wifiManager.getSignalStrengthLevel(rssi));
+    _eventStream.setField("rotctl_client_ip", rotctlWifi.getRotctlClientIP());
+    _eventStream.setField("rotctl_clients", rotctlWifi.getClientCount());
+    char rotctlLatency[64];
+    char rotctlHistogram[64];
+    formatRotctlLatency(rotctlLatency, sizeof(rotctlLatency), rotctlHistogram, sizeof(rotctlHistogram));
+    _eventStream.setField("rotctl_latency", rotctlLatency);
+    _eventStream.setField("rotctl_latency_hist", rotctlHistogram);
+    _eventStream.setField("ip_addr", wifiManager.ip_addr);
+    _eventStream.setField("bssid", wifiManager.getCurrentBSSID());
+    _eventStream.setField("wifi_channel", wifiManager.getCurrentWiFiChannel());
+
+    WindSafetyData windSafetyData = weatherPoller.getWindSafetyData();
+    _eventStream.setField("windStowActive", msc.isWindStowActive() ? "YES" : "NO");
+    _eventStream.setField("windStowReason", msc.getWindStowReason());
+    _eventStream.setField("windTrackingActive", msc.isWindTrackingActive() ? "YES" : "NO");
+    _eventStream.setField("windTrackingStatus", msc.getWindTrackingStatus());
+    _eventStream.setField("emergencyStowActive", windSafetyData.emergencyStowActive ? "YES" : "NO");
+    _eventStream.setField("stowDirection", windSafetyData.currentStowDirection, 1);
+
+    // Forecast slots are flattened because stream values are plain strings
+    static const char* const FORECAST_TIME_KEYS[] = { "forecastTime0", "forecastTime1", "forecastTime2" };
+    static const char* const FORECAST_SPEED_KEYS[] = { "forecastWindSpeed0", "forecastWindSpeed1", "forecastWindSpeed2" };
+    static const char* const FORECAST_DIRECTION_KEYS[] = { "forecastWindDirection0", "forecastWindDirection1", "forecastWindDirection2" };
+    static const char* const FORECAST_GUST_KEYS[] = { "forecastWindGust0", "forecastWindGust1", "forecastWindGust2" };
+    WeatherData weatherData = weatherPoller.getWeatherData();
+    _eventStream.setField("weatherDataValid", weatherData.dataValid ? "YES" : "NO");
+    if (weatherData.dataValid) {
+        _eventStream.setField("currentWindSpeed", weatherData.currentWindSpeed, 1);
+        _eventStream.setField("currentWindDirection", weatherData.currentWindDirection, 0);
+        _eventStream.setField("currentWindGust", weatherData.currentWindGust, 1);
+        _eventStream.setField("currentWeatherTime", weatherData.currentTime);
+        _eventStream.setField("weatherLastUpdate", weatherData.lastUpdateTime);
+        _eventStream.setField("weatherError", "");
+    } else {
+        _eventStream.setField("currentWindSpeed", "N/A");
+        _eventStream.setField("currentWindDirection", "N/A");
+        _eventStream.setField("currentWindGust", "N/A");
+        _eventStream.setField("currentWeatherTime", "N/A");
+        _eventStream.setField("weatherLastUpdate", "Never");
+        _eventStream.setField("weatherError", weatherPoller.getLastError());
+    }
+    for (int i = 0; i < 3; i++) {
+        _eventStream.setField(FORECAST_TIME_KEYS[i], weatherData.forecastTimes[i]);
+        _eventStream.setField(FORECAST_SPEED_KEYS[i], weatherData.forecastWindSpeed[i], 1);
+        _eventStream.setField(FORECAST_DIRECTION_KEYS[i], weatherData.forecastWindDirection[i], 0);
+        _eventStream.setField(FORECAST_GUST_KEYS[i], weatherData.forecastWindGust[i], 1);
+    }
+
+    char configVersion[12];
+    snprintf(configVersion, sizeof(configVersion), "%lu", (unsigned long)getConfigVersion());
+    _eventStream.setField("configVersion", configVersion);
+    _eventStream.endFrame();
+
+    // Log lines are drained here while anyone is subscribed, so they arrive with the frame
+    String newLogMessages = _logger.getNewLogMessages();
+    if (newLogMessages.length() > 0) {
+        _eventStream.sendLog(newLogMessages);
+    }
+}
+
+void WebServerManager::setEventIntervalMs(int value) {
+    if (value >= MIN_EVENT_INTERVAL_MS && value <= MAX_EVENT_INTERVAL_MS) {
+        _eventIntervalMs = value;
+        preferences.putInt("sseIntervalMs", value);
+        invalidateConfig();
+        LOGI(_logger, "Event stream interval set to " + String(value) + " ms");
+    }
+}
+
+// =============================================================================
+// CONFIG AND TELEMETRY
+// =============================================================================
+
+void WebServerManager::onConfigRoute(const char* uri, httpd_method_t method, HttpServer::THandlerFunction handler) {
+    server->on(uri, method, [this, handler]() {
+        handler();
+        invalidateConfig();
+    });
+}
+
+void WebServerManager::invalidateConfig() {
+    _configVersion++;
+}
+
+uint32_t WebServerManager::getConfigVersion() {
+    // Every term only ever grows, so the sum changes whenever any one of them does
+    return _configVersion + msc.getSettingsVersion() + satelliteTracker.getSettingsVersion() +
+           weatherPoller.getSettingsVersion() + stellariumPoller.getSettingsVersion() +
+           _logger.getSettingsVersion();
+}
+
+String WebServerManager::getConfigETag(uint32_t version) {
+    char etag[24];
+    snprintf(etag, sizeof(etag), "\"%08lx-%lu\"", (unsigned long)_configEpoch, (unsigned long)version);
+    return String(etag);
+}
+
+void WebServerManager::handleConfig() {
+    unsigned long buildStart = micros();
+    uint32_t version = getConfigVersion();
+    String etag = getConfigETag(version);
+    server->sendHeader("ETag", etag);
+    server->sendHeader("Cache-Control", "no-cache");
+
+    if (server->header("If-None-Match") == etag) {
+        server->send(304);
+        return;
+    }
+
+    if (_configJsonVersion != version) {
+        buildConfigJson();
+        _configJsonVersion = version;
+    }
+
+    server->sendHeader("Server-Timing", "build;dur=" + String((micros() - buildStart) / 1000.0f, 3));
+    server->send(200, "application/json", _configJson);
+}
+
+void WebServerManager::buildConfigJson() {
+    static DynamicJsonDocument doc(3072);
+    doc.clear();
+
+    // Network and access
+    doc["http_port"] = preferences.getInt("http_port", 80);
+    doc["rotctl_port"] = preferences.getInt("rotctl_port", 4533);
+    doc["wifissid"] = preferences.getString("wifi_ssid", "discoverydish_HOTSPOT");
+    doc["loginUser"] = getLoginUser();
+    doc["passwordProtected"] = _loginRequired && getLoginUser().length() != 0 && getLoginPassword().length() != 0;
+
+    // Motion limits
+    doc["maxDualMotorAzSpeed"] = msc.convertSpeedToPercentage((float)msc.max_dual_motor_az_speed);
+    doc["maxDualMotorElSpeed"] = msc.convertSpeedToPercentage((float)msc.max_dual_motor_el_speed);
+    doc["maxSingleMotorAzSpeed"] = msc.convertSpeedToPercentage((float)msc.max_single_motor_az_speed);
+    doc["maxSingleMotorElSpeed"] = msc.convertSpeedToPercentage((float)msc.max_single_motor_el_speed);
+    doc["azOffset"] = msc.getAzOffset();
+    doc["elOffset"] = msc.getElOffset();
+
+    // Advanced parameters
+    doc["P_el"] = msc.getPEl();
+    doc["P_az"] = msc.getPAz();
+    doc["MIN_EL_SPEED"] = msc.getMinElSpeed();
+    doc["MIN_AZ_SPEED"] = msc.getMinAzSpeed();
+    doc["MIN_AZ_TOLERANCE"] = msc.getMinAzTolerance();
+    doc["MIN_EL_TOLERANCE"] = msc.getMinElTolerance();
+    doc["MAX_FAULT_POWER"] = msc.getMaxPowerBeforeFault();
+    doc["MIN_VOLTAGE_THRESHOLD"] = msc.getMinVoltageThreshold();
+    doc["CONTROL_PERIOD_US"] = msc.getControlPeriodUs();
+    doc["CONTROLLER_MODE"] = msc.getControllerMode();
+    doc["MOTION_PROFILE"] = msc.getMotionProfileEnabled();
+    doc["Ki_az"] = msc.getKiAz();
+    doc["Kd_az"] = msc.getKdAz();
+    doc["Kff_az"] = msc.getKffAz();
+    doc["Ki_el"] = msc.getKiEl();
+    doc["Kd_el"] = msc.getKdEl();
+    doc["Kff_el"] = msc.getKffEl();
+    doc["EVENT_INTERVAL_MS"] = getEventIntervalMs();
+
+    // Stellarium and satellite tracking
+    doc["stellariumPollingOn"] = preferences.getBool("stellariumOn", false);
+    doc["stellariumServerIP"] = preferences.getString("stelServIP", "");
+    doc["stellariumServerPort"] = preferences.getString("stelServPort", "8090");
+    doc["trackingOn"] = satelliteTracker.getTrackingOn();
+    doc["trackingSatName"] = satelliteTracker.getSatelliteName();
+    doc["trackingTleEpoch"] = satelliteTracker.getTleEpochText();
+
+    // Weather and wind safety
+    doc["weatherEnabled"] = weatherPoller.isPollingEnabled();
+    doc["weatherApiKeyConfigured"] = weatherPoller.isApiKeyConfigured();
+    doc["weatherLocationConfigured"] = weatherPoller.isLocationConfigured();
+    doc["weatherLatitude"] = weatherPoller.getLatitude();
+    doc["weatherLongitude"] = weatherPoller.getLongitude();
+    doc["windSafetyEnabled"] = weatherPoller.isWindSafetyEnabled();
+    doc["windBasedHomeEnabled"] = weatherPoller.isWindBasedHomeEnabled();
+    doc["windSpeedThreshold"] = weatherPoller.getWindSpeedThreshold();
+    doc["windGustThreshold"] = weatherPoller.getWindGustThreshold();
+
+    // Logging
+    doc["currentDebugLevel"] = _logger.getDebugLevel();
+    doc["serialOutputDisabled"] = _logger.getSerialOutputDisabled();
+
+    _configJson = "";
+    serializeJson(doc, _configJson);
+}
+
+void WebServerManager::handleTelemetry() {
+    unsigned long buildStart = micros();
+    static DynamicJsonDocument doc(3072);
+    doc.clear();
+
+    // Lets a poller know when to revalidate /config
+    doc["configVersion"] = getConfigVersion();
+
+    // One control tick; angles in degrees, PWM inverted (255 is stopped)
+    MotorSensorController::MotorTelemetry telemetry = msc.getTelemetry();
+    doc["timestamp"] = telemetry.timestamp;
+    doc["correctedAngle_az"] = telemetry.correctedAngle_az;
+    doc["correctedAngle_el"] = telemetry.correctedAngle_el;
+    doc["setpoint_az"] = telemetry.setpoint_az;
+    doc["setpoint_el"] = telemetry.setpoint_el;
+    doc["error_az"] = telemetry.error_az;
+    doc["error_el"] = telemetry.error_el;
+    doc["setPointState_az"] = telemetry.setPointState_az;
+    doc["setPointState_el"] = telemetry.setPointState_el;
+    doc["isAzMotorLatched"] = telemetry.isAzMotorLatched;
+    doc["isElMotorLatched"] = telemetry.isElMotorLatched;
+    doc["streaming"] = telemetry.streaming;
+    doc["pwm_az"] = telemetry.pwm_az;
+    doc["pwm_el"] = telemetry.pwm_el;
+    doc["el_startAngle"] = telemetry.el_startAngle;
+    doc["needs_unwind"] = telemetry.needs_unwind;
+
+    // Status flags
+    doc["calMode"] = msc.calMode.load();
+    doc["singleMotorMode"] = msc.singleMotorMode.load();
+    doc["faultTripped"] = msc.global_fault.load();
+    doc["i2cErrorFlag_az"] = msc.i2cErrorFlag_az.load();
+    doc["i2cErrorFlag_el"] = msc.i2cErrorFlag_el.load();
+    doc["badAngleFlag"] = msc.badAngleFlag.load();
+    doc["magnetFault"] = msc.magnetFault.load();
+    doc["windStowActive"] = msc.isWindStowActive();
+    doc["windStowReason"] = msc.getWindStowReason();
+    doc["windTrackingActive"] = msc.isWindTrackingActive();
+    doc["windTrackingStatus"] = msc.getWindTrackingStatus();
+    WindSafetyData windSafetyData = weatherPoller.getWindSafetyData();
+    doc["emergencyStowActive"] = windSafetyData.emergencyStowActive;
+    doc["stowDirection"] = windSafetyData.currentStowDirection;
+
+    // Power in V, A and W
+    doc["inputVoltage"] = ina219Manager.getLoadVoltage();
+    doc["currentDraw"] = ina219Manager.getCurrent() / 1000;
+    doc["rotatorPowerDraw"] = ina219Manager.getPower();
+
+    // Satellite tracking look angles
+    doc["trackingState"] = satelliteTracker.getStateText();
+    doc["trackingAz"] = satelliteTracker.getAzimuth();
+    doc["trackingEl"] = satelliteTracker.getElevation();
+    doc["trackingRange"] = satelliteTracker.getRange();
+    doc["trackingPropUs"] = satelliteTracker.getLastPropagationMicros();
+    doc["trackingPropMaxUs"] = satelliteTracker.getMaxPropagationMicros();
+
+    // Connectivity
+    int rssi = wifiManager.getRSSI();
+    doc["rssi"] = rssi;
+    doc["level"] = wifiManager.getSignalStrengthLevel(rssi);
+    doc["ip_addr"] = wifiManager.ip_addr;
+    doc["bssid"] = wifiManager.getCurrentBSSID();
+    doc["wifi_channel"] = wifiManager.getCurrentWiFiChannel();
+    doc["serialActive"] = serialManager.serialActive.load();
+    doc["stellariumConnActive"] = stellariumPoller.getStellariumConnActive();
+    doc["rotctl_client_ip"] = rotctlWifi.getRotctlClientIP();
+    doc["rotctl_clients"] = rotctlWifi.getClientCount();
+
+    // rotctl reply latency; buckets end at 0.1, 0.25, 0.5, 1, 2.5, 5 and 10 ms, then the rest
+    RotctlWifi::LatencyStats latency = rotctlWifi.getLatencyStats();
+    JsonObject rotctlLatency = doc.createNestedObject("rotctl_latency");
+    rotctlLatency["count"] = latency.count;
+    rotctlLatency["p50_us"] = latency.p50Micros;
+    rotctlLatency["p99_us"] = latency.p99Micros;
+    rotctlLatency["max_us"] = latency.maxMicros;
+    JsonArray buckets = rotctlLatency.createNestedArray("buckets");
+    for (int i = 0; i < RotctlWifi::LATENCY_BUCKETS; i++) {
+        buckets.add(latency.buckets[i]);
+    }
+
+    // Weather in km/h and degrees; the forecast covers the next three hours
+    WeatherData weatherData = weatherPoller.getWeatherData();
+    JsonObject weather = doc.createNestedObject("weather");
+    weather["valid"] = weatherData.dataValid;
+    if (weatherData.dataValid) {
+        weather["windSpeed"] = weatherData.currentWindSpeed;
+        weather["windDirection"] = weatherData.currentWindDirection;
+        weather["windGust"] = weatherData.currentWindGust;
+        weather["time"] = weatherData.currentTime;
+        weather["lastUpdate"] = weatherData.lastUpdateTime;
+        JsonArray forecast = weather.createNestedArray("forecast");
+        for (int i = 0; i < 3; i++) {
+            JsonObject hour = forecast.createNestedObject();
+            hour["time"] = weatherData.forecastTimes[i];
+            hour["windSpeed"] = weatherData.forecastWindSpeed[i];
+            hour["windDirection"] = weatherData.forecastWindDirection[i];
+            hour["windGust"] = weatherData.forecastWindGust[i];
+        }
+    } else {
+        weather["error"] = weatherPoller.getLastError();
+    }
+
+    // ?logs=1 also drains new log text, for a UI that has no event stream to receive it
+    if (server->arg("logs") == "1") {
+        doc["newLogMessages"] = _logger.getNewLogMessages();
+    }
+
+    String json;
+    serializeJson(doc, json);
+    server->sendHeader("Server-Timing", "build;dur=" + String((micros() - buildStart) / 1000.0f, 3));
+    server->send(200, "application/json", json);
+}
+
 // =============================================================================
 // UPLOAD ROUTE SETUP METHODS
 // =============================================================================
@@ -875,7 +1567,7 @@ void WebServerManager::handleOTAUpload() {
 }
 
 void WebServerManager::handleFileUpload() {
-    HTTPUpload& upload = server->upload();
+    HttpUpload& upload = server->upload();
     
     static String uploadFilename = "";
     static File uploadFile;
@@ -883,45 +1575,42 @@ void WebServerManager::handleFileUpload() {
     static size_t totalBytesWritten = 0;
     static const size_t MAX_UPLOAD_SIZE = 3 * 1024 * 1024; // 3MB limit
 
-    _logger.debug("Upload status: " + String(upload.status) + ", filename: " + upload.filename + ", size: " + String(upload.currentSize));
+    LOGD(_logger, "Upload status: " + String(upload.status) + ", filename: " + upload.filename + ", size: " + String(upload.currentSize));
 
     if (upload.status == UPLOAD_FILE_START) {
-        _logger.info("Starting upload: " + String(upload.filename.c_str()));
+        LOGI(_logger, "Starting upload: " + String(upload.filename.c_str()));
         
         uploadFilename = upload.filename;
         uploadSuccess = false;
         totalBytesWritten = 0;
         
         if (!isValidUpdateFile(upload.filename)) {
-            _logger.error("Invalid file type");
+            LOGE(_logger, "Invalid file type");
             return;
         }
         
-        String filepath = "/" + upload.filename;
+        // Write to a temporary file so the live copy keeps being served until the upload completes
+        String filepath = "/" + upload.filename + ".tmp";
         
-        if (xSemaphoreTake(_fileMutex, portMAX_DELAY) == pdTRUE) {
-            uploadFile = LittleFS.open(filepath, "w");
-            if (uploadFile) {
-                _logger.debug("File opened for writing: " + filepath);
-                uploadSuccess = true;
-            } else {
-                _logger.error("Cannot open file: " + filepath);
-                xSemaphoreGive(_fileMutex);
-            }
+        uploadFile = LittleFS.open(filepath, "w");
+        if (uploadFile) {
+            LOGD(_logger, "File opened for writing: " + filepath);
+            uploadSuccess = true;
         } else {
-            _logger.error("Cannot take file mutex");
+            LOGE(_logger, "Cannot open file: " + filepath);
         }
         
     } else if (upload.status == UPLOAD_FILE_WRITE) {
-        _logger.debug("Writing " + String(upload.currentSize) + " bytes (total so far: " + String(totalBytesWritten + upload.currentSize) + " bytes)");
+        LOGD(_logger, "Writing " + String(upload.currentSize) + " bytes (total so far: " + String(totalBytesWritten + upload.currentSize) + " bytes)");
 
         // Check file size limit
         if (totalBytesWritten + upload.currentSize > MAX_UPLOAD_SIZE) {
-            _logger.error("File too large - " + String(totalBytesWritten + upload.currentSize) + " bytes exceeds " + String(MAX_UPLOAD_SIZE) + " byte limit");
+            LOGE(_logger, "File too large - " + String(totalBytesWritten + upload.currentSize) + " bytes exceeds " + String(MAX_UPLOAD_SIZE) + " byte limit");
             uploadSuccess = false;
             if (uploadFile) {
                 uploadFile.close();
                 uploadFile = File();
+                LittleFS.remove("/" + uploadFilename + ".tmp");
             }
             return;
         }
@@ -929,58 +1618,78 @@ void WebServerManager::handleFileUpload() {
         if (uploadFile && uploadSuccess && upload.currentSize > 0) {
             size_t written = uploadFile.write(upload.buf, upload.currentSize);
             if (written != upload.currentSize) {
-                _logger.error("Write failed - expected " + String(upload.currentSize) + ", wrote " + String(written));
+                LOGE(_logger, "Write failed - expected " + String(upload.currentSize) + ", wrote " + String(written));
                 uploadSuccess = false;
             } else {
                 totalBytesWritten += written;
             }
         } else {
-            _logger.error("File not ready for writing");
+            LOGE(_logger, "File not ready for writing");
             uploadSuccess = false;
         }
         
     } else if (upload.status == UPLOAD_FILE_END) {
-        _logger.debug("Upload finished: " + upload.filename + ", total: " + String(upload.totalSize) + " bytes (written: " + String(totalBytesWritten) + " bytes)");
+        LOGD(_logger, "Upload finished: " + upload.filename + ", total: " + String(upload.totalSize) + " bytes (written: " + String(totalBytesWritten) + " bytes)");
 
         if (uploadFile) {
             uploadFile.close();
-            _logger.debug("File closed");
+            uploadFile = File();
+            LOGD(_logger, "File closed");
         }
         
-        xSemaphoreGive(_fileMutex);
+        String tempPath = "/" + uploadFilename + ".tmp";
+        String finalPath = "/" + uploadFilename;
         
-        if (uploadSuccess && totalBytesWritten > 0) {
-            _logger.info("File uploaded: " + uploadFilename + " (" + String(totalBytesWritten) + " bytes)");
-            verifyUploadedFile(uploadFilename, totalBytesWritten);
+        if (uploadSuccess && totalBytesWritten > 0 &&
+            xSemaphoreTake(_fileMutex, portMAX_DELAY) == pdTRUE) {
+            // LittleFS renames atomically, replacing the old file in one step
+            bool renamed = LittleFS.rename(tempPath, finalPath);
+
+            // A .gz left over from an older plain file is ignored by refreshStaticAssets(), so the
+            // plain file and its .gz can be uploaded in either order
+            xSemaphoreGive(_fileMutex);
+
+            if (renamed) {
+                LOGI(_logger, "File uploaded: " + uploadFilename + " (" + String(totalBytesWritten) + " bytes)");
+                verifyUploadedFile(uploadFilename, totalBytesWritten);
+                // Uploads run on the worker task; asset versions and template offsets are
+                // read by requests on the server task, so they are rebuilt there
+                server->queueWork(reloadStaticAssetsOnServer, this);
+            } else {
+                LOGE(_logger, "Cannot replace " + finalPath);
+                LittleFS.remove(tempPath);
+            }
         } else {
-            _logger.error("Upload failed: " + uploadFilename);
+            LOGE(_logger, "Upload failed: " + uploadFilename);
+            LittleFS.remove(tempPath);
         }
         
     } else if (upload.status == UPLOAD_FILE_ABORTED) {
-        _logger.debug("Upload aborted");
+        LOGD(_logger, "Upload aborted");
         if (uploadFile) {
             uploadFile.close();
+            uploadFile = File();
+            LittleFS.remove("/" + uploadFilename + ".tmp");
         }
-        xSemaphoreGive(_fileMutex);
         uploadSuccess = false;
         totalBytesWritten = 0;
     }
 }
 
 void WebServerManager::handleFirmwareUpload() {
-    HTTPUpload& upload = server->upload();
+    HttpUpload& upload = server->upload();
     
     static bool updateStarted = false;
     static size_t totalSize = 0;
     static const size_t MAX_FIRMWARE_SIZE = 3 * 1024 * 1024; // 3MB limit
 
-    _logger.debug("Firmware upload status: " + String(upload.status) + ", size: " + String(upload.currentSize));
+    LOGD(_logger, "Firmware upload status: " + String(upload.status) + ", size: " + String(upload.currentSize));
 
     if (upload.status == UPLOAD_FILE_START) {
-        _logger.info("Starting firmware upload: " + upload.filename);
+        LOGI(_logger, "Starting firmware upload: " + upload.filename);
 
         if (!upload.filename.endsWith(".bin")) {
-            _logger.error("Invalid firmware file type");
+            LOGE(_logger, "Invalid firmware file type");
             return;
         }
         
@@ -990,7 +1699,7 @@ void WebServerManager::handleFirmwareUpload() {
     } else if (upload.status == UPLOAD_FILE_WRITE) {
         // Check size limit
         if (totalSize + upload.currentSize > MAX_FIRMWARE_SIZE) {
-            _logger.error("Firmware too large - " + String(totalSize + upload.currentSize) + " bytes exceeds " + String(MAX_FIRMWARE_SIZE) + " byte limit");
+            LOGE(_logger, "Firmware too large - " + String(totalSize + upload.currentSize) + " bytes exceeds " + String(MAX_FIRMWARE_SIZE) + " byte limit");
             if (updateStarted) {
                 Update.abort();
                 updateStarted = false;
@@ -999,36 +1708,36 @@ void WebServerManager::handleFirmwareUpload() {
         }
         
         if (!updateStarted) {
-            _logger.debug("Starting firmware update");
+            LOGD(_logger, "Starting firmware update");
             if (!Update.begin(UPDATE_SIZE_UNKNOWN)) {
-                _logger.error("Cannot start firmware update");
+                LOGE(_logger, "Cannot start firmware update");
                 return;
             }
             updateStarted = true;
         }
         
         if (Update.write(upload.buf, upload.currentSize) != upload.currentSize) {
-            _logger.error("Firmware write failed");
+            LOGE(_logger, "Firmware write failed");
             Update.abort();
             updateStarted = false;
             return;
         }
         
         totalSize += upload.currentSize;
-        _logger.debug("Firmware written: " + String(upload.currentSize) + " bytes (total: " + String(totalSize) + ")");
+        LOGD(_logger, "Firmware written: " + String(upload.currentSize) + " bytes (total: " + String(totalSize) + ")");
         
     } else if (upload.status == UPLOAD_FILE_END) {
         if (updateStarted) {
             if (Update.end(true)) {
-                _logger.info("Firmware update completed: " + String(totalSize) + " bytes");
+                LOGI(_logger, "Firmware update completed: " + String(totalSize) + " bytes");
             } else {
-                _logger.error("Firmware update failed");
+                LOGE(_logger, "Firmware update failed");
             }
         }
         updateStarted = false;
         
     } else if (upload.status == UPLOAD_FILE_ABORTED) {
-        _logger.debug("Firmware upload aborted");
+        LOGD(_logger, "Firmware upload aborted");
         if (updateStarted) {
             Update.abort();
             updateStarted = false;
@@ -1037,26 +1746,26 @@ void WebServerManager::handleFirmwareUpload() {
 }
 
 bool WebServerManager::updateFirmware(uint8_t* firmwareData, size_t firmwareSize) {
-    _logger.info("Updating firmware: " + String(firmwareSize) + " bytes");
+    LOGI(_logger, "Updating firmware: " + String(firmwareSize) + " bytes");
 
     if (!Update.begin(firmwareSize)) {
-        _logger.error("Not enough space for firmware update");
+        LOGE(_logger, "Not enough space for firmware update");
         return false;
     }
 
     size_t written = Update.write(firmwareData, firmwareSize);
     if (written != firmwareSize) {
-        _logger.error("Firmware write failed: " + String(written) + "/" + String(firmwareSize) + " bytes");
+        LOGE(_logger, "Firmware write failed: " + String(written) + "/" + String(firmwareSize) + " bytes");
         Update.abort();
         return false;
     }
 
     if (!Update.end(true)) {
-        _logger.error("Firmware update failed");
+        LOGE(_logger, "Firmware update failed");
         return false;
     }
 
-    _logger.info("Firmware update successful");
+    LOGI(_logger, "Firmware update successful");
     return true;
 }
 
@@ -1065,6 +1774,11 @@ bool WebServerManager::isValidUpdateFile(const String& filename) {
     
     String lowercaseFilename = filename;
     lowercaseFilename.toLowerCase();
+
+    // Precompressed variants are accepted for any file type that is itself valid
+    if (lowercaseFilename.endsWith(".gz")) {
+        return isValidUpdateFile(filename.substring(0, filename.length() - 3));
+    }
     
     return lowercaseFilename.endsWith(".html") || 
            lowercaseFilename.endsWith(".css") || 
@@ -1129,43 +1843,290 @@ String WebServerManager::createRestartResponse(const String& title, const String
 }
 
 void WebServerManager::handleStaticFile(const String& filePath, const String& contentType) {
-    if (xSemaphoreTake(_fileMutex, portMAX_DELAY) == pdTRUE) {
-        File file = LittleFS.open(filePath, "r");
-        if (file) {
-            server->streamFile(file, contentType);
-            file.close();
-        } else {
-            server->send(404, "text/plain", "File not found: " + filePath);
+    const StaticAsset* asset = findStaticAsset(filePath);
+    bool useGzip = asset != nullptr && asset->hasGzip &&
+                   server->header("Accept-Encoding").indexOf("gzip") >= 0;
+
+    if (asset != nullptr) {
+        // Each encoding is its own representation, so it gets its own strong ETag
+        String etag = "\"" + String(asset->version) + (useGzip ? "-gz\"" : "\"");
+        server->sendHeader("ETag", etag);
+        if (asset->hasGzip) {
+            server->sendHeader("Vary", "Accept-Encoding");
         }
+        if (server->header("If-None-Match") == etag) {
+            server->send(304);
+            return;
+        }
+        // URLs carrying the current version never change; bare URLs revalidate every time
+        bool versioned = server->arg("v") == asset->version;
+        server->sendHeader("Cache-Control", versioned ? "public, max-age=31536000, immutable" : "no-cache");
+    }
+
+    // The lock only covers the open so an upload cannot swap the file underneath it;
+    // streaming runs unlocked and readers never wait on each other
+    File file;
+    if (xSemaphoreTake(_fileMutex, portMAX_DELAY) == pdTRUE) {
+        file = LittleFS.open(useGzip ? filePath + ".gz" : filePath, "r");
         xSemaphoreGive(_fileMutex);
     }
+
+    if (file) {
+        // streamFile() adds Content-Encoding: gzip for .gz file names
+        server->streamFile(file, contentType);
+        file.close();
+    } else {
+        server->send(404, "text/plain", "File not found: " + filePath);
+    }
+}
+
+void WebServerManager::refreshStaticAssets() {
+    if (xSemaphoreTake(_fileMutex, portMAX_DELAY) != pdTRUE) {
+        return;
+    }
+
+    for (int i = 0; i < STATIC_ASSET_COUNT; i++) {
+        StaticAsset& asset = _staticAssets[i];
+        String gzipPath = String(asset.path) + ".gz";
+        uint32_t hash = fingerprintFile(asset.path, 2166136261u);
+
+        // tools/compress_assets.py records the fingerprint of the plain file it compressed;
+        // a .gz built from any other version would serve old content, so it is skipped
+        asset.hasGzip = false;
+        if (LittleFS.exists(gzipPath)) {
+            uint32_t source = 0;
+            if (readGzipSourceFingerprint(gzipPath, source) && source == hash) {
+                asset.hasGzip = true;
+                hash = fingerprintFile(gzipPath, hash);
+            } else {
+                LOGW(_logger, "Ignoring stale " + gzipPath + ", run tools/compress_assets.py and upload it again");
+            }
+        }
+        snprintf(asset.version, sizeof(asset.version), "%08lx", (unsigned long)hash);
+
+        LOGD(_logger, "Static asset " + String(asset.path) + " version " + String(asset.version) +
+                      (asset.hasGzip ? " (gzip)" : ""));
+    }
+
+    xSemaphoreGive(_fileMutex);
+}
+
+void WebServerManager::reloadStaticAssetsOnServer(void* arg) {
+    WebServerManager* manager = (WebServerManager*)arg;
+    manager->refreshStaticAssets();
+    manager->scanIndexTemplate();
+}
+
+String WebServerManager::getStaticAssetVersion(const String& filePath) {
+    const StaticAsset* asset = findStaticAsset(filePath);
+    return (asset != nullptr) ? String(asset->version) : "";
+}
+
+const WebServerManager::StaticAsset* WebServerManager::findStaticAsset(const String& filePath) {
+    for (int i = 0; i < STATIC_ASSET_COUNT; i++) {
+        if (filePath == _staticAssets[i].path) {
+            return &_staticAssets[i];
+        }
+    }
+    return nullptr;
+}
+
+uint32_t WebServerManager::fingerprintFile(const String& filePath, uint32_t hash) {
+    // FNV-1a over the file contents, chained so several files share one fingerprint
+    File file = LittleFS.open(filePath, "r");
+    if (!file) {
+        return hash;
+    }
+
+    uint8_t buf[256];
+    size_t bytesRead;
+    while ((bytesRead = file.read(buf, sizeof(buf))) > 0) {
+        for (size_t i = 0; i < bytesRead; i++) {
+            hash ^= buf[i];
+            hash *= 16777619u;
+        }
+    }
+    file.close();
+    return hash;
 }
 
-String WebServerManager::loadIndexHTML() {
+bool WebServerManager::readGzipSourceFingerprint(const String& gzipPath, uint32_t& fingerprint) {
+    // Gzip header (RFC 1952): magic, method, flags, then 6 bytes, then the zero-terminated
+    // FCOMMENT when flagged. compress_assets.py writes no FEXTRA or FNAME before it.
+    File file = LittleFS.open(gzipPath, "r");
+    if (!file) {
+        return false;
+    }
+
+    uint8_t header[GZIP_HEADER_SIZE];
+    char comment[GZIP_COMMENT_SIZE] = {};
+    bool valid = file.read(header, sizeof(header)) == sizeof(header) &&
+                 header[0] == 0x1f && header[1] == 0x8b && (header[3] & 0x1c) == GZIP_FCOMMENT;
+    if (valid) {
+        file.read((uint8_t*)comment, sizeof(comment) - 1);
+    }
+    file.close();
+
+    unsigned long value = 0;
+    if (!valid || sscanf(comment, "fnv1a=%8lx", &value) != 1) {
+        return false;
+    }
+    fingerprint = (uint32_t)value;
+    return true;
+}
+
+void WebServerManager::streamIndexHTML() {
+    File file;
     if (xSemaphoreTake(_fileMutex, portMAX_DELAY) == pdTRUE) {
-        File file = LittleFS.open("/index.html", "r");
+        file = LittleFS.open("/index.html", "r");
+        xSemaphoreGive(_fileMutex);
+    }
+    if (!file) {
+        server->send(500, "text/plain", "Failed to load HTML template");
+        return;
+    }
+
+    // Offsets belong to the file that was scanned; re-scan if it has been replaced since
+    if (file.size() != _indexSize) {
+        file.close();
+        scanIndexTemplate();
+        file = LittleFS.open("/index.html", "r");
         if (!file) {
-            xSemaphoreGive(_fileMutex);
-            return "";
+            server->send(500, "text/plain", "Failed to load HTML template");
+            return;
         }
-        
-        size_t fileSize = file.size();
-        String html;
-        html.reserve(fileSize + 500);
-        
-        const size_t bufSize = 512;
-        char buf[bufSize];
-        while (file.available()) {
-            size_t bytesRead = file.readBytes(buf, bufSize - 1);
-            buf[bytesRead] = 0;
-            html += buf;
+    }
+
+    server->setContentLength(HttpServer::CONTENT_LENGTH_UNKNOWN);
+    server->send(200, "text/html", "");
+
+    // Copy the file through a stack buffer, writing each substitution at its offset
+    char buf[512];
+    size_t position = 0;
+    for (int i = 0; i <= _indexPlaceholderCount; i++) {
+        size_t segmentEnd = (i < _indexPlaceholderCount) ? _indexPlaceholders[i].offset : _indexSize;
+        while (position < segmentEnd) {
+            size_t bytesRead = file.read((uint8_t*)buf, min(sizeof(buf), segmentEnd - position));
+            if (bytesRead == 0) {
+                break;
+            }
+            server->sendContent(buf, bytesRead);
+            position += bytesRead;
         }
 
-        file.close();
+        if (i < _indexPlaceholderCount) {
+            // An empty chunk would end the response, so empty values send nothing
+            String value = renderTemplateVar(_indexPlaceholders[i].var);
+            if (value.length() > 0) {
+                server->sendContent(value);
+            }
+            file.seek(_indexPlaceholders[i].offset + _indexPlaceholders[i].length);
+            position = _indexPlaceholders[i].offset + _indexPlaceholders[i].length;
+        }
+    }
+
+    file.close();
+    server->sendContent("");
+}
+
+void WebServerManager::scanIndexTemplate() {
+    static const char* const TEMPLATE_NAMES[TEMPLATE_VAR_COUNT] = {
+        "var_calmode_checked",
+        "var_singleMotorMode_checked",
+        "var_stellariumOn_checked",
+        "var_trackingOn_checked",
+        "var_styles_version",
+        "var_script_version",
+        "var_logo_version",
+    };
+
+    _indexPlaceholderCount = 0;
+    _indexSize = 0;
+
+    if (xSemaphoreTake(_fileMutex, portMAX_DELAY) != pdTRUE) {
+        return;
+    }
+    File file = LittleFS.open("/index.html", "r");
+    if (!file) {
         xSemaphoreGive(_fileMutex);
-        return html;
+        LOGE(_logger, "Cannot open /index.html for template scan");
+        return;
+    }
+    _indexSize = file.size();
+
+    // Tokens are %name% with an identifier in between; any other character ends the
+    // candidate, so literal percent signs in the page are left alone
+    char token[MAX_TEMPLATE_TOKEN + 1];
+    size_t tokenLength = 0;
+    bool inToken = false;
+    uint32_t tokenStart = 0;
+    uint32_t offset = 0;
+    uint8_t buf[256];
+    size_t bytesRead;
+
+    while ((bytesRead = file.read(buf, sizeof(buf))) > 0) {
+        for (size_t i = 0; i < bytesRead; i++, offset++) {
+            char c = (char)buf[i];
+            if (inToken) {
+                if (c == '%') {
+                    token[tokenLength] = '\0';
+                    inToken = false;
+                    int match = -1;
+                    for (int var = 0; var < TEMPLATE_VAR_COUNT; var++) {
+                        if (strcmp(token, TEMPLATE_NAMES[var]) == 0) {
+                            match = var;
+                            break;
+                        }
+                    }
+                    if (match >= 0 && _indexPlaceholderCount < MAX_TEMPLATE_PLACEHOLDERS) {
+                        _indexPlaceholders[_indexPlaceholderCount++] =
+                            { tokenStart, (uint8_t)(tokenLength + 2), (TemplateVar)match };
+                        continue;
+                    }
+                    // Not a known name: this percent sign may open the next token
+                } else if ((isalnum((unsigned char)c) || c == '_') && tokenLength < MAX_TEMPLATE_TOKEN) {
+                    token[tokenLength++] = c;
+                    continue;
+                } else {
+                    inToken = false;
+                }
+            }
+
+            if (c == '%') {
+                inToken = true;
+                tokenStart = offset;
+                tokenLength = 0;
+            }
+        }
+    }
+
+    file.close();
+    xSemaphoreGive(_fileMutex);
+
+    LOGD(_logger, "Index template: " + String(_indexPlaceholderCount) + " placeholders in " +
+                  String(_indexSize) + " bytes");
+}
+
+String WebServerManager::renderTemplateVar(TemplateVar var) {
+    switch (var) {
+        case TEMPLATE_CALMODE_CHECKED:
+            return msc.calMode ? "checked" : "";
+        case TEMPLATE_SINGLE_MOTOR_MODE_CHECKED:
+            return msc.singleMotorMode ? "checked" : "";
+        case TEMPLATE_STELLARIUM_ON_CHECKED:
+            return preferences.getBool("stellariumOn", false) ? "checked" : "";
+        case TEMPLATE_TRACKING_ON_CHECKED:
+            return satelliteTracker.getTrackingOn() ? "checked" : "";
+        // Versioned asset URLs let the browser cache them indefinitely
+        case TEMPLATE_STYLES_VERSION:
+            return getStaticAssetVersion("/styles.css");
+        case TEMPLATE_SCRIPT_VERSION:
+            return getStaticAssetVersion("/script.js");
+        case TEMPLATE_LOGO_VERSION:
+            return getStaticAssetVersion("/Logo-Circle-Cream.png");
+        default:
+            return "";
     }
-    return "";
 }
 
 void WebServerManager::verifyUploadedFile(const String& filename, size_t expectedSize) {
@@ -1174,15 +2135,33 @@ void WebServerManager::verifyUploadedFile(const String& filename, size_t expecte
         if (verifyFile) {
             size_t fileSize = verifyFile.size();
             verifyFile.close();
-            _logger.debug("File verification - size on disk: " + String(fileSize) + " bytes");
+            LOGD(_logger, "File verification - size on disk: " + String(fileSize) + " bytes");
             if (fileSize != expectedSize) {
-                _logger.warn("File size mismatch - expected " + String(expectedSize) + ", got " + String(fileSize));
+                LOGW(_logger, "File size mismatch - expected " + String(expectedSize) + ", got " + String(fileSize));
             }
         }
         xSemaphoreGive(_fileMutex);
     }
 }
 
+void WebServerManager::formatRotctlLatency(char* summary, size_t summarySize, char* histogram, size_t histogramSize) {
+    RotctlWifi::LatencyStats latency = rotctlWifi.getLatencyStats();
+    if (latency.count == 0) {
+        snprintf(summary, summarySize, "No commands yet");
+    } else {
+        snprintf(summary, summarySize, "p50 %.2f ms, p99 %.2f ms, max %.2f ms",
+                 latency.p50Micros / 1000.0f, latency.p99Micros / 1000.0f, latency.maxMicros / 1000.0f);
+    }
+
+    // Bucket shares in percent, comma separated, for the bar chart in the UI
+    size_t length = 0;
+    histogram[0] = '\0';
+    for (int i = 0; i < RotctlWifi::LATENCY_BUCKETS && length < histogramSize; i++) {
+        unsigned int percent = (latency.count > 0) ? (unsigned int)((uint64_t)latency.buckets[i] * 100 / latency.count) : 0;
+        length += snprintf(histogram + length, histogramSize - length, i == 0 ? "%u" : ",%u", percent);
+    }
+}
+
 String WebServerManager::generateOTAUploadHTML() {
     String html = "<!DOCTYPE html><html><head><title>OTA Update</title>";
     html += "<style>body{font-family:Arial;margin:40px;text-align:center;}";
@@ -1228,7 +2207,7 @@ String WebServerManager::generateOTAUploadHTML() {
     html += "<p><strong>Supported:</strong> .html, .css, .js, .png, .jpg, .jpeg</p>";
     html += "<div class='upload-box'>";
     html += "<form id='fileForm' onsubmit='return uploadFile(\"fileForm\", \"/fileupdate\", true);'>";
-    html += "<input type='file' name='webfile' accept='.html,.css,.js,.png,.jpg,.jpeg' required>";
+    html += "<input type='file' name='webfile' accept='.html,.css,.js,.png,.jpg,.jpeg,.gz' required>";
     html += generateProgressBarHTML();
     html += "<br><button type='submit'>Upload File</button>";
     html += "</form></div></div>";
@@ -1347,6 +2326,7 @@ void WebServerManager::setLoginUser(String loginUser) {
         _loginUser = loginUser;
         xSemaphoreGive(_loginUserMutex);
     }
+    invalidateConfig();
 }
 
 String WebServerManager::getLoginPassword() {
@@ -1363,4 +2343,5 @@ void WebServerManager::setLoginPassword(String loginPassword) {
         _loginPassword = loginPassword;
         xSemaphoreGive(_loginUserMutex);
     }
+    invalidateConfig();
 }
\ No newline at end of file
@@ -21,7 +21,6 @@
 
 // System includes
 #include <Arduino.h>
-#include <WebServer.h>
 #include <Preferences.h>
 #include <LittleFS.h>
 #include <ESPmDNS.h>
@@ -36,15 +35,21 @@
 #include "serial_manager.h"
 #include "wifi_manager.h"
 #include "rotctl_wifi.h"
+#include "udp_control.h"
 #include "logger.h"
 #include "weather_poller.h"
+#include "satellite_tracker.h"
+#include "log_file.h"
+#include "metrics_writer.h"
+#include "event_stream.h"
+#include "http_server.h"
 
 class WebServerManager {
 public:
     // Constructor
     WebServerManager(Preferences& prefs, MotorSensorController& motorController, INA219Manager& ina219Manager, 
                 StellariumPoller& stellariumPoller, WeatherPoller& weatherPoller, SerialManager& serialManager, 
-                WiFiManager& wifiManager, RotctlWifi& rotctlWifi, Logger& logger);
+                WiFiManager& wifiManager, RotctlWifi& rotctlWifi, UdpControl& udpControl, SatelliteTracker& satelliteTracker, LogFile& logFile, Logger& logger);
 
     // Core functionality
     void begin();
@@ -53,7 +58,9 @@ public:
     // Content and response methods
     String createRestartResponse(const String& title, const String& message);
     void handleStaticFile(const String& filePath, const String& contentType);
-    String loadIndexHTML();
+    void refreshStaticAssets();
+    String getStaticAssetVersion(const String& filePath);
+    void streamIndexHTML();
 
     // Authentication getters and setters
     String getLoginUser();
@@ -61,8 +68,21 @@ public:
     String getLoginPassword();
     void setLoginPassword(String loginPassword);
 
+    // Push channel; pushEvents() is called every event interval and hands the frame to the
+    // server task, which owns the event stream sockets
+    void pushEvents();
+    int getEventIntervalMs() const { return _eventIntervalMs; }
+    void setEventIntervalMs(int value);
+
+    // Bumps the /config ETag; routes registered with onConfigRoute() call it automatically
+    void invalidateConfig();
+
+    // Changes whenever anything /config reports changes: a config route ran here, or a
+    // setter ran in one of the modules whose settings it carries
+    uint32_t getConfigVersion();
+
     // Public members
-    WebServer* server;
+    HttpServer* server = nullptr;
     String wifi_ssid = "";
     String wifi_password = "";
 
@@ -75,6 +95,9 @@ private:
     WiFiManager& wifiManager;
     SerialManager& serialManager;
     RotctlWifi& rotctlWifi;
+    UdpControl& udpControl;
+    SatelliteTracker& satelliteTracker;
+    LogFile& logFile;
     Logger& _logger;
     WeatherPoller& weatherPoller;
 
@@ -83,6 +106,62 @@ private:
     String _loginUser = "";
     String _loginPassword = "";
 
+    // Server-Sent Events push channel
+    static constexpr int DEFAULT_EVENT_INTERVAL_MS = 250;
+    static constexpr int MIN_EVENT_INTERVAL_MS = 100;
+    static constexpr int MAX_EVENT_INTERVAL_MS = 5000;
+    EventStream _eventStream;
+    std::atomic<int> _eventIntervalMs = DEFAULT_EVENT_INTERVAL_MS;
+    std::atomic<bool> _eventsQueued = false;    // A frame is waiting for the server task
+
+    // Cached /config body, rebuilt only after a setter has run
+    std::atomic<uint32_t> _configVersion = 1;
+    uint32_t _configEpoch = 0;          // Random per boot so ETags never repeat across restarts
+    uint32_t _configJsonVersion = 0;
+    String _configJson;
+
+    // Static assets served from LittleFS. The version fingerprints the plain file and its
+    // optional .gz variant; it is the ETag and the ?v= cache-busting parameter on the index page.
+    // A .gz is only used when its header names the fingerprint of the current plain file.
+    struct StaticAsset {
+        const char* path;
+        const char* contentType;
+        char version[9];
+        bool hasGzip;
+    };
+    static constexpr int STATIC_ASSET_COUNT = 3;
+    static constexpr int GZIP_HEADER_SIZE = 10;
+    static constexpr uint8_t GZIP_FCOMMENT = 0x10;  // Header flag: a comment follows
+    static constexpr int GZIP_COMMENT_SIZE = 16;    // "fnv1a=xxxxxxxx" and its terminator
+    StaticAsset _staticAssets[STATIC_ASSET_COUNT] = {
+        { "/styles.css", "text/css", "", false },
+        { "/script.js", "application/javascript", "", false },
+        { "/Logo-Circle-Cream.png", "image/png", "", false },
+    };
+
+    // Index page template: byte offsets of each %var_...% placeholder, found once at boot
+    // and after uploads, so the page streams from LittleFS without being held in memory
+    enum TemplateVar : uint8_t {
+        TEMPLATE_CALMODE_CHECKED,
+        TEMPLATE_SINGLE_MOTOR_MODE_CHECKED,
+        TEMPLATE_STELLARIUM_ON_CHECKED,
+        TEMPLATE_TRACKING_ON_CHECKED,
+        TEMPLATE_STYLES_VERSION,
+        TEMPLATE_SCRIPT_VERSION,
+        TEMPLATE_LOGO_VERSION,
+        TEMPLATE_VAR_COUNT
+    };
+    struct TemplatePlaceholder {
+        uint32_t offset;
+        uint8_t length;
+        TemplateVar var;
+    };
+    static constexpr int MAX_TEMPLATE_PLACEHOLDERS = 16;
+    static constexpr size_t MAX_TEMPLATE_TOKEN = 40;
+    TemplatePlaceholder _indexPlaceholders[MAX_TEMPLATE_PLACEHOLDERS];
+    int _indexPlaceholderCount = 0;
+    size_t _indexSize = 0;
+
     // Thread synchronization
     SemaphoreHandle_t _fileMutex = NULL;
     SemaphoreHandle_t _loginUserMutex = NULL;
@@ -95,6 +174,15 @@ private:
     void setupConfigurationRoutes();
     void setupAPIRoutes();
     void setupDebugRoutes();
+    void handleMetrics();
+    void handleConfig();
+    void handleTelemetry();
+    void writeEvents();
+    static void writeEventsOnServer(void* arg);
+    static void reloadStaticAssetsOnServer(void* arg);
+    void buildConfigJson();
+    String getConfigETag(uint32_t version);
+    void onConfigRoute(const char* uri, httpd_method_t method, HttpServer::THandlerFunction handler);
     void setupFileUploadRoute();
     void setupFirmwareUploadRoute();
 
@@ -108,6 +196,12 @@ private:
     
     // Utility methods for file handling and HTML generation
     void verifyUploadedFile(const String& filename, size_t expectedSize);
+    void formatRotctlLatency(char* summary, size_t summarySize, char* histogram, size_t histogramSize);
+    const StaticAsset* findStaticAsset(const String& filePath);
+    static uint32_t fingerprintFile(const String& filePath, uint32_t hash);
+    static bool readGzipSourceFingerprint(const String& gzipPath, uint32_t& fingerprint);
+    void scanIndexTemplate();
+    String renderTemplateVar(TemplateVar var);
     String generateOTAUploadHTML();
     String generateUploadJavaScript();
     String generateProgressBarHTML();
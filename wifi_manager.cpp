@@ -34,8 +34,8 @@ void WiFiManager::begin() {
     connectToWiFi();
 
     if (MDNS.begin(_hostname)) {
-        _logger.info("MDNS responder started");
-        _logger.info("Access the ESP32 at: http://" + String(_hostname) + ".local");
+        LOGI(_logger, "MDNS responder started");
+        LOGI(_logger, "Access the ESP32 at: http://" + String(_hostname) + ".local");
     }
 
     MDNS.addService("http", "tcp", _preferences.getInt("http_port", 80));
@@ -71,7 +71,7 @@ void WiFiManager::connectToWiFi() {
                                                         &instance_got_ip));
 
     if (wifi_ssid != "" && wifi_password != "") {
-        _logger.info("Connecting to Wi-Fi...");
+        LOGI(_logger, "Connecting to Wi-Fi...");
 
         // Configure WiFi station mode
         ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
@@ -106,13 +106,13 @@ void WiFiManager::connectToWiFi() {
         ESP_ERROR_CHECK(esp_wifi_set_bandwidth(WIFI_IF_STA, WIFI_BW_HT20));
         ESP_ERROR_CHECK(esp_wifi_set_max_tx_power(84));
     } else {
-        _logger.info("No Wi-Fi credentials found, starting AP mode");
+        LOGI(_logger, "No Wi-Fi credentials found, starting AP mode");
         startAPMode();
     }
 }
 
 void WiFiManager::startAPMode() {
-    _logger.info("Starting Access Point...");
+    LOGI(_logger, "Starting Access Point...");
     
     esp_netif_t* ap_netif = esp_netif_create_default_wifi_ap();
     
@@ -135,7 +135,7 @@ void WiFiManager::startAPMode() {
     esp_netif_get_ip_info(ap_netif, &ip_info);
     ip_addr = IPAddress(ip_info.ip.addr).toString();
     
-    _logger.info("AP IP address: " + String(ip_addr));
+    LOGI(_logger, "AP IP address: " + String(ip_addr));
 }
 
 // Status and information methods
@@ -191,11 +191,11 @@ void WiFiManager::printCurrentBSSID() {
                 ap_info.bssid[0], ap_info.bssid[1], ap_info.bssid[2], 
                 ap_info.bssid[3], ap_info.bssid[4], ap_info.bssid[5]);
         
-        _logger.info("Connected to BSSID: " + String(bssid_str) + 
+        LOGI(_logger, "Connected to BSSID: " + String(bssid_str) + 
                     ", RSSI: " + String(ap_info.rssi) + " dBm" +
                     ", Channel: " + String(ap_info.primary));
     } else {
-        _logger.info("Failed to get AP info");
+        LOGI(_logger, "Failed to get AP info");
     }
 }
 
@@ -214,10 +214,10 @@ void WiFiManager::wifi_event_handler(void* arg, esp_event_base_t event_base, int
     if (event_base == WIFI_EVENT) {
         switch (event_id) {
             case WIFI_EVENT_STA_START: {
-                _instance->_logger.info("WiFi station mode started");
+                _instance->LOGI(_logger, "WiFi station mode started");
                 esp_err_t result = esp_wifi_connect();
                 if (result != ESP_OK && result != ESP_ERR_WIFI_CONN) {
-                    _instance->_logger.error("WiFi connect failed: " + String(result));
+                    _instance->LOGE(_logger, "WiFi connect failed: " + String(result));
                 }
                 break;
             }
@@ -229,7 +229,7 @@ void WiFiManager::wifi_event_handler(void* arg, esp_event_base_t event_base, int
                         event->bssid[0], event->bssid[1], event->bssid[2], 
                         event->bssid[3], event->bssid[4], event->bssid[5]);
                 
-                _instance->_logger.info("Connected to AP BSSID: " + String(bssid_str) + 
+                _instance->LOGI(_logger, "Connected to AP BSSID: " + String(bssid_str) + 
                                        ", Channel: " + String(event->channel));
                 _instance->wifiConnected = true;
                 break;
@@ -237,11 +237,11 @@ void WiFiManager::wifi_event_handler(void* arg, esp_event_base_t event_base, int
             
             case WIFI_EVENT_STA_DISCONNECTED: {
                 wifi_event_sta_disconnected_t* event = (wifi_event_sta_disconnected_t*)event_data;
-                _instance->_logger.error("WiFi disconnected. Reason: " + String(event->reason));
+                _instance->LOGE(_logger, "WiFi disconnected. Reason: " + String(event->reason));
 
                 // Handle roaming disconnections specially
                 if (event->reason == 8) {  // WIFI_REASON_ASSOC_LEAVE
-                    _instance->_logger.error("Disconnection due to roaming or AP request. Waiting before reconnecting...");
+                    _instance->LOGE(_logger, "Disconnection due to roaming or AP request. Waiting before reconnecting...");
                     delay(500);
                     break;
                 }
@@ -251,7 +251,7 @@ void WiFiManager::wifi_event_handler(void* arg, esp_event_base_t event_base, int
                 // Attempt reconnection
                 esp_err_t result = esp_wifi_connect();
                 if (result != ESP_OK && result != ESP_ERR_WIFI_CONN) {
-                    _instance->_logger.error("WiFi reconnect failed: " + String(result));
+                    _instance->LOGE(_logger, "WiFi reconnect failed: " + String(result));
                 }
                 break;
             }
@@ -259,7 +259,7 @@ void WiFiManager::wifi_event_handler(void* arg, esp_event_base_t event_base, int
     } 
     else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
         ip_event_got_ip_t* event = (ip_event_got_ip_t*)event_data;
-        _instance->_logger.info("Got IP: " + IPAddress(event->ip_info.ip.addr).toString());
+        _instance->LOGI(_logger, "Got IP: " + IPAddress(event->ip_info.ip.addr).toString());
         
         _instance->ip_addr = IPAddress(event->ip_info.ip.addr).toString();
         _instance->wifiConnected = true;